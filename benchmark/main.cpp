@@ -1,7 +1,59 @@
+#include <abacus/aggregator.hpp>
+#include <abacus/buffered_counter.hpp>
+#include <abacus/bulk_json.hpp>
+#include <abacus/compressor.hpp>
+#include <abacus/exporter.hpp>
+#include <abacus/framer.hpp>
+#include <abacus/history.hpp>
+#include <abacus/metadata_scanner.hpp>
 #include <abacus/metrics.hpp>
+#include <abacus/normalizer.hpp>
+#include <abacus/parse_metadata.hpp>
+#include <abacus/percpu_counter.hpp>
+#include <abacus/recorder.hpp>
+#include <abacus/recording.hpp>
+#include <abacus/rollup.hpp>
+#include <abacus/schema.hpp>
+#include <abacus/to_json.hpp>
+#include <abacus/value_pool.hpp>
+#include <abacus/view.hpp>
 #include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <map>
+#include <memory>
+#include <new>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
+
+// The number of heap allocations, counted by the replaced operator new
+static std::atomic<std::size_t> allocations{0};
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
 
 enum class test_enum
 {
@@ -128,7 +180,666 @@ static void BM_IncrementUint64(benchmark::State& state)
     state.SetItemsProcessed(state.iterations());
 }
 
+// Benchmark for incrementing a uint64 metric which enforces its bounds
+static void BM_IncrementBounded(benchmark::State& state)
+{
+    state.SetLabel("Increment Bounded Uint64 Metric");
+    abacus::metrics metrics(create_metric_infos());
+    auto m1 = metrics.initialize_bounded<abacus::uint64>("1").set_value(0);
+
+    for (auto _ : state)
+    {
+        m1 += 1;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Benchmark for incrementing a uint64 metric through a thread-local
+// accumulator, the sum is flushed to the metric every 1024 increments
+static void BM_IncrementBuffered(benchmark::State& state)
+{
+    state.SetLabel("Increment Buffered Counter");
+    abacus::metrics metrics(create_metric_infos());
+    abacus::buffered_counter<abacus::uint64> counter(
+        metrics.initialize<abacus::uint64>("1"));
+    auto local = counter.make_local();
+
+    for (auto _ : state)
+    {
+        ++local;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Benchmark for incrementing a uint64 metric through per-CPU slots
+static void BM_IncrementPerCpu(benchmark::State& state)
+{
+    state.SetLabel(abacus::percpu_counter<abacus::uint64>::uses_rseq()
+                       ? "Increment Per-CPU Counter (rseq)"
+                       : "Increment Per-CPU Counter (atomic)");
+    abacus::metrics metrics(create_metric_infos());
+    abacus::percpu_counter<abacus::uint64> counter(
+        metrics.initialize<abacus::uint64>("1"));
+
+    for (auto _ : state)
+    {
+        ++counter;
+    }
+
+    counter.flush();
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Benchmark for incrementing a shared atomic, for comparison with the
+// buffered counter
+static void BM_IncrementAtomic(benchmark::State& state)
+{
+    state.SetLabel("Increment Atomic");
+    std::atomic<uint64_t> counter{0};
+
+    for (auto _ : state)
+    {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    benchmark::DoNotOptimize(counter.load());
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Helper function to create a large schema with the given number of metrics
+std::map<abacus::name, abacus::info>
+create_large_metric_infos(std::size_t count)
+{
+    std::map<abacus::name, abacus::info> infos;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        abacus::name name{"conn." + std::to_string(i) + ".bytes"};
+        switch (i % 4)
+        {
+        case 0:
+            infos.emplace(name, abacus::uint64{abacus::kind::counter,
+                                               abacus::description{"Bytes"},
+                                               abacus::unit{"bytes"}});
+            break;
+        case 1:
+            infos.emplace(name, abacus::int64{abacus::kind::gauge,
+                                              abacus::description{"Delta"}});
+            break;
+        case 2:
+            infos.emplace(name, abacus::float64{abacus::kind::gauge,
+                                                abacus::description{"Rate"},
+                                                abacus::unit{"bytes/s"}});
+            break;
+        default:
+            infos.emplace(name, abacus::boolean{abacus::description{"Up"}});
+            break;
+        }
+    }
+    return infos;
+}
+
+// Benchmark for constructing metrics with a large schema
+static void BM_MetricsConstruction(benchmark::State& state)
+{
+    state.SetLabel("Metrics Construction");
+    auto infos = create_large_metric_infos(state.range(0));
+    for (auto _ : state)
+    {
+        abacus::metrics metrics(infos);
+        benchmark::DoNotOptimize(metrics.metadata_data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetComplexityN(state.range(0));
+}
+
+// Benchmark for creating metrics from a shared schema, like when opening a
+// connection
+static void BM_MetricsFromSchema(benchmark::State& state)
+{
+    state.SetLabel("Metrics From Schema");
+    auto schema = std::make_shared<const abacus::schema>(
+        create_large_metric_infos(state.range(0)));
+    for (auto _ : state)
+    {
+        abacus::metrics metrics(schema);
+        benchmark::DoNotOptimize(metrics.value_data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Benchmark for replacing the oldest of many live metrics, like connections
+// being opened and closed. The second argument selects the value pool.
+static void BM_MetricsChurn(benchmark::State& state)
+{
+    auto schema = std::make_shared<const abacus::schema>(
+        create_large_metric_infos(100));
+    abacus::value_pool pool(schema);
+    const bool pooled = state.range(1) != 0;
+    state.SetLabel(pooled ? "Metrics Churn Pool" : "Metrics Churn Heap");
+
+    auto create = [&]()
+    { return pooled ? abacus::metrics(pool) : abacus::metrics(schema); };
+
+    std::vector<std::optional<abacus::metrics>> live(state.range(0));
+    for (auto& metrics : live)
+    {
+        metrics.emplace(create());
+    }
+
+    std::size_t oldest = 0;
+    for (auto _ : state)
+    {
+        live[oldest].reset();
+        live[oldest].emplace(create());
+        benchmark::DoNotOptimize(live[oldest]->value_data());
+        oldest = (oldest + 1) % live.size();
+    }
+    live.clear();
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Benchmark for aggregating many value buffers of the same schema
+static void BM_Aggregate(benchmark::State& state)
+{
+    state.SetLabel("Aggregate");
+    abacus::metrics metrics(create_large_metric_infos(100));
+    abacus::aggregator aggregator(metrics.metadata());
+
+    // Every buffer is a separate copy, like the buffers of many connections
+    std::vector<std::vector<uint8_t>> buffers(
+        state.range(0), std::vector<uint8_t>(metrics.value_data(),
+                                             metrics.value_data() +
+                                                 metrics.value_bytes()));
+    std::vector<const uint8_t*> value_data;
+    for (const auto& buffer : buffers)
+    {
+        value_data.push_back(buffer.data());
+    }
+
+    std::vector<uint8_t> data(aggregator.value_bytes());
+    for (auto _ : state)
+    {
+        bool result =
+            aggregator.aggregate(value_data, data.data(), state.range(1));
+        benchmark::DoNotOptimize(result);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Helper function to create the value data of a producer with the opposite
+// byte order, the values are not used so only the sync value is swapped
+std::pair<abacus::protobuf::MetricsMetadata, std::vector<uint8_t>>
+create_foreign(const abacus::metrics& metrics)
+{
+    auto metadata = metrics.metadata();
+    metadata.set_endianness(
+        metadata.endianness() == abacus::protobuf::Endianness::BIG
+            ? abacus::protobuf::Endianness::LITTLE
+            : abacus::protobuf::Endianness::BIG);
+    std::vector<uint8_t> data(metrics.value_data(),
+                              metrics.value_data() + metrics.value_bytes());
+    std::reverse(data.begin(), data.begin() + sizeof(uint32_t));
+    return {metadata, data};
+}
+
+// Benchmark for reading the values of a buffer from a producer with a
+// foreign byte order. The argument selects reading a buffer which was
+// normalized to the byte order of the host instead of swapping every read.
+static void BM_ReadForeign(benchmark::State& state)
+{
+    const bool normalized = state.range(0) != 0;
+    state.SetLabel(normalized ? "Read Foreign Normalized"
+                              : "Read Foreign Swapped");
+    abacus::metrics metrics(create_large_metric_infos(1000));
+    auto [metadata, data] = create_foreign(metrics);
+
+    abacus::normalizer normalizer(metadata);
+    abacus::view view;
+    bool result = true;
+    if (normalized)
+    {
+        result = normalizer.normalize(data.data(), data.size()) &&
+                 view.set_metadata(normalizer.metadata());
+    }
+    else
+    {
+        result = view.set_metadata(metadata);
+    }
+    result = result && view.set_value_data(data.data(), data.size());
+    assert(result);
+    (void)result;
+
+    std::vector<std::size_t> ids;
+    for (std::size_t id = 0; id < view.count(); ++id)
+    {
+        if (view.metric(id).has_uint64())
+        {
+            ids.push_back(id);
+        }
+    }
+
+    for (auto _ : state)
+    {
+        uint64_t sum = 0;
+        for (auto id : ids)
+        {
+            sum += view.value<abacus::uint64>(id).value_or(0);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * ids.size());
+}
+
+// Benchmark for normalizing a buffer from a producer with a foreign byte
+// order, the items are the swapped values
+static void BM_Normalize(benchmark::State& state)
+{
+    state.SetLabel("Normalize");
+    abacus::metrics metrics(create_large_metric_infos(1000));
+    auto [metadata, foreign] = create_foreign(metrics);
+    abacus::normalizer normalizer(metadata);
+
+    std::vector<uint8_t> data(foreign.size());
+    for (auto _ : state)
+    {
+        bool result = normalizer.normalize(foreign.data(), foreign.size(),
+                                           data.data());
+        benchmark::DoNotOptimize(result);
+        benchmark::ClobberMemory();
+    }
+    // One in four metrics is a boolean, which is not swapped
+    state.SetItemsProcessed(state.iterations() * 750);
+}
+
+// Benchmark for parsing the meta data of a large schema into a view. The
+// second argument selects parsing into the arena of the view instead of
+// parsing to the heap and copying into the view.
+static void BM_ParseMetadata(benchmark::State& state)
+{
+    const bool arena = state.range(1) != 0;
+    state.SetLabel(arena ? "Parse Metadata Arena" : "Parse Metadata Heap");
+    auto schema = std::make_shared<const abacus::schema>(
+        create_large_metric_infos(state.range(0)));
+
+    std::size_t before = allocations.load();
+    for (auto _ : state)
+    {
+        abacus::view view;
+        bool result;
+        if (arena)
+        {
+            result = view.set_metadata(schema->metadata_data(),
+                                       schema->metadata_bytes());
+        }
+        else
+        {
+            auto parsed = abacus::parse_metadata(schema->metadata_data(),
+                                                 schema->metadata_bytes());
+            result = parsed.has_value() && view.set_metadata(*parsed);
+        }
+        benchmark::DoNotOptimize(result);
+    }
+    state.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(allocations.load() - before),
+        benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Benchmark for the size of the meta data of a large schema and parsing it
+// into a view. The second argument selects the inline strings, string table
+// or lean encoding, the lean meta data is parsed without its dictionary.
+static void BM_ParseStringTable(benchmark::State& state)
+{
+    const abacus::metadata_encoding encodings[] = {
+        abacus::metadata_encoding::inline_strings,
+        abacus::metadata_encoding::string_table,
+        abacus::metadata_encoding::lean};
+    const char* labels[] = {"Inline Strings", "String Table", "Lean"};
+    const auto encoding = encodings[state.range(1)];
+    state.SetLabel(labels[state.range(1)]);
+    auto schema = std::make_shared<const abacus::schema>(
+        create_large_metric_infos(state.range(0)), encoding);
+
+    for (auto _ : state)
+    {
+        abacus::view view;
+        bool result = view.set_metadata(schema->metadata_data(),
+                                        schema->metadata_bytes());
+        benchmark::DoNotOptimize(result);
+    }
+    state.counters["metadata_bytes"] =
+        static_cast<double>(schema->metadata_bytes());
+    state.counters["dictionary_bytes"] =
+        static_cast<double>(schema->dictionary_bytes());
+    state.SetBytesProcessed(state.iterations() * schema->metadata_bytes());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Benchmark for scanning the names, types and offsets of a large schema
+// without materializing the meta data
+static void BM_ScanMetadata(benchmark::State& state)
+{
+    state.SetLabel("Scan Metadata");
+    auto schema = std::make_shared<const abacus::schema>(
+        create_large_metric_infos(state.range(0)));
+
+    abacus::metadata_scanner scanner;
+    std::size_t before = allocations.load();
+    for (auto _ : state)
+    {
+        bool result =
+            scanner.scan(schema->metadata_data(), schema->metadata_bytes());
+        benchmark::DoNotOptimize(result);
+    }
+    state.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(allocations.load() - before),
+        benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
 // Apply custom arguments to all benchmarks
+// Helper function to create metrics with a large schema and realistic
+// values. The counters, rates and states are set while the deltas are left
+// unset.
+std::unique_ptr<abacus::metrics> create_large_metrics(std::size_t count)
+{
+    auto metrics =
+        std::make_unique<abacus::metrics>(create_large_metric_infos(count));
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto name = "conn." + std::to_string(i) + ".bytes";
+        switch (i % 4)
+        {
+        case 0:
+            metrics->initialize<abacus::uint64>(name).set_value(i * 1500);
+            break;
+        case 2:
+            metrics->initialize<abacus::float64>(name).set_value(i * 0.75);
+            break;
+        case 3:
+            metrics->initialize<abacus::boolean>(name).set_value(true);
+            break;
+        default:
+            break;
+        }
+    }
+    return metrics;
+}
+
+// Benchmark for compressing the value data or meta data of a large schema.
+// The first argument selects the codec and the second the meta data.
+static void BM_Compress(benchmark::State& state)
+{
+    const auto codec = static_cast<abacus::codec>(state.range(0));
+    const bool metadata = state.range(1) != 0;
+    state.SetLabel(std::string(codec == abacus::codec::lz ? "LZ" : "Zero Run") +
+                   (metadata ? " Metadata" : " Values"));
+    auto metrics = create_large_metrics(1000);
+    const uint8_t* data =
+        metadata ? metrics->metadata_data() : metrics->value_data();
+    const std::size_t bytes =
+        metadata ? metrics->metadata_bytes() : metrics->value_bytes();
+
+    abacus::compressor compressor(codec);
+    std::vector<uint8_t> frame(compressor.max_frame_bytes(bytes));
+    std::size_t frame_bytes = 0;
+    for (auto _ : state)
+    {
+        frame_bytes = compressor.compress(data, bytes, frame.data());
+        benchmark::DoNotOptimize(frame_bytes);
+        benchmark::ClobberMemory();
+    }
+    state.counters["ratio"] = static_cast<double>(bytes) / frame_bytes;
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+// Benchmark for decompressing the frames of BM_Compress, the bytes are those
+// of the decompressed data
+static void BM_Decompress(benchmark::State& state)
+{
+    const auto codec = static_cast<abacus::codec>(state.range(0));
+    const bool metadata = state.range(1) != 0;
+    state.SetLabel(std::string(codec == abacus::codec::lz ? "LZ" : "Zero Run") +
+                   (metadata ? " Metadata" : " Values"));
+    auto metrics = create_large_metrics(1000);
+    const uint8_t* data =
+        metadata ? metrics->metadata_data() : metrics->value_data();
+    const std::size_t bytes =
+        metadata ? metrics->metadata_bytes() : metrics->value_bytes();
+
+    std::vector<uint8_t> frame;
+    abacus::compressor(codec).compress(data, bytes, frame);
+    std::vector<uint8_t> output(bytes);
+    std::size_t before = allocations.load();
+    for (auto _ : state)
+    {
+        bool result = abacus::decompress(frame.data(), frame.size(),
+                                         output.data(), output.size());
+        benchmark::DoNotOptimize(result);
+        benchmark::ClobberMemory();
+    }
+    state.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(allocations.load() - before),
+        benchmark::Counter::kAvgIterations);
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+// Benchmark for recording snapshots of metrics with a large schema into a
+// full history ring, including reading the clock
+static void BM_RecordHistory(benchmark::State& state)
+{
+    state.SetLabel("Record History");
+    auto metrics = create_large_metrics(state.range(0));
+    abacus::history history(metrics->schema(), 100);
+    for (std::size_t i = 0; i < history.capacity(); ++i)
+    {
+        history.record(*metrics);
+    }
+
+    std::size_t before = allocations.load();
+    for (auto _ : state)
+    {
+        history.record(*metrics);
+        benchmark::ClobberMemory();
+    }
+    state.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(allocations.load() - before),
+        benchmark::Counter::kAvgIterations);
+    state.SetBytesProcessed(state.iterations() * history.value_bytes());
+}
+
+// Benchmark for adding the value data of metrics with a large schema to a
+// rollup, the items are the metrics
+static void BM_Rollup(benchmark::State& state)
+{
+    state.SetLabel("Rollup");
+    auto metrics = create_large_metrics(state.range(0));
+    abacus::rollup rollup(metrics->metadata(), std::chrono::seconds(10), 100);
+
+    // Every iteration is a snapshot 10ms after the previous
+    abacus::rollup::clock::time_point time;
+    std::size_t before = allocations.load();
+    for (auto _ : state)
+    {
+        time += std::chrono::milliseconds(10);
+        bool result = rollup.update(metrics->value_data(), time);
+        benchmark::DoNotOptimize(result);
+    }
+    state.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(allocations.load() - before),
+        benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Benchmark for exporting a snapshot of metrics with a large schema, i.e.
+// copying the value data, queueing it and delivering it to a sink. The
+// snapshot buffers are reused, so only the first snapshots allocate.
+static void BM_ExportSnapshot(benchmark::State& state)
+{
+    state.SetLabel("ExportSnapshot");
+    auto metrics = create_large_metrics(state.range(0));
+    abacus::exporter exporter(std::chrono::seconds(1), 16);
+    std::size_t bytes = 0;
+    exporter.add_sink([&bytes](const abacus::exporter::snapshot& snapshot)
+                      { bytes += snapshot.data.size(); });
+    exporter.add(*metrics);
+    exporter.flush();
+
+    std::size_t before = allocations.load();
+    for (auto _ : state)
+    {
+        exporter.flush();
+    }
+    benchmark::DoNotOptimize(bytes);
+    state.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(allocations.load() - before),
+        benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Benchmark for framing the value data of metrics with a large schema for
+// writev(), which reads the value data once for the checksum
+static void BM_Frame(benchmark::State& state)
+{
+    state.SetLabel("Frame");
+    auto metrics = create_large_metrics(state.range(0));
+    abacus::framer framer;
+    for (auto _ : state)
+    {
+        framer.frame(*metrics, false);
+        benchmark::DoNotOptimize(framer.spans());
+    }
+    state.SetBytesProcessed(state.iterations() * metrics->value_bytes());
+}
+
+// Benchmark for recording the value data of metrics with a large schema to
+// a file, including the batched writes and syncs
+static void BM_Record(benchmark::State& state)
+{
+    state.SetLabel("Record");
+    auto metrics = create_large_metrics(state.range(0));
+    const char* path = "abacus_benchmark_recording";
+    {
+        abacus::recorder recorder(path);
+        assert(recorder.is_open());
+
+        // Every iteration is a snapshot 10ms after the previous
+        abacus::recorder::clock::time_point time;
+        std::size_t before = allocations.load();
+        for (auto _ : state)
+        {
+            time += std::chrono::milliseconds(10);
+            bool result = recorder.record(*metrics, time);
+            benchmark::DoNotOptimize(result);
+        }
+        state.counters["allocations"] = benchmark::Counter(
+            static_cast<double>(allocations.load() - before),
+            benchmark::Counter::kAvgIterations);
+    }
+    std::remove(path);
+    state.SetBytesProcessed(state.iterations() * metrics->value_bytes());
+}
+
+// Benchmark for reading one second of snapshots from the middle of a
+// recording of a minute, the items are the snapshots read
+static void BM_ReadRecording(benchmark::State& state)
+{
+    state.SetLabel("ReadRecording");
+    auto metrics = create_large_metrics(state.range(0));
+    const char* path = "abacus_benchmark_recording";
+    abacus::recorder::clock::time_point time;
+    {
+        abacus::recorder recorder(path);
+        for (std::size_t i = 0; i < 6000; ++i)
+        {
+            time += std::chrono::milliseconds(10);
+            bool result = recorder.record(*metrics, time);
+            assert(result);
+            (void)result;
+        }
+    }
+
+    abacus::recording recording(path);
+    assert(recording.is_open());
+    auto from = time - std::chrono::seconds(30);
+    std::size_t snapshots = 0;
+    for (auto _ : state)
+    {
+        bool result =
+            recording.read(from, from + std::chrono::seconds(1),
+                           [&snapshots](auto, const abacus::view& view)
+                           {
+                               ++snapshots;
+                               benchmark::DoNotOptimize(view.value_data());
+                           });
+        benchmark::DoNotOptimize(result);
+    }
+    std::remove(path);
+    state.SetItemsProcessed(static_cast<int64_t>(snapshots));
+}
+
+// Benchmark for rendering the minimal JSON of 10000 views of 100 metrics
+// one at a time with abacus::to_json(), the items are the views
+static void BM_ToJson(benchmark::State& state)
+{
+    state.SetLabel("ToJson");
+    auto metrics = create_large_metrics(100);
+    abacus::view view;
+    bool valid = view.set_metadata(metrics->metadata()) &&
+                 view.set_value_data(metrics->value_data(),
+                                     metrics->value_bytes());
+    assert(valid);
+    (void)valid;
+
+    for (auto _ : state)
+    {
+        std::string json = "[";
+        for (std::size_t i = 0; i < 10000; ++i)
+        {
+            json += abacus::to_json(view, true);
+            json += i + 1 < 10000 ? "," : "]";
+        }
+        benchmark::DoNotOptimize(json.data());
+    }
+    state.SetItemsProcessed(state.iterations() * 10000);
+}
+
+// Benchmark for rendering the minimal JSON of 10000 views of 100 metrics
+// into one JSON array with abacus::bulk_json, the argument is the number of
+// threads and the items are the views
+static void BM_BulkJson(benchmark::State& state)
+{
+    state.SetLabel("BulkJson");
+    auto metrics = create_large_metrics(100);
+    abacus::view view;
+    bool valid = view.set_metadata(metrics->metadata()) &&
+                 view.set_value_data(metrics->value_data(),
+                                     metrics->value_bytes());
+    assert(valid);
+    (void)valid;
+    std::vector<const abacus::view*> views(10000, &view);
+
+    abacus::bulk_json bulk_json(static_cast<std::size_t>(state.range(0)));
+    std::string json;
+    bulk_json.render(views.data(), views.size(),
+                     abacus::bulk_json::format::array, true, json);
+
+    std::size_t before = allocations.load();
+    for (auto _ : state)
+    {
+        bulk_json.render(views.data(), views.size(),
+                         abacus::bulk_json::format::array, true, json);
+        benchmark::DoNotOptimize(json.data());
+    }
+    state.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(allocations.load() - before),
+        benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * views.size());
+}
+
 static void CustomArguments(benchmark::internal::Benchmark* b)
 {
     b->Unit(benchmark::kMicrosecond);
@@ -138,5 +849,64 @@ BENCHMARK(BM_MetricInitialization)->Apply(CustomArguments);
 BENCHMARK(BM_AssignMetrics)->Apply(CustomArguments);
 BENCHMARK(BM_AccessMetrics)->Apply(CustomArguments);
 BENCHMARK(BM_IncrementUint64)->Apply(CustomArguments);
+BENCHMARK(BM_IncrementBounded)->Apply(CustomArguments);
+BENCHMARK(BM_IncrementBuffered)->Apply(CustomArguments);
+BENCHMARK(BM_IncrementPerCpu)->Apply(CustomArguments);
+BENCHMARK(BM_IncrementAtomic)->Apply(CustomArguments);
+BENCHMARK(BM_MetricsConstruction)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity();
+BENCHMARK(BM_MetricsFromSchema)
+    ->RangeMultiplier(10)
+    ->Range(10, 1000)
+    ->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_MetricsChurn)
+    ->ArgsProduct({{100, 10000}, {0, 1}})
+    ->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_Aggregate)
+    ->ArgsProduct({{1000, 10000, 100000}, {1, 4}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+BENCHMARK(BM_ReadForeign)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_Normalize)->Unit(benchmark::kNanosecond);
+BENCHMARK(BM_ParseMetadata)
+    ->ArgsProduct({{1000, 100000}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseStringTable)
+    ->ArgsProduct({{1000, 100000}, {0, 1, 2}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ScanMetadata)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Compress)
+    ->ArgsProduct({{1, 2}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Decompress)
+    ->ArgsProduct({{1, 2}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RecordHistory)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Rollup)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ExportSnapshot)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Frame)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Record)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ReadRecording)->Arg(1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ToJson)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BulkJson)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
 
 BENCHMARK_MAIN();
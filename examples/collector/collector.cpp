@@ -0,0 +1,335 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <abacus/collector.hpp>
+#include <abacus/to_json.hpp>
+#include <abacus/view.hpp>
+
+// A collector daemon for local producers. The producers connect to a UNIX
+// domain socket and send frames created by abacus::framer, the first frame
+// with the meta data. A client connecting to the export socket receives the
+// aggregated metrics of every sync value as a JSON array.
+//
+// Usage: abacus_collector <socket> <export socket>
+//
+// The daemon is single threaded, epoll tells which connections have bytes,
+// and abacus::collector processes the frames where they are read. The
+// export is written to the clients without blocking, as they are ready to
+// receive it. The memory is bounded by the frame size limit per connection.
+
+namespace
+{
+volatile std::sig_atomic_t stopped = 0;
+
+void stop(int)
+{
+    stopped = 1;
+}
+
+// Creates a non-blocking listening UNIX domain socket
+int listen_unix(const std::string& path)
+{
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        std::fprintf(stderr, "Socket path too long: %s\n", path.c_str());
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        std::perror("socket");
+        return -1;
+    }
+    ::unlink(path.c_str());
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) !=
+            0 ||
+        ::listen(fd, SOMAXCONN) != 0)
+    {
+        std::perror(path.c_str());
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Renders the aggregate of every sync value
+std::string export_json(const abacus::collector& collector)
+{
+    std::string json = "[";
+    std::vector<uint8_t> aggregate;
+    for (uint32_t sync_value : collector.sync_values())
+    {
+        std::size_t producers = collector.aggregate(sync_value, aggregate);
+        if (producers == 0)
+        {
+            continue;
+        }
+        abacus::view view;
+        if (!view.set_metadata(collector.metadata(sync_value)) ||
+            !view.set_value_data(aggregate.data(), aggregate.size()))
+        {
+            continue;
+        }
+        if (json.size() > 1)
+        {
+            json += ",";
+        }
+        json += "{\"sync_value\":" + std::to_string(sync_value) +
+                ",\"producers\":" + std::to_string(producers) +
+                ",\"metrics\":" + abacus::to_json(view, true) + "}";
+    }
+    json += "]\n";
+    return json;
+}
+
+// A client of the export socket, which gets a second to read the export
+struct export_client
+{
+    std::string json;
+    std::size_t sent = 0;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+// Sends as much of the export as the socket takes without blocking
+// @return true if the client should be kept to send the rest
+bool send_export(int fd, export_client& client)
+{
+    while (client.sent < client.json.size())
+    {
+        auto result = ::send(fd, client.json.data() + client.sent,
+                             client.json.size() - client.sent, MSG_NOSIGNAL);
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result < 0 && errno == EAGAIN)
+        {
+            return true;
+        }
+        if (result <= 0)
+        {
+            return false;
+        }
+        client.sent += static_cast<std::size_t>(result);
+    }
+    return false;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::fprintf(stderr, "Usage: %s <socket> <export socket>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const std::string path = argv[1];
+    const std::string export_path = argv[2];
+
+    struct sigaction action{};
+    action.sa_handler = stop;
+    ::sigaction(SIGINT, &action, nullptr);
+    ::sigaction(SIGTERM, &action, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    int listener = listen_unix(path);
+    int export_listener = listen_unix(export_path);
+    int epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    if (listener < 0 || export_listener < 0 || epoll < 0)
+    {
+        return EXIT_FAILURE;
+    }
+    for (int fd : {listener, export_listener})
+    {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        ::epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    abacus::collector collector;
+    std::unordered_map<int, std::size_t> producers;
+    auto disconnect = [&](int fd)
+    {
+        ::epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        collector.remove_producer(producers.at(fd));
+        producers.erase(fd);
+    };
+
+    std::unordered_map<int, export_client> export_clients;
+    auto close_export = [&](int fd)
+    {
+        ::epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        export_clients.erase(fd);
+    };
+
+    // Reading up to a fixed number of times per event keeps a busy producer
+    // from starving the others, epoll reports the rest again
+    constexpr int reads_per_event = 16;
+    std::vector<uint8_t> buffer(256 * 1024);
+    std::vector<epoll_event> events(256);
+
+    uint64_t bytes = 0;
+    uint64_t last_frames = 0;
+    uint64_t last_bytes = 0;
+    auto last = std::chrono::steady_clock::now();
+    while (!stopped)
+    {
+        int count = ::epoll_wait(epoll, events.data(),
+                                 static_cast<int>(events.size()), 1000);
+        if (count < 0 && errno != EINTR)
+        {
+            std::perror("epoll_wait");
+            break;
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            const int fd = events[i].data.fd;
+            if (fd == listener)
+            {
+                int connection;
+                while ((connection = ::accept4(listener, nullptr, nullptr,
+                                               SOCK_NONBLOCK | SOCK_CLOEXEC)) >=
+                       0)
+                {
+                    epoll_event event{};
+                    event.events = EPOLLIN | EPOLLRDHUP;
+                    event.data.fd = connection;
+                    ::epoll_ctl(epoll, EPOLL_CTL_ADD, connection, &event);
+                    producers[connection] = collector.add_producer();
+                }
+                continue;
+            }
+            if (fd == export_listener)
+            {
+                // The export is rendered when a client connects and sent as
+                // the client reads it
+                int connection;
+                while ((connection = ::accept4(export_listener, nullptr,
+                                               nullptr,
+                                               SOCK_NONBLOCK | SOCK_CLOEXEC)) >=
+                       0)
+                {
+                    export_client client;
+                    client.json = export_json(collector);
+                    client.deadline = std::chrono::steady_clock::now() +
+                                      std::chrono::seconds(1);
+                    if (!send_export(connection, client))
+                    {
+                        ::close(connection);
+                        continue;
+                    }
+                    epoll_event event{};
+                    event.events = EPOLLOUT;
+                    event.data.fd = connection;
+                    ::epoll_ctl(epoll, EPOLL_CTL_ADD, connection, &event);
+                    export_clients[connection] = std::move(client);
+                }
+                continue;
+            }
+            auto client = export_clients.find(fd);
+            if (client != export_clients.end())
+            {
+                if (!send_export(fd, client->second))
+                {
+                    close_export(fd);
+                }
+                continue;
+            }
+
+            const std::size_t producer = producers.at(fd);
+            for (int read = 0; read < reads_per_event; ++read)
+            {
+                auto result = ::read(fd, buffer.data(), buffer.size());
+                if (result < 0 && (errno == EAGAIN || errno == EINTR))
+                {
+                    break;
+                }
+                if (result <= 0)
+                {
+                    disconnect(fd);
+                    break;
+                }
+                bytes += static_cast<uint64_t>(result);
+                if (!collector.receive(producer, buffer.data(),
+                                       static_cast<std::size_t>(result)))
+                {
+                    std::fprintf(stderr, "Invalid stream, disconnecting\n");
+                    disconnect(fd);
+                    break;
+                }
+            }
+        }
+
+        // Clients which do not read the export in time are closed
+        auto now = std::chrono::steady_clock::now();
+        for (auto it = export_clients.begin(); it != export_clients.end();)
+        {
+            const int fd = it->first;
+            const bool expired = it->second.deadline <= now;
+            ++it;
+            if (expired)
+            {
+                close_export(fd);
+            }
+        }
+
+        if (now - last >= std::chrono::seconds(1))
+        {
+            const double seconds =
+                std::chrono::duration<double>(now - last).count();
+            std::printf("producers %zu, frames/s %.0f, MB/s %.1f, "
+                        "unknown frames %llu\n",
+                        collector.producers(),
+                        static_cast<double>(collector.frames() - last_frames) /
+                            seconds,
+                        static_cast<double>(bytes - last_bytes) / seconds / 1e6,
+                        static_cast<unsigned long long>(
+                            collector.unknown_frames()));
+            std::fflush(stdout);
+            last = now;
+            last_frames = collector.frames();
+            last_bytes = bytes;
+        }
+    }
+
+    for (const auto& [fd, producer] : producers)
+    {
+        ::close(fd);
+    }
+    for (const auto& [fd, client] : export_clients)
+    {
+        ::close(fd);
+    }
+    ::close(listener);
+    ::close(export_listener);
+    ::close(epoll);
+    ::unlink(path.c_str());
+    ::unlink(export_path.c_str());
+    return EXIT_SUCCESS;
+}
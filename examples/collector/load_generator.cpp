@@ -0,0 +1,208 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <abacus/framer.hpp>
+#include <abacus/metrics.hpp>
+
+// A load generator for the collector daemon. Every producer has its own
+// metrics and connection, sends one frame with the meta data and then value
+// frames as fast as the collector reads them. The producers are shared by a
+// number of threads.
+//
+// Usage: abacus_load_generator <socket> [producers] [metrics] [seconds]
+//                              [threads]
+
+namespace
+{
+struct producer
+{
+    std::unique_ptr<abacus::metrics> metrics;
+    abacus::metric<abacus::uint64> frames;
+    abacus::framer framer;
+    int fd = -1;
+};
+
+int connect_unix(const std::string& path)
+{
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&address),
+                             sizeof(address)) != 0)
+    {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Sends the current frame of a producer with writev, straight from the
+// memory of the metrics
+bool send_frame(producer& p)
+{
+    iovec iovecs[abacus::framer::max_spans];
+    std::size_t count = p.framer.to_iovecs(iovecs);
+    iovec* next = iovecs;
+    while (count > 0)
+    {
+        auto result = ::writev(p.fd, next, static_cast<int>(count));
+        if (result <= 0)
+        {
+            return false;
+        }
+        // Skip the sent spans after a partial write
+        auto sent = static_cast<std::size_t>(result);
+        while (count > 0 && sent >= next->iov_len)
+        {
+            sent -= next->iov_len;
+            ++next;
+            --count;
+        }
+        if (count > 0)
+        {
+            next->iov_base = static_cast<uint8_t*>(next->iov_base) + sent;
+            next->iov_len -= sent;
+        }
+    }
+    return true;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr,
+                     "Usage: %s <socket> [producers] [metrics] [seconds] "
+                     "[threads]\n",
+                     argv[0]);
+        return EXIT_FAILURE;
+    }
+    const std::string path = argv[1];
+    const std::size_t producers = argc > 2 ? std::strtoul(argv[2], 0, 10) : 100;
+    const std::size_t metrics = argc > 3 ? std::strtoul(argv[3], 0, 10) : 100;
+    const auto seconds = argc > 4 ? std::strtoul(argv[4], 0, 10) : 10;
+    const std::size_t threads = argc > 5 ? std::strtoul(argv[5], 0, 10) : 4;
+    if (producers == 0 || metrics == 0 || threads == 0)
+    {
+        std::fprintf(stderr, "The counts must be positive\n");
+        return EXIT_FAILURE;
+    }
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // All producers have the same meta data, so they share a sync value
+    std::map<abacus::name, abacus::info> infos;
+    infos.emplace(abacus::name{"frames"},
+                  abacus::uint64{abacus::kind::counter,
+                                 abacus::description{"Frames sent"}});
+    for (std::size_t i = 0; i < metrics; ++i)
+    {
+        infos.emplace(abacus::name{"metric." + std::to_string(i)},
+                      abacus::uint64{abacus::kind::counter,
+                                     abacus::description{"A counter"}});
+    }
+
+    std::vector<producer> all(producers);
+    for (auto& p : all)
+    {
+        p.metrics = std::make_unique<abacus::metrics>(infos);
+        p.frames = p.metrics->initialize<abacus::uint64>("frames");
+        p.frames = 0;
+        for (std::size_t i = 0; i < metrics; ++i)
+        {
+            p.metrics->initialize<abacus::uint64>("metric." + std::to_string(i))
+                .set_value(i);
+        }
+        p.fd = connect_unix(path);
+        if (p.fd < 0)
+        {
+            std::perror(path.c_str());
+            return EXIT_FAILURE;
+        }
+        p.framer.frame(*p.metrics, true);
+        if (!send_frame(p))
+        {
+            std::perror("writev");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Every thread sends the frames of its share of the producers in turn
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> bytes{0};
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back(
+            [&, t]
+            {
+                uint64_t sent_frames = 0;
+                uint64_t sent_bytes = 0;
+                while (running.load(std::memory_order_relaxed))
+                {
+                    for (std::size_t i = t; i < all.size(); i += threads)
+                    {
+                        auto& p = all[i];
+                        ++p.frames;
+                        p.framer.frame(*p.metrics, false);
+                        if (!send_frame(p))
+                        {
+                            running = false;
+                            break;
+                        }
+                        ++sent_frames;
+                        sent_bytes += p.framer.bytes();
+                    }
+                }
+                frames += sent_frames;
+                bytes += sent_bytes;
+            });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    running = false;
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    const double elapsed = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+    for (auto& p : all)
+    {
+        ::close(p.fd);
+    }
+
+    std::printf("producers %zu, frames %llu, frames/s %.0f, MB/s %.1f\n",
+                all.size(), static_cast<unsigned long long>(frames.load()),
+                static_cast<double>(frames.load()) / elapsed,
+                static_cast<double>(bytes.load()) / elapsed / 1e6);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,36 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "protobuf/metrics.pb.h"
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// The operator used to combine the values of a metric from several value
+/// buffers. Only the buffers where the metric has a value are combined.
+///
+/// The operator can be declared per metric in the info of the metric, it is
+/// then part of the meta data and used by abacus::aggregator.
+enum class aggregation
+{
+    /// The sum of the values
+    sum = abacus::protobuf::SUM,
+    /// The smallest value
+    min = abacus::protobuf::MINIMUM,
+    /// The largest value
+    max = abacus::protobuf::MAXIMUM,
+    /// The average value, integer metrics use integer division
+    avg = abacus::protobuf::AVERAGE,
+    /// The logical or of boolean values
+    any = abacus::protobuf::ANY,
+    /// The logical and of boolean values
+    all = abacus::protobuf::ALL
+};
+}
+}
@@ -0,0 +1,512 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "aggregator.hpp"
+
+#include "detail/saturate.hpp"
+#include "detail/value_bytes.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <map>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <endian/is_big_endian.hpp>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace
+{
+template <class T>
+static inline T identity(aggregation op)
+{
+    switch (op)
+    {
+    case aggregation::min:
+        return std::numeric_limits<T>::max();
+    case aggregation::max:
+        return std::numeric_limits<T>::lowest();
+    case aggregation::all:
+        return T(1);
+    default:
+        return T(0);
+    }
+}
+
+// Calls a function with a value of the type of the metrics of a group and a
+// value of the type they are accumulated in. Narrow types are accumulated in
+// 64 bits or double, so sums of many values do not overflow.
+template <class Function>
+static inline void visit_types(protobuf::Metric::TypeCase type,
+                               Function function)
+{
+    switch (type)
+    {
+    case protobuf::Metric::kUint64:
+        function(uint64_t{}, uint64_t{});
+        break;
+    case protobuf::Metric::kInt64:
+        function(int64_t{}, int64_t{});
+        break;
+    case protobuf::Metric::kUint32:
+        function(uint32_t{}, uint64_t{});
+        break;
+    case protobuf::Metric::kInt32:
+        function(int32_t{}, int64_t{});
+        break;
+    case protobuf::Metric::kFloat64:
+        function(double{}, double{});
+        break;
+    case protobuf::Metric::kFloat32:
+        function(float{}, double{});
+        break;
+    default:
+        function(uint8_t{}, uint8_t{});
+        break;
+    }
+}
+
+// Combines the values of one value buffer into the accumulators. The loops
+// are branchless, a value which is not set is replaced by the identity of
+// the operator. Integer sums saturate at the limits of the accumulator.
+template <class T, class A>
+static inline void combine(aggregation op,
+                           const std::vector<std::size_t>& offsets,
+                           const uint8_t* data, A* values, uint32_t* counts)
+{
+    const std::size_t size = offsets.size();
+    const std::size_t* offset = offsets.data();
+    const A zero = static_cast<A>(identity<T>(op));
+    switch (op)
+    {
+    case aggregation::sum:
+    case aggregation::avg:
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const uint8_t* slot = data + offset[i];
+            T value;
+            std::memcpy(&value, slot + 1, sizeof(T));
+            bool overflow;
+            values[i] = detail::saturating_add(
+                values[i], slot[0] ? static_cast<A>(value) : zero, overflow);
+            counts[i] += slot[0];
+        }
+        break;
+    case aggregation::min:
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const uint8_t* slot = data + offset[i];
+            T value;
+            std::memcpy(&value, slot + 1, sizeof(T));
+            values[i] =
+                std::min(values[i], slot[0] ? static_cast<A>(value) : zero);
+            counts[i] += slot[0];
+        }
+        break;
+    case aggregation::max:
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const uint8_t* slot = data + offset[i];
+            T value;
+            std::memcpy(&value, slot + 1, sizeof(T));
+            values[i] =
+                std::max(values[i], slot[0] ? static_cast<A>(value) : zero);
+            counts[i] += slot[0];
+        }
+        break;
+    case aggregation::any:
+        if constexpr (std::is_same_v<T, uint8_t>)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                const uint8_t* slot = data + offset[i];
+                values[i] |= slot[0] & slot[1];
+                counts[i] += slot[0];
+            }
+        }
+        break;
+    case aggregation::all:
+        if constexpr (std::is_same_v<T, uint8_t>)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                const uint8_t* slot = data + offset[i];
+                values[i] &= (slot[0] ^ 1) | slot[1];
+                counts[i] += slot[0];
+            }
+        }
+        break;
+    }
+}
+
+// Combines two partial aggregates of the same group
+template <class A>
+static inline void merge(aggregation op, A* values, uint32_t* counts,
+                         const A* other_values, const uint32_t* other_counts,
+                         std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        switch (op)
+        {
+        case aggregation::sum:
+        case aggregation::avg:
+        {
+            bool overflow;
+            values[i] =
+                detail::saturating_add(values[i], other_values[i], overflow);
+            break;
+        }
+        case aggregation::min:
+            values[i] = std::min(values[i], other_values[i]);
+            break;
+        case aggregation::max:
+            values[i] = std::max(values[i], other_values[i]);
+            break;
+        case aggregation::any:
+            if constexpr (std::is_same_v<A, uint8_t>)
+            {
+                values[i] |= other_values[i];
+            }
+            break;
+        case aggregation::all:
+            if constexpr (std::is_same_v<A, uint8_t>)
+            {
+                values[i] &= other_values[i];
+            }
+            break;
+        }
+        counts[i] += other_counts[i];
+    }
+}
+
+// The aggregation declared for a metric if it is one of the valid operators
+// for the value type of the metric
+template <class Metric>
+static inline std::optional<aggregation>
+declared(const Metric& metric, std::initializer_list<aggregation> valid)
+{
+    if (!metric.has_aggregation())
+    {
+        return std::nullopt;
+    }
+    auto op = static_cast<aggregation>(metric.aggregation());
+    if (std::find(valid.begin(), valid.end(), op) == valid.end())
+    {
+        return std::nullopt;
+    }
+    return op;
+}
+}
+
+aggregator::aggregator(const protobuf::MetricsMetadata& metadata,
+                       aggregation gauge, aggregation boolean) :
+    m_sync_value(metadata.sync_value()), m_endianness(metadata.endianness()),
+    m_value_bytes(sizeof(uint32_t))
+{
+    assert(gauge == aggregation::sum || gauge == aggregation::min ||
+           gauge == aggregation::max || gauge == aggregation::avg);
+    assert(boolean == aggregation::any || boolean == aggregation::all);
+
+    // Numbers use the declared aggregation, otherwise counters are summed
+    // and gauges use the gauge aggregation
+    auto number = [gauge](const auto& metric)
+    {
+        auto op = declared(metric, {aggregation::sum, aggregation::min,
+                                    aggregation::max, aggregation::avg});
+        if (op.has_value())
+        {
+            return op.value();
+        }
+        return metric.kind() == protobuf::COUNTER ? aggregation::sum : gauge;
+    };
+
+    // Group the metrics by type and operator, the map keeps the groups in a
+    // deterministic order
+    std::map<std::pair<protobuf::Metric::TypeCase, aggregation>,
+             std::vector<std::size_t>>
+        groups;
+    for (const auto& [name, metric] : metadata.metrics())
+    {
+        std::size_t offset = 0;
+        switch (metric.type_case())
+        {
+        case protobuf::Metric::kUint64:
+            offset = metric.uint64().offset();
+            groups[{metric.type_case(), number(metric.uint64())}].push_back(
+                offset);
+            break;
+        case protobuf::Metric::kInt64:
+            offset = metric.int64().offset();
+            groups[{metric.type_case(), number(metric.int64())}].push_back(
+                offset);
+            break;
+        case protobuf::Metric::kUint32:
+            offset = metric.uint32().offset();
+            groups[{metric.type_case(), number(metric.uint32())}].push_back(
+                offset);
+            break;
+        case protobuf::Metric::kInt32:
+            offset = metric.int32().offset();
+            groups[{metric.type_case(), number(metric.int32())}].push_back(
+                offset);
+            break;
+        case protobuf::Metric::kFloat64:
+            offset = metric.float64().offset();
+            groups[{metric.type_case(), number(metric.float64())}].push_back(
+                offset);
+            break;
+        case protobuf::Metric::kFloat32:
+            offset = metric.float32().offset();
+            groups[{metric.type_case(), number(metric.float32())}].push_back(
+                offset);
+            break;
+        case protobuf::Metric::kBoolean:
+            offset = metric.boolean().offset();
+            groups[{metric.type_case(),
+                    declared(metric.boolean(),
+                             {aggregation::any, aggregation::all})
+                        .value_or(boolean)}]
+                .push_back(offset);
+            break;
+        case protobuf::Metric::kEnum8:
+        {
+            // Enums are only aggregated if they declare min or max, but they
+            // are always part of the buffer
+            offset = metric.enum8().offset();
+            auto op = declared(metric.enum8(),
+                               {aggregation::min, aggregation::max});
+            if (op.has_value())
+            {
+                groups[{metric.type_case(), op.value()}].push_back(offset);
+            }
+            break;
+        }
+        default:
+            // Constants have no value
+            continue;
+        }
+        m_value_bytes =
+            std::max(m_value_bytes,
+                     offset + 1 + detail::value_size(metric.type_case()));
+    }
+
+    for (auto& [key, offsets] : groups)
+    {
+        // Visit the value buffer in memory order
+        std::sort(offsets.begin(), offsets.end());
+        m_groups.push_back({key.first, key.second, std::move(offsets)});
+    }
+}
+
+auto aggregator::value_bytes() const -> std::size_t
+{
+    return m_value_bytes;
+}
+
+auto aggregator::aggregate_views(const std::vector<const view*>& views,
+                                 uint8_t* data, std::size_t threads) const
+    -> bool
+{
+    std::vector<const uint8_t*> value_data;
+    value_data.reserve(views.size());
+    for (auto view : views)
+    {
+        assert(view != nullptr);
+        if (view->value_data() == nullptr ||
+            view->value_bytes() < m_value_bytes)
+        {
+            return false;
+        }
+        value_data.push_back(view->value_data());
+    }
+    return aggregate(value_data, data, threads);
+}
+
+auto aggregator::make_accumulators() const -> std::vector<accumulator>
+{
+    std::vector<accumulator> accumulators(m_groups.size());
+    for (std::size_t i = 0; i < m_groups.size(); ++i)
+    {
+        const auto& group = m_groups[i];
+        auto& acc = accumulators[i];
+        const auto size = group.offsets.size();
+        visit_types(group.type,
+                    [&](auto value, auto sum)
+                    {
+                        using T = decltype(value);
+                        using A = decltype(sum);
+                        acc.values = std::vector<A>(
+                            size, static_cast<A>(identity<T>(group.op)));
+                    });
+        acc.counts.resize(size, 0);
+    }
+    return accumulators;
+}
+
+auto aggregator::accumulate(const uint8_t* const* first,
+                            const uint8_t* const* last,
+                            std::vector<accumulator>& accumulators) const
+    -> void
+{
+    for (std::size_t i = 0; i < m_groups.size(); ++i)
+    {
+        const auto& group = m_groups[i];
+        auto& acc = accumulators[i];
+        visit_types(group.type,
+                    [&](auto value, auto sum)
+                    {
+                        using T = decltype(value);
+                        using A = decltype(sum);
+                        auto& values = std::get<std::vector<A>>(acc.values);
+
+                        // Process one group over all buffers at a time to
+                        // keep the accumulators in cache
+                        for (auto data = first; data != last; ++data)
+                        {
+                            combine<T>(group.op, group.offsets, *data,
+                                       values.data(), acc.counts.data());
+                        }
+                    });
+    }
+}
+
+auto aggregator::aggregate(const std::vector<const uint8_t*>& value_data,
+                           uint8_t* data, std::size_t threads) const -> bool
+{
+    assert(data != nullptr);
+    assert(threads > 0);
+
+    // The values are combined in the byte order of the host
+    auto host = endian::is_big_endian() ? protobuf::Endianness::BIG
+                                        : protobuf::Endianness::LITTLE;
+    if (m_endianness != host)
+    {
+        return false;
+    }
+    for (auto buffer : value_data)
+    {
+        assert(buffer != nullptr);
+        uint32_t sync_value;
+        std::memcpy(&sync_value, buffer, sizeof(sync_value));
+        if (sync_value != m_sync_value)
+        {
+            return false;
+        }
+    }
+
+    auto accumulators = make_accumulators();
+    const auto* first = value_data.data();
+    const auto* last = first + value_data.size();
+
+    threads = std::min(threads, value_data.size());
+    if (threads <= 1)
+    {
+        accumulate(first, last, accumulators);
+    }
+    else
+    {
+        // Every thread aggregates a contiguous share of the buffers, the
+        // partial results are merged afterwards. The partial accumulators
+        // are allocated before any thread is started.
+        std::vector<std::vector<accumulator>> partials(threads - 1);
+        for (auto& partial : partials)
+        {
+            partial = make_accumulators();
+        }
+
+        // The started threads are joined if starting another one throws
+        struct joiner
+        {
+            ~joiner()
+            {
+                for (auto& worker : workers)
+                {
+                    if (worker.joinable())
+                    {
+                        worker.join();
+                    }
+                }
+            }
+            std::vector<std::thread> workers;
+        } pool;
+        pool.workers.reserve(threads - 1);
+        const std::size_t share = value_data.size() / threads;
+        for (std::size_t t = 0; t + 1 < threads; ++t)
+        {
+            pool.workers.emplace_back(
+                [this, &partials, t, begin = first + t * share,
+                 end = first + (t + 1) * share]
+                { accumulate(begin, end, partials[t]); });
+        }
+        accumulate(first + (threads - 1) * share, last, accumulators);
+
+        for (std::size_t t = 0; t < pool.workers.size(); ++t)
+        {
+            pool.workers[t].join();
+            for (std::size_t i = 0; i < m_groups.size(); ++i)
+            {
+                auto& acc = accumulators[i];
+                const auto& other = partials[t][i];
+                std::visit(
+                    [&](auto& values)
+                    {
+                        using vector = std::decay_t<decltype(values)>;
+                        merge(m_groups[i].op, values.data(),
+                              acc.counts.data(),
+                              std::get<vector>(other.values).data(),
+                              other.counts.data(), values.size());
+                    },
+                    acc.values);
+            }
+        }
+    }
+
+    // Write the result, metrics which are not aggregated are left unset.
+    // Integer results saturate at the limits of the value type.
+    std::memset(data, 0, m_value_bytes);
+    std::memcpy(data, &m_sync_value, sizeof(m_sync_value));
+    for (std::size_t i = 0; i < m_groups.size(); ++i)
+    {
+        const auto& group = m_groups[i];
+        const auto& acc = accumulators[i];
+        visit_types(group.type,
+                    [&](auto type, auto sum)
+                    {
+                        using T = decltype(type);
+                        using A = decltype(sum);
+                        const auto& values =
+                            std::get<std::vector<A>>(acc.values);
+                        for (std::size_t j = 0; j < values.size(); ++j)
+                        {
+                            const auto count = acc.counts[j];
+                            if (count == 0)
+                            {
+                                continue;
+                            }
+                            A result = values[j];
+                            if (group.op == aggregation::avg)
+                            {
+                                result = result / static_cast<A>(count);
+                            }
+                            T value = detail::narrow<T>(result);
+                            uint8_t* slot = data + group.offsets[j];
+                            slot[0] = 1;
+                            std::memcpy(slot + 1, &value, sizeof(value));
+                        }
+                    });
+    }
+    return true;
+}
+}
+}
@@ -0,0 +1,138 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+#include "aggregation.hpp"
+#include "protobuf/metrics.pb.h"
+#include "version.hpp"
+#include "view.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// Aggregates many value buffers of the same schema into one value buffer,
+/// e.g. to compute the totals of the metrics of thousands of connections.
+///
+/// A metric is combined with the aggregation declared for it in the meta
+/// data. Otherwise counters are summed, gauges are combined with the gauge
+/// aggregation and booleans with the boolean aggregation, while enum metrics
+/// have no meaningful aggregate and are left unset. A metric is set in the
+/// output if it is set in at least one of the inputs.
+///
+/// The output has the layout and sync value of the inputs, so it can be read
+/// with an abacus::view using the same meta data, and it can be aggregated
+/// again. This allows merging a hierarchy, e.g. devices into racks and racks
+/// into a site, with one pass per level and no configuration besides the
+/// meta data. Note that an average at a higher level is the average of the
+/// averages of the level below, not weighted by the number of values.
+///
+/// Sums and averages of 32-bit metrics are accumulated in 64 bits and those
+/// of floats in double. Integer sums saturate at the limits of the 64-bit
+/// accumulator and the result saturates at the limits of the value type of
+/// the metric, so summing many connections never wraps around.
+///
+/// The metrics are grouped by value type and operator when the aggregator is
+/// constructed, so every group is processed by a branchless loop over a
+/// homogeneous array of accumulators which the compiler can vectorize.
+class aggregator
+{
+public:
+    /// Constructor
+    /// @param metadata The meta data of the value buffers
+    /// @param gauge The aggregation used for gauges which do not declare
+    ///        one, one of sum, min, max or avg
+    /// @param boolean The aggregation used for booleans which do not declare
+    ///        one, either any or all
+    aggregator(const protobuf::MetricsMetadata& metadata,
+               aggregation gauge = aggregation::sum,
+               aggregation boolean = aggregation::any);
+
+    /// @return The size of the value buffers in bytes
+    auto value_bytes() const -> std::size_t;
+
+    /// Aggregates value buffers
+    /// @param value_data The value buffers to aggregate, each must be
+    ///        value_bytes() large
+    /// @param data The output buffer, must be value_bytes() large
+    /// @param threads The number of threads to split the value buffers
+    ///        between, useful for a very large number of buffers. The
+    ///        threads are started for the call and joined before it
+    ///        returns, so splitting only pays off when the buffers take
+    ///        much longer to combine than starting a thread.
+    /// @return true if all the value buffers have the sync value of the meta
+    ///         data and the endianness of the host, otherwise false
+    [[nodiscard]] auto aggregate(const std::vector<const uint8_t*>& value_data,
+                                 uint8_t* data, std::size_t threads = 1) const
+        -> bool;
+
+    /// Aggregates the value data of views
+    /// @param views The views to aggregate, each must have the meta data of
+    ///        the aggregator and value data set
+    /// @param data The output buffer, must be value_bytes() large
+    /// @param threads The number of threads to split the views between
+    /// @return true if the value data of all the views could be aggregated,
+    ///         otherwise false
+    [[nodiscard]] auto aggregate_views(const std::vector<const view*>& views,
+                                       uint8_t* data,
+                                       std::size_t threads = 1) const -> bool;
+
+private:
+    /// The metrics of one value type combined with the same operator
+    struct group
+    {
+        /// The value type of the metrics
+        protobuf::Metric::TypeCase type;
+
+        /// The operator
+        aggregation op;
+
+        /// The value offsets of the metrics
+        std::vector<std::size_t> offsets;
+    };
+
+    /// The running aggregate of a group
+    struct accumulator
+    {
+        /// The aggregated values, 32-bit integers are accumulated in 64 bits
+        /// and floats in double. Integer sums saturate.
+        std::variant<std::vector<uint64_t>, std::vector<int64_t>,
+                     std::vector<double>, std::vector<uint8_t>>
+            values;
+
+        /// The number of buffers with a value for each metric
+        std::vector<uint32_t> counts;
+    };
+
+    /// @return The accumulators of the groups set to the identity values
+    auto make_accumulators() const -> std::vector<accumulator>;
+
+    /// Adds value buffers to the accumulators
+    /// @param first The first value buffer
+    /// @param last The end of the value buffers
+    /// @param accumulators The accumulators of the groups
+    auto accumulate(const uint8_t* const* first, const uint8_t* const* last,
+                    std::vector<accumulator>& accumulators) const -> void;
+
+private:
+    /// The sync value of the value buffers
+    uint32_t m_sync_value;
+
+    /// The endianness of the value buffers
+    protobuf::Endianness m_endianness;
+
+    /// The size of the value buffers in bytes
+    std::size_t m_value_bytes;
+
+    /// The groups of metrics
+    std::vector<group> m_groups;
+};
+}
+}
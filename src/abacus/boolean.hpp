@@ -8,8 +8,10 @@
 #include <cassert>
 #include <cstdint>
 #include <cstring>
+#include <optional>
 #include <string>
 
+#include "aggregation.hpp"
 #include "description.hpp"
 #include "kind.hpp"
 
@@ -28,6 +30,10 @@ struct boolean
 
     /// The description of the metric
     abacus::description description;
+
+    /// The aggregation of the metric, either any or all. If not set the
+    /// aggregator default is used.
+    std::optional<abacus::aggregation> aggregation{};
 };
 }
 }
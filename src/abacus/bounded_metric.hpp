@@ -0,0 +1,219 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+#include "detail/saturate.hpp"
+#include "max.hpp"
+#include "metric.hpp"
+#include "min.hpp"
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// A metric handle which enforces the min and max value of the metric.
+///
+/// Every write is clamped to [min, max] without branching, so readers of the
+/// value data never see a value outside the bounds. Integer arithmetic
+/// saturates at the limits of the type before it is clamped, so an overflow
+/// cannot wrap around into the bounds. Every write which had to be clamped
+/// or saturated is counted as a violation.
+///
+/// The violation count is kept in the handle, so copies of the handle count
+/// independently.
+template <class Metric>
+class bounded_metric
+{
+public:
+    /// The type used to store the value
+    using value_type = typename Metric::type;
+
+    static_assert(std::is_arithmetic_v<value_type> &&
+                      !std::is_same_v<value_type, bool> &&
+                      sizeof(value_type) >= 4,
+                  "Only integer and floating point metrics can be bounded");
+
+public:
+    /// Default constructor
+    bounded_metric() = default;
+
+    /// Constructor
+    /// @param metric The initialized metric to write to
+    /// @param min The minimum value, if not set the lowest value of the type
+    /// @param max The maximum value, if not set the highest value of the type
+    bounded_metric(abacus::metric<Metric> metric, abacus::min<value_type> min,
+                   abacus::max<value_type> max) :
+        m_metric(metric),
+        m_min(min.value.value_or(std::numeric_limits<value_type>::lowest())),
+        m_max(max.value.value_or(std::numeric_limits<value_type>::max()))
+    {
+        assert(m_metric.is_initialized());
+        assert(m_min <= m_max && "The min value must not exceed the max");
+    }
+
+    /// Check if the metric is initialized
+    /// @return true if the metric is initialized
+    auto is_initialized() const -> bool
+    {
+        return m_metric.is_initialized();
+    }
+
+    /// Check if the metric has a value
+    /// @return true if the metric has a value
+    auto has_value() const -> bool
+    {
+        return m_metric.has_value();
+    }
+
+    /// Get the value of the metric
+    /// @return The value of the metric
+    auto value() const -> value_type
+    {
+        return m_metric.value();
+    }
+
+    /// Assign a new value to the metric, the value is clamped to the bounds
+    /// @param value The value to assign
+    auto set_value(value_type value) -> bounded_metric&
+    {
+        write(value, false);
+        return *this;
+    }
+
+    /// Assign an optional value to the metric
+    /// @param value The value to assign, if the value is not set the metric
+    ///        will be reset.
+    auto set_value(std::optional<value_type> value) -> bounded_metric&
+    {
+        if (value)
+        {
+            return set_value(*value);
+        }
+        reset();
+        return *this;
+    }
+
+    /// Assign the metric a new value
+    /// @param value The value to assign
+    /// @return the metric with the new value
+    auto operator=(value_type value) -> bounded_metric&
+    {
+        return set_value(value);
+    }
+
+    /// Assign the metric a new optional value
+    /// @param value The value to assign if the value is not set the metric
+    ///        will be reset.
+    auto operator=(std::optional<value_type> value) -> bounded_metric&
+    {
+        return set_value(value);
+    }
+
+    /// Reset the metric. This will cause the metric to not have a value
+    auto reset() -> void
+    {
+        m_metric.reset();
+    }
+
+    /// @return The minimum value
+    auto min() const -> value_type
+    {
+        return m_min;
+    }
+
+    /// @return The maximum value
+    auto max() const -> value_type
+    {
+        return m_max;
+    }
+
+    /// @return The number of writes which were clamped or saturated
+    auto violations() const -> uint64_t
+    {
+        return m_violations;
+    }
+
+    /// Reset the violation count
+    auto reset_violations() -> void
+    {
+        m_violations = 0;
+    }
+
+public:
+    /// Arithmetic operators
+
+    /// Increment the metric
+    /// @param increment The value to add
+    /// @return The result of the arithmetic
+    auto operator+=(value_type increment) -> bounded_metric&
+    {
+        bool overflow;
+        value_type sum = detail::saturating_add(value(), increment, overflow);
+        write(sum, overflow);
+        return *this;
+    }
+
+    /// Decrement the metric
+    /// @param decrement The value to subtract
+    /// @return The result of the arithmetic
+    auto operator-=(value_type decrement) -> bounded_metric&
+    {
+        bool overflow;
+        value_type diff = detail::saturating_sub(value(), decrement, overflow);
+        write(diff, overflow);
+        return *this;
+    }
+
+    /// Increment the value of the metric
+    /// @return The result of the arithmetic
+    auto operator++() -> bounded_metric&
+    {
+        return *this += 1;
+    }
+
+    /// Decrement the value of the metric
+    /// @return The result of the arithmetic
+    auto operator--() -> bounded_metric&
+    {
+        return *this -= 1;
+    }
+
+private:
+    /// Clamps and writes a value
+    /// @param value The value to write
+    /// @param overflow true if the value was already saturated
+    auto write(value_type value, bool overflow) -> void
+    {
+        // std::min and std::max compile to conditional moves or min/max
+        // instructions, so the clamp does not branch
+        value_type clamped = std::min(std::max(value, m_min), m_max);
+        m_violations += static_cast<uint64_t>(overflow | (clamped != value));
+        m_metric.set_value(clamped);
+    }
+
+private:
+    /// The metric
+    abacus::metric<Metric> m_metric;
+
+    /// The minimum value
+    value_type m_min{};
+
+    /// The maximum value
+    value_type m_max{};
+
+    /// The number of clamped or saturated writes
+    uint64_t m_violations = 0;
+};
+}
+}
@@ -0,0 +1,230 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <type_traits>
+
+#include "float64.hpp"
+#include "int64.hpp"
+#include "metric.hpp"
+#include "uint64.hpp"
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// A counter which is incremented from many threads through thread-local
+/// accumulators, for counters which are too hot for a shared atomic.
+///
+/// Every thread increments its own local(), which only touches memory owned
+/// by that thread. The sum of all accumulators is written to the metric by
+/// flush(), which is called by a local when it has been incremented
+/// flush_threshold times, by local::flush(), and when a local is destroyed,
+/// e.g. on thread exit for a thread_local accumulator. To export the latest
+/// sum, add flush() to abacus::exporter with exporter::add_flush(), which
+/// calls it before every snapshot.
+///
+/// Like abacus::metrics the value data is not synchronized, so flush() must
+/// not run concurrently with readers of the value data. The locals may be
+/// incremented concurrently with flush().
+template <class Metric>
+class buffered_counter
+{
+    static_assert(std::is_same_v<Metric, uint64> ||
+                      std::is_same_v<Metric, int64> ||
+                      std::is_same_v<Metric, float64>,
+                  "Only uint64, int64 and float64 counters can be buffered");
+
+public:
+    /// The type used to store the value
+    using value_type = typename Metric::type;
+
+private:
+    /// The accumulated increments of one thread. Each slot has its own
+    /// cache line, so the threads do not contend.
+    struct alignas(64) slot
+    {
+        /// The sum of the increments, only written by the owning thread
+        std::atomic<value_type> total{0};
+    };
+
+public:
+    /// The accumulator of one thread
+    class local
+    {
+    public:
+        /// Move constructor
+        /// @param other The accumulator to move from
+        local(local&& other) noexcept :
+            m_counter(other.m_counter), m_slot(other.m_slot),
+            m_increments(other.m_increments)
+        {
+            other.m_counter = nullptr;
+            other.m_slot = nullptr;
+        }
+
+        /// Destructor, the increments are flushed to the metric
+        ~local()
+        {
+            if (m_counter != nullptr)
+            {
+                m_counter->release(m_slot);
+            }
+        }
+
+        /// Increment the counter
+        /// @param increment The value to add
+        /// @return The accumulator
+        auto operator+=(value_type increment) -> local&
+        {
+            assert(m_slot != nullptr);
+
+            // Only this thread writes the total, so a plain load and store
+            // is enough and no atomic read-modify-write is needed
+            value_type total = m_slot->total.load(std::memory_order_relaxed);
+            m_slot->total.store(total + increment, std::memory_order_relaxed);
+
+            if (++m_increments == m_counter->m_flush_threshold)
+            {
+                flush();
+            }
+            return *this;
+        }
+
+        /// Increment the counter by one
+        /// @return The accumulator
+        auto operator++() -> local&
+        {
+            return *this += 1;
+        }
+
+        /// Flush the counter to the metric
+        auto flush() -> void
+        {
+            assert(m_counter != nullptr);
+            m_increments = 0;
+            m_counter->flush();
+        }
+
+    private:
+        friend class buffered_counter;
+
+        local(buffered_counter* counter, slot* slot) :
+            m_counter(counter), m_slot(slot)
+        {
+        }
+
+        /// No copy
+        local(const local&) = delete;
+
+        /// No copy assignment
+        local& operator=(const local&) = delete;
+
+    private:
+        /// The counter of the accumulator
+        buffered_counter* m_counter;
+
+        /// The slot of the accumulator
+        slot* m_slot;
+
+        /// The number of increments since the last flush
+        std::size_t m_increments = 0;
+    };
+
+public:
+    /// Constructor
+    /// @param metric The initialized metric to write the sum to. The current
+    ///        value of the metric, if any, is the start value.
+    /// @param flush_threshold The number of increments of a local after
+    ///        which it flushes the counter
+    buffered_counter(metric<Metric> metric,
+                     std::size_t flush_threshold = 1024) :
+        m_metric(metric), m_flush_threshold(flush_threshold)
+    {
+        assert(m_metric.is_initialized());
+        assert(m_flush_threshold > 0);
+        m_base = m_metric.has_value() ? m_metric.value() : 0;
+        m_metric = m_base;
+    }
+
+    /// Destructor
+    ~buffered_counter()
+    {
+        assert(m_slots.empty() && "The counter must outlive its locals");
+    }
+
+    /// Creates an accumulator for the calling thread
+    /// @return The accumulator
+    auto make_local() -> local
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_slots.emplace_back();
+        return local(this, &m_slots.back());
+    }
+
+    /// Writes the sum of all accumulators to the metric
+    auto flush() -> void
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        write();
+    }
+
+private:
+    /// No copy
+    buffered_counter(const buffered_counter&) = delete;
+
+    /// No copy assignment
+    buffered_counter& operator=(const buffered_counter&) = delete;
+
+    /// Writes the sum to the metric, the mutex must be locked
+    auto write() -> void
+    {
+        value_type sum = m_base;
+        for (const auto& slot : m_slots)
+        {
+            sum += slot.total.load(std::memory_order_relaxed);
+        }
+        m_metric = sum;
+    }
+
+    /// Folds the total of a slot into the base and removes it
+    auto release(slot* released) -> void
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::find_if(m_slots.begin(), m_slots.end(),
+                               [released](const slot& s)
+                               { return &s == released; });
+        assert(it != m_slots.end());
+        m_base += it->total.load(std::memory_order_relaxed);
+        m_slots.erase(it);
+        write();
+    }
+
+private:
+    /// The metric holding the sum
+    metric<Metric> m_metric;
+
+    /// The number of increments after which a local flushes
+    std::size_t m_flush_threshold;
+
+    /// Protects the slots, the base and the metric
+    std::mutex m_mutex;
+
+    /// The sum of the released accumulators and the start value
+    value_type m_base;
+
+    /// The slots of the live accumulators
+    std::list<slot> m_slots;
+};
+}
+}
@@ -0,0 +1,233 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "bulk_json.hpp"
+
+#include "detail/append_json.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace
+{
+// The number of chunks per thread, more chunks balance uneven views better
+// but are taken more often
+static constexpr std::size_t chunks_per_thread = 8;
+
+static inline auto pack(uint64_t begin, uint64_t end) -> uint64_t
+{
+    return begin << 32 | end;
+}
+}
+
+bulk_json::bulk_json(std::size_t threads, std::size_t buffer_bytes) :
+    m_threads(std::max<std::size_t>(threads, 1)),
+    m_queues(std::make_unique<queue[]>(m_threads)), m_buffers(m_threads)
+{
+    for (auto& buffer : m_buffers)
+    {
+        buffer.reserve(buffer_bytes);
+    }
+    // The calling thread is the first thread of the pool
+    for (std::size_t thread = 1; thread < m_threads; ++thread)
+    {
+        m_workers.emplace_back([this, thread] { run(thread); });
+    }
+}
+
+bulk_json::~bulk_json()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_start.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+auto bulk_json::threads() const -> std::size_t
+{
+    return m_threads;
+}
+
+auto bulk_json::render(const view* const* views, std::size_t count,
+                       format format, bool minimal, std::string& out) -> void
+{
+    assert(views != nullptr || count == 0);
+    out.clear();
+    if (count == 0)
+    {
+        if (format == format::array)
+        {
+            out.append("[]");
+        }
+        return;
+    }
+
+    const std::size_t chunk_size =
+        std::max<std::size_t>(count / (m_threads * chunks_per_thread), 1);
+    const std::size_t chunks = (count + chunk_size - 1) / chunk_size;
+    assert(chunks <= std::numeric_limits<uint32_t>::max());
+    m_pieces.resize(chunks);
+    for (std::size_t thread = 0; thread < m_threads; ++thread)
+    {
+        m_buffers[thread].clear();
+        const std::size_t begin = thread * chunks / m_threads;
+        const std::size_t end = (thread + 1) * chunks / m_threads;
+        m_queues[thread].chunks.store(pack(begin, end),
+                                      std::memory_order_relaxed);
+    }
+    m_views = views;
+    m_count = count;
+    m_chunk_size = chunk_size;
+    m_format = format;
+    m_minimal = minimal;
+
+    if (!m_workers.empty())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = m_workers.size();
+            ++m_generation;
+        }
+        m_start.notify_all();
+    }
+    render_chunks(0);
+    if (!m_workers.empty())
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_running == 0; });
+    }
+
+    // The pieces are concatenated in the order of the views
+    std::size_t bytes = 2 + chunks;
+    for (const auto& piece : m_pieces)
+    {
+        bytes += piece.bytes;
+    }
+    out.reserve(bytes);
+    if (format == format::array)
+    {
+        out.push_back('[');
+    }
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+    {
+        const auto& piece = m_pieces[chunk];
+        if (format == format::array && chunk != 0)
+        {
+            out.push_back(',');
+        }
+        out.append(m_buffers[piece.thread], piece.offset, piece.bytes);
+    }
+    if (format == format::array)
+    {
+        out.push_back(']');
+    }
+}
+
+auto bulk_json::run(std::size_t thread) -> void
+{
+    uint64_t generation = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_start.wait(lock, [this, generation]
+                     { return m_stopping || m_generation != generation; });
+        if (m_stopping)
+        {
+            return;
+        }
+        generation = m_generation;
+        lock.unlock();
+        render_chunks(thread);
+        lock.lock();
+        if (--m_running == 0)
+        {
+            m_done.notify_one();
+        }
+    }
+}
+
+auto bulk_json::render_chunks(std::size_t thread) -> void
+{
+    auto& buffer = m_buffers[thread];
+    auto render_chunk = [&](std::size_t chunk)
+    {
+        const std::size_t offset = buffer.size();
+        const std::size_t first = chunk * m_chunk_size;
+        const std::size_t last = std::min(first + m_chunk_size, m_count);
+        for (std::size_t i = first; i < last; ++i)
+        {
+            if (m_format == format::array && i != first)
+            {
+                buffer.push_back(',');
+            }
+            if (m_views[i] == nullptr)
+            {
+                buffer.append("null");
+            }
+            else
+            {
+                detail::append_json(*m_views[i], m_minimal, buffer);
+            }
+            if (m_format == format::ndjson)
+            {
+                buffer.push_back('\n');
+            }
+        }
+        m_pieces[chunk] = {thread, offset, buffer.size() - offset};
+    };
+
+    // The own chunks are taken from the front, and when they run out the
+    // chunks of the other threads are stolen from the back
+    std::size_t chunk;
+    while (take(thread, false, chunk))
+    {
+        render_chunk(chunk);
+    }
+    for (std::size_t i = 1; i < m_threads; ++i)
+    {
+        const std::size_t victim = (thread + i) % m_threads;
+        while (take(victim, true, chunk))
+        {
+            render_chunk(chunk);
+        }
+    }
+}
+
+auto bulk_json::take(std::size_t thread, bool steal, std::size_t& chunk)
+    -> bool
+{
+    auto& chunks = m_queues[thread].chunks;
+    uint64_t bounds = chunks.load(std::memory_order_acquire);
+    while (true)
+    {
+        const uint64_t begin = bounds >> 32;
+        const uint64_t end = bounds & std::numeric_limits<uint32_t>::max();
+        if (begin >= end)
+        {
+            return false;
+        }
+        const uint64_t next =
+            steal ? pack(begin, end - 1) : pack(begin + 1, end);
+        if (chunks.compare_exchange_weak(bounds, next,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire))
+        {
+            chunk = static_cast<std::size_t>(steal ? end - 1 : begin);
+            return true;
+        }
+    }
+}
+}
+}
@@ -0,0 +1,124 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "version.hpp"
+#include "view.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// Renders many views into one JSON document on a pool of threads, e.g. the
+/// views of all devices for an HTTP API.
+///
+/// The views are split into chunks, which are divided evenly between the
+/// threads. Each thread renders its chunks into its own buffer and steals
+/// chunks from the other threads when it runs out, so a few large views do
+/// not leave the other threads idle. The calling thread renders chunks as
+/// well. The rendered chunks are concatenated in the order of the views.
+///
+/// The values of a view are written as the JSON of abacus::to_json() on one
+/// line. The minimal JSON is written directly into the buffers, without
+/// building a JSON document per view. The buffers are kept between calls,
+/// so rendering documents of a similar size does not allocate.
+///
+/// A bulk_json renders one document at a time, render() is not called
+/// concurrently.
+class bulk_json
+{
+public:
+    /// The formats of the rendered document
+    enum class format
+    {
+        /// A JSON array with an element per view
+        array,
+        /// Newline delimited JSON, a line per view
+        ndjson
+    };
+
+public:
+    /// Constructor, starts the threads of the pool
+    /// @param threads The number of threads rendering, including the
+    ///        calling thread
+    /// @param buffer_bytes The initial size of the buffer of each thread
+    bulk_json(std::size_t threads = std::thread::hardware_concurrency(),
+              std::size_t buffer_bytes = 1U << 16);
+
+    /// The threads refer to the bulk_json, so it is not copied
+    bulk_json(const bulk_json&) = delete;
+    bulk_json& operator=(const bulk_json&) = delete;
+
+    /// Destructor, stops the threads of the pool
+    ~bulk_json();
+
+    /// @return The number of threads rendering, including the calling thread
+    auto threads() const -> std::size_t;
+
+    /// Renders views into one document
+    /// @param views The views, a nullptr is rendered as null
+    /// @param count The number of views
+    /// @param format The format of the document
+    /// @param minimal If true, the JSON of a view will be slimmed down to
+    ///        only contain the value data
+    /// @param out The document, replacing the content of the string
+    auto render(const view* const* views, std::size_t count, format format,
+                bool minimal, std::string& out) -> void;
+
+private:
+    // The chunks [begin, end) not yet taken from a thread, packed into one
+    // word so the owner and thieves take chunks with a single CAS
+    struct alignas(64) queue
+    {
+        std::atomic<uint64_t> chunks{0};
+    };
+
+    // A rendered chunk in the buffer of a thread
+    struct piece
+    {
+        std::size_t thread;
+        std::size_t offset;
+        std::size_t bytes;
+    };
+
+    auto run(std::size_t thread) -> void;
+
+    auto render_chunks(std::size_t thread) -> void;
+
+    auto take(std::size_t thread, bool steal, std::size_t& chunk) -> bool;
+
+private:
+    const std::size_t m_threads;
+    std::vector<std::thread> m_workers;
+    std::unique_ptr<queue[]> m_queues;
+    std::vector<std::string> m_buffers;
+    std::vector<piece> m_pieces;
+
+    // The current job
+    const view* const* m_views = nullptr;
+    std::size_t m_count = 0;
+    std::size_t m_chunk_size = 0;
+    format m_format = format::array;
+    bool m_minimal = false;
+
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    uint64_t m_generation = 0;
+    std::size_t m_running = 0;
+    bool m_stopping = false;
+};
+}
+}
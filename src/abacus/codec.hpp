@@ -0,0 +1,36 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// The built-in codecs of abacus::compressor. The value is the id stored in
+/// the first byte of a compressed frame.
+enum class codec : uint8_t
+{
+    /// The data is stored uncompressed. This is also used when a codec does
+    /// not make the data smaller.
+    none = 0,
+    /// Runs of zero bytes are removed. The data is split into 8 byte words,
+    /// and each word is stored as a byte marking its non-zero bytes followed
+    /// by them. Runs of zero words and of words without zeros are stored
+    /// with a count. Value data, where unset metrics and the high bytes of
+    /// small values are zero, typically shrinks to half or less. This is the
+    /// fastest codec.
+    zero_run = 1,
+    /// Repeated byte sequences are replaced by references to an earlier
+    /// occurrence, like LZ4. This also compresses the repeated names and
+    /// strings of the meta data, but is slower than zero_run.
+    lz = 2
+};
+}
+}
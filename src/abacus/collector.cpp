@@ -0,0 +1,265 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "collector.hpp"
+
+#include "framer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <endian/big_endian.hpp>
+#include <endian/little_endian.hpp>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace
+{
+// The size of the length prefix of a frame
+static constexpr std::size_t prefix_bytes = 4;
+
+// Checks the sync value of value data against its meta data, reading it in
+// the byte order of the meta data like abacus::view
+static inline auto matches(const protobuf::MetricsMetadata& metadata,
+                           const uint8_t* value_data) -> bool
+{
+    uint32_t sync_value = 0;
+    if (metadata.endianness() == protobuf::Endianness::BIG)
+    {
+        endian::big_endian::get(sync_value, value_data);
+    }
+    else
+    {
+        endian::little_endian::get(sync_value, value_data);
+    }
+    return sync_value == metadata.sync_value();
+}
+}
+
+collector::collector(std::size_t max_frame_bytes, std::size_t max_metadata) :
+    m_max_frame_bytes(max_frame_bytes), m_max_metadata(max_metadata)
+{
+    assert(m_max_frame_bytes >= framer::header_bytes);
+}
+
+auto collector::add_producer() -> std::size_t
+{
+    std::size_t id;
+    if (m_free.empty())
+    {
+        id = m_producers.size();
+        m_producers.emplace_back();
+    }
+    else
+    {
+        id = m_free.back();
+        m_free.pop_back();
+    }
+    m_producers[id].active = true;
+    return id;
+}
+
+auto collector::remove_producer(std::size_t producer) -> void
+{
+    assert(producer < m_producers.size());
+    assert(m_producers[producer].active);
+    // The buffers are released, as the next producer may send less
+    m_producers[producer] = collector::producer{};
+    m_free.push_back(producer);
+}
+
+auto collector::producers() const -> std::size_t
+{
+    return m_producers.size() - m_free.size();
+}
+
+auto collector::receive(std::size_t id, const uint8_t* data, std::size_t bytes)
+    -> bool
+{
+    assert(id < m_producers.size());
+    assert(data != nullptr || bytes == 0);
+    auto& producer = m_producers[id];
+    assert(producer.active);
+
+    // Complete a frame split by the previous bytes first
+    auto& pending = producer.pending;
+    if (!pending.empty())
+    {
+        if (pending.size() < prefix_bytes)
+        {
+            std::size_t take = std::min(prefix_bytes - pending.size(), bytes);
+            pending.insert(pending.end(), data, data + take);
+            data += take;
+            bytes -= take;
+            if (pending.size() < prefix_bytes)
+            {
+                return true;
+            }
+        }
+        auto size = frame_bytes(pending.data(), pending.size());
+        if (!size.has_value() || size.value() > m_max_frame_bytes)
+        {
+            return false;
+        }
+        std::size_t take = std::min(size.value() - pending.size(), bytes);
+        pending.insert(pending.end(), data, data + take);
+        data += take;
+        bytes -= take;
+        if (pending.size() < size.value())
+        {
+            return true;
+        }
+        if (!process(producer, pending.data(), pending.size()))
+        {
+            return false;
+        }
+        pending.clear();
+    }
+
+    // The complete frames are processed where they were received
+    while (bytes >= prefix_bytes)
+    {
+        auto size = frame_bytes(data, bytes);
+        if (!size.has_value() || size.value() > m_max_frame_bytes)
+        {
+            return false;
+        }
+        if (size.value() > bytes)
+        {
+            break;
+        }
+        if (!process(producer, data, size.value()))
+        {
+            return false;
+        }
+        data += size.value();
+        bytes -= size.value();
+    }
+    pending.assign(data, data + bytes);
+    return true;
+}
+
+auto collector::view(std::size_t producer) const -> const abacus::view*
+{
+    assert(producer < m_producers.size());
+    const auto& p = m_producers[producer];
+    if (!p.has_values)
+    {
+        return nullptr;
+    }
+    auto& view = m_schemas.at(p.sync_value).view;
+    bool valid = view.set_value_data(p.values.data(), p.values.size());
+    assert(valid);
+    (void)valid;
+    return &view;
+}
+
+auto collector::frames() const -> uint64_t
+{
+    return m_frames;
+}
+
+auto collector::unknown_frames() const -> uint64_t
+{
+    return m_unknown_frames;
+}
+
+auto collector::sync_values() const -> std::vector<uint32_t>
+{
+    std::vector<uint32_t> sync_values;
+    sync_values.reserve(m_schemas.size());
+    for (const auto& [sync_value, schema] : m_schemas)
+    {
+        sync_values.push_back(sync_value);
+    }
+    return sync_values;
+}
+
+auto collector::metadata(uint32_t sync_value) const
+    -> const protobuf::MetricsMetadata&
+{
+    assert(m_schemas.count(sync_value) != 0);
+    return m_schemas.at(sync_value).view.metadata();
+}
+
+auto collector::aggregate(uint32_t sync_value, std::vector<uint8_t>& data) const
+    -> std::size_t
+{
+    assert(m_schemas.count(sync_value) != 0);
+    const auto& aggregator = *m_schemas.at(sync_value).aggregator;
+
+    std::vector<const uint8_t*> values;
+    for (const auto& producer : m_producers)
+    {
+        if (producer.has_values && producer.sync_value == sync_value)
+        {
+            values.push_back(producer.values.data());
+        }
+    }
+    data.resize(aggregator.value_bytes());
+    if (values.empty() || !aggregator.aggregate(values, data.data()))
+    {
+        return 0;
+    }
+    return values.size();
+}
+
+auto collector::process(producer& producer, const uint8_t* data,
+                        std::size_t bytes) -> bool
+{
+    received_frame frame;
+    if (!read_frame(data, bytes, frame) || frame.value_bytes < 4)
+    {
+        return false;
+    }
+    ++m_frames;
+
+    // The value data is dispatched on its sync value in the byte order of
+    // the host
+    uint32_t sync_value;
+    std::memcpy(&sync_value, frame.value_data, sizeof(sync_value));
+    auto it = m_schemas.find(sync_value);
+
+    // Meta data is only parsed the first time a sync value is seen
+    if (it == m_schemas.end() && frame.metadata_data != nullptr)
+    {
+        if (m_schemas.size() == m_max_metadata)
+        {
+            return false;
+        }
+        schema schema;
+        if (frame.metadata_bytes == 0 ||
+            !schema.view.set_metadata(frame.metadata_data,
+                                      frame.metadata_bytes) ||
+            !matches(schema.view.metadata(), frame.value_data))
+        {
+            return false;
+        }
+        schema.aggregator =
+            std::make_unique<abacus::aggregator>(schema.view.metadata());
+        it = m_schemas.emplace(sync_value, std::move(schema)).first;
+    }
+    if (it == m_schemas.end())
+    {
+        ++m_unknown_frames;
+        return true;
+    }
+
+    // The view reads the value data only within the size of the schema
+    if (frame.value_bytes != it->second.aggregator->value_bytes())
+    {
+        return false;
+    }
+    producer.values.assign(frame.value_data,
+                           frame.value_data + frame.value_bytes);
+    producer.sync_value = sync_value;
+    producer.has_values = true;
+    return true;
+}
+}
+}
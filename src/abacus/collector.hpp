@@ -0,0 +1,130 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "aggregator.hpp"
+#include "protobuf/metrics.pb.h"
+#include "version.hpp"
+#include "view.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// Collects the metrics of many producers sending frames created by
+/// abacus::framer over byte streams, e.g. UNIX domain sockets, and
+/// aggregates the latest values of the producers with the same meta data.
+///
+/// The bytes of a stream are passed to receive() as they arrive. Complete
+/// frames are processed where they are received, only a frame split between
+/// two receive() calls is buffered. A frame with meta data registers the
+/// meta data under its sync value, so the value frames of all producers with
+/// that sync value are dispatched to it, whichever producer sent the meta
+/// data. The meta data is parsed once per sync value and shared by its
+/// producers, only the latest value data is kept per producer.
+///
+/// The memory is bounded by the maximum frame size per producer and the
+/// maximum number of meta data. The collector does no I/O and is not
+/// thread-safe, see examples/collector for a daemon using epoll.
+class collector
+{
+public:
+    /// Constructor
+    /// @param max_frame_bytes The maximum size of a frame, larger frames
+    ///        are invalid
+    /// @param max_metadata The maximum number of different meta data, meta
+    ///        data beyond it is invalid
+    collector(std::size_t max_frame_bytes = 1U << 24,
+              std::size_t max_metadata = 256);
+
+    /// Adds a producer, e.g. for an accepted connection
+    /// @return The identifier of the producer
+    auto add_producer() -> std::size_t;
+
+    /// Removes a producer, e.g. when its connection is closed. The
+    /// identifier may be reused by add_producer().
+    /// @param producer The identifier of the producer
+    auto remove_producer(std::size_t producer) -> void;
+
+    /// @return The number of producers
+    auto producers() const -> std::size_t;
+
+    /// Receives bytes of the stream of a producer
+    /// @param producer The identifier of the producer
+    /// @param data The bytes
+    /// @param bytes The number of bytes
+    /// @return false if the stream is invalid, the producer should then be
+    ///         removed
+    [[nodiscard]] auto receive(std::size_t producer, const uint8_t* data,
+                               std::size_t bytes) -> bool;
+
+    /// The producers of a sync value share one view, which is pointed at
+    /// the value data of the producer. The view is valid until the next
+    /// call of view(), receive() or remove_producer().
+    /// @return The view of the latest value data of a producer, or nullptr
+    ///         if no value data has been received
+    /// @param producer The identifier of the producer
+    auto view(std::size_t producer) const -> const abacus::view*;
+
+    /// @return The number of processed frames
+    auto frames() const -> uint64_t;
+
+    /// @return The number of value frames dropped because their sync value
+    ///         was unknown, i.e. no frame with the meta data was received
+    auto unknown_frames() const -> uint64_t;
+
+    /// @return The sync values of the received meta data
+    auto sync_values() const -> std::vector<uint32_t>;
+
+    /// @return The meta data of a sync value
+    /// @param sync_value The sync value, see sync_values()
+    auto metadata(uint32_t sync_value) const
+        -> const protobuf::MetricsMetadata&;
+
+    /// Aggregates the latest value data of the producers of a sync value
+    /// with an abacus::aggregator
+    /// @param sync_value The sync value, see sync_values()
+    /// @param data The aggregate, resized to the size of the value data
+    /// @return The number of aggregated producers
+    auto aggregate(uint32_t sync_value, std::vector<uint8_t>& data) const
+        -> std::size_t;
+
+private:
+    struct schema
+    {
+        // The parsed meta data, its value data is set by view()
+        mutable abacus::view view;
+        std::unique_ptr<abacus::aggregator> aggregator;
+    };
+
+    struct producer
+    {
+        bool active = false;
+        bool has_values = false;
+        uint32_t sync_value = 0;
+        std::vector<uint8_t> pending;
+        std::vector<uint8_t> values;
+    };
+
+    auto process(producer& producer, const uint8_t* data, std::size_t bytes)
+        -> bool;
+
+private:
+    const std::size_t m_max_frame_bytes;
+    const std::size_t m_max_metadata;
+    std::map<uint32_t, schema> m_schemas;
+    std::vector<producer> m_producers;
+    std::vector<std::size_t> m_free;
+    uint64_t m_frames = 0;
+    uint64_t m_unknown_frames = 0;
+};
+}
+}
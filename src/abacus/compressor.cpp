@@ -0,0 +1,189 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "compressor.hpp"
+
+#include "detail/frame_header.hpp"
+#include "detail/lz.hpp"
+#include "detail/zero_run.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace
+{
+// Decompresses the payload of a frame with a built-in codec
+static inline auto decompress_payload(uint8_t id, const uint8_t* payload,
+                                      std::size_t payload_bytes, uint8_t* data,
+                                      std::size_t bytes) -> bool
+{
+    // Empty data is always stored as is
+    if (bytes == 0)
+    {
+        return payload_bytes == 0;
+    }
+    switch (static_cast<codec>(id))
+    {
+    case codec::none:
+        if (payload_bytes != bytes)
+        {
+            return false;
+        }
+        std::memcpy(data, payload, bytes);
+        return true;
+    case codec::zero_run:
+        return detail::zero_run_decompress(payload, payload_bytes, data,
+                                           bytes);
+    case codec::lz:
+        return detail::lz_decompress(payload, payload_bytes, data, bytes);
+    default:
+        return false;
+    }
+}
+}
+
+compressor::compressor(abacus::codec codec) : m_codec(codec)
+{
+}
+
+compressor::compressor(abacus::custom_codec codec) :
+    m_codec(abacus::codec::none), m_custom(std::move(codec))
+{
+    assert(m_custom->id >= custom_codec::first_id);
+    assert(m_custom->bound);
+    assert(m_custom->compress);
+    assert(m_custom->decompress);
+}
+
+auto compressor::id() const -> uint8_t
+{
+    return m_custom ? m_custom->id : static_cast<uint8_t>(m_codec);
+}
+
+auto compressor::max_frame_bytes(std::size_t bytes) const -> std::size_t
+{
+    std::size_t bound = bytes;
+    if (m_custom)
+    {
+        bound = m_custom->bound(bytes);
+    }
+    else if (m_codec == codec::zero_run)
+    {
+        bound = detail::zero_run_bound(bytes);
+    }
+    else if (m_codec == codec::lz)
+    {
+        bound = detail::lz_bound(bytes);
+    }
+    return detail::max_frame_header_bytes + std::max(bound, bytes);
+}
+
+auto compressor::compress(const uint8_t* data, std::size_t bytes,
+                          uint8_t* frame) const -> std::size_t
+{
+    assert(bytes == 0 || data != nullptr);
+    assert(frame != nullptr);
+
+    std::size_t header = detail::write_frame_header(id(), bytes, frame);
+    uint8_t* payload = frame + header;
+    std::size_t payload_bytes = 0;
+    if (bytes > 0)
+    {
+        if (m_custom)
+        {
+            payload_bytes = m_custom->compress(data, bytes, payload);
+        }
+        else if (m_codec == codec::zero_run)
+        {
+            payload_bytes = detail::zero_run_compress(data, bytes, payload);
+        }
+        else if (m_codec == codec::lz)
+        {
+            payload_bytes = detail::lz_compress(data, bytes, payload);
+        }
+    }
+
+    // Data which is not made smaller is stored as is
+    if (payload_bytes == 0 || payload_bytes >= bytes)
+    {
+        header = detail::write_frame_header(
+            static_cast<uint8_t>(codec::none), bytes, frame);
+        if (bytes > 0)
+        {
+            std::memcpy(frame + header, data, bytes);
+        }
+        return header + bytes;
+    }
+    return header + payload_bytes;
+}
+
+auto compressor::compress(const uint8_t* data, std::size_t bytes,
+                          std::vector<uint8_t>& frame) const -> void
+{
+    frame.resize(max_frame_bytes(bytes));
+    frame.resize(compress(data, bytes, frame.data()));
+}
+
+auto decompressed_bytes(const uint8_t* frame, std::size_t frame_bytes)
+    -> std::optional<std::size_t>
+{
+    assert(frame != nullptr || frame_bytes == 0);
+    uint8_t id;
+    std::size_t bytes;
+    if (detail::read_frame_header(frame, frame_bytes, id, bytes) == 0)
+    {
+        return std::nullopt;
+    }
+    return bytes;
+}
+
+auto decompress(const uint8_t* frame, std::size_t frame_bytes, uint8_t* data,
+                std::size_t bytes) -> bool
+{
+    assert(frame != nullptr || frame_bytes == 0);
+    assert(data != nullptr || bytes == 0);
+    uint8_t id;
+    std::size_t size;
+    std::size_t header =
+        detail::read_frame_header(frame, frame_bytes, id, size);
+    if (header == 0 || size != bytes)
+    {
+        return false;
+    }
+    return decompress_payload(id, frame + header, frame_bytes - header, data,
+                              bytes);
+}
+
+auto decompress(const uint8_t* frame, std::size_t frame_bytes, uint8_t* data,
+                std::size_t bytes, const custom_codec& codec) -> bool
+{
+    assert(frame != nullptr || frame_bytes == 0);
+    assert(data != nullptr || bytes == 0);
+    uint8_t id;
+    std::size_t size;
+    std::size_t header =
+        detail::read_frame_header(frame, frame_bytes, id, size);
+    if (header == 0 || size != bytes)
+    {
+        return false;
+    }
+    if (id != codec.id)
+    {
+        return decompress_payload(id, frame + header, frame_bytes - header,
+                                  data, bytes);
+    }
+    if (bytes == 0)
+    {
+        return frame_bytes == header;
+    }
+    return codec.decompress(frame + header, frame_bytes - header, data, bytes);
+}
+}
+}
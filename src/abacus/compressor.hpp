@@ -0,0 +1,99 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "codec.hpp"
+#include "custom_codec.hpp"
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// Compresses value data or meta data into self-describing frames, e.g. for
+/// sending them over links which are paid per byte.
+///
+/// A frame starts with the id of the codec and the size of the data, so it
+/// is decompressed with abacus::decompress() without knowing how it was
+/// compressed. Data which a codec does not make smaller is stored as is.
+/// Compressing into a buffer of max_frame_bytes() does not allocate.
+class compressor
+{
+public:
+    /// Constructor
+    /// @param codec The built-in codec
+    compressor(abacus::codec codec = abacus::codec::zero_run);
+
+    /// Constructor
+    /// @param codec The custom codec, its id must be at least
+    ///        abacus::custom_codec::first_id
+    compressor(abacus::custom_codec codec);
+
+    /// @return The id of the codec stored in the frames
+    auto id() const -> uint8_t;
+
+    /// @return The maximum size of a frame
+    /// @param bytes The size of the data
+    auto max_frame_bytes(std::size_t bytes) const -> std::size_t;
+
+    /// Compresses data into a frame
+    /// @param data The data, e.g. abacus::metrics::value_data()
+    /// @param bytes The size of the data
+    /// @param frame The frame, at least max_frame_bytes(bytes) large
+    /// @return The size of the frame
+    auto compress(const uint8_t* data, std::size_t bytes, uint8_t* frame) const
+        -> std::size_t;
+
+    /// Compresses data into a frame. The frame is resized to the size of the
+    /// frame, so reusing it only allocates if it has to grow.
+    /// @param data The data, e.g. abacus::metrics::value_data()
+    /// @param bytes The size of the data
+    /// @param frame The frame
+    auto compress(const uint8_t* data, std::size_t bytes,
+                  std::vector<uint8_t>& frame) const -> void;
+
+private:
+    /// The built-in codec, if no custom codec is used
+    abacus::codec m_codec;
+
+    /// The custom codec
+    std::optional<abacus::custom_codec> m_custom;
+};
+
+/// @return The size of the data of a frame, or std::nullopt if the frame
+///         header is invalid
+/// @param frame The frame
+/// @param frame_bytes The size of the frame
+auto decompressed_bytes(const uint8_t* frame, std::size_t frame_bytes)
+    -> std::optional<std::size_t>;
+
+/// Decompresses a frame of abacus::compressor with a built-in codec. The
+/// frame is fully validated and decompressing does not allocate.
+/// @param frame The frame
+/// @param frame_bytes The size of the frame
+/// @param data The data, e.g. passed to abacus::view::set_value_data()
+/// @param bytes The size of the data, must be decompressed_bytes()
+/// @return true if the frame was valid and decompressed
+[[nodiscard]] auto decompress(const uint8_t* frame, std::size_t frame_bytes,
+                              uint8_t* data, std::size_t bytes) -> bool;
+
+/// Decompresses a frame of abacus::compressor with a built-in codec or the
+/// given custom codec
+/// @param frame The frame
+/// @param frame_bytes The size of the frame
+/// @param data The data, e.g. passed to abacus::view::set_value_data()
+/// @param bytes The size of the data, must be decompressed_bytes()
+/// @param codec The custom codec the frame may be compressed with
+/// @return true if the frame was valid and decompressed
+[[nodiscard]] auto decompress(const uint8_t* frame, std::size_t frame_bytes,
+                              uint8_t* data, std::size_t bytes,
+                              const custom_codec& codec) -> bool;
+}
+}
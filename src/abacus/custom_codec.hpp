@@ -0,0 +1,45 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// A user supplied codec, e.g. wrapping zstd, used by abacus::compressor
+/// instead of a built-in codec. The frames are decompressed by passing the
+/// same codec to abacus::decompress().
+struct custom_codec
+{
+    /// The lowest id of a custom codec, the lower ids are reserved for the
+    /// built-in codecs
+    static constexpr uint8_t first_id = 128;
+
+    /// The id stored in the frames, at least first_id
+    uint8_t id = first_id;
+
+    /// Returns the maximum compressed size of data of the given size
+    std::function<std::size_t(std::size_t bytes)> bound;
+
+    /// Compresses data into a buffer of at least bound(bytes) bytes and
+    /// returns the compressed size, or 0 if the data could not be compressed
+    std::function<std::size_t(const uint8_t* data, std::size_t bytes,
+                              uint8_t* compressed)>
+        compress;
+
+    /// Decompresses data which must result in exactly bytes bytes and
+    /// returns false if the compressed data is invalid
+    std::function<bool(const uint8_t* compressed, std::size_t compressed_bytes,
+                       uint8_t* data, std::size_t bytes)>
+        decompress;
+};
+}
+}
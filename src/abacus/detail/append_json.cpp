@@ -0,0 +1,218 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "append_json.hpp"
+
+#include "../boolean.hpp"
+#include "../enum8.hpp"
+#include "../float32.hpp"
+#include "../float64.hpp"
+#include "../int32.hpp"
+#include "../int64.hpp"
+#include "../uint32.hpp"
+#include "../uint64.hpp"
+#include "to_json.hpp"
+
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <optional>
+
+#include <bourne/json.hpp>
+
+#include "../version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+namespace
+{
+static inline void append_string(std::string_view value, std::string& out)
+{
+    static constexpr char hex[] = "0123456789abcdef";
+    out.push_back('"');
+    for (char c : value)
+    {
+        auto byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\')
+        {
+            out.push_back('\\');
+            out.push_back(c);
+        }
+        else if (byte < 0x20)
+        {
+            out.append("\\u00");
+            out.push_back(hex[byte >> 4]);
+            out.push_back(hex[byte & 0xf]);
+        }
+        else
+        {
+            out.push_back(c);
+        }
+    }
+    out.push_back('"');
+}
+
+template <class T>
+static inline void append_integer(T value, std::string& out)
+{
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+// Floats are formatted like bourne::json::dump() formats them, so they match
+// abacus::to_json() without allocating. Infinity and NaN are rare and are
+// left to bourne.
+static inline void append_float(double value, std::string& out)
+{
+    if (!std::isfinite(value))
+    {
+        out.append(bourne::json(value).dump());
+        return;
+    }
+    char buffer[32];
+    int size = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    assert(size > 0 && static_cast<std::size_t>(size) < sizeof(buffer));
+    out.append(buffer, static_cast<std::size_t>(size));
+}
+
+template <class Metric, class Append>
+static inline void append_optional(const view& view, std::size_t id,
+                                   std::string& out, Append append)
+{
+    auto value = view.value<Metric>(id);
+    if (value.has_value())
+    {
+        append(value.value());
+    }
+    else
+    {
+        out.append("null");
+    }
+}
+
+// Appends the value of a metric, unset metrics are null
+static inline void append_value(const view& view, std::size_t id,
+                                std::string& out)
+{
+    const auto& metric = view.metric(id);
+    auto integer = [&out](auto value) { append_integer(value, out); };
+    switch (metric.type_case())
+    {
+    case protobuf::Metric::kConstant:
+    {
+        const auto& constant = metric.constant();
+        switch (constant.value_case())
+        {
+        case protobuf::Constant::kUint64:
+            append_integer(constant.uint64(), out);
+            break;
+        case protobuf::Constant::kInt64:
+            append_integer(constant.int64(), out);
+            break;
+        case protobuf::Constant::kFloat64:
+            append_float(constant.float64(), out);
+            break;
+        case protobuf::Constant::kBoolean:
+            out.append(constant.boolean() ? "true" : "false");
+            break;
+        case protobuf::Constant::kString:
+            append_string(constant.string(), out);
+            break;
+        default:
+            out.append("null");
+            break;
+        }
+        break;
+    }
+    case protobuf::Metric::kUint64:
+        append_optional<abacus::uint64>(view, id, out, integer);
+        break;
+    case protobuf::Metric::kInt64:
+        append_optional<abacus::int64>(view, id, out, integer);
+        break;
+    case protobuf::Metric::kUint32:
+        append_optional<abacus::uint32>(view, id, out, integer);
+        break;
+    case protobuf::Metric::kInt32:
+        append_optional<abacus::int32>(view, id, out, integer);
+        break;
+    case protobuf::Metric::kFloat64:
+        append_optional<abacus::float64>(view, id, out, [&out](double value)
+                                         { append_float(value, out); });
+        break;
+    case protobuf::Metric::kFloat32:
+        append_optional<abacus::float32>(view, id, out, [&out](float value)
+                                         { append_float(value, out); });
+        break;
+    case protobuf::Metric::kBoolean:
+        append_optional<abacus::boolean>(view, id, out, [&out](bool value)
+                                         { out.append(value ? "true"
+                                                            : "false"); });
+        break;
+    case protobuf::Metric::kEnum8:
+        append_optional<abacus::enum8>(view, id, out, integer);
+        break;
+    default:
+        out.append("null");
+        break;
+    }
+}
+}
+
+auto append_json(const view& view, bool minimal, std::string& out) -> void
+{
+    if (!minimal)
+    {
+        append_compact_json(to_json(view, false).dump(), out);
+        return;
+    }
+
+    // The metrics are visited in the order of their names, like the keys of
+    // a JSON object
+    out.push_back('{');
+    for (std::size_t id = 0; id < view.count(); ++id)
+    {
+        if (id != 0)
+        {
+            out.push_back(',');
+        }
+        append_string(view.metric_name(id), out);
+        out.push_back(':');
+        append_value(view, id, out);
+    }
+    out.push_back('}');
+}
+
+auto append_compact_json(std::string_view json, std::string& out) -> void
+{
+    bool in_string = false;
+    bool escaped = false;
+    for (char c : json)
+    {
+        if (in_string)
+        {
+            in_string = escaped || c != '"';
+            escaped = !escaped && c == '\\';
+        }
+        else if (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+        {
+            continue;
+        }
+        else
+        {
+            in_string = c == '"';
+        }
+        out.push_back(c);
+    }
+}
+}
+}
+}
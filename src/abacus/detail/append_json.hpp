@@ -0,0 +1,37 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "../view.hpp"
+
+#include "../version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+/// Appends the values of a view as JSON on one line, i.e. the JSON of
+/// abacus::to_json() without whitespace. The minimal JSON is written
+/// directly to the string without building a JSON document, the full JSON
+/// is built with detail::to_json().
+/// @param view A view with access to metrics-data.
+/// @param minimal If true, only the values are written, as a map between
+///        metric names and values.
+/// @param out The string the JSON is appended to
+auto append_json(const view& view, bool minimal, std::string& out) -> void;
+
+/// Appends JSON on one line, i.e. without the whitespace outside of strings
+/// @param json The JSON
+/// @param out The string the JSON is appended to
+auto append_compact_json(std::string_view json, std::string& out) -> void;
+}
+}
+}
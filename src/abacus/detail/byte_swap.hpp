@@ -0,0 +1,64 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+
+#include "../version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+/// @param value The value to swap
+/// @return The value with the byte order reversed
+inline auto byte_swap(uint32_t value) -> uint32_t
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap32(value);
+#elif defined(_MSC_VER)
+    return _byteswap_ulong(value);
+#else
+    return ((value & 0x000000FFU) << 24) | ((value & 0x0000FF00U) << 8) |
+           ((value & 0x00FF0000U) >> 8) | ((value & 0xFF000000U) >> 24);
+#endif
+}
+
+/// @param value The value to swap
+/// @return The value with the byte order reversed
+inline auto byte_swap(uint64_t value) -> uint64_t
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(value);
+#elif defined(_MSC_VER)
+    return _byteswap_uint64(value);
+#else
+    return (static_cast<uint64_t>(byte_swap(static_cast<uint32_t>(value)))
+            << 32) |
+           byte_swap(static_cast<uint32_t>(value >> 32));
+#endif
+}
+
+/// Reverses the byte order of an unaligned value in place
+/// @param data The value
+template <class T>
+inline auto byte_swap_at(uint8_t* data) -> void
+{
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    value = byte_swap(value);
+    std::memcpy(data, &value, sizeof(T));
+}
+}
+}
+}
@@ -0,0 +1,128 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "crc32c.hpp"
+
+#include <array>
+#include <cstring>
+
+// The CRC32 instruction of SSE 4.2 is used on x86-64 if the CPU has it
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <nmmintrin.h>
+#define ABACUS_DETAIL_CRC32C_SSE42 1
+#endif
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+namespace
+{
+// The reversed Castagnoli polynomial
+static constexpr uint32_t polynomial = 0x82F63B78;
+
+// The tables for processing eight bytes at a time, table i holds the CRC of
+// a byte followed by i zero bytes
+static constexpr auto make_tables() -> std::array<std::array<uint32_t, 256>, 8>
+{
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t byte = 0; byte < 256; ++byte)
+    {
+        uint32_t crc = byte;
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ ((crc & 1) != 0 ? polynomial : 0);
+        }
+        tables[0][byte] = crc;
+    }
+    for (uint32_t byte = 0; byte < 256; ++byte)
+    {
+        for (std::size_t i = 1; i < 8; ++i)
+        {
+            const uint32_t previous = tables[i - 1][byte];
+            tables[i][byte] = (previous >> 8) ^ tables[0][previous & 0xFF];
+        }
+    }
+    return tables;
+}
+
+static constexpr std::array<std::array<uint32_t, 256>, 8> tables =
+    make_tables();
+
+static inline auto crc32c_tables(const uint8_t* data, std::size_t bytes,
+                                 uint32_t crc) -> uint32_t
+{
+    for (; bytes >= 8; bytes -= 8, data += 8)
+    {
+        // The words are read little endian on any host
+        uint32_t low = static_cast<uint32_t>(data[0]) |
+                       static_cast<uint32_t>(data[1]) << 8 |
+                       static_cast<uint32_t>(data[2]) << 16 |
+                       static_cast<uint32_t>(data[3]) << 24;
+        uint32_t high = static_cast<uint32_t>(data[4]) |
+                        static_cast<uint32_t>(data[5]) << 8 |
+                        static_cast<uint32_t>(data[6]) << 16 |
+                        static_cast<uint32_t>(data[7]) << 24;
+        low ^= crc;
+        crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^
+              tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24] ^
+              tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^
+              tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+    }
+    for (; bytes > 0; --bytes, ++data)
+    {
+        crc = (crc >> 8) ^ tables[0][(crc ^ *data) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(ABACUS_DETAIL_CRC32C_SSE42)
+__attribute__((target("sse4.2"))) static auto
+crc32c_sse42(const uint8_t* data, std::size_t bytes, uint32_t crc) -> uint32_t
+{
+    uint64_t crc64 = crc;
+    for (; bytes >= 8; bytes -= 8, data += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = static_cast<uint32_t>(crc64);
+    for (; bytes > 0; --bytes, ++data)
+    {
+        crc = _mm_crc32_u8(crc, *data);
+    }
+    return crc;
+}
+
+// __builtin_cpu_supports() reads the CPU model filled in by
+// __builtin_cpu_init(). Static initializers may run before the runtime has
+// called it, so it is called explicitly.
+static inline auto detect_sse42() -> bool
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+}
+
+static const bool has_sse42 = detect_sse42();
+#endif
+}
+
+auto crc32c(const uint8_t* data, std::size_t bytes, uint32_t crc) -> uint32_t
+{
+    crc = ~crc;
+#if defined(ABACUS_DETAIL_CRC32C_SSE42)
+    if (has_sse42)
+    {
+        return ~crc32c_sse42(data, bytes, crc);
+    }
+#endif
+    return ~crc32c_tables(data, bytes, crc);
+}
+}
+}
+}
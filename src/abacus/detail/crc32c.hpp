@@ -0,0 +1,29 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+/// Computes the CRC-32C (Castagnoli) of data. The CRC of data split in parts
+/// is computed by passing the CRC of the previous parts.
+/// @param data The data
+/// @param bytes The size of the data
+/// @param crc The CRC of the previous parts, zero for the first part
+/// @return The CRC of the data and the previous parts
+auto crc32c(const uint8_t* data, std::size_t bytes, uint32_t crc = 0)
+    -> uint32_t;
+}
+}
+}
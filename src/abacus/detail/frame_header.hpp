@@ -0,0 +1,76 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+/// The maximum size of a frame header, the codec id and the size of the
+/// decompressed data as a varint
+static constexpr std::size_t max_frame_header_bytes = 1 + 10;
+
+/// Writes a frame header
+/// @param id The id of the codec
+/// @param bytes The size of the decompressed data
+/// @param frame The frame, at least max_frame_header_bytes large
+/// @return The size of the header
+inline auto write_frame_header(uint8_t id, std::size_t bytes, uint8_t* frame)
+    -> std::size_t
+{
+    uint8_t* out = frame;
+    *out++ = id;
+    uint64_t value = bytes;
+    while (value >= 0x80)
+    {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return static_cast<std::size_t>(out - frame);
+}
+
+/// Reads a frame header
+/// @param frame The frame
+/// @param frame_bytes The size of the frame
+/// @param id The id of the codec
+/// @param bytes The size of the decompressed data
+/// @return The size of the header, or 0 if the header is invalid
+inline auto read_frame_header(const uint8_t* frame, std::size_t frame_bytes,
+                              uint8_t& id, std::size_t& bytes) -> std::size_t
+{
+    if (frame_bytes == 0)
+    {
+        return 0;
+    }
+    id = frame[0];
+    uint64_t value = 0;
+    for (std::size_t i = 1; i < frame_bytes && i < max_frame_header_bytes;
+         ++i)
+    {
+        value |= static_cast<uint64_t>(frame[i] & 0x7F) << (7 * (i - 1));
+        if ((frame[i] & 0x80) == 0)
+        {
+            if (value > SIZE_MAX)
+            {
+                return 0;
+            }
+            bytes = static_cast<std::size_t>(value);
+            return i + 1;
+        }
+    }
+    return 0;
+}
+}
+}
+}
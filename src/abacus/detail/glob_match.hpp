@@ -0,0 +1,75 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "../version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+/// Matches a string against a glob pattern. The character '*' matches any
+/// sequence of characters (including none) and '?' matches any single
+/// character, all other characters match themselves.
+/// @param pattern The glob pattern
+/// @param str The string to match
+/// @return true if the string matches the pattern
+constexpr auto glob_match(std::string_view pattern, std::string_view str)
+    -> bool
+{
+    std::size_t p = 0;
+    std::size_t s = 0;
+
+    // The position after the last '*' seen and the position in str it is
+    // currently matched up to, used to backtrack on a mismatch
+    std::size_t star = std::string_view::npos;
+    std::size_t star_s = 0;
+
+    while (s < str.size())
+    {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == str[s]))
+        {
+            ++p;
+            ++s;
+        }
+        else if (p < pattern.size() && pattern[p] == '*')
+        {
+            star = ++p;
+            star_s = s;
+        }
+        else if (star != std::string_view::npos)
+        {
+            // Let the last '*' swallow one more character
+            p = star;
+            s = ++star_s;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == '*')
+    {
+        ++p;
+    }
+    return p == pattern.size();
+}
+
+/// @param pattern The glob pattern
+/// @return The literal prefix of the pattern before the first wildcard
+constexpr auto glob_prefix(std::string_view pattern) -> std::string_view
+{
+    return pattern.substr(0, pattern.find_first_of("*?"));
+}
+}
+}
+}
@@ -0,0 +1,212 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "lz.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+namespace
+{
+// The shortest sequence which is replaced by a match
+static constexpr std::size_t min_match = 4;
+
+// The largest distance to a match, as the offset is stored in two bytes
+static constexpr std::size_t max_offset = 0xFFFF;
+
+// The number of bits of the hash of the positions of the last sequences
+static constexpr uint32_t hash_bits = 12;
+
+static inline auto load32(const uint8_t* data) -> uint32_t
+{
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// Writes the part of a length which does not fit in the token
+static inline auto write_length(std::size_t length, uint8_t* out) -> uint8_t*
+{
+    for (; length >= 255; length -= 255)
+    {
+        *out++ = 255;
+    }
+    *out++ = static_cast<uint8_t>(length);
+    return out;
+}
+
+// Reads the part of a length which did not fit in the token
+static inline auto read_length(const uint8_t*& in, const uint8_t* end,
+                               std::size_t& length) -> bool
+{
+    uint8_t byte;
+    do
+    {
+        if (in == end)
+        {
+            return false;
+        }
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+// Writes a sequence of literals followed by a match, the last sequence has
+// no match
+static inline auto write_sequence(const uint8_t* literals,
+                                  std::size_t literal_bytes, std::size_t offset,
+                                  std::size_t match_bytes, uint8_t* out)
+    -> uint8_t*
+{
+    uint8_t* token = out++;
+    std::size_t match = match_bytes == 0 ? 0 : match_bytes - min_match;
+    *token = static_cast<uint8_t>((std::min<std::size_t>(literal_bytes, 15)
+                                   << 4) |
+                                  std::min<std::size_t>(match, 15));
+    if (literal_bytes >= 15)
+    {
+        out = write_length(literal_bytes - 15, out);
+    }
+    std::memcpy(out, literals, literal_bytes);
+    out += literal_bytes;
+    if (match_bytes == 0)
+    {
+        return out;
+    }
+    *out++ = static_cast<uint8_t>(offset);
+    *out++ = static_cast<uint8_t>(offset >> 8);
+    if (match >= 15)
+    {
+        out = write_length(match - 15, out);
+    }
+    return out;
+}
+}
+
+auto lz_bound(std::size_t bytes) -> std::size_t
+{
+    // Incompressible data is one sequence of literals, a match is never
+    // larger than the literals it replaces
+    return bytes + bytes / 255 + 16;
+}
+
+auto lz_compress(const uint8_t* data, std::size_t bytes, uint8_t* compressed)
+    -> std::size_t
+{
+    assert(bytes < UINT32_MAX);
+
+    // The last position of the sequences with a hash, stored with one added
+    // so zero is empty
+    uint32_t table[1U << hash_bits] = {};
+    auto hash = [](uint32_t sequence) -> uint32_t
+    { return (sequence * 2654435761U) >> (32 - hash_bits); };
+
+    uint8_t* out = compressed;
+    std::size_t anchor = 0;
+    std::size_t position = 0;
+    while (position + min_match <= bytes)
+    {
+        const uint32_t sequence = load32(data + position);
+        uint32_t& entry = table[hash(sequence)];
+        const std::size_t candidate = entry;
+        entry = static_cast<uint32_t>(position + 1);
+
+        if (candidate == 0 || position + 1 - candidate > max_offset ||
+            load32(data + candidate - 1) != sequence)
+        {
+            // Incompressible data is skipped faster the longer it gets
+            position += 1 + ((position - anchor) >> 6);
+            continue;
+        }
+
+        const std::size_t match = candidate - 1;
+        std::size_t length = min_match;
+        while (position + length < bytes &&
+               data[match + length] == data[position + length])
+        {
+            ++length;
+        }
+        out = write_sequence(data + anchor, position - anchor,
+                             position - match, length, out);
+        position += length;
+        anchor = position;
+    }
+    out = write_sequence(data + anchor, bytes - anchor, 0, 0, out);
+    return static_cast<std::size_t>(out - compressed);
+}
+
+auto lz_decompress(const uint8_t* compressed, std::size_t compressed_bytes,
+                   uint8_t* data, std::size_t bytes) -> bool
+{
+    const uint8_t* in = compressed;
+    const uint8_t* end = compressed + compressed_bytes;
+    std::size_t position = 0;
+    // The data ends with a sequence without a match
+    while (in != end)
+    {
+        const uint8_t token = *in++;
+        std::size_t literals = token >> 4;
+        if (literals == 15 && !read_length(in, end, literals))
+        {
+            return false;
+        }
+        if (literals > static_cast<std::size_t>(end - in) ||
+            literals > bytes - position)
+        {
+            return false;
+        }
+        std::memcpy(data + position, in, literals);
+        in += literals;
+        position += literals;
+
+        if (in == end)
+        {
+            return position == bytes;
+        }
+        if (end - in < 2)
+        {
+            return false;
+        }
+        const std::size_t offset = in[0] | static_cast<std::size_t>(in[1]) << 8;
+        in += 2;
+        std::size_t length = token & 0x0F;
+        if (length == 15 && !read_length(in, end, length))
+        {
+            return false;
+        }
+        length += min_match;
+        if (offset == 0 || offset > position || length > bytes - position)
+        {
+            return false;
+        }
+
+        // A match may overlap the bytes it produces, e.g. a run of zeros
+        const uint8_t* match = data + position - offset;
+        if (offset >= length)
+        {
+            std::memcpy(data + position, match, length);
+        }
+        else
+        {
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                data[position + i] = match[i];
+            }
+        }
+        position += length;
+    }
+    return false;
+}
+}
+}
+}
@@ -0,0 +1,42 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+/// @return The maximum size of data compressed with lz_compress()
+/// @param bytes The size of the data
+auto lz_bound(std::size_t bytes) -> std::size_t;
+
+/// Replaces repeated byte sequences, see abacus::codec::lz
+/// @param data The data
+/// @param bytes The size of the data
+/// @param compressed The output, at least lz_bound(bytes) large
+/// @return The size of the compressed data
+auto lz_compress(const uint8_t* data, std::size_t bytes, uint8_t* compressed)
+    -> std::size_t;
+
+/// Restores data compressed with lz_compress()
+/// @param compressed The compressed data
+/// @param compressed_bytes The size of the compressed data
+/// @param data The output
+/// @param bytes The size of the data
+/// @return true if the compressed data was valid and of the given size
+[[nodiscard]] auto lz_decompress(const uint8_t* compressed,
+                                 std::size_t compressed_bytes, uint8_t* data,
+                                 std::size_t bytes) -> bool;
+}
+}
+}
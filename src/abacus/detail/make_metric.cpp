@@ -0,0 +1,271 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "make_metric.hpp"
+
+#include "overload.hpp"
+
+#include <cassert>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+namespace
+{
+// Stores the aggregation declared in the info of a metric in its meta data
+template <class Info, class Metric>
+static inline void set_aggregation(Metric* metric, const Info& info)
+{
+    if (!info.aggregation.has_value())
+    {
+        return;
+    }
+    aggregation op = info.aggregation.value();
+    if constexpr (std::is_same_v<Info, boolean>)
+    {
+        assert((op == aggregation::any || op == aggregation::all) &&
+               "Booleans must be aggregated with any or all");
+    }
+    else if constexpr (std::is_same_v<Info, enum8>)
+    {
+        assert((op == aggregation::min || op == aggregation::max) &&
+               "Enums must be aggregated with min or max");
+    }
+    else
+    {
+        assert(op != aggregation::any && op != aggregation::all &&
+               "Numbers must be aggregated with sum, min, max or avg");
+    }
+    metric->set_aggregation(static_cast<protobuf::Aggregation>(op));
+}
+}
+
+auto make_metric(const info& info, std::size_t offset,
+                 protobuf::Metric& metric) -> std::size_t
+{
+    std::size_t bytes = 0;
+    std::visit(
+        detail::overload{
+            [&](const uint64& m)
+            {
+                auto* typed_metric = metric.mutable_uint64();
+                typed_metric->set_offset(offset);
+                typed_metric->set_description(m.description.value);
+                typed_metric->set_kind(static_cast<protobuf::Kind>(m.kind));
+
+                if (!m.unit.empty())
+                {
+                    typed_metric->set_unit(m.unit.value);
+                }
+                if (m.min.value.has_value())
+                {
+                    typed_metric->set_min(m.min.value.value());
+                }
+                if (m.max.value.has_value())
+                {
+                    typed_metric->set_max(m.max.value.value());
+                }
+                set_aggregation(typed_metric, m);
+
+                // The value is prefixed by one byte which represents
+                // whether the metric is set or not.
+                bytes = sizeof(uint64::type) + 1;
+            },
+            [&](const int64& m)
+            {
+                auto* typed_metric = metric.mutable_int64();
+                typed_metric->set_offset(offset);
+                typed_metric->set_description(m.description.value);
+                typed_metric->set_kind(static_cast<protobuf::Kind>(m.kind));
+
+                if (!m.unit.empty())
+                {
+                    typed_metric->set_unit(m.unit.value);
+                }
+                if (m.min.value.has_value())
+                {
+                    typed_metric->set_min(m.min.value.value());
+                }
+                if (m.max.value.has_value())
+                {
+                    typed_metric->set_max(m.max.value.value());
+                }
+                set_aggregation(typed_metric, m);
+
+                // The value is prefixed by one byte which represents
+                // whether the metric is set or not.
+                bytes = sizeof(int64::type) + 1;
+            },
+            [&](const uint32& m)
+            {
+                auto* typed_metric = metric.mutable_uint32();
+                typed_metric->set_offset(offset);
+                typed_metric->set_description(m.description.value);
+                typed_metric->set_kind(static_cast<protobuf::Kind>(m.kind));
+
+                if (!m.unit.empty())
+                {
+                    typed_metric->set_unit(m.unit.value);
+                }
+                if (m.min.value.has_value())
+                {
+                    typed_metric->set_min(m.min.value.value());
+                }
+                if (m.max.value.has_value())
+                {
+                    typed_metric->set_max(m.max.value.value());
+                }
+                set_aggregation(typed_metric, m);
+
+                // The value is prefixed by one byte which represents
+                // whether the metric is set or not.
+                bytes = sizeof(uint32::type) + 1;
+            },
+            [&](const int32& m)
+            {
+                auto* typed_metric = metric.mutable_int32();
+                typed_metric->set_offset(offset);
+                typed_metric->set_description(m.description.value);
+                typed_metric->set_kind(static_cast<protobuf::Kind>(m.kind));
+
+                if (!m.unit.empty())
+                {
+                    typed_metric->set_unit(m.unit.value);
+                }
+                if (m.min.value.has_value())
+                {
+                    typed_metric->set_min(m.min.value.value());
+                }
+                if (m.max.value.has_value())
+                {
+                    typed_metric->set_max(m.max.value.value());
+                }
+                set_aggregation(typed_metric, m);
+
+                // The value is prefixed by one byte which represents
+                // whether the metric is set or not.
+                bytes = sizeof(int32::type) + 1;
+            },
+            [&](const float64& m)
+            {
+                auto* typed_metric = metric.mutable_float64();
+                typed_metric->set_offset(offset);
+                typed_metric->set_description(m.description.value);
+                typed_metric->set_kind(static_cast<protobuf::Kind>(m.kind));
+
+                if (!m.unit.empty())
+                {
+                    typed_metric->set_unit(m.unit.value);
+                }
+                if (m.min.value.has_value())
+                {
+                    typed_metric->set_min(m.min.value.value());
+                }
+                if (m.max.value.has_value())
+                {
+                    typed_metric->set_max(m.max.value.value());
+                }
+                set_aggregation(typed_metric, m);
+
+                // The value is prefixed by one byte which represents
+                // whether the metric is set or not.
+                bytes = sizeof(float64::type) + 1;
+            },
+            [&](const float32& m)
+            {
+                auto* typed_metric = metric.mutable_float32();
+                typed_metric->set_offset(offset);
+                typed_metric->set_description(m.description.value);
+                typed_metric->set_kind(static_cast<protobuf::Kind>(m.kind));
+
+                if (!m.unit.empty())
+                {
+                    typed_metric->set_unit(m.unit.value);
+                }
+                if (m.min.value.has_value())
+                {
+                    typed_metric->set_min(m.min.value.value());
+                }
+                if (m.max.value.has_value())
+                {
+                    typed_metric->set_max(m.max.value.value());
+                }
+                set_aggregation(typed_metric, m);
+
+                // The value is prefixed by one byte which represents
+                // whether the metric is set or not.
+                bytes = sizeof(float32::type) + 1;
+            },
+            [&](const boolean& m)
+            {
+                auto* typed_metric = metric.mutable_boolean();
+                typed_metric->set_offset(offset);
+                typed_metric->set_description(m.description.value);
+                set_aggregation(typed_metric, m);
+
+                // The value is prefixed by one byte which represents
+                // whether the metric is set or not.
+                bytes = sizeof(boolean::type) + 1;
+            },
+            [&](const enum8& m)
+            {
+                auto* typed_metric = metric.mutable_enum8();
+                typed_metric->set_offset(offset);
+                typed_metric->set_description(m.description.value);
+                auto* values = typed_metric->mutable_values();
+                for (const auto& [key, value] : m.values)
+                {
+                    auto& enum_value = (*values)[key.value];
+                    enum_value.set_name(value.name);
+                    if (!value.description.empty())
+                    {
+                        enum_value.set_description(value.description);
+                    }
+                }
+                set_aggregation(typed_metric, m);
+
+                // The value is prefixed by one byte which represents
+                // whether the metric is set or not.
+                bytes = sizeof(enum8::type) + 1;
+            },
+            [&](const constant& m)
+            {
+                auto* typed_metric = metric.mutable_constant();
+                typed_metric->set_description(m.description.value);
+                if (!m.unit.empty())
+                {
+                    typed_metric->set_unit(m.unit.value);
+                }
+                // We expect the metric to be a constant
+                std::visit(
+                    detail::overload{
+                        [typed_metric](constant::uint64 c)
+                        { typed_metric->set_uint64(c.value); },
+                        [typed_metric](constant::int64 c)
+                        { typed_metric->set_int64(c.value); },
+                        [typed_metric](constant::float64 c)
+                        { typed_metric->set_float64(c.value); },
+                        [typed_metric](const constant::str& c)
+                        { typed_metric->set_string(c.value); },
+                        [typed_metric](constant::boolean c)
+                        { typed_metric->set_boolean(c.value); },
+                        [](const auto&)
+                        { assert(false && "Unsupported constant type"); }},
+                    m.value);
+
+                // Constants have no value
+                bytes = 0;
+            },
+            [&](const auto&)
+            { assert(false && "Unsupported metric type"); }},
+        info);
+    return bytes;
+}
+}
+}
+}
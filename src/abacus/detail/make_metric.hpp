@@ -0,0 +1,31 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+
+#include "../info.hpp"
+#include "../protobuf/metrics.pb.h"
+#include "../version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+/// Fills in the meta data of a metric from its info
+/// @param info The info of the metric
+/// @param offset The offset of the value of the metric in the value data
+/// @param metric The meta data to fill in
+/// @return The number of value bytes used by the metric, including the byte
+///         which tells whether the metric is set. Constants have no value
+///         and use 0 bytes.
+auto make_metric(const info& info, std::size_t offset,
+                 protobuf::Metric& metric) -> std::size_t;
+}
+}
+}
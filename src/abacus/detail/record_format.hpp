@@ -0,0 +1,106 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+/// The format of the files written by abacus::recorder.
+///
+/// A file starts with a header of record_magic and the format version in 4
+/// bytes and 4 reserved bytes. The header is followed by records. A record
+/// header holds, little endian, the size of the payload in 4 bytes, the
+/// CRC-32C of the rest of the header and the payload in 4 bytes, the type in
+/// 1 byte, 7 reserved bytes and the time in nanoseconds since the epoch in 8
+/// bytes.
+namespace record_format
+{
+/// The magic bytes at the start of a file
+static constexpr uint8_t magic[8] = {'A', 'B', 'A', 'C', 'U', 'S', 'R', 'C'};
+
+/// The version of the format
+static constexpr uint32_t version = 1;
+
+/// The size of the file header
+static constexpr std::size_t file_header_bytes = 16;
+
+/// The size of a record header
+static constexpr std::size_t header_bytes = 24;
+
+/// The offsets of the fields of a record header
+static constexpr std::size_t checksum_offset = 4;
+static constexpr std::size_t type_offset = 8;
+static constexpr std::size_t time_offset = 16;
+
+/// The types of records
+enum type : uint8_t
+{
+    /// The meta data of a sync value
+    metadata = 1,
+    /// The value data of a sync value
+    values = 2,
+    /// The offset of the previous index record, the number of index entries
+    /// and meta data records in 4 bytes each, the index entries of a time
+    /// and an offset in 8 bytes each and the offsets of the meta data
+    /// records written since the previous index record in 8 bytes each
+    index = 3,
+    /// The offset of the last index record, written when a file is closed
+    trailer = 4
+};
+
+/// The size of an index entry
+static constexpr std::size_t entry_bytes = 16;
+
+/// The size of the fixed part of an index record
+static constexpr std::size_t index_bytes = 16;
+
+inline auto put32(uint32_t value, uint8_t* out) -> void
+{
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+inline auto put64(uint64_t value, uint8_t* out) -> void
+{
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+inline auto get32(const uint8_t* in) -> uint32_t
+{
+    uint32_t value = 0;
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        value |= static_cast<uint32_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+inline auto get64(const uint8_t* in) -> uint64_t
+{
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+}
+}
+}
+}
@@ -0,0 +1,147 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+// Restartable sequences are used on x86-64 Linux with a glibc which
+// registers them for every thread (glibc 2.35 or later)
+#if defined(__linux__) && defined(__x86_64__) && defined(__GNUC__) &&         \
+    __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#if defined(RSEQ_SIG)
+#define ABACUS_DETAIL_RSEQ 1
+#endif
+#endif
+
+#include "../version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+/// The size of a per-CPU slot, one cache line
+constexpr std::size_t rseq_slot_bytes = 64;
+
+/// @return The number of configured CPUs
+inline auto cpu_count() -> std::size_t
+{
+#if defined(__linux__)
+    long configured = sysconf(_SC_NPROCESSORS_CONF);
+    if (configured > 0)
+    {
+        return static_cast<std::size_t>(configured);
+    }
+#endif
+    std::size_t count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+/// @return The CPU the calling thread is running on, or an identifier of
+///         the calling thread if the CPU is unknown
+inline auto current_cpu() -> std::size_t
+{
+#if defined(__linux__)
+    int cpu = sched_getcpu();
+    if (cpu >= 0)
+    {
+        return static_cast<std::size_t>(cpu);
+    }
+#endif
+    return std::hash<std::thread::id>{}(std::this_thread::get_id());
+}
+
+/// @return true if the restartable sequence of the calling thread is
+///         registered
+inline auto rseq_available() -> bool
+{
+#if defined(ABACUS_DETAIL_RSEQ)
+    if (__rseq_size == 0)
+    {
+        return false;
+    }
+    auto* area = reinterpret_cast<volatile struct rseq*>(
+        reinterpret_cast<char*>(__builtin_thread_pointer()) + __rseq_offset);
+    return static_cast<int32_t>(area->cpu_id) >= 0;
+#else
+    return false;
+#endif
+}
+
+/// Adds a value to the first 8 bytes of the slot of the current CPU without
+/// an atomic instruction. The addition is a restartable sequence, which the
+/// kernel aborts if the thread is preempted, migrated or signaled before
+/// the addition is committed.
+///
+/// The restartable sequence of the calling thread must be registered, i.e.
+/// rseq_available() must have returned true. Otherwise the sequence would
+/// write through an rseq area which does not exist.
+/// @param slots The slots, rseq_slot_bytes apart
+/// @param count The number of slots
+/// @param value The value to add
+/// @return true if the value was added, false if the sequence was aborted,
+///         the CPU has no slot or restartable sequences are not compiled in
+inline auto rseq_add(uint8_t* slots, std::size_t count, uint64_t value) -> bool
+{
+#if defined(ABACUS_DETAIL_RSEQ)
+    static_assert(rseq_slot_bytes == 64, "The sequence shifts by 6");
+    static_assert(RSEQ_SIG == 0x53053053, "Unexpected rseq signature");
+    __asm__ __volatile__ goto(
+        // The critical section descriptor: version, flags, start,
+        // post commit offset and abort handler
+        ".pushsection __rseq_cs, \"aw\"\n\t"
+        ".balign 32\n\t"
+        "3:\n\t"
+        ".long 0x0, 0x0\n\t"
+        ".quad 1f, (2f - 1f), 4f\n\t"
+        ".popsection\n\t"
+        // Register the descriptor in the rseq area of the thread
+        "leaq 3b(%%rip), %%rax\n\t"
+        "movq %%rax, %%fs:8(%[offset])\n\t"
+        "1:\n\t"
+        // Load the current CPU and abort if it has no slot
+        "movl %%fs:4(%[offset]), %%eax\n\t"
+        "cmpq %[count], %%rax\n\t"
+        "jae 4f\n\t"
+        "shlq $6, %%rax\n\t"
+        // Commit
+        "addq %[value], (%[slots], %%rax)\n\t"
+        "2:\n\t"
+        // The abort handler must be preceded by the signature
+        ".pushsection __rseq_failure, \"ax\"\n\t"
+        ".byte 0x0f, 0xb9, 0x3d\n\t"
+        ".long 0x53053053\n\t"
+        "4:\n\t"
+        "jmp %l[abort]\n\t"
+        ".popsection\n\t"
+        :
+        : [offset] "r"(__rseq_offset), [slots] "r"(slots),
+          [count] "r"(static_cast<uint64_t>(count)), [value] "r"(value)
+        : "memory", "cc", "rax"
+        : abort);
+    return true;
+abort:
+    return false;
+#else
+    (void)slots;
+    (void)count;
+    (void)value;
+    return false;
+#endif
+}
+}
+}
+}
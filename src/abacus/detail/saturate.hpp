@@ -0,0 +1,120 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include "../version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+/// Adds two values, integers saturate at the limits of the type
+/// @param a The first value
+/// @param b The second value
+/// @param overflow Set to true if the result was saturated
+/// @return The sum
+template <class T>
+inline auto saturating_add(T a, T b, bool& overflow) -> T
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        overflow = false;
+        return a + b;
+    }
+    else
+    {
+        T result;
+#if defined(__GNUC__) || defined(__clang__)
+        overflow = __builtin_add_overflow(a, b, &result);
+#else
+        if constexpr (std::is_signed_v<T>)
+        {
+            overflow = b > 0 ? a > std::numeric_limits<T>::max() - b
+                             : a < std::numeric_limits<T>::min() - b;
+        }
+        else
+        {
+            overflow = a > std::numeric_limits<T>::max() - b;
+        }
+        result = overflow ? T{} : static_cast<T>(a + b);
+#endif
+        // A positive b can only overflow upwards, so the limit is selected
+        // by the sign of b
+        T limit = std::numeric_limits<T>::max();
+        if constexpr (std::is_signed_v<T>)
+        {
+            limit = b < 0 ? std::numeric_limits<T>::min() : limit;
+        }
+        return overflow ? limit : result;
+    }
+}
+
+/// Subtracts two values, integers saturate at the limits of the type
+/// @param a The first value
+/// @param b The value to subtract
+/// @param overflow Set to true if the result was saturated
+/// @return The difference
+template <class T>
+inline auto saturating_sub(T a, T b, bool& overflow) -> T
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        overflow = false;
+        return a - b;
+    }
+    else
+    {
+        T result;
+#if defined(__GNUC__) || defined(__clang__)
+        overflow = __builtin_sub_overflow(a, b, &result);
+#else
+        if constexpr (std::is_signed_v<T>)
+        {
+            overflow = b < 0 ? a > std::numeric_limits<T>::max() + b
+                             : a < std::numeric_limits<T>::min() + b;
+        }
+        else
+        {
+            overflow = a < b;
+        }
+        result = overflow ? T{} : static_cast<T>(a - b);
+#endif
+        T limit = std::numeric_limits<T>::min();
+        if constexpr (std::is_signed_v<T>)
+        {
+            limit = b < 0 ? std::numeric_limits<T>::max() : limit;
+        }
+        return overflow ? limit : result;
+    }
+}
+
+/// Converts a sum to a narrower value type, integers saturate at the limits
+/// of the type
+/// @param sum The sum, e.g. of 32-bit values accumulated in 64 bits
+/// @return The sum as the value type
+template <class T, class Sum>
+inline auto narrow(Sum sum) -> T
+{
+    if constexpr (std::is_floating_point_v<T> || std::is_same_v<T, Sum>)
+    {
+        return static_cast<T>(sum);
+    }
+    else
+    {
+        return static_cast<T>(
+            std::clamp<Sum>(sum, std::numeric_limits<T>::lowest(),
+                            std::numeric_limits<T>::max()));
+    }
+}
+}
+}
+}
@@ -0,0 +1,43 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/message_lite.h>
+
+#include "../version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+/// Serializes a message with the map entries sorted by key. The iteration
+/// order of a protobuf map differs between instances, so this is needed for
+/// equal messages to serialize to equal bytes, and thereby equal hashes.
+/// @param message The message, ByteSizeLong() must have been called
+/// @param data The output buffer
+/// @param bytes The size of the output buffer, must be the cached size of
+///        the message
+inline auto serialize(const google::protobuf::MessageLite& message,
+                      uint8_t* data, std::size_t bytes) -> void
+{
+    assert(static_cast<std::size_t>(message.GetCachedSize()) == bytes);
+    google::protobuf::io::ArrayOutputStream array(data,
+                                                  static_cast<int>(bytes));
+    google::protobuf::io::CodedOutputStream stream(&array);
+    stream.SetSerializationDeterministic(true);
+    message.SerializeWithCachedSizes(&stream);
+    assert(!stream.HadError());
+}
+}
+}
+}
@@ -0,0 +1,299 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "string_table.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+namespace
+{
+// Calls the function with the typed meta data of the metric, which all have
+// a description and an optional unit
+template <class Function>
+static inline void visit(protobuf::Metric& metric, Function&& function)
+{
+    switch (metric.type_case())
+    {
+    case protobuf::Metric::kConstant:
+        function(*metric.mutable_constant());
+        break;
+    case protobuf::Metric::kUint64:
+        function(*metric.mutable_uint64());
+        break;
+    case protobuf::Metric::kInt64:
+        function(*metric.mutable_int64());
+        break;
+    case protobuf::Metric::kUint32:
+        function(*metric.mutable_uint32());
+        break;
+    case protobuf::Metric::kInt32:
+        function(*metric.mutable_int32());
+        break;
+    case protobuf::Metric::kFloat64:
+        function(*metric.mutable_float64());
+        break;
+    case protobuf::Metric::kFloat32:
+        function(*metric.mutable_float32());
+        break;
+    case protobuf::Metric::kBoolean:
+        function(*metric.mutable_boolean());
+        break;
+    case protobuf::Metric::kEnum8:
+        function(*metric.mutable_enum8());
+        break;
+    default:
+        // This should never be reached
+        assert(false);
+        break;
+    }
+}
+
+// The metrics of the meta data sorted by name, which is the order of the
+// references
+static inline auto sorted_metrics(protobuf::MetricsMetadata& metadata)
+    -> std::vector<std::pair<std::string_view, protobuf::Metric*>>
+{
+    std::vector<std::pair<std::string_view, protobuf::Metric*>> entries;
+    entries.reserve(metadata.metrics_size());
+    for (auto& [name, metric] : *metadata.mutable_metrics())
+    {
+        entries.emplace_back(name, &metric);
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const auto& lhs, const auto& rhs)
+              { return lhs.first < rhs.first; });
+    return entries;
+}
+}
+
+auto make_string_table(const protobuf::MetricsMetadata& metadata)
+    -> protobuf::MetricsMetadata
+{
+    protobuf::MetricsMetadata result = metadata;
+    auto* references = result.mutable_references();
+
+    // The keys point into the string table, the strings of a repeated field
+    // do not move when it grows
+    std::unordered_map<std::string_view, uint32_t> indices;
+    auto index = [&](const std::string& value) -> uint32_t
+    {
+        auto it = indices.find(value);
+        if (it != indices.end())
+        {
+            return it->second;
+        }
+        auto next = static_cast<uint32_t>(result.strings_size());
+        std::string* string = result.add_strings();
+        *string = value;
+        indices.emplace(*string, next);
+        return next;
+    };
+
+    // The enum tables as value, name index and description index triples
+    std::map<std::vector<uint32_t>, uint32_t> tables;
+
+    for (auto& [name, metric] : sorted_metrics(result))
+    {
+        visit(*metric,
+              [&](auto& typed)
+              {
+                  references->Add(index(typed.description()));
+                  references->Add(typed.has_unit() ? index(typed.unit()) + 1
+                                                   : 0);
+                  typed.clear_description();
+                  typed.clear_unit();
+              });
+
+        if (!metric->has_enum8())
+        {
+            continue;
+        }
+
+        auto* values = metric->mutable_enum8()->mutable_values();
+        std::vector<uint32_t> keys;
+        keys.reserve(values->size());
+        for (const auto& [key, value] : *values)
+        {
+            keys.push_back(key);
+        }
+        std::sort(keys.begin(), keys.end());
+
+        std::vector<uint32_t> table;
+        table.reserve(keys.size() * 3);
+        for (uint32_t key : keys)
+        {
+            const auto& value = values->at(key);
+            table.push_back(key);
+            table.push_back(index(value.name()));
+            table.push_back(value.has_description()
+                                ? index(value.description()) + 1
+                                : 0);
+        }
+        values->clear();
+
+        // Enums of the same type share one table
+        auto number = static_cast<uint32_t>(tables.size());
+        auto [it, inserted] = tables.try_emplace(std::move(table), number);
+        if (!inserted)
+        {
+            references->Add(it->second + 1);
+            continue;
+        }
+        references->Add(0);
+        references->Add(static_cast<uint32_t>(keys.size()));
+        references->Add(it->first.begin(), it->first.end());
+    }
+    return result;
+}
+
+auto resolve_string_table(protobuf::MetricsMetadata& metadata) -> bool
+{
+    if (metadata.strings_size() == 0 && metadata.references_size() == 0)
+    {
+        return true;
+    }
+
+    std::vector<std::string_view> strings(metadata.strings().begin(),
+                                          metadata.strings().end());
+    const uint32_t* references = metadata.references().data();
+    const auto size = static_cast<std::size_t>(metadata.references_size());
+
+    // Check all references before changing any metric, so invalid
+    // references leave the metrics unchanged
+    auto entries = sorted_metrics(metadata);
+    std::vector<std::size_t> positions;
+    positions.reserve(entries.size());
+    std::size_t position = 0;
+    std::vector<std::size_t> tables;
+    for (const auto& [name, metric] : entries)
+    {
+        positions.push_back(position);
+        if (!skip_references(metric->type_case(), references, size,
+                             strings.size(), position, tables))
+        {
+            return false;
+        }
+    }
+    if (position != size)
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        resolve_references(*entries[i].second, strings, references,
+                           positions[i], tables);
+    }
+    metadata.clear_strings();
+    metadata.clear_references();
+    return true;
+}
+
+auto skip_references(protobuf::Metric::TypeCase type,
+                     const uint32_t* references, std::size_t size,
+                     std::size_t strings, std::size_t& position,
+                     std::vector<std::size_t>& tables) -> bool
+{
+    assert(position <= size);
+    if (type == protobuf::Metric::TYPE_NOT_SET || size - position < 2)
+    {
+        return false;
+    }
+    uint32_t description = references[position];
+    uint32_t unit = references[position + 1];
+    if (description >= strings || unit > strings)
+    {
+        return false;
+    }
+    position += 2;
+
+    if (type != protobuf::Metric::kEnum8)
+    {
+        return true;
+    }
+    if (position == size)
+    {
+        return false;
+    }
+    uint32_t table = references[position++];
+    if (table != 0)
+    {
+        return table <= tables.size();
+    }
+
+    if (position == size)
+    {
+        return false;
+    }
+    tables.push_back(position);
+    uint32_t count = references[position++];
+    if (count > (size - position) / 3)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; ++i, position += 3)
+    {
+        if (references[position + 1] >= strings ||
+            references[position + 2] > strings)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto resolve_references(protobuf::Metric& metric,
+                        const std::vector<std::string_view>& strings,
+                        const uint32_t* references, std::size_t position,
+                        const std::vector<std::size_t>& tables) -> void
+{
+    visit(metric,
+          [&](auto& typed)
+          {
+              auto description = strings[references[position]];
+              typed.set_description(description.data(), description.size());
+              uint32_t unit = references[position + 1];
+              if (unit != 0)
+              {
+                  auto value = strings[unit - 1];
+                  typed.set_unit(value.data(), value.size());
+              }
+          });
+
+    if (!metric.has_enum8())
+    {
+        return;
+    }
+
+    uint32_t table = references[position + 2];
+    std::size_t at = table == 0 ? position + 3 : tables[table - 1];
+    uint32_t count = references[at++];
+    auto* values = metric.mutable_enum8()->mutable_values();
+    for (uint32_t i = 0; i < count; ++i, at += 3)
+    {
+        auto& value = (*values)[references[at]];
+        auto name = strings[references[at + 1]];
+        value.set_name(name.data(), name.size());
+        uint32_t description = references[at + 2];
+        if (description != 0)
+        {
+            auto text = strings[description - 1];
+            value.set_description(text.data(), text.size());
+        }
+    }
+}
+}
+}
+}
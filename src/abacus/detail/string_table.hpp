@@ -0,0 +1,67 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "../protobuf/metrics.pb.h"
+#include "../version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+/// Moves the descriptions, units and enum values of the meta data into a
+/// shared string table. See MetricsMetadata in metrics.proto for the layout
+/// of the references.
+/// @param metadata The meta data with the strings stored in the metrics
+/// @return The meta data referencing the string table
+auto make_string_table(const protobuf::MetricsMetadata& metadata)
+    -> protobuf::MetricsMetadata;
+
+/// Stores the strings of the string table in the metrics again and removes
+/// the string table. Meta data without a string table is left unchanged, and
+/// with invalid references the metrics are left unchanged.
+/// @param metadata The meta data
+/// @return true if all references were valid
+[[nodiscard]] auto resolve_string_table(protobuf::MetricsMetadata& metadata)
+    -> bool;
+
+/// Checks the references of a metric and advances past them
+/// @param type The type of the metric
+/// @param references The references of the meta data
+/// @param size The number of references
+/// @param strings The number of strings in the string table
+/// @param position The position of the references of the metric, advanced
+///        to the references of the next metric
+/// @param tables The positions of the enum tables seen so far, new enum
+///        tables are appended
+/// @return true if the references are valid
+[[nodiscard]] auto skip_references(protobuf::Metric::TypeCase type,
+                                   const uint32_t* references,
+                                   std::size_t size, std::size_t strings,
+                                   std::size_t& position,
+                                   std::vector<std::size_t>& tables) -> bool;
+
+/// Stores the referenced strings in a metric. The references must have been
+/// checked with skip_references().
+/// @param metric The metric without strings
+/// @param strings The string table
+/// @param references The references of the meta data
+/// @param position The position of the references of the metric
+/// @param tables The positions of the enum tables
+auto resolve_references(protobuf::Metric& metric,
+                        const std::vector<std::string_view>& strings,
+                        const uint32_t* references, std::size_t position,
+                        const std::vector<std::size_t>& tables) -> void;
+}
+}
+}
@@ -16,6 +16,8 @@
 
 #include "../view.hpp"
 
+#include <cassert>
+
 #include <bourne/json.hpp>
 #include <google/protobuf/util/json_util.h>
 
@@ -27,146 +29,179 @@ inline namespace STEINWURF_ABACUS_VERSION
 {
 namespace detail
 {
-auto to_json(const view& view, bool minimal) -> bourne::json
+namespace
 {
-    auto json = bourne::json::object();
-    if (minimal)
+// Adds the value of a metric to a JSON object, unset metrics are null
+static inline void add_value(const view& view, std::size_t id,
+                             bourne::json& json)
+{
+    const auto& metric = view.metric(id);
+    const std::string name(view.metric_name(id));
+    switch (metric.type_case())
+    {
+    case protobuf::Metric::kConstant:
+    {
+        switch (metric.constant().value_case())
+        {
+        case protobuf::Constant::kUint64:
+            json[name] = metric.constant().uint64();
+            break;
+        case protobuf::Constant::kInt64:
+            json[name] = metric.constant().int64();
+            break;
+        case protobuf::Constant::kFloat64:
+            json[name] = metric.constant().float64();
+            break;
+        case protobuf::Constant::kBoolean:
+            json[name] = metric.constant().boolean();
+            break;
+        case protobuf::Constant::kString:
+            json[name] = metric.constant().string();
+            break;
+        case protobuf::Constant::VALUE_NOT_SET:
+            break;
+        }
+        break;
+    }
+    case protobuf::Metric::kUint64:
     {
-        for (const auto& [name, metric] : view.metadata().metrics())
+        auto v = view.value<abacus::uint64>(id);
+        if (v.has_value())
         {
-            switch (metric.type_case())
-            {
-            case protobuf::Metric::kConstant:
-            {
-                switch (metric.constant().value_case())
-                {
-                case protobuf::Constant::kUint64:
-                    json[name] = metric.constant().uint64();
-                    break;
-                case protobuf::Constant::kInt64:
-                    json[name] = metric.constant().int64();
-                    break;
-                case protobuf::Constant::kFloat64:
-                    json[name] = metric.constant().float64();
-                    break;
-                case protobuf::Constant::kBoolean:
-                    json[name] = metric.constant().boolean();
-                    break;
-                case protobuf::Constant::kString:
-                    json[name] = metric.constant().string();
-                    break;
-                case protobuf::Constant::VALUE_NOT_SET:
-                    break;
-                }
-                break;
-            }
-            case protobuf::Metric::kUint64:
-            {
-                auto v = view.value<abacus::uint64>(name);
-                if (v.has_value())
-                {
-                    json[name] = v.value();
-                }
-                break;
-            }
-            case protobuf::Metric::kInt64:
-            {
-                auto v = view.value<abacus::int64>(name);
-                if (v.has_value())
-                {
-                    json[name] = v.value();
-                }
-                break;
-            }
-            case protobuf::Metric::kUint32:
-            {
-                auto v = view.value<abacus::uint32>(name);
-                if (v.has_value())
-                {
-                    json[name] = v.value();
-                }
-                break;
-            }
-            case protobuf::Metric::kInt32:
-            {
-                auto v = view.value<abacus::int32>(name);
-                if (v.has_value())
-                {
-                    json[name] = v.value();
-                }
-                break;
-            }
-            case protobuf::Metric::kFloat64:
-            {
-                auto v = view.value<abacus::float64>(name);
-                if (v.has_value())
-                {
-                    json[name] = v.value();
-                }
-                break;
-            }
-            case protobuf::Metric::kFloat32:
-            {
-                auto v = view.value<abacus::float32>(name);
-                if (v.has_value())
-                {
-                    json[name] = v.value();
-                }
-                break;
-            }
-            case protobuf::Metric::kBoolean:
-            {
-                auto v = view.value<abacus::boolean>(name);
-                if (v.has_value())
-                {
-                    json[name] = v.value();
-                }
-                break;
-            }
-            case protobuf::Metric::kEnum8:
-            {
-                auto v = view.value<abacus::enum8>(name);
-                if (v.has_value())
-                {
-                    json[name] = v.value();
-                }
-                break;
-            }
-            default:
-                break;
-            }
-            if (!json.has_key(name))
-            {
-                json[name] = nullptr;
-            }
+            json[name] = v.value();
         }
+        break;
     }
-    else
+    case protobuf::Metric::kInt64:
     {
-        std::string metadata_json;
-        google::protobuf::util::JsonPrintOptions options;
-        options.always_print_fields_with_no_presence = true;
-        auto status = google::protobuf::util::MessageToJsonString(
-            view.metadata(), &metadata_json, options);
-        if (!status.ok())
+        auto v = view.value<abacus::int64>(id);
+        if (v.has_value())
         {
-            return json;
+            json[name] = v.value();
         }
-        json = bourne::json::parse(metadata_json);
-        if (json.has_key("metrics"))
+        break;
+    }
+    case protobuf::Metric::kUint32:
+    {
+        auto v = view.value<abacus::uint32>(id);
+        if (v.has_value())
         {
-            json = json["metrics"];
+            json[name] = v.value();
         }
-        // Call the minimal version recursively to get the values
-        auto values = to_json(view, true);
-        for (const auto& [key, value] : values.object_range())
+        break;
+    }
+    case protobuf::Metric::kInt32:
+    {
+        auto v = view.value<abacus::int32>(id);
+        if (v.has_value())
         {
-            json[key]["value"] = value;
+            json[name] = v.value();
         }
+        break;
+    }
+    case protobuf::Metric::kFloat64:
+    {
+        auto v = view.value<abacus::float64>(id);
+        if (v.has_value())
+        {
+            json[name] = v.value();
+        }
+        break;
+    }
+    case protobuf::Metric::kFloat32:
+    {
+        auto v = view.value<abacus::float32>(id);
+        if (v.has_value())
+        {
+            json[name] = v.value();
+        }
+        break;
+    }
+    case protobuf::Metric::kBoolean:
+    {
+        auto v = view.value<abacus::boolean>(id);
+        if (v.has_value())
+        {
+            json[name] = v.value();
+        }
+        break;
+    }
+    case protobuf::Metric::kEnum8:
+    {
+        auto v = view.value<abacus::enum8>(id);
+        if (v.has_value())
+        {
+            json[name] = v.value();
+        }
+        break;
+    }
+    default:
+        break;
     }
+    if (!json.has_key(name))
+    {
+        json[name] = nullptr;
+    }
+}
 
+// Adds the values of a metrics JSON object to the metrics meta data JSON
+static inline auto
+add_metadata(const protobuf::MetricsMetadata& metadata,
+             const bourne::json& values) -> bourne::json
+{
+    std::string metadata_json;
+    google::protobuf::util::JsonPrintOptions options;
+    options.always_print_fields_with_no_presence = true;
+    auto status = google::protobuf::util::MessageToJsonString(
+        metadata, &metadata_json, options);
+    if (!status.ok())
+    {
+        return bourne::json::object();
+    }
+    auto json = bourne::json::parse(metadata_json);
+    if (json.has_key("metrics"))
+    {
+        json = json["metrics"];
+    }
+    for (const auto& [key, value] : values.object_range())
+    {
+        json[key]["value"] = value;
+    }
     return json;
 }
 }
+
+auto to_json(const view& view, bool minimal) -> bourne::json
+{
+    auto json = bourne::json::object();
+    for (std::size_t id = 0; id < view.count(); ++id)
+    {
+        add_value(view, id, json);
+    }
+    if (minimal)
+    {
+        return json;
+    }
+    return add_metadata(view.metadata(), json);
+}
+
+auto to_json(const view& view, const selection& selection, bool minimal)
+    -> bourne::json
+{
+    assert(view.metadata().sync_value() == selection.source_sync_value());
+
+    // Only the selected metrics are visited
+    auto json = bourne::json::object();
+    for (auto id : selection.ids())
+    {
+        add_value(view, id, json);
+    }
+    if (minimal)
+    {
+        return json;
+    }
+    return add_metadata(selection.metadata(), json);
+}
+}
 }
 }
@@ -7,6 +7,7 @@
 
 #include <bourne/json.hpp>
 
+#include "../selection.hpp"
 #include "../view.hpp"
 
 #include "../version.hpp"
@@ -22,6 +23,14 @@ namespace detail
 /// values.
 /// @return a JSON-formatted string of a metrics views data.
 auto to_json(const view& view, bool minimal) -> bourne::json;
+
+/// @param view A view with access to metrics-data.
+/// @param selection The selected metrics, compiled against the view.
+/// @param minimal If true, the JSON will a simple map between metric names and
+/// values.
+/// @return a JSON-formatted string of the selected metrics of a views data.
+auto to_json(const view& view, const selection& selection, bool minimal)
+    -> bourne::json;
 }
 }
 }
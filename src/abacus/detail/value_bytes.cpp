@@ -0,0 +1,81 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "value_bytes.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+namespace
+{
+static inline std::size_t offset(const protobuf::Metric& metric)
+{
+    switch (metric.type_case())
+    {
+    case protobuf::Metric::kUint64:
+        return metric.uint64().offset();
+    case protobuf::Metric::kInt64:
+        return metric.int64().offset();
+    case protobuf::Metric::kUint32:
+        return metric.uint32().offset();
+    case protobuf::Metric::kInt32:
+        return metric.int32().offset();
+    case protobuf::Metric::kFloat64:
+        return metric.float64().offset();
+    case protobuf::Metric::kFloat32:
+        return metric.float32().offset();
+    case protobuf::Metric::kBoolean:
+        return metric.boolean().offset();
+    case protobuf::Metric::kEnum8:
+        return metric.enum8().offset();
+    default:
+        return 0;
+    }
+}
+}
+
+auto value_size(protobuf::Metric::TypeCase type) -> std::size_t
+{
+    switch (type)
+    {
+    case protobuf::Metric::kUint64:
+    case protobuf::Metric::kInt64:
+    case protobuf::Metric::kFloat64:
+        return 8;
+    case protobuf::Metric::kUint32:
+    case protobuf::Metric::kInt32:
+    case protobuf::Metric::kFloat32:
+        return 4;
+    case protobuf::Metric::kBoolean:
+    case protobuf::Metric::kEnum8:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+auto value_bytes(const protobuf::MetricsMetadata& metadata) -> std::size_t
+{
+    // The first bytes are the sync value
+    std::size_t bytes = sizeof(uint32_t);
+    for (const auto& [name, metric] : metadata.metrics())
+    {
+        const std::size_t size = value_size(metric.type_case());
+        if (size != 0)
+        {
+            bytes = std::max(bytes, offset(metric) + 1 + size);
+        }
+    }
+    return bytes;
+}
+}
+}
+}
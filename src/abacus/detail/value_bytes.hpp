@@ -0,0 +1,31 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+
+#include "../protobuf/metrics.pb.h"
+#include "../version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+/// @param type The type of a metric
+/// @return The size of the value of a metric of the type, without the byte
+///         which tells whether the metric is set. Constants have no value
+///         and have size 0.
+auto value_size(protobuf::Metric::TypeCase type) -> std::size_t;
+
+/// Computes the size of the value data from the offsets of the metrics
+/// @param metadata The meta data
+/// @return The size of the value data, at least the size of the sync value
+auto value_bytes(const protobuf::MetricsMetadata& metadata) -> std::size_t;
+}
+}
+}
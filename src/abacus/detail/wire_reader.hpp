@@ -0,0 +1,202 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "../version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+/// Reads the protobuf wire format without materializing messages. All reads
+/// are bounds checked and return false on malformed input.
+class wire_reader
+{
+public:
+    /// The varint wire type
+    static constexpr uint32_t varint = 0;
+
+    /// The 64-bit wire type
+    static constexpr uint32_t fixed64 = 1;
+
+    /// The length delimited wire type
+    static constexpr uint32_t length_delimited = 2;
+
+    /// The 32-bit wire type
+    static constexpr uint32_t fixed32 = 5;
+
+public:
+    /// Constructor
+    /// @param data The encoded message
+    wire_reader(std::string_view data) :
+        m_data(reinterpret_cast<const uint8_t*>(data.data())),
+        m_end(m_data + data.size())
+    {
+    }
+
+    /// @return true if the whole message has been read
+    auto at_end() const -> bool
+    {
+        return m_data == m_end;
+    }
+
+    /// Reads a varint
+    /// @param value The value read
+    /// @return true if a value was read
+    auto read_varint(uint64_t& value) -> bool
+    {
+        value = 0;
+        for (uint32_t shift = 0; shift < 64 && m_data != m_end; shift += 7)
+        {
+            uint8_t byte = *m_data++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Reads the tag of the next field
+    /// @param field The field number
+    /// @param wire_type The wire type of the field
+    /// @return true if a tag was read
+    auto read_tag(uint32_t& field, uint32_t& wire_type) -> bool
+    {
+        uint64_t tag;
+        if (!read_varint(tag) || (tag >> 3) == 0 || (tag >> 3) > UINT32_MAX)
+        {
+            return false;
+        }
+        field = static_cast<uint32_t>(tag >> 3);
+        wire_type = static_cast<uint32_t>(tag & 0x7);
+        return true;
+    }
+
+    /// Reads a length delimited field
+    /// @param bytes The bytes of the field, pointing into the message
+    /// @return true if the field was read
+    auto read_bytes(std::string_view& bytes) -> bool
+    {
+        uint64_t size;
+        if (!read_varint(size) ||
+            size > static_cast<uint64_t>(m_end - m_data))
+        {
+            return false;
+        }
+        bytes = std::string_view(reinterpret_cast<const char*>(m_data),
+                                 static_cast<std::size_t>(size));
+        m_data += size;
+        return true;
+    }
+
+    /// Reads a 32-bit field
+    /// @param value The value read
+    /// @return true if the value was read
+    auto read_fixed32(uint32_t& value) -> bool
+    {
+        if (m_end - m_data < 4)
+        {
+            return false;
+        }
+        // The wire format is little endian
+        value = static_cast<uint32_t>(m_data[0]) |
+                static_cast<uint32_t>(m_data[1]) << 8 |
+                static_cast<uint32_t>(m_data[2]) << 16 |
+                static_cast<uint32_t>(m_data[3]) << 24;
+        m_data += 4;
+        return true;
+    }
+
+    /// Skips the value of a field
+    /// @param wire_type The wire type of the field
+    /// @return true if the value was skipped
+    auto skip(uint32_t wire_type) -> bool
+    {
+        switch (wire_type)
+        {
+        case varint:
+        {
+            uint64_t value;
+            return read_varint(value);
+        }
+        case fixed64:
+            return advance(8);
+        case length_delimited:
+        {
+            std::string_view bytes;
+            return read_bytes(bytes);
+        }
+        case fixed32:
+            return advance(4);
+        default:
+            // Groups are not used by abacus
+            return false;
+        }
+    }
+
+private:
+    auto advance(std::size_t bytes) -> bool
+    {
+        if (static_cast<std::size_t>(m_end - m_data) < bytes)
+        {
+            return false;
+        }
+        m_data += bytes;
+        return true;
+    }
+
+private:
+    /// The next byte to read
+    const uint8_t* m_data;
+
+    /// The end of the message
+    const uint8_t* m_end;
+};
+
+/// Finds the last occurrence of a length delimited field in a message, as
+/// the last occurrence wins when parsing
+/// @param message The encoded message
+/// @param field The field number
+/// @param bytes The bytes of the field
+/// @return true if the field was found
+inline auto find_bytes(std::string_view message, uint32_t field,
+                       std::string_view& bytes) -> bool
+{
+    wire_reader reader(message);
+    bool found = false;
+    while (!reader.at_end())
+    {
+        uint32_t number;
+        uint32_t wire_type;
+        if (!reader.read_tag(number, wire_type))
+        {
+            return false;
+        }
+        if (number == field && wire_type == wire_reader::length_delimited)
+        {
+            if (!reader.read_bytes(bytes))
+            {
+                return false;
+            }
+            found = true;
+        }
+        else if (!reader.skip(wire_type))
+        {
+            return false;
+        }
+    }
+    return found;
+}
+}
+}
+}
@@ -0,0 +1,201 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "zero_run.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace detail
+{
+namespace
+{
+// The size of a word
+static constexpr std::size_t word_bytes = 8;
+
+// The maximum number of words in a run
+static constexpr std::size_t max_run = 255;
+
+static inline auto zeros(const uint8_t* word) -> std::size_t
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < word_bytes; ++i)
+    {
+        count += word[i] == 0;
+    }
+    return count;
+}
+}
+
+auto zero_run_bound(std::size_t bytes) -> std::size_t
+{
+    // A word with all bytes set takes a tag, the bytes and a run count
+    return (bytes + word_bytes - 1) / word_bytes * (word_bytes + 2);
+}
+
+auto zero_run_compress(const uint8_t* data, std::size_t bytes,
+                       uint8_t* compressed) -> std::size_t
+{
+    // The last word is padded with zeros
+    const std::size_t full = bytes / word_bytes;
+    const std::size_t words = (bytes + word_bytes - 1) / word_bytes;
+    uint8_t tail[word_bytes] = {};
+    if (full != words)
+    {
+        std::memcpy(tail, data + full * word_bytes, bytes - full * word_bytes);
+    }
+    auto word = [&](std::size_t i) -> const uint8_t*
+    { return i < full ? data + i * word_bytes : tail; };
+
+    uint8_t* out = compressed;
+    std::size_t i = 0;
+    while (i < words)
+    {
+        const uint8_t* current = word(i++);
+        uint8_t* tag = out++;
+        uint8_t bits = 0;
+        for (std::size_t b = 0; b < word_bytes; ++b)
+        {
+            if (current[b] != 0)
+            {
+                bits |= static_cast<uint8_t>(1U << b);
+                *out++ = current[b];
+            }
+        }
+        *tag = bits;
+
+        if (bits == 0x00)
+        {
+            // The following zero words
+            std::size_t run = 0;
+            while (i < words && run < max_run && zeros(word(i)) == word_bytes)
+            {
+                ++run;
+                ++i;
+            }
+            *out++ = static_cast<uint8_t>(run);
+        }
+        else if (bits == 0xFF)
+        {
+            // The following words are copied as is while packing them
+            // would save at most one byte
+            std::size_t run = 0;
+            while (i + run < words && run < max_run &&
+                   zeros(word(i + run)) < 2)
+            {
+                ++run;
+            }
+            *out++ = static_cast<uint8_t>(run);
+            for (; run > 0; --run, ++i)
+            {
+                std::memcpy(out, word(i), word_bytes);
+                out += word_bytes;
+            }
+        }
+    }
+    return static_cast<std::size_t>(out - compressed);
+}
+
+auto zero_run_decompress(const uint8_t* compressed,
+                         std::size_t compressed_bytes, uint8_t* data,
+                         std::size_t bytes) -> bool
+{
+    const uint8_t* in = compressed;
+    const uint8_t* end = compressed + compressed_bytes;
+    std::size_t position = 0;
+
+    // Only the bytes of the last word which are part of the data are written
+    auto words = [&]() -> std::size_t
+    { return (bytes - position + word_bytes - 1) / word_bytes; };
+
+    while (position < bytes)
+    {
+        if (in == end)
+        {
+            return false;
+        }
+        const uint8_t bits = *in++;
+
+        // The last word is written to a copy if only a part of it is data
+        uint8_t tail[word_bytes];
+        const bool is_tail = bytes - position < word_bytes;
+        uint8_t* word = is_tail ? tail : data + position;
+        std::size_t set = 0;
+        if (static_cast<std::size_t>(end - in) >= word_bytes)
+        {
+            // Without branches, as the bits of the values are unpredictable.
+            // A byte is always read, and masked out if it is not set.
+            for (std::size_t b = 0; b < word_bytes; ++b)
+            {
+                const uint8_t is_set = (bits >> b) & 1U;
+                word[b] = in[set] & static_cast<uint8_t>(0U - is_set);
+                set += is_set;
+            }
+        }
+        else
+        {
+            if (static_cast<std::size_t>(end - in) <
+                std::bitset<8>(bits).count())
+            {
+                return false;
+            }
+            for (std::size_t b = 0; b < word_bytes; ++b)
+            {
+                const bool is_set = (bits >> b) & 1U;
+                word[b] = is_set ? in[set] : 0;
+                set += is_set;
+            }
+        }
+        in += set;
+        if (is_tail)
+        {
+            std::memcpy(data + position, tail, bytes - position);
+            position = bytes;
+        }
+        else
+        {
+            position += word_bytes;
+        }
+
+        if (bits != 0x00 && bits != 0xFF)
+        {
+            continue;
+        }
+        if (in == end)
+        {
+            return false;
+        }
+        const std::size_t run = *in++;
+        if (run > words())
+        {
+            return false;
+        }
+        const std::size_t run_bytes =
+            std::min(run * word_bytes, bytes - position);
+        if (bits == 0x00)
+        {
+            std::memset(data + position, 0, run_bytes);
+        }
+        else
+        {
+            if (static_cast<std::size_t>(end - in) < run * word_bytes)
+            {
+                return false;
+            }
+            std::memcpy(data + position, in, run_bytes);
+            in += run * word_bytes;
+        }
+        position += run_bytes;
+    }
+    return in == end;
+}
+}
+}
+}
@@ -9,8 +9,10 @@
 #include <cstdint>
 #include <cstring>
 #include <map>
+#include <optional>
 #include <string>
 
+#include "aggregation.hpp"
 #include "description.hpp"
 #include "unit.hpp"
 
@@ -61,6 +63,10 @@ struct enum8
 
     /// The unit of the metric
     abacus::unit unit{};
+
+    /// The aggregation of the metric, either min or max. If not set the
+    /// metric is not aggregated.
+    std::optional<abacus::aggregation> aggregation{};
 };
 }
 }
@@ -0,0 +1,481 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "exporter.hpp"
+
+#include "detail/append_json.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define ABACUS_UNIX_SOCKETS 1
+#endif
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace
+{
+// The types of the records written by the built-in sinks
+static constexpr uint8_t metadata_record = 0;
+static constexpr uint8_t value_data_record = 1;
+
+// The size of the header of a record
+static constexpr std::size_t record_header_bytes = 1 + 4 + 8 + 4;
+
+static inline auto put_little_endian(uint64_t value, std::size_t bytes,
+                                     uint8_t* out) -> void
+{
+    for (std::size_t i = 0; i < bytes; ++i)
+    {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+static inline auto append_record(uint8_t type, const exporter::snapshot& s,
+                                 const std::vector<uint8_t>& payload,
+                                 std::vector<uint8_t>& out) -> void
+{
+    const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          s.time.time_since_epoch())
+                          .count();
+    const std::size_t first = out.size();
+    out.resize(first + record_header_bytes + payload.size());
+    uint8_t* header = out.data() + first;
+    header[0] = type;
+    put_little_endian(s.source, 4, header + 1);
+    put_little_endian(static_cast<uint64_t>(time), 8, header + 5);
+    put_little_endian(payload.size(), 4, header + 13);
+    std::copy(payload.begin(), payload.end(), header + record_header_bytes);
+}
+
+// The state of a sink writing a byte stream, i.e. the sync values of the
+// sources whose meta data is written
+struct stream_encoder
+{
+    // Encodes a snapshot in the format described by exporter::file_sink()
+    auto encode(const exporter::snapshot& s) -> const std::vector<uint8_t>&
+    {
+        buffer.clear();
+        if (s.encoding != exporter::encoding::value_data)
+        {
+            // The JSON is on one line
+            buffer.assign(s.data.begin(), s.data.end());
+            buffer.push_back('\n');
+            return buffer;
+        }
+        auto [it, inserted] = sync_values.try_emplace(s.source, s.sync_value);
+        if (inserted || it->second != s.sync_value)
+        {
+            it->second = s.sync_value;
+            append_record(metadata_record, s, *s.metadata, buffer);
+        }
+        append_record(value_data_record, s, s.data, buffer);
+        return buffer;
+    }
+
+    std::map<std::size_t, uint32_t> sync_values;
+    std::vector<uint8_t> buffer;
+};
+}
+
+exporter::exporter(clock::duration interval, std::size_t capacity,
+                   exporter::encoding encoding, exporter::overflow overflow) :
+    m_interval(interval), m_capacity(capacity), m_encoding(encoding),
+    m_overflow(overflow), m_queue(capacity)
+{
+    assert(m_interval > clock::duration::zero());
+    assert(m_capacity > 0);
+}
+
+exporter::~exporter()
+{
+    stop();
+}
+
+auto exporter::add_sink(sink sink) -> void
+{
+    assert(sink);
+    assert(!is_running());
+    m_sinks.push_back(std::move(sink));
+}
+
+auto exporter::add_flush(std::function<void()> flush) -> void
+{
+    assert(flush);
+    assert(!is_running());
+    m_flushes.push_back(std::move(flush));
+}
+
+auto exporter::add(const metrics& metrics) -> std::size_t
+{
+    source source{0, &metrics,
+                  std::make_shared<const std::vector<uint8_t>>(
+                      metrics.metadata_data(),
+                      metrics.metadata_data() + metrics.metadata_bytes()),
+                  {}};
+    if (m_encoding != encoding::value_data)
+    {
+        bool valid = source.view.set_metadata(metrics.metadata());
+        assert(valid);
+        (void)valid;
+    }
+
+    std::lock_guard<std::mutex> lock(m_sources_mutex);
+    source.id = m_next_id++;
+    m_sources.push_back(std::move(source));
+    return m_sources.back().id;
+}
+
+auto exporter::remove(std::size_t source) -> void
+{
+    std::lock_guard<std::mutex> lock(m_sources_mutex);
+    auto it = std::find_if(m_sources.begin(), m_sources.end(),
+                           [source](const auto& s) { return s.id == source; });
+    assert(it != m_sources.end());
+    m_sources.erase(it);
+}
+
+auto exporter::start() -> void
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    assert(!m_running);
+    m_running = true;
+    m_delivery = std::thread([this] { run_delivery(); });
+    m_sampler = std::thread([this] { run_sampler(); });
+}
+
+auto exporter::stop() -> void
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+        {
+            return;
+        }
+        m_stopping = true;
+    }
+    m_wake_sampler.notify_all();
+    m_wake_delivery.notify_all();
+    m_sampler.join();
+    m_delivery.join();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running = false;
+    m_stopping = false;
+}
+
+auto exporter::is_running() const -> bool
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_running;
+}
+
+auto exporter::flush() -> void
+{
+    sample();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_running)
+    {
+        // Snapshots taken later may keep the queue from getting empty, so
+        // only the snapshots taken until now are waited for
+        const uint64_t end = m_next_sequence;
+        m_idle.wait(lock,
+                    [this, end]
+                    {
+                        if (m_delivering && m_delivering_sequence < end)
+                        {
+                            return false;
+                        }
+                        for (std::size_t i = 0; i < m_queued; ++i)
+                        {
+                            if (queued(i)->sequence < end)
+                            {
+                                return false;
+                            }
+                        }
+                        return true;
+                    });
+        return;
+    }
+    while (m_queued > 0)
+    {
+        deliver_one(lock);
+    }
+}
+
+auto exporter::delivered() const -> uint64_t
+{
+    return m_delivered.load(std::memory_order_relaxed);
+}
+
+auto exporter::dropped() const -> uint64_t
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+auto exporter::sample() -> void
+{
+    std::lock_guard<std::mutex> sources_lock(m_sources_mutex);
+    for (const auto& flush : m_flushes)
+    {
+        flush();
+    }
+    for (auto& source : m_sources)
+    {
+        std::unique_ptr<snapshot> s;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_free.empty())
+            {
+                s = std::move(m_free.back());
+                m_free.pop_back();
+            }
+        }
+        if (!s)
+        {
+            s = std::make_unique<snapshot>();
+        }
+
+        // The copy is the only access to the memory of the metrics
+        const metrics& metrics = *source.metrics;
+        s->source = source.id;
+        s->time = wall_clock::now();
+        s->encoding = m_encoding;
+        s->metadata = source.metadata;
+        s->data.assign(metrics.value_data(),
+                       metrics.value_data() + metrics.value_bytes());
+        std::memcpy(&s->sync_value, s->data.data(), sizeof(s->sync_value));
+        if (m_encoding != encoding::value_data)
+        {
+            bool valid =
+                source.view.set_value_data(s->data.data(), s->data.size());
+            assert(valid);
+            (void)valid;
+            m_json.clear();
+            detail::append_json(source.view,
+                                m_encoding == encoding::minimal_json, m_json);
+            s->data.assign(m_json.begin(), m_json.end());
+        }
+        push(std::move(s));
+    }
+}
+
+auto exporter::push(std::unique_ptr<snapshot> s) -> void
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        s->sequence = m_next_sequence++;
+        if (m_queued == m_capacity)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            switch (m_overflow)
+            {
+            case overflow::drop_newest:
+                m_free.push_back(std::move(s));
+                return;
+            case overflow::coalesce:
+            {
+                // The newest queued snapshot of the metrics is replaced in
+                // its place, so the snapshots stay in the order of time
+                for (std::size_t i = m_queued; i-- > 0;)
+                {
+                    if (queued(i)->source == s->source)
+                    {
+                        std::swap(queued(i), s);
+                        m_free.push_back(std::move(s));
+                        m_idle.notify_all();
+                        return;
+                    }
+                }
+                break;
+            }
+            case overflow::drop_oldest:
+                break;
+            }
+            m_free.push_back(std::move(queued(0)));
+            m_first = m_first + 1 == m_capacity ? 0 : m_first + 1;
+            --m_queued;
+            m_idle.notify_all();
+        }
+        queued(m_queued) = std::move(s);
+        ++m_queued;
+    }
+    m_wake_delivery.notify_one();
+}
+
+auto exporter::deliver_one(std::unique_lock<std::mutex>& lock) -> void
+{
+    assert(m_queued > 0);
+    std::unique_ptr<snapshot> s = std::move(queued(0));
+    m_first = m_first + 1 == m_capacity ? 0 : m_first + 1;
+    --m_queued;
+    m_delivering = true;
+    m_delivering_sequence = s->sequence;
+
+    // The sinks are called without the lock, so a slow sink does not block
+    // the sampling
+    lock.unlock();
+    for (const auto& sink : m_sinks)
+    {
+        sink(*s);
+    }
+    lock.lock();
+
+    m_free.push_back(std::move(s));
+    m_delivering = false;
+    m_delivered.fetch_add(1, std::memory_order_relaxed);
+    m_idle.notify_all();
+}
+
+auto exporter::queued(std::size_t index) -> std::unique_ptr<snapshot>&
+{
+    std::size_t position = m_first + index;
+    return m_queue[position < m_capacity ? position : position - m_capacity];
+}
+
+auto exporter::run_sampler() -> void
+{
+    auto next = clock::now() + m_interval;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_wake_sampler.wait_until(lock, next,
+                                      [this] { return m_stopping; }))
+    {
+        lock.unlock();
+        sample();
+        lock.lock();
+
+        // Intervals missed by a late wake up are skipped
+        next += m_interval;
+        const auto now = clock::now();
+        if (next <= now)
+        {
+            next = now + m_interval;
+        }
+    }
+}
+
+auto exporter::run_delivery() -> void
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_wake_delivery.wait(lock,
+                             [this] { return m_queued > 0 || m_stopping; });
+        if (m_queued == 0)
+        {
+            return;
+        }
+        deliver_one(lock);
+    }
+}
+
+auto exporter::file_sink(const std::string& path) -> sink
+{
+    std::shared_ptr<std::FILE> file(std::fopen(path.c_str(), "ab"),
+                                    [](std::FILE* f)
+                                    {
+                                        if (f != nullptr)
+                                        {
+                                            std::fclose(f);
+                                        }
+                                    });
+    if (file == nullptr)
+    {
+        return {};
+    }
+    auto encoder = std::make_shared<stream_encoder>();
+    return [file, encoder](const snapshot& s)
+    {
+        const auto& bytes = encoder->encode(s);
+        std::fwrite(bytes.data(), 1, bytes.size(), file.get());
+        std::fflush(file.get());
+    };
+}
+
+auto exporter::unix_socket_sink(const std::string& path) -> sink
+{
+#if defined(ABACUS_UNIX_SOCKETS)
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        return {};
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    struct connection
+    {
+        ~connection()
+        {
+            close();
+        }
+
+        auto close() -> void
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+
+        int fd = -1;
+        stream_encoder encoder;
+    };
+    auto state = std::make_shared<connection>();
+
+    return [address, state](const snapshot& s)
+    {
+        if (state->fd < 0)
+        {
+            state->fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (state->fd < 0)
+            {
+                return;
+            }
+            const auto* name = reinterpret_cast<const sockaddr*>(&address);
+            if (::connect(state->fd, name, sizeof(address)) != 0)
+            {
+                state->close();
+                return;
+            }
+            // The meta data is written again on a new connection
+            state->encoder.sync_values.clear();
+        }
+
+        int flags = 0;
+#if defined(MSG_NOSIGNAL)
+        flags = MSG_NOSIGNAL;
+#endif
+        const auto& bytes = state->encoder.encode(s);
+        std::size_t sent = 0;
+        while (sent < bytes.size())
+        {
+            auto result = ::send(state->fd, bytes.data() + sent,
+                                 bytes.size() - sent, flags);
+            if (result <= 0)
+            {
+                state->close();
+                return;
+            }
+            sent += static_cast<std::size_t>(result);
+        }
+    };
+#else
+    (void)path;
+    return {};
+#endif
+}
+}
+}
@@ -0,0 +1,247 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics.hpp"
+#include "version.hpp"
+#include "view.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// Exports snapshots of metrics from a background thread.
+///
+/// Metrics are registered with add(). Once started, a sampling thread copies
+/// the value data of every registered metrics at a fixed interval, encodes
+/// the copies and puts them in a bounded queue. A delivery thread takes the
+/// snapshots from the queue and hands them to the sinks. A slow sink never
+/// delays the sampling, when the queue is full the overflow policy decides
+/// which snapshots are dropped.
+///
+/// The application threads only pay for updating their metrics. The value
+/// data is copied without synchronizing with the application, like a reader
+/// of metrics in shared memory would. A snapshot is therefore not consistent
+/// across values, and a value updated during the copy may be read partially
+/// updated. Applications needing consistent snapshots call flush() from the
+/// thread updating the metrics instead of starting the exporter. Metrics
+/// which buffer their values, e.g. abacus::buffered_counter, are written to
+/// the value data by the callbacks added with add_flush().
+///
+/// The snapshot buffers are recycled, so once they have grown to size value
+/// data and minimal JSON snapshots are taken without allocating. Full JSON
+/// snapshots build a JSON document per snapshot.
+///
+/// Registered metrics must outlive their registration, i.e. they must be
+/// removed with remove() or the exporter stopped before they are destroyed.
+/// The meta data of registered metrics must not change.
+class exporter
+{
+public:
+    /// The clock of the sampling interval
+    using clock = std::chrono::steady_clock;
+
+    /// The clock of the snapshot times, the wall clock like abacus::recorder
+    using wall_clock = std::chrono::system_clock;
+
+    /// The encodings of the exported snapshots
+    enum class encoding
+    {
+        /// A copy of the value data
+        value_data,
+        /// The values as JSON on one line, see abacus::to_json()
+        json,
+        /// The values as minimal JSON on one line, see abacus::to_json()
+        minimal_json
+    };
+
+    /// The policies for snapshots taken while the queue is full
+    enum class overflow
+    {
+        /// The new snapshot is dropped
+        drop_newest,
+        /// The oldest queued snapshot is dropped
+        drop_oldest,
+        /// The new snapshot replaces the queued snapshot of the same
+        /// metrics, or the oldest queued snapshot if there is none
+        coalesce
+    };
+
+    /// An encoded snapshot of registered metrics
+    struct snapshot
+    {
+        /// The identifier of the metrics returned by add()
+        std::size_t source = 0;
+
+        /// The number of the snapshot, counted from zero by the exporter.
+        /// Gaps in the numbers of the delivered snapshots are dropped
+        /// snapshots.
+        uint64_t sequence = 0;
+
+        /// The wall clock time the snapshot was taken
+        wall_clock::time_point time;
+
+        /// The encoding of the data
+        exporter::encoding encoding = exporter::encoding::value_data;
+
+        /// The sync value of the metrics
+        uint32_t sync_value = 0;
+
+        /// The serialized meta data of the metrics
+        std::shared_ptr<const std::vector<uint8_t>> metadata;
+
+        /// The encoded snapshot
+        std::vector<uint8_t> data;
+    };
+
+    /// A sink receiving the snapshots on the delivery thread. A sink must
+    /// not throw and must not call the exporter.
+    using sink = std::function<void(const snapshot&)>;
+
+public:
+    /// Constructor
+    /// @param interval The time between two snapshots of the metrics
+    /// @param capacity The maximum number of queued snapshots, at least one
+    /// @param encoding The encoding of the snapshots
+    /// @param overflow The policy for snapshots taken while the queue is
+    ///        full
+    exporter(clock::duration interval, std::size_t capacity,
+             exporter::encoding encoding = exporter::encoding::value_data,
+             exporter::overflow overflow = exporter::overflow::drop_oldest);
+
+    /// Destructor, stops the exporter
+    ~exporter();
+
+    exporter(const exporter&) = delete;
+    exporter& operator=(const exporter&) = delete;
+
+    /// Adds a sink, only while the exporter is stopped
+    /// @param sink The sink
+    auto add_sink(sink sink) -> void;
+
+    /// Adds a callback which is called before the registered metrics are
+    /// copied, only while the exporter is stopped. The callbacks are called
+    /// on the thread taking the snapshots, e.g. to write the sum of an
+    /// abacus::buffered_counter with buffered_counter::flush().
+    /// @param flush The callback
+    auto add_flush(std::function<void()> flush) -> void;
+
+    /// Registers metrics
+    /// @param metrics The metrics
+    /// @return The identifier of the metrics in the snapshots
+    auto add(const metrics& metrics) -> std::size_t;
+
+    /// Unregisters metrics, their queued snapshots are still delivered
+    /// @param source The identifier returned by add()
+    auto remove(std::size_t source) -> void;
+
+    /// Starts the sampling and delivery threads
+    auto start() -> void;
+
+    /// Stops the threads after the queued snapshots are delivered
+    auto stop() -> void;
+
+    /// @return true if the exporter is started
+    auto is_running() const -> bool;
+
+    /// Takes a snapshot of all registered metrics on the calling thread and
+    /// waits until all queued snapshots are delivered. If the exporter is
+    /// stopped the snapshots are delivered on the calling thread.
+    auto flush() -> void;
+
+    /// @return The number of snapshots delivered to the sinks
+    auto delivered() const -> uint64_t;
+
+    /// @return The number of snapshots dropped because the queue was full
+    auto dropped() const -> uint64_t;
+
+    /// Creates a sink appending the snapshots to a file. JSON snapshots are
+    /// written as one line each. Value data snapshots are written as
+    /// records of a one byte type, the source, the time in nanoseconds
+    /// since the UNIX epoch and the size of the payload, little endian in 1,
+    /// 4, 8 and 4 bytes, followed by the payload. A meta data record, type
+    /// 0, is written before the first value data record, type 1, of a source
+    /// and whenever its sync value changes.
+    /// @param path The path of the file
+    /// @return The sink, or an empty function if the file cannot be opened
+    static auto file_sink(const std::string& path) -> sink;
+
+    /// Creates a sink writing the snapshots to a UNIX stream socket, in the
+    /// format of file_sink(). The socket is connected when a snapshot is
+    /// delivered and reconnected after an error, the snapshots delivered
+    /// while the socket is not connected are dropped.
+    /// @param path The path of the socket
+    /// @return The sink, or an empty function if UNIX sockets are not
+    ///         supported on the platform
+    static auto unix_socket_sink(const std::string& path) -> sink;
+
+private:
+    struct source
+    {
+        std::size_t id;
+        const abacus::metrics* metrics;
+        std::shared_ptr<const std::vector<uint8_t>> metadata;
+        abacus::view view;
+    };
+
+    auto sample() -> void;
+    auto push(std::unique_ptr<snapshot> s) -> void;
+    auto queued(std::size_t index) -> std::unique_ptr<snapshot>&;
+    auto deliver_one(std::unique_lock<std::mutex>& lock) -> void;
+    auto run_sampler() -> void;
+    auto run_delivery() -> void;
+
+private:
+    const clock::duration m_interval;
+    const std::size_t m_capacity;
+    const exporter::encoding m_encoding;
+    const exporter::overflow m_overflow;
+
+    std::vector<sink> m_sinks;
+    std::vector<std::function<void()>> m_flushes;
+
+    /// The registered metrics and the buffer for encoding JSON, guarded by
+    /// m_sources_mutex which is held while they are sampled
+    std::mutex m_sources_mutex;
+    std::vector<source> m_sources;
+    std::size_t m_next_id = 0;
+    std::string m_json;
+
+    /// The queue, a ring of capacity snapshots, and the snapshot buffers
+    /// for reuse, guarded by m_mutex
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake_sampler;
+    std::condition_variable m_wake_delivery;
+    std::condition_variable m_idle;
+    std::vector<std::unique_ptr<snapshot>> m_queue;
+    std::size_t m_first = 0;
+    std::size_t m_queued = 0;
+    std::vector<std::unique_ptr<snapshot>> m_free;
+    bool m_running = false;
+    bool m_stopping = false;
+    bool m_delivering = false;
+    uint64_t m_delivering_sequence = 0;
+    uint64_t m_next_sequence = 0;
+
+    std::atomic<uint64_t> m_delivered{0};
+    std::atomic<uint64_t> m_dropped{0};
+
+    std::thread m_sampler;
+    std::thread m_delivery;
+};
+}
+}
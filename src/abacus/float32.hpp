@@ -7,6 +7,9 @@
 
 #include <string>
 
+#include <optional>
+
+#include "aggregation.hpp"
 #include "description.hpp"
 #include "kind.hpp"
 #include "max.hpp"
@@ -40,6 +43,10 @@ struct float32
 
     /// The maximum value of the metric
     abacus::max<type> max{};
+
+    /// The aggregation of the metric, one of sum, min, max or avg. If not
+    /// set counters are summed and gauges use the aggregator default.
+    std::optional<abacus::aggregation> aggregation{};
 };
 }
 }
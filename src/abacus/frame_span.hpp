@@ -0,0 +1,32 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// A contiguous part of a frame created by abacus::framer, like a struct
+/// iovec of writev().
+///
+/// The span does not own its bytes. It points into the header of the framer
+/// or into the meta data and value data the frame was created from, so it
+/// is only valid until those change or the next frame is created.
+struct frame_span
+{
+    /// The bytes of the part
+    const uint8_t* data = nullptr;
+
+    /// The number of bytes of the part
+    std::size_t size = 0;
+};
+}
+}
@@ -0,0 +1,154 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "framer.hpp"
+
+#include "detail/crc32c.hpp"
+
+#include <cassert>
+#include <limits>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace
+{
+// The flag of frames with meta data
+static constexpr uint8_t metadata_flag = 0x01;
+
+// The offsets of the fields of the header
+static constexpr std::size_t checksum_offset = 4;
+static constexpr std::size_t version_offset = 8;
+static constexpr std::size_t flags_offset = 9;
+static constexpr std::size_t reserved_offset = 10;
+static constexpr std::size_t metadata_bytes_offset = 12;
+
+static inline auto put32(uint32_t value, uint8_t* out) -> void
+{
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+    out[2] = static_cast<uint8_t>(value >> 16);
+    out[3] = static_cast<uint8_t>(value >> 24);
+}
+
+static inline auto get32(const uint8_t* in) -> uint32_t
+{
+    return static_cast<uint32_t>(in[0]) | static_cast<uint32_t>(in[1]) << 8 |
+           static_cast<uint32_t>(in[2]) << 16 |
+           static_cast<uint32_t>(in[3]) << 24;
+}
+}
+
+auto framer::frame(const metrics& metrics, bool with_metadata) -> void
+{
+    if (with_metadata)
+    {
+        frame(metrics.metadata_data(), metrics.metadata_bytes(),
+              metrics.value_data(), metrics.value_bytes());
+    }
+    else
+    {
+        frame(nullptr, 0, metrics.value_data(), metrics.value_bytes());
+    }
+}
+
+auto framer::frame(const uint8_t* metadata_data, std::size_t metadata_bytes,
+                   const uint8_t* value_data, std::size_t value_bytes) -> void
+{
+    assert(metadata_data != nullptr || metadata_bytes == 0);
+    assert(value_data != nullptr);
+    m_bytes = header_bytes + metadata_bytes + value_bytes;
+    assert(m_bytes - checksum_offset <= std::numeric_limits<uint32_t>::max());
+
+    put32(static_cast<uint32_t>(m_bytes - checksum_offset), m_header);
+    m_header[version_offset] = version;
+    m_header[flags_offset] = metadata_data != nullptr ? metadata_flag : 0;
+    m_header[reserved_offset] = 0;
+    m_header[reserved_offset + 1] = 0;
+    put32(static_cast<uint32_t>(metadata_bytes),
+          m_header + metadata_bytes_offset);
+
+    // The checksum covers the header after the checksum and the data, in
+    // the order they are sent
+    uint32_t crc = detail::crc32c(m_header + version_offset,
+                                  header_bytes - version_offset);
+    m_span_count = 0;
+    m_spans[m_span_count++] = {m_header, header_bytes};
+    if (metadata_data != nullptr)
+    {
+        crc = detail::crc32c(metadata_data, metadata_bytes, crc);
+        m_spans[m_span_count++] = {metadata_data, metadata_bytes};
+    }
+    crc = detail::crc32c(value_data, value_bytes, crc);
+    m_spans[m_span_count++] = {value_data, value_bytes};
+    put32(crc, m_header + checksum_offset);
+}
+
+auto framer::spans() const -> const frame_span*
+{
+    return m_spans;
+}
+
+auto framer::span_count() const -> std::size_t
+{
+    return m_span_count;
+}
+
+auto framer::bytes() const -> std::size_t
+{
+    return m_bytes;
+}
+
+auto frame_bytes(const uint8_t* data, std::size_t bytes)
+    -> std::optional<std::size_t>
+{
+    assert(data != nullptr || bytes == 0);
+    if (bytes < checksum_offset)
+    {
+        return std::nullopt;
+    }
+    const std::size_t length = get32(data);
+    if (length < framer::header_bytes - checksum_offset)
+    {
+        return std::nullopt;
+    }
+    return checksum_offset + length;
+}
+
+auto read_frame(const uint8_t* data, std::size_t bytes, received_frame& frame)
+    -> bool
+{
+    assert(data != nullptr || bytes == 0);
+    auto size = frame_bytes(data, bytes);
+    if (!size.has_value() || size.value() != bytes)
+    {
+        return false;
+    }
+    const uint8_t flags = data[flags_offset];
+    const std::size_t metadata_bytes = get32(data + metadata_bytes_offset);
+    if (data[version_offset] != framer::version ||
+        (flags & ~metadata_flag) != 0 || data[reserved_offset] != 0 ||
+        data[reserved_offset + 1] != 0 ||
+        metadata_bytes > bytes - framer::header_bytes ||
+        ((flags & metadata_flag) == 0 && metadata_bytes != 0))
+    {
+        return false;
+    }
+    if (detail::crc32c(data + version_offset, bytes - version_offset) !=
+        get32(data + checksum_offset))
+    {
+        return false;
+    }
+
+    const uint8_t* payload = data + framer::header_bytes;
+    frame.metadata_data = (flags & metadata_flag) != 0 ? payload : nullptr;
+    frame.metadata_bytes = metadata_bytes;
+    frame.value_data = payload + metadata_bytes;
+    frame.value_bytes = bytes - framer::header_bytes - metadata_bytes;
+    return true;
+}
+}
+}
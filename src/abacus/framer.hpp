@@ -0,0 +1,119 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "frame_span.hpp"
+#include "metrics.hpp"
+#include "received_frame.hpp"
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// Frames the value data, and optionally the meta data, of metrics for
+/// sending them over a stream without copying them into a send buffer.
+///
+/// A frame is a header followed by the meta data, if any, and the value
+/// data. The header holds, little endian, the size of the rest of the frame
+/// in 4 bytes, the CRC-32C of the rest of the frame after the checksum in 4
+/// bytes, the format version and flags in 1 byte each, 2 reserved bytes and
+/// the size of the meta data in 4 bytes.
+///
+/// Only the header is written by the framer. The frame is described by up
+/// to max_spans spans, the header and the memory of the meta data and value
+/// data, which are passed to writev() or sendmsg() with to_iovecs(). The
+/// data must not change until the frame is sent, as the checksum is
+/// computed when the frame is created.
+///
+/// The frames are read with abacus::frame_bytes() and abacus::read_frame().
+class framer
+{
+public:
+    /// The size of the header of a frame
+    static constexpr std::size_t header_bytes = 16;
+
+    /// The maximum number of spans of a frame
+    static constexpr std::size_t max_spans = 3;
+
+    /// The version of the format of the frames
+    static constexpr uint8_t version = 1;
+
+public:
+    /// Constructor
+    framer() = default;
+
+    /// The spans point into the framer, so it is not copied
+    framer(const framer&) = delete;
+    framer& operator=(const framer&) = delete;
+
+    /// Creates a frame of metrics
+    /// @param metrics The metrics
+    /// @param with_metadata Whether the frame includes the meta data
+    auto frame(const metrics& metrics, bool with_metadata) -> void;
+
+    /// Creates a frame
+    /// @param metadata_data The meta data, or nullptr for no meta data
+    /// @param metadata_bytes The size of the meta data
+    /// @param value_data The value data
+    /// @param value_bytes The size of the value data
+    auto frame(const uint8_t* metadata_data, std::size_t metadata_bytes,
+               const uint8_t* value_data, std::size_t value_bytes) -> void;
+
+    /// @return The spans of the frame
+    auto spans() const -> const frame_span*;
+
+    /// @return The number of spans of the frame
+    auto span_count() const -> std::size_t;
+
+    /// @return The size of the frame
+    auto bytes() const -> std::size_t;
+
+    /// Fills iovec like structures, e.g. struct iovec, with the spans
+    /// @param iovecs The structures with iov_base and iov_len members, at
+    ///        least span_count() of them
+    /// @return The number of filled structures
+    template <class IoVec>
+    auto to_iovecs(IoVec* iovecs) const -> std::size_t
+    {
+        for (std::size_t i = 0; i < m_span_count; ++i)
+        {
+            iovecs[i].iov_base =
+                const_cast<void*>(static_cast<const void*>(m_spans[i].data));
+            iovecs[i].iov_len = m_spans[i].size;
+        }
+        return m_span_count;
+    }
+
+private:
+    uint8_t m_header[header_bytes] = {};
+    frame_span m_spans[max_spans];
+    std::size_t m_span_count = 0;
+    std::size_t m_bytes = 0;
+};
+
+/// Reads the size of a frame from its beginning, e.g. to find the end of a
+/// frame in a stream
+/// @param data The beginning of the frame
+/// @param bytes The number of available bytes
+/// @return The size of the frame, or std::nullopt if fewer than 4 bytes are
+///         available or the size is invalid
+auto frame_bytes(const uint8_t* data, std::size_t bytes)
+    -> std::optional<std::size_t>;
+
+/// Reads a frame created by abacus::framer and checks its checksum
+/// @param data The frame
+/// @param bytes The size of the frame, see abacus::frame_bytes()
+/// @param frame The parts of the frame, pointing into data
+/// @return true if the frame is valid
+[[nodiscard]] auto read_frame(const uint8_t* data, std::size_t bytes,
+                              received_frame& frame) -> bool;
+}
+}
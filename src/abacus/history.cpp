@@ -0,0 +1,138 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "history.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+history::history(std::shared_ptr<const abacus::schema> schema,
+                 std::size_t capacity) :
+    m_schema(std::move(schema)), m_capacity(capacity)
+{
+    assert(m_schema);
+    assert(m_capacity > 0);
+    m_value_bytes = m_schema->value_bytes();
+    m_data.reset(new uint8_t[m_value_bytes * m_capacity]);
+    m_times.resize(m_capacity);
+}
+
+auto history::schema() const -> const std::shared_ptr<const abacus::schema>&
+{
+    return m_schema;
+}
+
+auto history::capacity() const -> std::size_t
+{
+    return m_capacity;
+}
+
+auto history::size() const -> std::size_t
+{
+    return m_size;
+}
+
+auto history::value_bytes() const -> std::size_t
+{
+    return m_value_bytes;
+}
+
+auto history::record(const metrics& metrics, clock::time_point time) -> void
+{
+    assert(metrics.schema() != nullptr);
+    assert(metrics.schema()->sync_value() == m_schema->sync_value());
+    assert(metrics.value_bytes() == m_value_bytes);
+    record(metrics.value_data(), time);
+}
+
+auto history::record(const uint8_t* value_data, clock::time_point time)
+    -> void
+{
+    assert(value_data != nullptr);
+    assert(m_size == 0 || time >= m_times[position(m_size - 1)]);
+
+    std::size_t next;
+    if (m_size < m_capacity)
+    {
+        next = position(m_size);
+        ++m_size;
+    }
+    else
+    {
+        // Overwrite the oldest snapshot
+        next = m_first;
+        m_first = m_first + 1 == m_capacity ? 0 : m_first + 1;
+    }
+    std::memcpy(m_data.get() + next * m_value_bytes, value_data,
+                m_value_bytes);
+    m_times[next] = time;
+}
+
+auto history::value_data(std::size_t index) const -> const uint8_t*
+{
+    assert(index < m_size);
+    return m_data.get() + position(index) * m_value_bytes;
+}
+
+auto history::time(std::size_t index) const -> clock::time_point
+{
+    assert(index < m_size);
+    return m_times[position(index)];
+}
+
+auto history::read(std::size_t index, view& view) const -> bool
+{
+    return view.set_value_data(value_data(index), m_value_bytes);
+}
+
+auto history::window(clock::time_point from, clock::time_point to) const
+    -> std::pair<std::size_t, std::size_t>
+{
+    // The times increase with the index, so the window is found with a
+    // binary search over the indices
+    auto partition_point = [&](auto predicate)
+    {
+        std::size_t first = 0;
+        std::size_t count = m_size;
+        while (count > 0)
+        {
+            std::size_t step = count / 2;
+            if (predicate(time(first + step)))
+            {
+                first += step + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+        return first;
+    };
+    std::size_t first =
+        partition_point([&](clock::time_point t) { return t < from; });
+    std::size_t last =
+        partition_point([&](clock::time_point t) { return t <= to; });
+    return {first, std::max(first, last)};
+}
+
+auto history::clear() -> void
+{
+    m_first = 0;
+    m_size = 0;
+}
+
+auto history::position(std::size_t index) const -> std::size_t
+{
+    std::size_t position = m_first + index;
+    return position < m_capacity ? position : position - m_capacity;
+}
+}
+}
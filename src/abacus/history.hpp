@@ -0,0 +1,130 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "metrics.hpp"
+#include "schema.hpp"
+#include "version.hpp"
+#include "view.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// Keeps the last snapshots of the value data of metrics of one schema, e.g.
+/// for local debugging and short-window analytics.
+///
+/// The snapshots are stored in a ring allocated when the history is
+/// constructed, so recording a snapshot is a single copy of the value data
+/// and never allocates. When the ring is full the oldest snapshot is
+/// overwritten. The snapshots are indexed from 0, the oldest, to size() - 1,
+/// the newest.
+///
+/// A snapshot is read by pointing an abacus::view with the meta data of the
+/// schema at it with read(). The meta data only has to be set once, so
+/// stepping a view through many snapshots is as cheap as
+/// view::set_value_data().
+///
+/// Like abacus::metrics the history is not thread-safe.
+class history
+{
+public:
+    /// The clock of the snapshot times
+    using clock = std::chrono::steady_clock;
+
+public:
+    /// Constructor
+    /// @param schema The schema of the metrics
+    /// @param capacity The maximum number of snapshots, at least one
+    history(std::shared_ptr<const abacus::schema> schema,
+            std::size_t capacity);
+
+    /// @return The schema of the metrics
+    auto schema() const -> const std::shared_ptr<const abacus::schema>&;
+
+    /// @return The maximum number of snapshots
+    auto capacity() const -> std::size_t;
+
+    /// @return The number of snapshots
+    auto size() const -> std::size_t;
+
+    /// @return The size of a snapshot in bytes
+    auto value_bytes() const -> std::size_t;
+
+    /// Records a snapshot of the value data of metrics
+    /// @param metrics The metrics, must have the schema of the history
+    /// @param time The time of the snapshot, not before the time of the
+    ///        newest snapshot
+    auto record(const metrics& metrics, clock::time_point time = clock::now())
+        -> void;
+
+    /// Records a snapshot of value data
+    /// @param value_data The value data, value_bytes() large with the sync
+    ///        value of the schema
+    /// @param time The time of the snapshot, not before the time of the
+    ///        newest snapshot
+    auto record(const uint8_t* value_data, clock::time_point time) -> void;
+
+    /// @return The value data of a snapshot
+    /// @param index The index of the snapshot, 0 is the oldest
+    auto value_data(std::size_t index) const -> const uint8_t*;
+
+    /// @return The time of a snapshot
+    /// @param index The index of the snapshot, 0 is the oldest
+    auto time(std::size_t index) const -> clock::time_point;
+
+    /// Points a view at a snapshot. The view keeps pointing at the ring, so
+    /// it reads the values of a newer snapshot once the snapshot has been
+    /// overwritten.
+    /// @param index The index of the snapshot, 0 is the oldest
+    /// @param view A view with the meta data of the schema
+    /// @return true if the view has the meta data of the schema
+    [[nodiscard]] auto read(std::size_t index, view& view) const -> bool;
+
+    /// @return The indices [first, last) of the snapshots recorded within a
+    ///         time window
+    /// @param from The start of the window
+    /// @param to The end of the window, included
+    auto window(clock::time_point from, clock::time_point to) const
+        -> std::pair<std::size_t, std::size_t>;
+
+    /// Removes all snapshots, the ring is kept
+    auto clear() -> void;
+
+private:
+    /// @return The position in the ring of a snapshot
+    auto position(std::size_t index) const -> std::size_t;
+
+private:
+    /// The schema of the metrics
+    std::shared_ptr<const abacus::schema> m_schema;
+
+    /// The size of a snapshot in bytes
+    std::size_t m_value_bytes;
+
+    /// The maximum number of snapshots
+    std::size_t m_capacity;
+
+    /// The ring of value data
+    std::unique_ptr<uint8_t[]> m_data;
+
+    /// The times of the snapshots in the ring
+    std::vector<clock::time_point> m_times;
+
+    /// The position in the ring of the oldest snapshot
+    std::size_t m_first = 0;
+
+    /// The number of snapshots
+    std::size_t m_size = 0;
+};
+}
+}
@@ -0,0 +1,31 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// How the descriptive strings are stored in the serialized meta data
+enum class metadata_encoding
+{
+    /// The descriptions, units and enum values are stored in each metric.
+    inline_strings,
+    /// The descriptions, units and enum values are stored once in a shared
+    /// string table and referenced by index from the metrics. Schemas where
+    /// many metrics share units, descriptions or enum types get
+    /// considerably smaller meta data.
+    string_table,
+    /// The meta data only holds what is needed to read the values, i.e. the
+    /// names, types, offsets and kinds of the metrics. The descriptions,
+    /// units and enum values are serialized separately as a dictionary with
+    /// the same sync value, which receivers can fetch once and cache.
+    lean
+};
+}
+}
@@ -0,0 +1,422 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "metadata_scanner.hpp"
+
+#include "detail/string_table.hpp"
+#include "detail/wire_reader.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace
+{
+// The field numbers of the MetricsMetadata message
+constexpr uint32_t protocol_version_field = 1;
+constexpr uint32_t endianness_field = 2;
+constexpr uint32_t sync_value_field = 3;
+constexpr uint32_t metrics_field = 4;
+constexpr uint32_t strings_field = 6;
+constexpr uint32_t references_field = 7;
+
+// The field numbers of a map entry
+constexpr uint32_t key_field = 1;
+constexpr uint32_t value_field = 2;
+
+// The field number of the offset in the typed metric messages
+constexpr uint32_t offset_field = 1;
+
+// @return The field number of the description of a type
+static inline uint32_t description_field(protobuf::Metric::TypeCase type)
+{
+    return type == protobuf::Metric::kConstant ? 6 : 2;
+}
+
+// @return The field number of the unit of a type
+static inline uint32_t unit_field(protobuf::Metric::TypeCase type)
+{
+    switch (type)
+    {
+    case protobuf::Metric::kConstant:
+        return 7;
+    case protobuf::Metric::kBoolean:
+        return 3;
+    default:
+        return 4;
+    }
+}
+}
+
+auto metadata_scanner::scan(const uint8_t* metadata_data,
+                            std::size_t metadata_bytes) -> bool
+{
+    assert(metadata_data != nullptr);
+
+    m_protocol_version = 0;
+    m_endianness = protobuf::Endianness::LITTLE;
+    m_sync_value = 0;
+    m_entries.clear();
+    m_strings.clear();
+    m_references.clear();
+    m_tables.clear();
+
+    auto fail = [this]()
+    {
+        m_entries.clear();
+        m_strings.clear();
+        m_references.clear();
+        m_tables.clear();
+        return false;
+    };
+
+    detail::wire_reader reader(std::string_view(
+        reinterpret_cast<const char*>(metadata_data), metadata_bytes));
+    while (!reader.at_end())
+    {
+        uint32_t field;
+        uint32_t wire_type;
+        if (!reader.read_tag(field, wire_type))
+        {
+            return fail();
+        }
+
+        uint64_t value;
+        if (field == protocol_version_field &&
+            wire_type == detail::wire_reader::varint)
+        {
+            if (!reader.read_varint(value))
+            {
+                return fail();
+            }
+            m_protocol_version = static_cast<uint32_t>(value);
+        }
+        else if (field == endianness_field &&
+                 wire_type == detail::wire_reader::varint)
+        {
+            if (!reader.read_varint(value))
+            {
+                return fail();
+            }
+            m_endianness = static_cast<protobuf::Endianness>(value);
+        }
+        else if (field == sync_value_field &&
+                 wire_type == detail::wire_reader::fixed32)
+        {
+            if (!reader.read_fixed32(m_sync_value))
+            {
+                return fail();
+            }
+        }
+        else if (field == metrics_field &&
+                 wire_type == detail::wire_reader::length_delimited)
+        {
+            std::string_view map_entry;
+            if (!reader.read_bytes(map_entry))
+            {
+                return fail();
+            }
+
+            entry e{};
+            detail::wire_reader entry_reader(map_entry);
+            while (!entry_reader.at_end())
+            {
+                uint32_t entry_field;
+                uint32_t entry_wire_type;
+                if (!entry_reader.read_tag(entry_field, entry_wire_type))
+                {
+                    return fail();
+                }
+                if (entry_wire_type != detail::wire_reader::length_delimited)
+                {
+                    if (!entry_reader.skip(entry_wire_type))
+                    {
+                        return fail();
+                    }
+                }
+                else if (entry_field == key_field)
+                {
+                    if (!entry_reader.read_bytes(e.name))
+                    {
+                        return fail();
+                    }
+                }
+                else if (entry_field == value_field)
+                {
+                    std::string_view message;
+                    if (!entry_reader.read_bytes(message) ||
+                        !scan_metric(message, e))
+                    {
+                        return fail();
+                    }
+                }
+                else if (!entry_reader.skip(entry_wire_type))
+                {
+                    return fail();
+                }
+            }
+            m_entries.push_back(e);
+        }
+        else if (field == strings_field &&
+                 wire_type == detail::wire_reader::length_delimited)
+        {
+            std::string_view string;
+            if (!reader.read_bytes(string))
+            {
+                return fail();
+            }
+            m_strings.push_back(string);
+        }
+        else if (field == references_field &&
+                 wire_type == detail::wire_reader::length_delimited)
+        {
+            // The references are packed
+            std::string_view packed;
+            if (!reader.read_bytes(packed))
+            {
+                return fail();
+            }
+            detail::wire_reader packed_reader(packed);
+            while (!packed_reader.at_end())
+            {
+                if (!packed_reader.read_varint(value))
+                {
+                    return fail();
+                }
+                m_references.push_back(static_cast<uint32_t>(value));
+            }
+        }
+        else if (field == references_field &&
+                 wire_type == detail::wire_reader::varint)
+        {
+            if (!reader.read_varint(value))
+            {
+                return fail();
+            }
+            m_references.push_back(static_cast<uint32_t>(value));
+        }
+        else if (!reader.skip(wire_type))
+        {
+            return fail();
+        }
+    }
+
+    // Sort by name to assign the ids. For duplicate names the last entry
+    // wins, like when parsing a protobuf map.
+    std::stable_sort(m_entries.begin(), m_entries.end(),
+                     [](const entry& lhs, const entry& rhs)
+                     { return lhs.name < rhs.name; });
+    auto last = std::unique(m_entries.rbegin(), m_entries.rend(),
+                            [](const entry& lhs, const entry& rhs)
+                            { return lhs.name == rhs.name; });
+    m_entries.erase(m_entries.begin(), last.base());
+
+    // The references of the string table follow the ids
+    if (m_strings.empty() && m_references.empty())
+    {
+        return true;
+    }
+    std::size_t position = 0;
+    for (auto& e : m_entries)
+    {
+        e.references = position;
+        if (!detail::skip_references(e.type, m_references.data(),
+                                     m_references.size(), m_strings.size(),
+                                     position, m_tables))
+        {
+            return fail();
+        }
+    }
+    if (position != m_references.size())
+    {
+        return fail();
+    }
+    return true;
+}
+
+auto metadata_scanner::scan_metric(std::string_view message, entry& e) const
+    -> bool
+{
+    e.message = message;
+    e.type = protobuf::Metric::TYPE_NOT_SET;
+    e.body = {};
+    e.offset = 0;
+    e.references = 0;
+
+    detail::wire_reader reader(message);
+    while (!reader.at_end())
+    {
+        uint32_t field;
+        uint32_t wire_type;
+        if (!reader.read_tag(field, wire_type))
+        {
+            return false;
+        }
+        // The fields of the oneof are numbered like the type cases
+        if (field >= static_cast<uint32_t>(protobuf::Metric::kConstant) &&
+            field <= static_cast<uint32_t>(protobuf::Metric::kEnum8) &&
+            wire_type == detail::wire_reader::length_delimited)
+        {
+            if (!reader.read_bytes(e.body))
+            {
+                return false;
+            }
+            e.type = static_cast<protobuf::Metric::TypeCase>(field);
+        }
+        else if (!reader.skip(wire_type))
+        {
+            return false;
+        }
+    }
+
+    if (e.type == protobuf::Metric::kConstant)
+    {
+        return true;
+    }
+
+    // Find the offset, the last occurrence wins
+    detail::wire_reader body_reader(e.body);
+    while (!body_reader.at_end())
+    {
+        uint32_t field;
+        uint32_t wire_type;
+        if (!body_reader.read_tag(field, wire_type))
+        {
+            return false;
+        }
+        uint64_t value;
+        if (field == offset_field && wire_type == detail::wire_reader::varint)
+        {
+            if (!body_reader.read_varint(value))
+            {
+                return false;
+            }
+            e.offset = static_cast<uint32_t>(value);
+        }
+        else if (!body_reader.skip(wire_type))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto metadata_scanner::protocol_version() const -> uint32_t
+{
+    return m_protocol_version;
+}
+
+auto metadata_scanner::endianness() const -> protobuf::Endianness
+{
+    return m_endianness;
+}
+
+auto metadata_scanner::sync_value() const -> uint32_t
+{
+    return m_sync_value;
+}
+
+auto metadata_scanner::count() const -> std::size_t
+{
+    return m_entries.size();
+}
+
+auto metadata_scanner::id(std::string_view name) const -> std::size_t
+{
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), name,
+                               [](const entry& e, std::string_view name)
+                               { return e.name < name; });
+    if (it == m_entries.end() || it->name != name)
+    {
+        throw std::out_of_range("Unknown metric: " + std::string(name));
+    }
+    return static_cast<std::size_t>(it - m_entries.begin());
+}
+
+auto metadata_scanner::metric_name(std::size_t id) const -> std::string_view
+{
+    assert(id < m_entries.size());
+    return m_entries[id].name;
+}
+
+auto metadata_scanner::type(std::size_t id) const
+    -> protobuf::Metric::TypeCase
+{
+    assert(id < m_entries.size());
+    return m_entries[id].type;
+}
+
+auto metadata_scanner::offset(std::size_t id) const -> std::size_t
+{
+    assert(id < m_entries.size());
+    return m_entries[id].offset;
+}
+
+auto metadata_scanner::description(std::size_t id) const -> std::string_view
+{
+    assert(id < m_entries.size());
+    const auto& e = m_entries[id];
+    if (has_string_table())
+    {
+        return m_strings[m_references[e.references]];
+    }
+    std::string_view description;
+    detail::find_bytes(e.body, description_field(e.type), description);
+    return description;
+}
+
+auto metadata_scanner::unit(std::size_t id) const
+    -> std::optional<std::string_view>
+{
+    assert(id < m_entries.size());
+    const auto& e = m_entries[id];
+    if (has_string_table())
+    {
+        uint32_t unit = m_references[e.references + 1];
+        if (unit == 0)
+        {
+            return std::nullopt;
+        }
+        return m_strings[unit - 1];
+    }
+    std::string_view unit;
+    if (!detail::find_bytes(e.body, unit_field(e.type), unit))
+    {
+        return std::nullopt;
+    }
+    return unit;
+}
+
+auto metadata_scanner::metric(std::size_t id) const -> protobuf::Metric
+{
+    assert(id < m_entries.size());
+    const auto& e = m_entries[id];
+    protobuf::Metric metric;
+    if (!metric.ParseFromArray(e.message.data(),
+                               static_cast<int>(e.message.size())))
+    {
+        // The scan only checks the framing of the typed message
+        metric.Clear();
+        return metric;
+    }
+    if (has_string_table())
+    {
+        detail::resolve_references(metric, m_strings, m_references.data(),
+                                   e.references, m_tables);
+    }
+    return metric;
+}
+
+auto metadata_scanner::has_string_table() const -> bool
+{
+    return !m_strings.empty() || !m_references.empty();
+}
+}
+}
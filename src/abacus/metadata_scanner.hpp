@@ -0,0 +1,142 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "protobuf/metrics.pb.h"
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// A lightweight index over serialized meta data, for consumers which only
+/// need the names, types and offsets of the metrics.
+///
+/// scan() reads the protobuf wire format of the meta data directly, without
+/// materializing any messages. The names are string views into the
+/// serialized meta data, which must therefore outlive the scanner. The
+/// descriptive fields, e.g. the description and unit, are only read when
+/// requested, and metric() parses the full message of a single metric.
+/// With a string table the descriptive fields are string views into the
+/// string table of the meta data instead.
+///
+/// The metrics are indexed by the same dense ids as abacus::view.
+class metadata_scanner
+{
+public:
+    /// Default constructor
+    metadata_scanner() = default;
+
+    /// Scans serialized meta data
+    /// @param metadata_data The meta data pointer
+    /// @param metadata_bytes The meta data size in bytes
+    /// @return true if the meta data was scanned, otherwise false and the
+    ///         scanner is empty
+    [[nodiscard]] auto scan(const uint8_t* metadata_data,
+                            std::size_t metadata_bytes) -> bool;
+
+    /// @return The protocol version of the meta data
+    auto protocol_version() const -> uint32_t;
+
+    /// @return The endianness of the value data
+    auto endianness() const -> protobuf::Endianness;
+
+    /// @return The sync value of the meta data
+    auto sync_value() const -> uint32_t;
+
+    /// @return The number of metrics
+    auto count() const -> std::size_t;
+
+    /// Look up the id of a metric
+    /// @param name The name of the metric
+    /// @return The id of the metric
+    auto id(std::string_view name) const -> std::size_t;
+
+    /// @param id The id of the metric
+    /// @return The name of the metric
+    auto metric_name(std::size_t id) const -> std::string_view;
+
+    /// @param id The id of the metric
+    /// @return The type of the metric
+    auto type(std::size_t id) const -> protobuf::Metric::TypeCase;
+
+    /// @param id The id of the metric
+    /// @return The offset of the value of the metric, 0 for constants
+    auto offset(std::size_t id) const -> std::size_t;
+
+    /// Reads the description of a metric
+    /// @param id The id of the metric
+    /// @return The description
+    auto description(std::size_t id) const -> std::string_view;
+
+    /// Reads the unit of a metric
+    /// @param id The id of the metric
+    /// @return The unit, if the metric has one
+    auto unit(std::size_t id) const -> std::optional<std::string_view>;
+
+    /// Parses the full meta data of a metric
+    /// @param id The id of the metric
+    /// @return The meta data of the metric, empty if it cannot be parsed
+    auto metric(std::size_t id) const -> protobuf::Metric;
+
+private:
+    /// A scanned metric
+    struct entry
+    {
+        /// The name, pointing into the meta data
+        std::string_view name;
+
+        /// The encoded typed message, pointing into the meta data
+        std::string_view body;
+
+        /// The encoded Metric message, pointing into the meta data
+        std::string_view message;
+
+        /// The type
+        protobuf::Metric::TypeCase type;
+
+        /// The offset of the value
+        std::size_t offset;
+
+        /// The position of the references into the string table
+        std::size_t references;
+    };
+
+    /// Scans the encoded Metric message of a map entry
+    auto scan_metric(std::string_view message, entry& e) const -> bool;
+
+    /// @return true if the strings are stored in a string table
+    auto has_string_table() const -> bool;
+
+private:
+    /// The protocol version
+    uint32_t m_protocol_version = 0;
+
+    /// The endianness
+    protobuf::Endianness m_endianness = protobuf::Endianness::LITTLE;
+
+    /// The sync value
+    uint32_t m_sync_value = 0;
+
+    /// The metrics sorted by name
+    std::vector<entry> m_entries;
+
+    /// The string table, pointing into the meta data
+    std::vector<std::string_view> m_strings;
+
+    /// The references into the string table
+    std::vector<uint32_t> m_references;
+
+    /// The positions of the enum tables in the references
+    std::vector<std::size_t> m_tables;
+};
+}
+}
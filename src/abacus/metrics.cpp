@@ -5,401 +5,276 @@
 
 #include "metrics.hpp"
 
-#include "detail/hash_function.hpp"
-
 #include "info.hpp"
-#include "protocol_version.hpp"
 #include "version.hpp"
 
-#include "detail/overload.hpp"
 #include "protobuf/metrics.pb.h"
 
-#include <endian/is_big_endian.hpp>
-
-#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
 
 namespace abacus
 {
 inline namespace STEINWURF_ABACUS_VERSION
 {
+namespace
+{
+template <class Metric>
+static inline bool has_type(const protobuf::Metric& m)
+{
+    if constexpr (std::is_same_v<Metric, uint64>)
+        return m.has_uint64();
+    if constexpr (std::is_same_v<Metric, int64>)
+        return m.has_int64();
+    if constexpr (std::is_same_v<Metric, uint32>)
+        return m.has_uint32();
+    if constexpr (std::is_same_v<Metric, int32>)
+        return m.has_int32();
+    if constexpr (std::is_same_v<Metric, float64>)
+        return m.has_float64();
+    if constexpr (std::is_same_v<Metric, float32>)
+        return m.has_float32();
+    if constexpr (std::is_same_v<Metric, boolean>)
+        return m.has_boolean();
+    if constexpr (std::is_same_v<Metric, enum8>)
+        return m.has_enum8();
+    return false;
+}
+
+template <class Metric>
+static inline auto typed_metric(const protobuf::Metric& m) -> const auto&
+{
+    if constexpr (std::is_same_v<Metric, uint64>)
+        return m.uint64();
+    if constexpr (std::is_same_v<Metric, int64>)
+        return m.int64();
+    if constexpr (std::is_same_v<Metric, uint32>)
+        return m.uint32();
+    if constexpr (std::is_same_v<Metric, int32>)
+        return m.int32();
+    if constexpr (std::is_same_v<Metric, float64>)
+        return m.float64();
+    if constexpr (std::is_same_v<Metric, float32>)
+        return m.float32();
+}
+}
 
 metrics::metrics(metrics&& other) noexcept :
-    m_info(std::move(other.m_info)), m_metadata(std::move(other.m_metadata)),
-    m_data(std::move(other.m_data)), m_metadata_bytes(other.m_metadata_bytes),
-    m_hash(other.m_hash), m_value_bytes(other.m_value_bytes),
-    m_offsets(std::move(other.m_offsets)),
-    m_initialized(std::move(other.m_initialized))
+    m_schema(std::move(other.m_schema)), m_pool(other.m_pool),
+    m_data(other.m_data)
+{
+    other.m_schema.reset();
+    other.m_pool = nullptr;
+    other.m_data = nullptr;
+}
+
+metrics::metrics(const std::map<name, abacus::info>& info,
+                 metadata_encoding encoding) :
+    metrics(std::make_shared<abacus::schema>(info, encoding))
 {
-    other.m_metadata = protobuf::MetricsMetadata();
-    other.m_data.clear();
-    other.m_metadata_bytes = 0;
-    other.m_hash = 0;
-    other.m_value_bytes = 0;
-    other.m_offsets.clear();
-    other.m_initialized.clear();
 }
 
-metrics::metrics(const std::map<name, abacus::info>& info) : m_info(info)
+metrics::metrics(std::shared_ptr<const abacus::schema> schema) :
+    m_schema(std::move(schema))
 {
-    m_metadata = protobuf::MetricsMetadata();
-    m_metadata.set_protocol_version(protocol_version());
-    m_metadata.set_endianness(endian::is_big_endian()
-                                  ? protobuf::Endianness::BIG
-                                  : protobuf::Endianness::LITTLE);
+    assert(m_schema);
+    const auto& initial_data = m_schema->m_initial_data;
+    m_data = new uint8_t[initial_data.size()];
+    std::memcpy(m_data, initial_data.data(), initial_data.size());
+}
 
-    // The first byte is reserved for the sync value
-    m_value_bytes = sizeof(uint32_t);
+metrics::metrics(value_pool& pool) :
+    m_schema(pool.schema()), m_pool(&pool), m_data(pool.allocate())
+{
+    const auto& initial_data = m_schema->m_initial_data;
+    assert(initial_data.size() == pool.block_bytes());
+    std::memcpy(m_data, initial_data.data(), initial_data.size());
+}
 
-    for (auto [name, info] : m_info)
+metrics::~metrics()
+{
+    if (m_pool != nullptr)
     {
-        protobuf::Metric metric;
-        std::string name_str = name.value;
-        // Save the offset of the metric
-        m_offsets.emplace(name_str, m_value_bytes);
-
-        std::visit(
-            detail::overload{
-                [&](const uint64& m)
-                {
-                    auto* typed_metric = metric.mutable_uint64();
-                    typed_metric->set_offset(m_value_bytes);
-                    typed_metric->set_description(m.description.value);
-                    typed_metric->set_kind(static_cast<protobuf::Kind>(m.kind));
-
-                    if (!m.unit.empty())
-                    {
-                        typed_metric->set_unit(m.unit.value);
-                    }
-                    if (m.min.value.has_value())
-                    {
-                        typed_metric->set_min(m.min.value.value());
-                    }
-                    if (m.max.value.has_value())
-                    {
-                        typed_metric->set_max(m.max.value.value());
-                    }
-                    // The offset is incremented by the size of the type
-                    m_value_bytes += sizeof(uint64::type);
-
-                    // The offset is incremented by one byte which
-                    // represents whether the metric is set or not.
-                    m_value_bytes += 1;
-                },
-                [&](const int64& m)
-                {
-                    auto* typed_metric = metric.mutable_int64();
-                    typed_metric->set_offset(m_value_bytes);
-                    typed_metric->set_description(m.description.value);
-                    typed_metric->set_kind(static_cast<protobuf::Kind>(m.kind));
-
-                    if (!m.unit.empty())
-                    {
-                        typed_metric->set_unit(m.unit.value);
-                    }
-                    if (m.min.value.has_value())
-                    {
-                        typed_metric->set_min(m.min.value.value());
-                    }
-                    if (m.max.value.has_value())
-                    {
-                        typed_metric->set_max(m.max.value.value());
-                    }
-                    // The offset is incremented by the size of the type
-                    m_value_bytes += sizeof(int64::type);
-
-                    // The offset is incremented by one byte which
-                    // represents whether the metric is set or not.
-                    m_value_bytes += 1;
-                },
-                [&](const uint32& m)
-                {
-                    auto* typed_metric = metric.mutable_uint32();
-                    typed_metric->set_offset(m_value_bytes);
-                    typed_metric->set_description(m.description.value);
-                    typed_metric->set_kind(static_cast<protobuf::Kind>(m.kind));
-
-                    if (!m.unit.empty())
-                    {
-                        typed_metric->set_unit(m.unit.value);
-                    }
-                    if (m.min.value.has_value())
-                    {
-                        typed_metric->set_min(m.min.value.value());
-                    }
-                    if (m.max.value.has_value())
-                    {
-                        typed_metric->set_max(m.max.value.value());
-                    }
-                    // The offset is incremented by the size of the type
-                    m_value_bytes += sizeof(uint32::type);
-
-                    // The offset is incremented by one byte which
-                    // represents whether the metric is set or not.
-                    m_value_bytes += 1;
-                },
-                [&](const int32& m)
-                {
-                    auto* typed_metric = metric.mutable_int32();
-                    typed_metric->set_offset(m_value_bytes);
-                    typed_metric->set_description(m.description.value);
-                    typed_metric->set_kind(static_cast<protobuf::Kind>(m.kind));
-
-                    if (!m.unit.empty())
-                    {
-                        typed_metric->set_unit(m.unit.value);
-                    }
-                    if (m.min.value.has_value())
-                    {
-                        typed_metric->set_min(m.min.value.value());
-                    }
-                    if (m.max.value.has_value())
-                    {
-                        typed_metric->set_max(m.max.value.value());
-                    }
-                    // The offset is incremented by the size of the type
-                    m_value_bytes += sizeof(int32::type);
-
-                    // The offset is incremented by one byte which
-                    // represents whether the metric is set or not.
-                    m_value_bytes += 1;
-                },
-                [&](const float64& m)
-                {
-                    auto* typed_metric = metric.mutable_float64();
-                    typed_metric->set_offset(m_value_bytes);
-                    typed_metric->set_description(m.description.value);
-                    typed_metric->set_kind(static_cast<protobuf::Kind>(m.kind));
-
-                    if (!m.unit.empty())
-                    {
-                        typed_metric->set_unit(m.unit.value);
-                    }
-                    if (m.min.value.has_value())
-                    {
-                        typed_metric->set_min(m.min.value.value());
-                    }
-                    if (m.max.value.has_value())
-                    {
-                        typed_metric->set_max(m.max.value.value());
-                    }
-                    // The offset is incremented by the size of the type
-                    m_value_bytes += sizeof(float64::type);
-
-                    // The offset is incremented by one byte which
-                    // represents whether the metric is set or not.
-                    m_value_bytes += 1;
-                },
-                [&](const float32& m)
-                {
-                    auto* typed_metric = metric.mutable_float32();
-                    typed_metric->set_offset(m_value_bytes);
-                    typed_metric->set_description(m.description.value);
-                    typed_metric->set_kind(static_cast<protobuf::Kind>(m.kind));
-
-                    if (!m.unit.empty())
-                    {
-                        typed_metric->set_unit(m.unit.value);
-                    }
-                    if (m.min.value.has_value())
-                    {
-                        typed_metric->set_min(m.min.value.value());
-                    }
-                    if (m.max.value.has_value())
-                    {
-                        typed_metric->set_max(m.max.value.value());
-                    }
-                    // The offset is incremented by the size of the type
-                    m_value_bytes += sizeof(float32::type);
-
-                    // The offset is incremented by one byte which
-                    // represents whether the metric is set or not.
-                    m_value_bytes += 1;
-                },
-                [&](const boolean& m)
-                {
-                    auto* typed_metric = metric.mutable_boolean();
-                    typed_metric->set_offset(m_value_bytes);
-                    typed_metric->set_description(m.description.value);
-                    m_value_bytes += sizeof(boolean::type);
-
-                    // The offset is incremented by one byte which
-                    // represents whether the metric is set or not.
-                    m_value_bytes += 1;
-                },
-                [&](const enum8& m)
-                {
-                    auto* typed_metric = metric.mutable_enum8();
-                    typed_metric->set_offset(m_value_bytes);
-                    typed_metric->set_description(m.description.value);
-                    for (auto [key, value] : m.values)
-                    {
-                        auto enum_value = protobuf::Enum8Metric::EnumValue();
-                        enum_value.set_name(value.name);
-                        if (!value.description.empty())
-                        {
-                            enum_value.set_description(value.description);
-                        }
-
-                        typed_metric->mutable_values()->insert(
-                            {key.value, enum_value});
-                    }
-                    m_value_bytes += sizeof(enum8::type);
-
-                    // The offset is incremented by one byte which
-                    // represents whether the metric is set or not.
-                    m_value_bytes += 1;
-                },
-                [&](const constant& m)
-                {
-                    auto* typed_metric = metric.mutable_constant();
-                    typed_metric->set_description(m.description.value);
-                    if (!m.unit.empty())
-                    {
-                        typed_metric->set_unit(m.unit.value);
-                    }
-                    // We expect the metric to be a constant
-                    std::visit(
-                        detail::overload{
-                            [typed_metric](constant::uint64 c)
-                            { typed_metric->set_uint64(c.value); },
-                            [typed_metric](constant::int64 c)
-                            { typed_metric->set_int64(c.value); },
-                            [typed_metric](constant::float64 c)
-                            { typed_metric->set_float64(c.value); },
-                            [typed_metric](constant::str c)
-                            { typed_metric->set_string(c.value); },
-                            [typed_metric](constant::boolean c)
-                            { typed_metric->set_boolean(c.value); },
-                            [](const auto&)
-                            { assert(false && "Unsupported constant type"); }},
-                        m.value);
-                    m_initialized[name_str] = true;
-                },
-                [&](const auto&)
-                { assert(false && "Unsupported metric type"); }},
-            info);
-
-        m_metadata.mutable_metrics()->insert({name.value, metric});
+        m_pool->deallocate(m_data);
     }
+    else
+    {
+        delete[] m_data;
+    }
+}
 
-    // Set the sync value to 1 so that the size of the metadata is
-    // calculated correctly
-    m_metadata.set_sync_value(1);
-
-    m_metadata_bytes = metadata().ByteSizeLong();
-
-    m_data.resize(m_metadata_bytes + m_value_bytes);
-
-    // Serialize the metadata
-    metadata().SerializeToArray(m_data.data(), m_metadata_bytes);
-
-    // Calculate the hash of the metadata
-    m_hash = detail::hash_function(m_data.data(), m_metadata_bytes);
-
-    // Update the sync value
-    m_metadata.set_sync_value(m_hash);
-
-    // Serialize the metadata again to include the sync value
-    metadata().SerializeToArray(m_data.data(), m_metadata_bytes);
+auto metrics::count() const -> std::size_t
+{
+    return m_schema ? m_schema->count() : 0;
+}
 
-    // Make sure the metadata didn't change unexpectedly
-    assert(metadata().ByteSizeLong() == m_metadata_bytes);
+auto metrics::id(std::string_view name) const -> std::size_t
+{
+    if (!m_schema)
+    {
+        throw std::out_of_range("Unknown metric: " + std::string(name));
+    }
+    return m_schema->id(name);
+}
 
-    // Write the sync value to the first byte of the value data (this
-    // will be written as the endianess of the system) Consuming code
-    // can use the endianness field in the metadata to read the sync
-    // value
-    std::memcpy(m_data.data() + m_metadata_bytes, &m_hash, sizeof(uint32_t));
+auto metrics::metric_name(std::size_t id) const -> std::string_view
+{
+    assert(m_schema);
+    return m_schema->metric_name(id);
 }
 
 template <class Metric>
-[[nodiscard]] auto
-metrics::initialize(const std::string& name) -> metric<Metric>
+[[nodiscard]] auto metrics::initialize(std::size_t id) -> metric<Metric>
 {
-    assert(m_initialized.find(name) == m_initialized.end());
-    assert(m_offsets.find(name) != m_offsets.end());
-    assert(std::holds_alternative<Metric>(m_info.at(abacus::name{name})));
+    assert(id < count());
+    assert(!is_initialized(id));
+    assert(has_type<Metric>(
+        metadata().metrics().at(std::string(m_schema->metric_name(id)))));
 
-    std::size_t offset = m_offsets.at(name);
-    metric<Metric> m(m_data.data() + m_metadata_bytes + offset);
+    metric<Metric> m(m_data + m_schema->offset(id));
 
-    m_initialized[name] = true;
+    m_data[value_bytes() + id] = true;
     return m;
 }
 
 // Explicit instantiations for the expected types
-template auto
-metrics::initialize<uint64>(const std::string& name) -> metric<uint64>;
+template auto metrics::initialize<uint64>(std::size_t id) -> metric<uint64>;
 
-template auto
-metrics::initialize<int64>(const std::string& name) -> metric<int64>;
+template auto metrics::initialize<int64>(std::size_t id) -> metric<int64>;
 
-template auto
-metrics::initialize<uint32>(const std::string& name) -> metric<uint32>;
+template auto metrics::initialize<uint32>(std::size_t id) -> metric<uint32>;
 
-template auto
-metrics::initialize<int32>(const std::string& name) -> metric<int32>;
+template auto metrics::initialize<int32>(std::size_t id) -> metric<int32>;
 
-template auto
-metrics::initialize<float64>(const std::string& name) -> metric<float64>;
+template auto metrics::initialize<float64>(std::size_t id) -> metric<float64>;
 
-template auto
-metrics::initialize<float32>(const std::string& name) -> metric<float32>;
+template auto metrics::initialize<float32>(std::size_t id) -> metric<float32>;
 
-template auto
-metrics::initialize<boolean>(const std::string& name) -> metric<boolean>;
+template auto metrics::initialize<boolean>(std::size_t id) -> metric<boolean>;
 
-template auto
-metrics::initialize<enum8>(const std::string& name) -> metric<enum8>;
+template auto metrics::initialize<enum8>(std::size_t id) -> metric<enum8>;
+
+template <class Metric>
+[[nodiscard]] auto metrics::initialize_bounded(std::size_t id)
+    -> bounded_metric<Metric>
+{
+    using value_type = typename Metric::type;
+    const auto& m = typed_metric<Metric>(
+        metadata().metrics().at(std::string(m_schema->metric_name(id))));
+
+    abacus::min<value_type> min;
+    abacus::max<value_type> max;
+    if (m.has_min())
+    {
+        min.value = m.min();
+    }
+    if (m.has_max())
+    {
+        max.value = m.max();
+    }
+    return bounded_metric<Metric>(initialize<Metric>(id), min, max);
+}
+
+// Explicit instantiations for the bounded types
+template auto metrics::initialize_bounded<uint64>(std::size_t id)
+    -> bounded_metric<uint64>;
+
+template auto metrics::initialize_bounded<int64>(std::size_t id)
+    -> bounded_metric<int64>;
+
+template auto metrics::initialize_bounded<uint32>(std::size_t id)
+    -> bounded_metric<uint32>;
+
+template auto metrics::initialize_bounded<int32>(std::size_t id)
+    -> bounded_metric<int32>;
+
+template auto metrics::initialize_bounded<float64>(std::size_t id)
+    -> bounded_metric<float64>;
+
+template auto metrics::initialize_bounded<float32>(std::size_t id)
+    -> bounded_metric<float32>;
 
 auto metrics::value_data() const -> const uint8_t*
 {
-    return m_data.data() + m_metadata_bytes;
+    return m_data;
 }
 
 auto metrics::value_bytes() const -> std::size_t
 {
-    return m_value_bytes;
+    return m_schema ? m_schema->value_bytes() : 0;
 }
 
 auto metrics::metadata() const -> const protobuf::MetricsMetadata&
 {
-    return m_metadata;
+    return m_schema ? m_schema->metadata()
+                    : protobuf::MetricsMetadata::default_instance();
 }
 
 auto metrics::metadata_data() const -> const uint8_t*
 {
-    return m_data.data();
+    return m_schema ? m_schema->metadata_data() : nullptr;
 }
 
 auto metrics::metadata_bytes() const -> std::size_t
 {
-    return m_metadata_bytes;
+    return m_schema ? m_schema->metadata_bytes() : 0;
 }
 
-auto metrics::is_initialized(const std::string& name) const -> bool
+auto metrics::dictionary_data() const -> const uint8_t*
 {
-    return m_initialized.find(name) != m_initialized.end();
+    return m_schema ? m_schema->dictionary_data() : nullptr;
 }
 
-auto metrics::is_initialized() const -> bool
+auto metrics::dictionary_bytes() const -> std::size_t
 {
-    for (const auto& [name, offset] : m_offsets)
+    return m_schema ? m_schema->dictionary_bytes() : 0;
+}
+
+auto metrics::schema() const -> const std::shared_ptr<const abacus::schema>&
+{
+    return m_schema;
+}
+
+auto metrics::is_initialized(std::size_t id) const -> bool
+{
+    assert(id < count());
+    return m_data[value_bytes() + id] != 0;
+}
+
+auto metrics::is_initialized(std::string_view name) const -> bool
+{
+    if (!m_schema)
     {
-        (void)offset;
-        if (!is_initialized(name))
-        {
-            return false;
-        }
+        return false;
     }
-    return true;
+    auto first = m_schema->m_names.begin();
+    auto last = m_schema->m_names.end();
+    auto it = std::lower_bound(first, last, name);
+    if (it == last || *it != name)
+    {
+        return false;
+    }
+    return is_initialized(static_cast<std::size_t>(it - first));
+}
+
+auto metrics::is_initialized() const -> bool
+{
+    // The initialized flags follow the values
+    const uint8_t* flags = m_data + value_bytes();
+    return std::all_of(flags, flags + count(),
+                       [](uint8_t initialized) { return initialized != 0; });
 }
 
 auto metrics::reset() -> void
 {
+    if (!m_schema)
+    {
+        return;
+    }
     // Reset all metrics but keep the hash
-    std::memset(m_data.data() + m_metadata_bytes + sizeof(uint32_t), 0,
-                m_value_bytes - sizeof(uint32_t));
+    std::memset(m_data + sizeof(uint32_t), 0,
+                value_bytes() - sizeof(uint32_t));
 }
 }
 }
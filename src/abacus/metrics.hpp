@@ -8,11 +8,17 @@
 #include <any>
 #include <cassert>
 #include <map>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "bounded_metric.hpp"
 #include "info.hpp"
+#include "metadata_encoding.hpp"
 #include "name.hpp"
+#include "schema.hpp"
+#include "value_pool.hpp"
 #include "version.hpp"
 
 #include "metric.hpp"
@@ -24,6 +30,16 @@ inline namespace STEINWURF_ABACUS_VERSION
 {
 /// This class is used for creating descriptive counters that are contiguous in
 /// memory, to allow for fast access and arithmetic operations.
+///
+/// Each metric is identified by a dense integer id in the range [0, count()).
+/// The ids are assigned in the lexicographical order of the metric names, so
+/// the id of a metric is the same in abacus::view for the same metadata.
+///
+/// The meta data of the metrics is kept in an abacus::schema. When many
+/// metrics with the same info are created, e.g. one per connection, the
+/// schema should be created once and shared, so creating the metrics is
+/// a single allocation of the value data. The value data can also be
+/// allocated from an abacus::value_pool.
 class metrics
 {
 public:
@@ -37,18 +53,82 @@ public:
 
     /// Constructor
     /// @param info The info of the metrics to create.
-    metrics(const std::map<name, abacus::info>& info);
+    /// @param encoding How the strings are stored in the serialized meta
+    ///        data.
+    metrics(const std::map<name, abacus::info>& info,
+            metadata_encoding encoding = metadata_encoding::inline_strings);
+
+    /// Constructor
+    /// @param schema The shared schema of the metrics to create. The meta
+    ///        data is shared with the schema, only the value data is
+    ///        allocated.
+    metrics(std::shared_ptr<const abacus::schema> schema);
+
+    /// Constructor
+    /// @param pool The pool to allocate the value data from. The metrics
+    ///        use the schema of the pool and return the value data to the
+    ///        pool when destroyed.
+    metrics(value_pool& pool);
+
+    /// Destructor
+    ~metrics();
+
+    /// @return The number of metrics
+    auto count() const -> std::size_t;
+
+    /// Look up the id of a metric. The lookup is a binary search, so the
+    /// id should be looked up once and reused for repeated access.
+    /// @param name The name of the metric
+    /// @return The id of the metric
+    auto id(std::string_view name) const -> std::size_t;
+
+    /// @param id The id of the metric
+    /// @return The name of the metric
+    auto metric_name(std::size_t id) const -> std::string_view;
+
+    /// Initialize a metric
+    /// @param id The id of the metric
+    /// @return The metric object
+    template <class Metric>
+    [[nodiscard]] auto initialize(std::size_t id) -> metric<Metric>;
 
     /// Initialize a metric
     /// @param name The name of the metric
     /// @return The metric object
     template <class Metric>
-    [[nodiscard]] auto initialize(const std::string& name) -> metric<Metric>;
+    [[nodiscard]] auto initialize(std::string_view name) -> metric<Metric>
+    {
+        return initialize<Metric>(id(name));
+    }
+
+    /// Initialize a metric which enforces the min and max value of its info.
+    /// Writes outside the bounds are clamped and counted as violations.
+    /// @param id The id of the metric
+    /// @return The bounded metric object
+    template <class Metric>
+    [[nodiscard]] auto initialize_bounded(std::size_t id)
+        -> bounded_metric<Metric>;
+
+    /// Initialize a metric which enforces the min and max value of its info.
+    /// Writes outside the bounds are clamped and counted as violations.
+    /// @param name The name of the metric
+    /// @return The bounded metric object
+    template <class Metric>
+    [[nodiscard]] auto initialize_bounded(std::string_view name)
+        -> bounded_metric<Metric>
+    {
+        return initialize_bounded<Metric>(id(name));
+    }
+
+    /// Check if a metric has been initialized
+    /// @param id The id of the metric
+    /// @return true if the metric has been initialized
+    auto is_initialized(std::size_t id) const -> bool;
 
     /// Check if a metric has been initialized
     /// @param name The name of the metric
     /// @return true if the metric has been initialized
-    auto is_initialized(const std::string& name) const -> bool;
+    auto is_initialized(std::string_view name) const -> bool;
 
     /// @return true if all metrics have been initialized
     auto is_initialized() const -> bool;
@@ -62,6 +142,13 @@ public:
     /// @return the size of the metadata part of the metrics.
     auto metadata_bytes() const -> std::size_t;
 
+    /// @return the pointer to the dictionary of lean meta data.
+    auto dictionary_data() const -> const uint8_t*;
+
+    /// @return the size of the dictionary of lean meta data, 0 for the other
+    ///         encodings.
+    auto dictionary_bytes() const -> std::size_t;
+
     /// @return the const pointer to the value data of the metrics.
     auto value_data() const -> const uint8_t*;
 
@@ -71,6 +158,10 @@ public:
     /// @return the metadata part of the metrics.
     auto metadata() const -> const protobuf::MetricsMetadata&;
 
+    /// @return The schema of the metrics, may be empty for default
+    ///         constructed metrics.
+    auto schema() const -> const std::shared_ptr<const abacus::schema>&;
+
 private:
     /// No copy
     metrics(metrics&) = delete;
@@ -79,29 +170,15 @@ private:
     metrics& operator=(metrics&) = delete;
 
 private:
-    /// The metrics metadata
-    std::map<name, abacus::info> m_info;
-
-    /// The info of the metrics separated by byte-sizes
-    protobuf::MetricsMetadata m_metadata;
-
-    /// Data of the metrics, both metadata and values
-    std::vector<uint8_t> m_data;
-
-    /// The size of the metadata in bytes
-    std::size_t m_metadata_bytes;
-
-    /// The hash of the metadata
-    uint32_t m_hash;
-
-    /// The size of the value data in bytes
-    std::size_t m_value_bytes;
+    /// The schema with the meta data of the metrics
+    std::shared_ptr<const abacus::schema> m_schema;
 
-    /// Map of metric offsets
-    std::unordered_map<std::string, std::size_t> m_offsets;
+    /// The pool of the value data, nullptr if the value data is owned
+    value_pool* m_pool = nullptr;
 
-    /// Map of metrics initialization status
-    std::unordered_map<std::string, bool> m_initialized;
+    /// The value data of the metrics followed by the initialization status
+    /// of the metrics indexed by id
+    uint8_t* m_data = nullptr;
 };
 }
 }
@@ -0,0 +1,158 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "normalizer.hpp"
+
+#include "detail/byte_swap.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <endian/is_big_endian.hpp>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+normalizer::normalizer(const protobuf::MetricsMetadata& metadata) :
+    m_metadata(metadata)
+{
+    auto host = endian::is_big_endian() ? protobuf::Endianness::BIG
+                                        : protobuf::Endianness::LITTLE;
+    m_native = m_metadata.endianness() == host;
+    m_metadata.set_endianness(host);
+
+    // The first bytes are the sync value
+    m_value_bytes = sizeof(uint32_t);
+    m_positions32.push_back(0);
+
+    for (const auto& [name, m] : m_metadata.metrics())
+    {
+        // The value follows the byte marking whether it is set
+        switch (m.type_case())
+        {
+        case protobuf::Metric::kUint64:
+            m_positions64.push_back(m.uint64().offset() + 1);
+            break;
+        case protobuf::Metric::kInt64:
+            m_positions64.push_back(m.int64().offset() + 1);
+            break;
+        case protobuf::Metric::kFloat64:
+            m_positions64.push_back(m.float64().offset() + 1);
+            break;
+        case protobuf::Metric::kUint32:
+            m_positions32.push_back(m.uint32().offset() + 1);
+            break;
+        case protobuf::Metric::kInt32:
+            m_positions32.push_back(m.int32().offset() + 1);
+            break;
+        case protobuf::Metric::kFloat32:
+            m_positions32.push_back(m.float32().offset() + 1);
+            break;
+        case protobuf::Metric::kBoolean:
+            m_value_bytes =
+                std::max<std::size_t>(m_value_bytes, m.boolean().offset() + 2);
+            break;
+        case protobuf::Metric::kEnum8:
+            m_value_bytes =
+                std::max<std::size_t>(m_value_bytes, m.enum8().offset() + 2);
+            break;
+        default:
+            // Constants have no value
+            break;
+        }
+    }
+
+    // Swapping in address order keeps the pass sequential in memory
+    std::sort(m_positions64.begin(), m_positions64.end());
+    std::sort(m_positions32.begin(), m_positions32.end());
+    if (!m_positions64.empty())
+    {
+        m_value_bytes = std::max(m_value_bytes,
+                                 m_positions64.back() + sizeof(uint64_t));
+    }
+    m_value_bytes =
+        std::max(m_value_bytes, m_positions32.back() + sizeof(uint32_t));
+}
+
+auto normalizer::metadata() const -> const protobuf::MetricsMetadata&
+{
+    return m_metadata;
+}
+
+auto normalizer::is_native() const -> bool
+{
+    return m_native;
+}
+
+auto normalizer::value_bytes() const -> std::size_t
+{
+    return m_value_bytes;
+}
+
+auto normalizer::normalize(uint8_t* value_data, std::size_t value_bytes) const
+    -> bool
+{
+    assert(value_data != nullptr);
+    if (!is_synced(value_data, value_bytes))
+    {
+        return false;
+    }
+    if (!m_native)
+    {
+        swap(value_data);
+    }
+    return true;
+}
+
+auto normalizer::normalize(const uint8_t* value_data, std::size_t value_bytes,
+                           uint8_t* data) const -> bool
+{
+    assert(value_data != nullptr);
+    assert(data != nullptr);
+    if (!is_synced(value_data, value_bytes))
+    {
+        return false;
+    }
+    std::memcpy(data, value_data, value_bytes);
+    if (!m_native)
+    {
+        swap(data);
+    }
+    return true;
+}
+
+auto normalizer::is_synced(const uint8_t* value_data,
+                           std::size_t value_bytes) const -> bool
+{
+    if (value_bytes < m_value_bytes)
+    {
+        return false;
+    }
+    uint32_t sync_value;
+    std::memcpy(&sync_value, value_data, sizeof(sync_value));
+    if (!m_native)
+    {
+        sync_value = detail::byte_swap(sync_value);
+    }
+    return sync_value == m_metadata.sync_value();
+}
+
+auto normalizer::swap(uint8_t* data) const -> void
+{
+    // The swaps are independent, so the loops have no branches and the
+    // compiler can overlap the loads, swaps and stores
+    for (std::size_t position : m_positions64)
+    {
+        detail::byte_swap_at<uint64_t>(data + position);
+    }
+    for (std::size_t position : m_positions32)
+    {
+        detail::byte_swap_at<uint32_t>(data + position);
+    }
+}
+}
+}
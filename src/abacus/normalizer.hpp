@@ -0,0 +1,90 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "protobuf/metrics.pb.h"
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// Converts value buffers to the byte order of the host, compiled once
+/// against the meta data of the producer.
+///
+/// Value buffers from a producer with a foreign byte order, e.g. an embedded
+/// big endian device, must otherwise be byte swapped on every read. A
+/// normalized buffer is described by metadata(), which is the meta data of
+/// the producer in host byte order, so an abacus::view reads it with plain
+/// loads and it can be passed to abacus::aggregator.
+class normalizer
+{
+public:
+    /// Default constructor
+    normalizer() = default;
+
+    /// Constructor
+    /// @param metadata The meta data of the producer
+    normalizer(const protobuf::MetricsMetadata& metadata);
+
+    /// @return The meta data of the normalized value buffers
+    auto metadata() const -> const protobuf::MetricsMetadata&;
+
+    /// @return true if the producer already uses the byte order of the host,
+    ///         in which case normalizing only checks the sync value
+    auto is_native() const -> bool;
+
+    /// @return The minimum size of the value buffers in bytes
+    auto value_bytes() const -> std::size_t;
+
+    /// Converts a value buffer to host byte order in place
+    /// @param value_data The value data of the producer
+    /// @param value_bytes The size of the value data in bytes
+    /// @return true if the sync value of the value data matches the meta data
+    ///         otherwise false and the value data is unchanged
+    [[nodiscard]] auto normalize(uint8_t* value_data,
+                                 std::size_t value_bytes) const -> bool;
+
+    /// Copies a value buffer and converts the copy to host byte order
+    /// @param value_data The value data of the producer
+    /// @param value_bytes The size of the value data in bytes
+    /// @param data The normalized buffer, must be value_bytes large
+    /// @return true if the sync value of the value data matches the meta data
+    ///         otherwise false
+    [[nodiscard]] auto normalize(const uint8_t* value_data,
+                                 std::size_t value_bytes, uint8_t* data) const
+        -> bool;
+
+private:
+    /// Checks the sync value of a value buffer in the producer byte order
+    auto is_synced(const uint8_t* value_data, std::size_t value_bytes) const
+        -> bool;
+
+    /// Swaps the values of a buffer which has passed is_synced()
+    auto swap(uint8_t* data) const -> void;
+
+private:
+    /// The meta data in host byte order
+    protobuf::MetricsMetadata m_metadata;
+
+    /// True if the producer uses the byte order of the host
+    bool m_native = true;
+
+    /// The minimum size of the value buffers
+    std::size_t m_value_bytes = 0;
+
+    /// The sorted positions of the 8 byte values
+    std::vector<std::size_t> m_positions64;
+
+    /// The sorted positions of the 4 byte values, starting with the sync
+    /// value
+    std::vector<std::size_t> m_positions32;
+};
+}
+}
@@ -5,6 +5,8 @@
 
 #include "parse_metadata.hpp"
 
+#include "detail/string_table.hpp"
+
 #include <cassert>
 #include <optional>
 
@@ -19,11 +21,29 @@ auto parse_metadata(const uint8_t* metadata_data, std::size_t metadata_bytes)
     assert(metadata_bytes > 0);
     protobuf::MetricsMetadata metadata;
     auto result = metadata.ParseFromArray(metadata_data, metadata_bytes);
-    if (!result)
+    if (!result || !detail::resolve_string_table(metadata))
     {
         return std::nullopt;
     }
     return metadata;
 }
+
+auto parse_metadata(const uint8_t* metadata_data, std::size_t metadata_bytes,
+                    google::protobuf::Arena& arena)
+    -> protobuf::MetricsMetadata*
+{
+    assert(metadata_data != nullptr);
+    assert(metadata_bytes > 0);
+    auto* metadata =
+        google::protobuf::Arena::Create<protobuf::MetricsMetadata>(&arena);
+    if (!metadata->ParseFromArray(metadata_data,
+                                  static_cast<int>(metadata_bytes)) ||
+        !detail::resolve_string_table(*metadata))
+    {
+        // The message is freed with the arena
+        return nullptr;
+    }
+    return metadata;
+}
 }
 }
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 
 #include "protobuf/metrics.pb.h"
 #include "version.hpp"
@@ -15,10 +16,25 @@ namespace abacus
 inline namespace STEINWURF_ABACUS_VERSION
 {
 
+/// Parses the meta data. A string table is resolved, so the strings are
+/// stored in the metrics.
 /// @param metadata_data The meta data pointer
 /// @param metadata_bytes The meta data size in bytes
 auto parse_metadata(const uint8_t* metadata_data, std::size_t metadata_bytes)
     -> std::optional<protobuf::MetricsMetadata>;
 
+/// Parses the meta data into an arena. The strings and map nodes of the
+/// metrics are allocated in the arena, so parsing a large schema only needs
+/// a few allocations, and the meta data is freed with the arena. A string
+/// table is resolved like by the other overload.
+/// @param metadata_data The meta data pointer
+/// @param metadata_bytes The meta data size in bytes
+/// @param arena The arena to allocate the meta data in
+/// @return The meta data owned by the arena, or nullptr if the meta data
+///         could not be parsed
+auto parse_metadata(const uint8_t* metadata_data, std::size_t metadata_bytes,
+                    google::protobuf::Arena& arena)
+    -> protobuf::MetricsMetadata*;
+
 }
 }
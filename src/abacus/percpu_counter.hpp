@@ -0,0 +1,156 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include "detail/rseq.hpp"
+#include "int64.hpp"
+#include "metric.hpp"
+#include "uint64.hpp"
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// A counter with one slot per CPU, for counters incremented from many
+/// threads. The memory use depends on the number of CPUs, not on the number
+/// of threads.
+///
+/// On x86-64 Linux an increment adds to the slot of the current CPU with a
+/// restartable sequence (rseq), i.e. without an atomic instruction. If the
+/// sequence is aborted, e.g. because the thread was migrated, or if rseq is
+/// not available, the increment falls back to an atomic addition to the
+/// slot.
+///
+/// flush() merges the slots and writes the sum to the metric. Like
+/// abacus::metrics the value data is not synchronized, so flush() must not
+/// run concurrently with readers of the value data. Increments may run
+/// concurrently with flush().
+template <class Metric>
+class percpu_counter
+{
+    static_assert(std::is_same_v<Metric, uint64> ||
+                      std::is_same_v<Metric, int64>,
+                  "Only uint64 and int64 counters are supported");
+
+public:
+    /// The type used to store the value
+    using value_type = typename Metric::type;
+
+private:
+    /// The slot of a CPU
+    struct alignas(detail::rseq_slot_bytes) slot
+    {
+        /// Written by restartable sequences on the CPU of the slot
+        std::atomic<uint64_t> local{0};
+
+        /// Written by atomic additions from any CPU
+        std::atomic<uint64_t> shared{0};
+    };
+
+    static_assert(sizeof(slot) == detail::rseq_slot_bytes,
+                  "A slot must fill a cache line");
+
+public:
+    /// Constructor
+    /// @param metric The initialized metric to write the sum to. The current
+    ///        value of the metric, if any, is the start value.
+    percpu_counter(metric<Metric> metric) :
+        m_metric(metric), m_count(detail::cpu_count()),
+        m_slots(new slot[m_count]), m_rseq(detail::rseq_available())
+    {
+        assert(m_metric.is_initialized());
+        m_base = m_metric.has_value() ? m_metric.value() : 0;
+        m_metric = m_base;
+    }
+
+    /// Increment the counter
+    /// @param increment The value to add
+    /// @return The counter
+    auto operator+=(value_type increment) -> percpu_counter&
+    {
+        // Signed values are added in two's complement
+        uint64_t value = static_cast<uint64_t>(increment);
+        if (!m_rseq ||
+            !detail::rseq_add(reinterpret_cast<uint8_t*>(m_slots.get()),
+                              m_count, value))
+        {
+            slot& s = m_slots[detail::current_cpu() % m_count];
+            s.shared.fetch_add(value, std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
+    /// Increment the counter by one
+    /// @return The counter
+    auto operator++() -> percpu_counter&
+    {
+        return *this += 1;
+    }
+
+    /// @return The sum of the start value and all increments
+    auto value() const -> value_type
+    {
+        uint64_t sum = static_cast<uint64_t>(m_base);
+        for (std::size_t i = 0; i < m_count; ++i)
+        {
+            sum += m_slots[i].local.load(std::memory_order_relaxed);
+            sum += m_slots[i].shared.load(std::memory_order_relaxed);
+        }
+        return static_cast<value_type>(sum);
+    }
+
+    /// Writes the sum to the metric
+    auto flush() -> void
+    {
+        m_metric = value();
+    }
+
+    /// @return The number of slots
+    auto slots() const -> std::size_t
+    {
+        return m_count;
+    }
+
+    /// @return true if the calling thread increments with restartable
+    ///         sequences
+    static auto uses_rseq() -> bool
+    {
+        return detail::rseq_available();
+    }
+
+private:
+    /// No copy
+    percpu_counter(const percpu_counter&) = delete;
+
+    /// No copy assignment
+    percpu_counter& operator=(const percpu_counter&) = delete;
+
+private:
+    /// The metric holding the sum
+    metric<Metric> m_metric;
+
+    /// The start value
+    value_type m_base;
+
+    /// The number of slots
+    std::size_t m_count;
+
+    /// The slots indexed by CPU
+    std::unique_ptr<slot[]> m_slots;
+
+    /// true if restartable sequences are registered. glibc registers them
+    /// for every thread or for none, so checking once is enough.
+    const bool m_rseq;
+};
+}
+}
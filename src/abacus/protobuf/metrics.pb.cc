@@ -39,7 +39,8 @@ inline constexpr UInt64Metric::Impl_::Impl_(
         offset_{0u},
         kind_{static_cast< ::abacus::protobuf::Kind >(0)},
         min_{::uint64_t{0u}},
-        max_{::uint64_t{0u}} {}
+        max_{::uint64_t{0u}},
+        aggregation_{static_cast< ::abacus::protobuf::Aggregation >(0)} {}
 
 template <typename>
 PROTOBUF_CONSTEXPR UInt64Metric::UInt64Metric(::_pbi::ConstantInitialized)
@@ -73,7 +74,8 @@ inline constexpr UInt32Metric::Impl_::Impl_(
         offset_{0u},
         kind_{static_cast< ::abacus::protobuf::Kind >(0)},
         min_{0u},
-        max_{0u} {}
+        max_{0u},
+        aggregation_{static_cast< ::abacus::protobuf::Aggregation >(0)} {}
 
 template <typename>
 PROTOBUF_CONSTEXPR UInt32Metric::UInt32Metric(::_pbi::ConstantInitialized)
@@ -107,7 +109,8 @@ inline constexpr Int64Metric::Impl_::Impl_(
         offset_{0u},
         kind_{static_cast< ::abacus::protobuf::Kind >(0)},
         min_{::int64_t{0}},
-        max_{::int64_t{0}} {}
+        max_{::int64_t{0}},
+        aggregation_{static_cast< ::abacus::protobuf::Aggregation >(0)} {}
 
 template <typename>
 PROTOBUF_CONSTEXPR Int64Metric::Int64Metric(::_pbi::ConstantInitialized)
@@ -141,7 +144,8 @@ inline constexpr Int32Metric::Impl_::Impl_(
         offset_{0u},
         kind_{static_cast< ::abacus::protobuf::Kind >(0)},
         min_{0},
-        max_{0} {}
+        max_{0},
+        aggregation_{static_cast< ::abacus::protobuf::Aggregation >(0)} {}
 
 template <typename>
 PROTOBUF_CONSTEXPR Int32Metric::Int32Metric(::_pbi::ConstantInitialized)
@@ -175,7 +179,8 @@ inline constexpr Float64Metric::Impl_::Impl_(
         offset_{0u},
         kind_{static_cast< ::abacus::protobuf::Kind >(0)},
         min_{0},
-        max_{0} {}
+        max_{0},
+        aggregation_{static_cast< ::abacus::protobuf::Aggregation >(0)} {}
 
 template <typename>
 PROTOBUF_CONSTEXPR Float64Metric::Float64Metric(::_pbi::ConstantInitialized)
@@ -209,7 +214,8 @@ inline constexpr Float32Metric::Impl_::Impl_(
         offset_{0u},
         kind_{static_cast< ::abacus::protobuf::Kind >(0)},
         min_{0},
-        max_{0} {}
+        max_{0},
+        aggregation_{static_cast< ::abacus::protobuf::Aggregation >(0)} {}
 
 template <typename>
 PROTOBUF_CONSTEXPR Float32Metric::Float32Metric(::_pbi::ConstantInitialized)
@@ -302,7 +308,8 @@ inline constexpr BoolMetric::Impl_::Impl_(
         unit_(
             &::google::protobuf::internal::fixed_address_empty_string,
             ::_pbi::ConstantInitialized()),
-        offset_{0u} {}
+        offset_{0u},
+        aggregation_{static_cast< ::abacus::protobuf::Aggregation >(0)} {}
 
 template <typename>
 PROTOBUF_CONSTEXPR BoolMetric::BoolMetric(::_pbi::ConstantInitialized)
@@ -352,7 +359,8 @@ inline constexpr Enum8Metric::Impl_::Impl_(
         unit_(
             &::google::protobuf::internal::fixed_address_empty_string,
             ::_pbi::ConstantInitialized()),
-        offset_{0u} {}
+        offset_{0u},
+        aggregation_{static_cast< ::abacus::protobuf::Aggregation >(0)} {}
 
 template <typename>
 PROTOBUF_CONSTEXPR Enum8Metric::Enum8Metric(::_pbi::ConstantInitialized)
@@ -422,9 +430,13 @@ inline constexpr MetricsMetadata::Impl_::Impl_(
     ::_pbi::ConstantInitialized) noexcept
       : _cached_size_{0},
         metrics_{},
+        strings_{},
+        references_{},
+        _references_cached_byte_size_{0},
         protocol_version_{0u},
         endianness_{static_cast< ::abacus::protobuf::Endianness >(0)},
-        sync_value_{0u} {}
+        sync_value_{0u},
+        base_sync_value_{0u} {}
 
 template <typename>
 PROTOBUF_CONSTEXPR MetricsMetadata::MetricsMetadata(::_pbi::ConstantInitialized)
@@ -448,7 +460,7 @@ PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT
 }  // namespace protobuf
 }  // namespace abacus
 static const ::_pb::EnumDescriptor* PROTOBUF_NONNULL
-    file_level_enum_descriptors_abacus_2fprotobuf_2fmetrics_2eproto[2];
+    file_level_enum_descriptors_abacus_2fprotobuf_2fmetrics_2eproto[3];
 static constexpr const ::_pb::ServiceDescriptor *PROTOBUF_NONNULL *PROTOBUF_NULLABLE
     file_level_service_descriptors_abacus_2fprotobuf_2fmetrics_2eproto = nullptr;
 const ::uint32_t
@@ -456,103 +468,117 @@ const ::uint32_t
         protodesc_cold) = {
         0x081, // bitmap
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt64Metric, _impl_._has_bits_),
-        9, // hasbit index offset
+        10, // hasbit index offset
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt64Metric, _impl_.offset_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt64Metric, _impl_.description_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt64Metric, _impl_.kind_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt64Metric, _impl_.unit_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt64Metric, _impl_.min_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt64Metric, _impl_.max_),
+        PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt64Metric, _impl_.aggregation_),
         2,
         0,
         3,
         1,
         4,
         5,
+        6,
         0x081, // bitmap
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int64Metric, _impl_._has_bits_),
-        9, // hasbit index offset
+        10, // hasbit index offset
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int64Metric, _impl_.offset_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int64Metric, _impl_.description_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int64Metric, _impl_.kind_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int64Metric, _impl_.unit_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int64Metric, _impl_.min_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int64Metric, _impl_.max_),
+        PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int64Metric, _impl_.aggregation_),
         2,
         0,
         3,
         1,
         4,
         5,
+        6,
         0x081, // bitmap
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt32Metric, _impl_._has_bits_),
-        9, // hasbit index offset
+        10, // hasbit index offset
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt32Metric, _impl_.offset_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt32Metric, _impl_.description_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt32Metric, _impl_.kind_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt32Metric, _impl_.unit_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt32Metric, _impl_.min_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt32Metric, _impl_.max_),
+        PROTOBUF_FIELD_OFFSET(::abacus::protobuf::UInt32Metric, _impl_.aggregation_),
         2,
         0,
         3,
         1,
         4,
         5,
+        6,
         0x081, // bitmap
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int32Metric, _impl_._has_bits_),
-        9, // hasbit index offset
+        10, // hasbit index offset
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int32Metric, _impl_.offset_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int32Metric, _impl_.description_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int32Metric, _impl_.kind_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int32Metric, _impl_.unit_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int32Metric, _impl_.min_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int32Metric, _impl_.max_),
+        PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Int32Metric, _impl_.aggregation_),
         2,
         0,
         3,
         1,
         4,
         5,
+        6,
         0x081, // bitmap
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float64Metric, _impl_._has_bits_),
-        9, // hasbit index offset
+        10, // hasbit index offset
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float64Metric, _impl_.offset_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float64Metric, _impl_.description_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float64Metric, _impl_.kind_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float64Metric, _impl_.unit_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float64Metric, _impl_.min_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float64Metric, _impl_.max_),
+        PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float64Metric, _impl_.aggregation_),
         2,
         0,
         3,
         1,
         4,
         5,
+        6,
         0x081, // bitmap
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float32Metric, _impl_._has_bits_),
-        9, // hasbit index offset
+        10, // hasbit index offset
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float32Metric, _impl_.offset_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float32Metric, _impl_.description_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float32Metric, _impl_.kind_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float32Metric, _impl_.unit_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float32Metric, _impl_.min_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float32Metric, _impl_.max_),
+        PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Float32Metric, _impl_.aggregation_),
         2,
         0,
         3,
         1,
         4,
         5,
+        6,
         0x081, // bitmap
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::BoolMetric, _impl_._has_bits_),
-        6, // hasbit index offset
+        7, // hasbit index offset
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::BoolMetric, _impl_.offset_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::BoolMetric, _impl_.description_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::BoolMetric, _impl_.unit_),
+        PROTOBUF_FIELD_OFFSET(::abacus::protobuf::BoolMetric, _impl_.aggregation_),
         2,
         0,
         1,
+        3,
         0x081, // bitmap
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Enum8Metric_EnumValue, _impl_._has_bits_),
         5, // hasbit index offset
@@ -569,15 +595,17 @@ const ::uint32_t
         1,
         0x081, // bitmap
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Enum8Metric, _impl_._has_bits_),
-        7, // hasbit index offset
+        8, // hasbit index offset
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Enum8Metric, _impl_.offset_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Enum8Metric, _impl_.description_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Enum8Metric, _impl_.values_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Enum8Metric, _impl_.unit_),
+        PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Enum8Metric, _impl_.aggregation_),
         2,
         0,
         ~0u,
         1,
+        3,
         0x085, // bitmap
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Constant, _impl_._has_bits_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::Constant, _impl_._oneof_case_[0]),
@@ -618,33 +646,39 @@ const ::uint32_t
         1,
         0x081, // bitmap
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::MetricsMetadata, _impl_._has_bits_),
-        7, // hasbit index offset
+        10, // hasbit index offset
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::MetricsMetadata, _impl_.protocol_version_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::MetricsMetadata, _impl_.endianness_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::MetricsMetadata, _impl_.sync_value_),
         PROTOBUF_FIELD_OFFSET(::abacus::protobuf::MetricsMetadata, _impl_.metrics_),
+        PROTOBUF_FIELD_OFFSET(::abacus::protobuf::MetricsMetadata, _impl_.base_sync_value_),
+        PROTOBUF_FIELD_OFFSET(::abacus::protobuf::MetricsMetadata, _impl_.strings_),
+        PROTOBUF_FIELD_OFFSET(::abacus::protobuf::MetricsMetadata, _impl_.references_),
         0,
         1,
         2,
         ~0u,
+        3,
+        ~0u,
+        ~0u,
 };
 
 static const ::_pbi::MigrationSchema
     schemas[] ABSL_ATTRIBUTE_SECTION_VARIABLE(protodesc_cold) = {
         {0, sizeof(::abacus::protobuf::UInt64Metric)},
-        {15, sizeof(::abacus::protobuf::Int64Metric)},
-        {30, sizeof(::abacus::protobuf::UInt32Metric)},
-        {45, sizeof(::abacus::protobuf::Int32Metric)},
-        {60, sizeof(::abacus::protobuf::Float64Metric)},
-        {75, sizeof(::abacus::protobuf::Float32Metric)},
-        {90, sizeof(::abacus::protobuf::BoolMetric)},
-        {99, sizeof(::abacus::protobuf::Enum8Metric_EnumValue)},
-        {106, sizeof(::abacus::protobuf::Enum8Metric_ValuesEntry_DoNotUse)},
-        {113, sizeof(::abacus::protobuf::Enum8Metric)},
-        {124, sizeof(::abacus::protobuf::Constant)},
-        {143, sizeof(::abacus::protobuf::Metric)},
-        {155, sizeof(::abacus::protobuf::MetricsMetadata_MetricsEntry_DoNotUse)},
-        {162, sizeof(::abacus::protobuf::MetricsMetadata)},
+        {17, sizeof(::abacus::protobuf::Int64Metric)},
+        {34, sizeof(::abacus::protobuf::UInt32Metric)},
+        {51, sizeof(::abacus::protobuf::Int32Metric)},
+        {68, sizeof(::abacus::protobuf::Float64Metric)},
+        {85, sizeof(::abacus::protobuf::Float32Metric)},
+        {102, sizeof(::abacus::protobuf::BoolMetric)},
+        {113, sizeof(::abacus::protobuf::Enum8Metric_EnumValue)},
+        {120, sizeof(::abacus::protobuf::Enum8Metric_ValuesEntry_DoNotUse)},
+        {127, sizeof(::abacus::protobuf::Enum8Metric)},
+        {140, sizeof(::abacus::protobuf::Constant)},
+        {159, sizeof(::abacus::protobuf::Metric)},
+        {171, sizeof(::abacus::protobuf::MetricsMetadata_MetricsEntry_DoNotUse)},
+        {178, sizeof(::abacus::protobuf::MetricsMetadata)},
 };
 static const ::_pb::Message* PROTOBUF_NONNULL const file_default_instances[] = {
     &::abacus::protobuf::_UInt64Metric_default_instance_._instance,
@@ -665,72 +699,90 @@ static const ::_pb::Message* PROTOBUF_NONNULL const file_default_instances[] = {
 const char descriptor_table_protodef_abacus_2fprotobuf_2fmetrics_2eproto[] ABSL_ATTRIBUTE_SECTION_VARIABLE(
     protodesc_cold) = {
     "\n\035abacus/protobuf/metrics.proto\022\017abacus."
-    "protobuf\"\250\001\n\014UInt64Metric\022\016\n\006offset\030\001 \001("
+    "protobuf\"\360\001\n\014UInt64Metric\022\016\n\006offset\030\001 \001("
     "\r\022\023\n\013description\030\002 \001(\t\022#\n\004kind\030\003 \001(\0162\025.a"
     "bacus.protobuf.Kind\022\021\n\004unit\030\004 \001(\tH\000\210\001\001\022\020"
-    "\n\003min\030\005 \001(\004H\001\210\001\001\022\020\n\003max\030\006 \001(\004H\002\210\001\001B\007\n\005_u"
-    "nitB\006\n\004_minB\006\n\004_max\"\247\001\n\013Int64Metric\022\016\n\006o"
-    "ffset\030\001 \001(\r\022\023\n\013description\030\002 \001(\t\022#\n\004kind"
-    "\030\003 \001(\0162\025.abacus.protobuf.Kind\022\021\n\004unit\030\004 "
-    "\001(\tH\000\210\001\001\022\020\n\003min\030\005 \001(\003H\001\210\001\001\022\020\n\003max\030\006 \001(\003H"
-    "\002\210\001\001B\007\n\005_unitB\006\n\004_minB\006\n\004_max\"\250\001\n\014UInt32"
-    "Metric\022\016\n\006offset\030\001 \001(\r\022\023\n\013description\030\002 "
-    "\001(\t\022#\n\004kind\030\003 \001(\0162\025.abacus.protobuf.Kind"
-    "\022\021\n\004unit\030\004 \001(\tH\000\210\001\001\022\020\n\003min\030\005 \001(\rH\001\210\001\001\022\020\n"
-    "\003max\030\006 \001(\rH\002\210\001\001B\007\n\005_unitB\006\n\004_minB\006\n\004_max"
-    "\"\247\001\n\013Int32Metric\022\016\n\006offset\030\001 \001(\r\022\023\n\013desc"
-    "ription\030\002 \001(\t\022#\n\004kind\030\003 \001(\0162\025.abacus.pro"
-    "tobuf.Kind\022\021\n\004unit\030\004 \001(\tH\000\210\001\001\022\020\n\003min\030\005 \001"
-    "(\005H\001\210\001\001\022\020\n\003max\030\006 \001(\005H\002\210\001\001B\007\n\005_unitB\006\n\004_m"
-    "inB\006\n\004_max\"\251\001\n\rFloat64Metric\022\016\n\006offset\030\001"
-    " \001(\r\022\023\n\013description\030\002 \001(\t\022#\n\004kind\030\003 \001(\0162"
-    "\025.abacus.protobuf.Kind\022\021\n\004unit\030\004 \001(\tH\000\210\001"
-    "\001\022\020\n\003min\030\005 \001(\001H\001\210\001\001\022\020\n\003max\030\006 \001(\001H\002\210\001\001B\007\n"
-    "\005_unitB\006\n\004_minB\006\n\004_max\"\251\001\n\rFloat32Metric"
+    "\n\003min\030\005 \001(\004H\001\210\001\001\022\020\n\003max\030\006 \001(\004H\002\210\001\001\0226\n\013ag"
+    "gregation\030\007 \001(\0162\034.abacus.protobuf.Aggreg"
+    "ationH\003\210\001\001B\007\n\005_unitB\006\n\004_minB\006\n\004_maxB\016\n\014_"
+    "aggregation\"\357\001\n\013Int64Metric\022\016\n\006offset\030\001 "
+    "\001(\r\022\023\n\013description\030\002 \001(\t\022#\n\004kind\030\003 \001(\0162\025"
+    ".abacus.protobuf.Kind\022\021\n\004unit\030\004 \001(\tH\000\210\001\001"
+    "\022\020\n\003min\030\005 \001(\003H\001\210\001\001\022\020\n\003max\030\006 \001(\003H\002\210\001\001\0226\n\013"
+    "aggregation\030\007 \001(\0162\034.abacus.protobuf.Aggr"
+    "egationH\003\210\001\001B\007\n\005_unitB\006\n\004_minB\006\n\004_maxB\016\n"
+    "\014_aggregation\"\360\001\n\014UInt32Metric\022\016\n\006offset"
+    "\030\001 \001(\r\022\023\n\013description\030\002 \001(\t\022#\n\004kind\030\003 \001("
+    "\0162\025.abacus.protobuf.Kind\022\021\n\004unit\030\004 \001(\tH\000"
+    "\210\001\001\022\020\n\003min\030\005 \001(\rH\001\210\001\001\022\020\n\003max\030\006 \001(\rH\002\210\001\001\022"
+    "6\n\013aggregation\030\007 \001(\0162\034.abacus.protobuf.A"
+    "ggregationH\003\210\001\001B\007\n\005_unitB\006\n\004_minB\006\n\004_max"
+    "B\016\n\014_aggregation\"\357\001\n\013Int32Metric\022\016\n\006offs"
+    "et\030\001 \001(\r\022\023\n\013description\030\002 \001(\t\022#\n\004kind\030\003 "
+    "\001(\0162\025.abacus.protobuf.Kind\022\021\n\004unit\030\004 \001(\t"
+    "H\000\210\001\001\022\020\n\003min\030\005 \001(\005H\001\210\001\001\022\020\n\003max\030\006 \001(\005H\002\210\001"
+    "\001\0226\n\013aggregation\030\007 \001(\0162\034.abacus.protobuf"
+    ".AggregationH\003\210\001\001B\007\n\005_unitB\006\n\004_minB\006\n\004_m"
+    "axB\016\n\014_aggregation\"\361\001\n\rFloat64Metric\022\016\n\006"
+    "offset\030\001 \001(\r\022\023\n\013description\030\002 \001(\t\022#\n\004kin"
+    "d\030\003 \001(\0162\025.abacus.protobuf.Kind\022\021\n\004unit\030\004"
+    " \001(\tH\000\210\001\001\022\020\n\003min\030\005 \001(\001H\001\210\001\001\022\020\n\003max\030\006 \001(\001"
+    "H\002\210\001\001\0226\n\013aggregation\030\007 \001(\0162\034.abacus.prot"
+    "obuf.AggregationH\003\210\001\001B\007\n\005_unitB\006\n\004_minB\006"
+    "\n\004_maxB\016\n\014_aggregation\"\361\001\n\rFloat32Metric"
     "\022\016\n\006offset\030\001 \001(\r\022\023\n\013description\030\002 \001(\t\022#\n"
     "\004kind\030\003 \001(\0162\025.abacus.protobuf.Kind\022\021\n\004un"
     "it\030\004 \001(\tH\000\210\001\001\022\020\n\003min\030\005 \001(\002H\001\210\001\001\022\020\n\003max\030\006"
-    " \001(\002H\002\210\001\001B\007\n\005_unitB\006\n\004_minB\006\n\004_max\"M\n\nBo"
-    "olMetric\022\016\n\006offset\030\001 \001(\r\022\023\n\013description\030"
-    "\002 \001(\t\022\021\n\004unit\030\003 \001(\tH\000\210\001\001B\007\n\005_unit\"\244\002\n\013En"
-    "um8Metric\022\016\n\006offset\030\001 \001(\r\022\023\n\013description"
-    "\030\002 \001(\t\0228\n\006values\030\003 \003(\0132(.abacus.protobuf"
-    ".Enum8Metric.ValuesEntry\022\021\n\004unit\030\004 \001(\tH\000"
-    "\210\001\001\032C\n\tEnumValue\022\014\n\004name\030\001 \001(\t\022\030\n\013descri"
-    "ption\030\002 \001(\tH\000\210\001\001B\016\n\014_description\032U\n\013Valu"
-    "esEntry\022\013\n\003key\030\001 \001(\r\0225\n\005value\030\002 \001(\0132&.ab"
-    "acus.protobuf.Enum8Metric.EnumValue:\0028\001B"
-    "\007\n\005_unit\"\237\001\n\010Constant\022\020\n\006uint64\030\001 \001(\004H\000\022"
-    "\017\n\005int64\030\002 \001(\003H\000\022\021\n\007float64\030\003 \001(\001H\000\022\021\n\007b"
-    "oolean\030\004 \001(\010H\000\022\020\n\006string\030\005 \001(\tH\000\022\023\n\013desc"
-    "ription\030\006 \001(\t\022\021\n\004unit\030\007 \001(\tH\001\210\001\001B\007\n\005valu"
-    "eB\007\n\005_unit\"\304\003\n\006Metric\022-\n\010constant\030\001 \001(\0132"
-    "\031.abacus.protobuf.ConstantH\000\022/\n\006uint64\030\002"
-    " \001(\0132\035.abacus.protobuf.UInt64MetricH\000\022-\n"
-    "\005int64\030\003 \001(\0132\034.abacus.protobuf.Int64Metr"
-    "icH\000\022/\n\006uint32\030\004 \001(\0132\035.abacus.protobuf.U"
-    "Int32MetricH\000\022-\n\005int32\030\005 \001(\0132\034.abacus.pr"
-    "otobuf.Int32MetricH\000\0221\n\007float64\030\006 \001(\0132\036."
-    "abacus.protobuf.Float64MetricH\000\0221\n\007float"
-    "32\030\007 \001(\0132\036.abacus.protobuf.Float32Metric"
-    "H\000\022.\n\007boolean\030\010 \001(\0132\033.abacus.protobuf.Bo"
-    "olMetricH\000\022-\n\005enum8\030\t \001(\0132\034.abacus.proto"
-    "buf.Enum8MetricH\000B\006\n\004type\"\371\001\n\017MetricsMet"
-    "adata\022\030\n\020protocol_version\030\001 \001(\r\022/\n\nendia"
-    "nness\030\002 \001(\0162\033.abacus.protobuf.Endianness"
-    "\022\022\n\nsync_value\030\003 \001(\007\022>\n\007metrics\030\004 \003(\0132-."
-    "abacus.protobuf.MetricsMetadata.MetricsE"
-    "ntry\032G\n\014MetricsEntry\022\013\n\003key\030\001 \001(\t\022&\n\005val"
-    "ue\030\002 \001(\0132\027.abacus.protobuf.Metric:\0028\001*!\n"
-    "\nEndianness\022\n\n\006LITTLE\020\000\022\007\n\003BIG\020\001*\036\n\004Kind"
-    "\022\t\n\005GAUGE\020\000\022\013\n\007COUNTER\020\001B\021Z\017abacus/proto"
+    " \001(\002H\002\210\001\001\0226\n\013aggregation\030\007 \001(\0162\034.abacus."
+    "protobuf.AggregationH\003\210\001\001B\007\n\005_unitB\006\n\004_m"
+    "inB\006\n\004_maxB\016\n\014_aggregation\"\225\001\n\nBoolMetri"
+    "c\022\016\n\006offset\030\001 \001(\r\022\023\n\013description\030\002 \001(\t\022\021"
+    "\n\004unit\030\003 \001(\tH\000\210\001\001\0226\n\013aggregation\030\004 \001(\0162\034"
+    ".abacus.protobuf.AggregationH\001\210\001\001B\007\n\005_un"
+    "itB\016\n\014_aggregation\"\354\002\n\013Enum8Metric\022\016\n\006of"
+    "fset\030\001 \001(\r\022\023\n\013description\030\002 \001(\t\0228\n\006value"
+    "s\030\003 \003(\0132(.abacus.protobuf.Enum8Metric.Va"
+    "luesEntry\022\021\n\004unit\030\004 \001(\tH\000\210\001\001\0226\n\013aggregat"
+    "ion\030\005 \001(\0162\034.abacus.protobuf.AggregationH"
+    "\001\210\001\001\032C\n\tEnumValue\022\014\n\004name\030\001 \001(\t\022\030\n\013descr"
+    "iption\030\002 \001(\tH\000\210\001\001B\016\n\014_description\032U\n\013Val"
+    "uesEntry\022\013\n\003key\030\001 \001(\r\0225\n\005value\030\002 \001(\0132&.a"
+    "bacus.protobuf.Enum8Metric.EnumValue:\0028\001"
+    "B\007\n\005_unitB\016\n\014_aggregation\"\237\001\n\010Constant\022\020"
+    "\n\006uint64\030\001 \001(\004H\000\022\017\n\005int64\030\002 \001(\003H\000\022\021\n\007flo"
+    "at64\030\003 \001(\001H\000\022\021\n\007boolean\030\004 \001(\010H\000\022\020\n\006strin"
+    "g\030\005 \001(\tH\000\022\023\n\013description\030\006 \001(\t\022\021\n\004unit\030\007"
+    " \001(\tH\001\210\001\001B\007\n\005valueB\007\n\005_unit\"\304\003\n\006Metric\022-"
+    "\n\010constant\030\001 \001(\0132\031.abacus.protobuf.Const"
+    "antH\000\022/\n\006uint64\030\002 \001(\0132\035.abacus.protobuf."
+    "UInt64MetricH\000\022-\n\005int64\030\003 \001(\0132\034.abacus.p"
+    "rotobuf.Int64MetricH\000\022/\n\006uint32\030\004 \001(\0132\035."
+    "abacus.protobuf.UInt32MetricH\000\022-\n\005int32\030"
+    "\005 \001(\0132\034.abacus.protobuf.Int32MetricH\000\0221\n"
+    "\007float64\030\006 \001(\0132\036.abacus.protobuf.Float64"
+    "MetricH\000\0221\n\007float32\030\007 \001(\0132\036.abacus.proto"
+    "buf.Float32MetricH\000\022.\n\007boolean\030\010 \001(\0132\033.a"
+    "bacus.protobuf.BoolMetricH\000\022-\n\005enum8\030\t \001"
+    "(\0132\034.abacus.protobuf.Enum8MetricH\000B\006\n\004ty"
+    "pe\"\267\002\n\017MetricsMetadata\022\030\n\020protocol_versi"
+    "on\030\001 \001(\r\022/\n\nendianness\030\002 \001(\0162\033.abacus.pr"
+    "otobuf.Endianness\022\022\n\nsync_value\030\003 \001(\007\022>\n"
+    "\007metrics\030\004 \003(\0132-.abacus.protobuf.Metrics"
+    "Metadata.MetricsEntry\022\027\n\017base_sync_value"
+    "\030\005 \001(\007\022\017\n\007strings\030\006 \003(\t\022\022\n\nreferences\030\007 "
+    "\003(\r\032G\n\014MetricsEntry\022\013\n\003key\030\001 \001(\t\022&\n\005valu"
+    "e\030\002 \001(\0132\027.abacus.protobuf.Metric:\0028\001*!\n\n"
+    "Endianness\022\n\n\006LITTLE\020\000\022\007\n\003BIG\020\001*\036\n\004Kind\022"
+    "\t\n\005GAUGE\020\000\022\013\n\007COUNTER\020\001*O\n\013Aggregation\022\007"
+    "\n\003SUM\020\000\022\013\n\007MINIMUM\020\001\022\013\n\007MAXIMUM\020\002\022\013\n\007AVE"
+    "RAGE\020\003\022\007\n\003ANY\020\004\022\007\n\003ALL\020\005B\021Z\017abacus/proto"
     "bufb\006proto3"
 };
 static ::absl::once_flag descriptor_table_abacus_2fprotobuf_2fmetrics_2eproto_once;
 PROTOBUF_CONSTINIT const ::_pbi::DescriptorTable descriptor_table_abacus_2fprotobuf_2fmetrics_2eproto = {
     false,
     false,
-    2411,
+    3131,
     descriptor_table_protodef_abacus_2fprotobuf_2fmetrics_2eproto,
     "abacus/protobuf/metrics.proto",
     &descriptor_table_abacus_2fprotobuf_2fmetrics_2eproto_once,
@@ -757,6 +809,12 @@ const ::google::protobuf::EnumDescriptor* PROTOBUF_NONNULL Kind_descriptor() {
 }
 PROTOBUF_CONSTINIT const uint32_t Kind_internal_data_[] = {
     131072u, 0u, };
+const ::google::protobuf::EnumDescriptor* PROTOBUF_NONNULL Aggregation_descriptor() {
+  ::google::protobuf::internal::AssignDescriptors(&descriptor_table_abacus_2fprotobuf_2fmetrics_2eproto);
+  return file_level_enum_descriptors_abacus_2fprotobuf_2fmetrics_2eproto[2];
+}
+PROTOBUF_CONSTINIT const uint32_t Aggregation_internal_data_[] = {
+    393216u, 0u, };
 // ===================================================================
 
 class UInt64Metric::_Internal {
@@ -802,9 +860,9 @@ UInt64Metric::UInt64Metric(
                offsetof(Impl_, offset_),
            reinterpret_cast<const char *>(&from._impl_) +
                offsetof(Impl_, offset_),
-           offsetof(Impl_, max_) -
+           offsetof(Impl_, aggregation_) -
                offsetof(Impl_, offset_) +
-               sizeof(Impl_::max_));
+               sizeof(Impl_::aggregation_));
 
   // @@protoc_insertion_point(copy_constructor:abacus.protobuf.UInt64Metric)
 }
@@ -820,9 +878,9 @@ inline void UInt64Metric::SharedCtor(::_pb::Arena* PROTOBUF_NULLABLE arena) {
   ::memset(reinterpret_cast<char *>(&_impl_) +
                offsetof(Impl_, offset_),
            0,
-           offsetof(Impl_, max_) -
+           offsetof(Impl_, aggregation_) -
                offsetof(Impl_, offset_) +
-               sizeof(Impl_::max_));
+               sizeof(Impl_::aggregation_));
 }
 UInt64Metric::~UInt64Metric() {
   // @@protoc_insertion_point(destructor:abacus.protobuf.UInt64Metric)
@@ -880,16 +938,16 @@ UInt64Metric::GetClassData() const {
   return UInt64Metric_class_data_.base();
 }
 PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1
-const ::_pbi::TcParseTable<3, 6, 0, 52, 2>
+const ::_pbi::TcParseTable<3, 7, 0, 52, 2>
 UInt64Metric::_table_ = {
   {
     PROTOBUF_FIELD_OFFSET(UInt64Metric, _impl_._has_bits_),
     0, // no _extensions_
-    6, 56,  // max_field_number, fast_idx_mask
+    7, 56,  // max_field_number, fast_idx_mask
     offsetof(decltype(_table_), field_lookup_table),
-    4294967232,  // skipmap
+    4294967168,  // skipmap
     offsetof(decltype(_table_), field_entries),
-    6,  // num_field_entries
+    7,  // num_field_entries
     0,  // num_aux_entries
     offsetof(decltype(_table_), field_names),  // no aux_entries
     UInt64Metric_class_data_.base(),
@@ -918,7 +976,9 @@ UInt64Metric::_table_ = {
     // optional uint64 max = 6;
     {::_pbi::TcParser::SingularVarintNoZag1<::uint64_t, offsetof(UInt64Metric, _impl_.max_), 5>(),
      {48, 5, 0, PROTOBUF_FIELD_OFFSET(UInt64Metric, _impl_.max_)}},
-    {::_pbi::TcParser::MiniParse, {}},
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    {::_pbi::TcParser::SingularVarintNoZag1<::uint32_t, offsetof(UInt64Metric, _impl_.aggregation_), 6>(),
+     {56, 6, 0, PROTOBUF_FIELD_OFFSET(UInt64Metric, _impl_.aggregation_)}},
   }}, {{
     65535, 65535
   }}, {{
@@ -940,6 +1000,9 @@ UInt64Metric::_table_ = {
     // optional uint64 max = 6;
     {PROTOBUF_FIELD_OFFSET(UInt64Metric, _impl_.max_), _Internal::kHasBitsOffset + 5, 0,
     (0 | ::_fl::kFcOptional | ::_fl::kUInt64)},
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    {PROTOBUF_FIELD_OFFSET(UInt64Metric, _impl_.aggregation_), _Internal::kHasBitsOffset + 6, 0,
+    (0 | ::_fl::kFcOptional | ::_fl::kOpenEnum)},
   }},
   // no aux_entries
   {{
@@ -965,10 +1028,10 @@ PROTOBUF_NOINLINE void UInt64Metric::Clear() {
       _impl_.unit_.ClearNonDefaultToEmpty();
     }
   }
-  if ((cached_has_bits & 0x0000003cu) != 0) {
+  if ((cached_has_bits & 0x0000007cu) != 0) {
     ::memset(&_impl_.offset_, 0, static_cast<::size_t>(
-        reinterpret_cast<char*>(&_impl_.max_) -
-        reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.max_));
+        reinterpret_cast<char*>(&_impl_.aggregation_) -
+        reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.aggregation_));
   }
   _impl_._has_bits_.Clear();
   _internal_metadata_.Clear<::google::protobuf::UnknownFieldSet>();
@@ -1040,6 +1103,13 @@ PROTOBUF_NOINLINE void UInt64Metric::Clear() {
         6, this_._internal_max(), target);
   }
 
+  // optional .abacus.protobuf.Aggregation aggregation = 7;
+  if ((cached_has_bits & 0x00000040u) != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+        7, this_._internal_aggregation(), target);
+  }
+
   if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
     target =
         ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
@@ -1065,7 +1135,7 @@ PROTOBUF_NOINLINE void UInt64Metric::Clear() {
 
   ::_pbi::Prefetch5LinesFrom7Lines(&this_);
   cached_has_bits = this_._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x0000003fu) != 0) {
+  if ((cached_has_bits & 0x0000007fu) != 0) {
     // string description = 2;
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!this_._internal_description().empty()) {
@@ -1102,6 +1172,11 @@ PROTOBUF_NOINLINE void UInt64Metric::Clear() {
       total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(
           this_._internal_max());
     }
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    if ((cached_has_bits & 0x00000040u) != 0) {
+      total_size += 1 +
+                    ::_pbi::WireFormatLite::EnumSize(this_._internal_aggregation());
+    }
   }
   return this_.MaybeComputeUnknownFieldsSize(total_size,
                                              &this_._impl_._cached_size_);
@@ -1116,7 +1191,7 @@ void UInt64Metric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::go
   (void) cached_has_bits;
 
   cached_has_bits = from._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x0000003fu) != 0) {
+  if ((cached_has_bits & 0x0000007fu) != 0) {
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!from._internal_description().empty()) {
         _this->_internal_set_description(from._internal_description());
@@ -1145,6 +1220,9 @@ void UInt64Metric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::go
     if ((cached_has_bits & 0x00000020u) != 0) {
       _this->_impl_.max_ = from._impl_.max_;
     }
+    if ((cached_has_bits & 0x00000040u) != 0) {
+      _this->_impl_.aggregation_ = from._impl_.aggregation_;
+    }
   }
   _this->_impl_._has_bits_[0] |= cached_has_bits;
   _this->_internal_metadata_.MergeFrom<::google::protobuf::UnknownFieldSet>(from._internal_metadata_);
@@ -1167,8 +1245,8 @@ void UInt64Metric::InternalSwap(UInt64Metric* PROTOBUF_RESTRICT PROTOBUF_NONNULL
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.description_, &other->_impl_.description_, arena);
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.unit_, &other->_impl_.unit_, arena);
   ::google::protobuf::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(UInt64Metric, _impl_.max_)
-      + sizeof(UInt64Metric::_impl_.max_)
+      PROTOBUF_FIELD_OFFSET(UInt64Metric, _impl_.aggregation_)
+      + sizeof(UInt64Metric::_impl_.aggregation_)
       - PROTOBUF_FIELD_OFFSET(UInt64Metric, _impl_.offset_)>(
           reinterpret_cast<char*>(&_impl_.offset_),
           reinterpret_cast<char*>(&other->_impl_.offset_));
@@ -1222,9 +1300,9 @@ Int64Metric::Int64Metric(
                offsetof(Impl_, offset_),
            reinterpret_cast<const char *>(&from._impl_) +
                offsetof(Impl_, offset_),
-           offsetof(Impl_, max_) -
+           offsetof(Impl_, aggregation_) -
                offsetof(Impl_, offset_) +
-               sizeof(Impl_::max_));
+               sizeof(Impl_::aggregation_));
 
   // @@protoc_insertion_point(copy_constructor:abacus.protobuf.Int64Metric)
 }
@@ -1240,9 +1318,9 @@ inline void Int64Metric::SharedCtor(::_pb::Arena* PROTOBUF_NULLABLE arena) {
   ::memset(reinterpret_cast<char *>(&_impl_) +
                offsetof(Impl_, offset_),
            0,
-           offsetof(Impl_, max_) -
+           offsetof(Impl_, aggregation_) -
                offsetof(Impl_, offset_) +
-               sizeof(Impl_::max_));
+               sizeof(Impl_::aggregation_));
 }
 Int64Metric::~Int64Metric() {
   // @@protoc_insertion_point(destructor:abacus.protobuf.Int64Metric)
@@ -1300,16 +1378,16 @@ Int64Metric::GetClassData() const {
   return Int64Metric_class_data_.base();
 }
 PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1
-const ::_pbi::TcParseTable<3, 6, 0, 51, 2>
+const ::_pbi::TcParseTable<3, 7, 0, 51, 2>
 Int64Metric::_table_ = {
   {
     PROTOBUF_FIELD_OFFSET(Int64Metric, _impl_._has_bits_),
     0, // no _extensions_
-    6, 56,  // max_field_number, fast_idx_mask
+    7, 56,  // max_field_number, fast_idx_mask
     offsetof(decltype(_table_), field_lookup_table),
-    4294967232,  // skipmap
+    4294967168,  // skipmap
     offsetof(decltype(_table_), field_entries),
-    6,  // num_field_entries
+    7,  // num_field_entries
     0,  // num_aux_entries
     offsetof(decltype(_table_), field_names),  // no aux_entries
     Int64Metric_class_data_.base(),
@@ -1338,7 +1416,9 @@ Int64Metric::_table_ = {
     // optional int64 max = 6;
     {::_pbi::TcParser::SingularVarintNoZag1<::uint64_t, offsetof(Int64Metric, _impl_.max_), 5>(),
      {48, 5, 0, PROTOBUF_FIELD_OFFSET(Int64Metric, _impl_.max_)}},
-    {::_pbi::TcParser::MiniParse, {}},
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    {::_pbi::TcParser::SingularVarintNoZag1<::uint32_t, offsetof(Int64Metric, _impl_.aggregation_), 6>(),
+     {56, 6, 0, PROTOBUF_FIELD_OFFSET(Int64Metric, _impl_.aggregation_)}},
   }}, {{
     65535, 65535
   }}, {{
@@ -1360,6 +1440,9 @@ Int64Metric::_table_ = {
     // optional int64 max = 6;
     {PROTOBUF_FIELD_OFFSET(Int64Metric, _impl_.max_), _Internal::kHasBitsOffset + 5, 0,
     (0 | ::_fl::kFcOptional | ::_fl::kInt64)},
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    {PROTOBUF_FIELD_OFFSET(Int64Metric, _impl_.aggregation_), _Internal::kHasBitsOffset + 6, 0,
+    (0 | ::_fl::kFcOptional | ::_fl::kOpenEnum)},
   }},
   // no aux_entries
   {{
@@ -1385,10 +1468,10 @@ PROTOBUF_NOINLINE void Int64Metric::Clear() {
       _impl_.unit_.ClearNonDefaultToEmpty();
     }
   }
-  if ((cached_has_bits & 0x0000003cu) != 0) {
+  if ((cached_has_bits & 0x0000007cu) != 0) {
     ::memset(&_impl_.offset_, 0, static_cast<::size_t>(
-        reinterpret_cast<char*>(&_impl_.max_) -
-        reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.max_));
+        reinterpret_cast<char*>(&_impl_.aggregation_) -
+        reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.aggregation_));
   }
   _impl_._has_bits_.Clear();
   _internal_metadata_.Clear<::google::protobuf::UnknownFieldSet>();
@@ -1460,6 +1543,13 @@ PROTOBUF_NOINLINE void Int64Metric::Clear() {
             stream, this_._internal_max(), target);
   }
 
+  // optional .abacus.protobuf.Aggregation aggregation = 7;
+  if ((cached_has_bits & 0x00000040u) != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+        7, this_._internal_aggregation(), target);
+  }
+
   if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
     target =
         ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
@@ -1485,7 +1575,7 @@ PROTOBUF_NOINLINE void Int64Metric::Clear() {
 
   ::_pbi::Prefetch5LinesFrom7Lines(&this_);
   cached_has_bits = this_._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x0000003fu) != 0) {
+  if ((cached_has_bits & 0x0000007fu) != 0) {
     // string description = 2;
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!this_._internal_description().empty()) {
@@ -1522,6 +1612,11 @@ PROTOBUF_NOINLINE void Int64Metric::Clear() {
       total_size += ::_pbi::WireFormatLite::Int64SizePlusOne(
           this_._internal_max());
     }
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    if ((cached_has_bits & 0x00000040u) != 0) {
+      total_size += 1 +
+                    ::_pbi::WireFormatLite::EnumSize(this_._internal_aggregation());
+    }
   }
   return this_.MaybeComputeUnknownFieldsSize(total_size,
                                              &this_._impl_._cached_size_);
@@ -1536,7 +1631,7 @@ void Int64Metric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::goo
   (void) cached_has_bits;
 
   cached_has_bits = from._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x0000003fu) != 0) {
+  if ((cached_has_bits & 0x0000007fu) != 0) {
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!from._internal_description().empty()) {
         _this->_internal_set_description(from._internal_description());
@@ -1565,6 +1660,9 @@ void Int64Metric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::goo
     if ((cached_has_bits & 0x00000020u) != 0) {
       _this->_impl_.max_ = from._impl_.max_;
     }
+    if ((cached_has_bits & 0x00000040u) != 0) {
+      _this->_impl_.aggregation_ = from._impl_.aggregation_;
+    }
   }
   _this->_impl_._has_bits_[0] |= cached_has_bits;
   _this->_internal_metadata_.MergeFrom<::google::protobuf::UnknownFieldSet>(from._internal_metadata_);
@@ -1587,8 +1685,8 @@ void Int64Metric::InternalSwap(Int64Metric* PROTOBUF_RESTRICT PROTOBUF_NONNULL o
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.description_, &other->_impl_.description_, arena);
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.unit_, &other->_impl_.unit_, arena);
   ::google::protobuf::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(Int64Metric, _impl_.max_)
-      + sizeof(Int64Metric::_impl_.max_)
+      PROTOBUF_FIELD_OFFSET(Int64Metric, _impl_.aggregation_)
+      + sizeof(Int64Metric::_impl_.aggregation_)
       - PROTOBUF_FIELD_OFFSET(Int64Metric, _impl_.offset_)>(
           reinterpret_cast<char*>(&_impl_.offset_),
           reinterpret_cast<char*>(&other->_impl_.offset_));
@@ -1642,9 +1740,9 @@ UInt32Metric::UInt32Metric(
                offsetof(Impl_, offset_),
            reinterpret_cast<const char *>(&from._impl_) +
                offsetof(Impl_, offset_),
-           offsetof(Impl_, max_) -
+           offsetof(Impl_, aggregation_) -
                offsetof(Impl_, offset_) +
-               sizeof(Impl_::max_));
+               sizeof(Impl_::aggregation_));
 
   // @@protoc_insertion_point(copy_constructor:abacus.protobuf.UInt32Metric)
 }
@@ -1660,9 +1758,9 @@ inline void UInt32Metric::SharedCtor(::_pb::Arena* PROTOBUF_NULLABLE arena) {
   ::memset(reinterpret_cast<char *>(&_impl_) +
                offsetof(Impl_, offset_),
            0,
-           offsetof(Impl_, max_) -
+           offsetof(Impl_, aggregation_) -
                offsetof(Impl_, offset_) +
-               sizeof(Impl_::max_));
+               sizeof(Impl_::aggregation_));
 }
 UInt32Metric::~UInt32Metric() {
   // @@protoc_insertion_point(destructor:abacus.protobuf.UInt32Metric)
@@ -1720,16 +1818,16 @@ UInt32Metric::GetClassData() const {
   return UInt32Metric_class_data_.base();
 }
 PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1
-const ::_pbi::TcParseTable<3, 6, 0, 52, 2>
+const ::_pbi::TcParseTable<3, 7, 0, 52, 2>
 UInt32Metric::_table_ = {
   {
     PROTOBUF_FIELD_OFFSET(UInt32Metric, _impl_._has_bits_),
     0, // no _extensions_
-    6, 56,  // max_field_number, fast_idx_mask
+    7, 56,  // max_field_number, fast_idx_mask
     offsetof(decltype(_table_), field_lookup_table),
-    4294967232,  // skipmap
+    4294967168,  // skipmap
     offsetof(decltype(_table_), field_entries),
-    6,  // num_field_entries
+    7,  // num_field_entries
     0,  // num_aux_entries
     offsetof(decltype(_table_), field_names),  // no aux_entries
     UInt32Metric_class_data_.base(),
@@ -1758,7 +1856,9 @@ UInt32Metric::_table_ = {
     // optional uint32 max = 6;
     {::_pbi::TcParser::SingularVarintNoZag1<::uint32_t, offsetof(UInt32Metric, _impl_.max_), 5>(),
      {48, 5, 0, PROTOBUF_FIELD_OFFSET(UInt32Metric, _impl_.max_)}},
-    {::_pbi::TcParser::MiniParse, {}},
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    {::_pbi::TcParser::SingularVarintNoZag1<::uint32_t, offsetof(UInt32Metric, _impl_.aggregation_), 6>(),
+     {56, 6, 0, PROTOBUF_FIELD_OFFSET(UInt32Metric, _impl_.aggregation_)}},
   }}, {{
     65535, 65535
   }}, {{
@@ -1780,6 +1880,9 @@ UInt32Metric::_table_ = {
     // optional uint32 max = 6;
     {PROTOBUF_FIELD_OFFSET(UInt32Metric, _impl_.max_), _Internal::kHasBitsOffset + 5, 0,
     (0 | ::_fl::kFcOptional | ::_fl::kUInt32)},
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    {PROTOBUF_FIELD_OFFSET(UInt32Metric, _impl_.aggregation_), _Internal::kHasBitsOffset + 6, 0,
+    (0 | ::_fl::kFcOptional | ::_fl::kOpenEnum)},
   }},
   // no aux_entries
   {{
@@ -1805,10 +1908,10 @@ PROTOBUF_NOINLINE void UInt32Metric::Clear() {
       _impl_.unit_.ClearNonDefaultToEmpty();
     }
   }
-  if ((cached_has_bits & 0x0000003cu) != 0) {
+  if ((cached_has_bits & 0x0000007cu) != 0) {
     ::memset(&_impl_.offset_, 0, static_cast<::size_t>(
-        reinterpret_cast<char*>(&_impl_.max_) -
-        reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.max_));
+        reinterpret_cast<char*>(&_impl_.aggregation_) -
+        reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.aggregation_));
   }
   _impl_._has_bits_.Clear();
   _internal_metadata_.Clear<::google::protobuf::UnknownFieldSet>();
@@ -1880,6 +1983,13 @@ PROTOBUF_NOINLINE void UInt32Metric::Clear() {
         6, this_._internal_max(), target);
   }
 
+  // optional .abacus.protobuf.Aggregation aggregation = 7;
+  if ((cached_has_bits & 0x00000040u) != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+        7, this_._internal_aggregation(), target);
+  }
+
   if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
     target =
         ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
@@ -1905,7 +2015,7 @@ PROTOBUF_NOINLINE void UInt32Metric::Clear() {
 
   ::_pbi::Prefetch5LinesFrom7Lines(&this_);
   cached_has_bits = this_._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x0000003fu) != 0) {
+  if ((cached_has_bits & 0x0000007fu) != 0) {
     // string description = 2;
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!this_._internal_description().empty()) {
@@ -1942,6 +2052,11 @@ PROTOBUF_NOINLINE void UInt32Metric::Clear() {
       total_size += ::_pbi::WireFormatLite::UInt32SizePlusOne(
           this_._internal_max());
     }
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    if ((cached_has_bits & 0x00000040u) != 0) {
+      total_size += 1 +
+                    ::_pbi::WireFormatLite::EnumSize(this_._internal_aggregation());
+    }
   }
   return this_.MaybeComputeUnknownFieldsSize(total_size,
                                              &this_._impl_._cached_size_);
@@ -1956,7 +2071,7 @@ void UInt32Metric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::go
   (void) cached_has_bits;
 
   cached_has_bits = from._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x0000003fu) != 0) {
+  if ((cached_has_bits & 0x0000007fu) != 0) {
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!from._internal_description().empty()) {
         _this->_internal_set_description(from._internal_description());
@@ -1985,6 +2100,9 @@ void UInt32Metric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::go
     if ((cached_has_bits & 0x00000020u) != 0) {
       _this->_impl_.max_ = from._impl_.max_;
     }
+    if ((cached_has_bits & 0x00000040u) != 0) {
+      _this->_impl_.aggregation_ = from._impl_.aggregation_;
+    }
   }
   _this->_impl_._has_bits_[0] |= cached_has_bits;
   _this->_internal_metadata_.MergeFrom<::google::protobuf::UnknownFieldSet>(from._internal_metadata_);
@@ -2007,8 +2125,8 @@ void UInt32Metric::InternalSwap(UInt32Metric* PROTOBUF_RESTRICT PROTOBUF_NONNULL
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.description_, &other->_impl_.description_, arena);
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.unit_, &other->_impl_.unit_, arena);
   ::google::protobuf::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(UInt32Metric, _impl_.max_)
-      + sizeof(UInt32Metric::_impl_.max_)
+      PROTOBUF_FIELD_OFFSET(UInt32Metric, _impl_.aggregation_)
+      + sizeof(UInt32Metric::_impl_.aggregation_)
       - PROTOBUF_FIELD_OFFSET(UInt32Metric, _impl_.offset_)>(
           reinterpret_cast<char*>(&_impl_.offset_),
           reinterpret_cast<char*>(&other->_impl_.offset_));
@@ -2062,9 +2180,9 @@ Int32Metric::Int32Metric(
                offsetof(Impl_, offset_),
            reinterpret_cast<const char *>(&from._impl_) +
                offsetof(Impl_, offset_),
-           offsetof(Impl_, max_) -
+           offsetof(Impl_, aggregation_) -
                offsetof(Impl_, offset_) +
-               sizeof(Impl_::max_));
+               sizeof(Impl_::aggregation_));
 
   // @@protoc_insertion_point(copy_constructor:abacus.protobuf.Int32Metric)
 }
@@ -2080,9 +2198,9 @@ inline void Int32Metric::SharedCtor(::_pb::Arena* PROTOBUF_NULLABLE arena) {
   ::memset(reinterpret_cast<char *>(&_impl_) +
                offsetof(Impl_, offset_),
            0,
-           offsetof(Impl_, max_) -
+           offsetof(Impl_, aggregation_) -
                offsetof(Impl_, offset_) +
-               sizeof(Impl_::max_));
+               sizeof(Impl_::aggregation_));
 }
 Int32Metric::~Int32Metric() {
   // @@protoc_insertion_point(destructor:abacus.protobuf.Int32Metric)
@@ -2140,16 +2258,16 @@ Int32Metric::GetClassData() const {
   return Int32Metric_class_data_.base();
 }
 PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1
-const ::_pbi::TcParseTable<3, 6, 0, 51, 2>
+const ::_pbi::TcParseTable<3, 7, 0, 51, 2>
 Int32Metric::_table_ = {
   {
     PROTOBUF_FIELD_OFFSET(Int32Metric, _impl_._has_bits_),
     0, // no _extensions_
-    6, 56,  // max_field_number, fast_idx_mask
+    7, 56,  // max_field_number, fast_idx_mask
     offsetof(decltype(_table_), field_lookup_table),
-    4294967232,  // skipmap
+    4294967168,  // skipmap
     offsetof(decltype(_table_), field_entries),
-    6,  // num_field_entries
+    7,  // num_field_entries
     0,  // num_aux_entries
     offsetof(decltype(_table_), field_names),  // no aux_entries
     Int32Metric_class_data_.base(),
@@ -2178,7 +2296,9 @@ Int32Metric::_table_ = {
     // optional int32 max = 6;
     {::_pbi::TcParser::SingularVarintNoZag1<::uint32_t, offsetof(Int32Metric, _impl_.max_), 5>(),
      {48, 5, 0, PROTOBUF_FIELD_OFFSET(Int32Metric, _impl_.max_)}},
-    {::_pbi::TcParser::MiniParse, {}},
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    {::_pbi::TcParser::SingularVarintNoZag1<::uint32_t, offsetof(Int32Metric, _impl_.aggregation_), 6>(),
+     {56, 6, 0, PROTOBUF_FIELD_OFFSET(Int32Metric, _impl_.aggregation_)}},
   }}, {{
     65535, 65535
   }}, {{
@@ -2200,6 +2320,9 @@ Int32Metric::_table_ = {
     // optional int32 max = 6;
     {PROTOBUF_FIELD_OFFSET(Int32Metric, _impl_.max_), _Internal::kHasBitsOffset + 5, 0,
     (0 | ::_fl::kFcOptional | ::_fl::kInt32)},
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    {PROTOBUF_FIELD_OFFSET(Int32Metric, _impl_.aggregation_), _Internal::kHasBitsOffset + 6, 0,
+    (0 | ::_fl::kFcOptional | ::_fl::kOpenEnum)},
   }},
   // no aux_entries
   {{
@@ -2225,10 +2348,10 @@ PROTOBUF_NOINLINE void Int32Metric::Clear() {
       _impl_.unit_.ClearNonDefaultToEmpty();
     }
   }
-  if ((cached_has_bits & 0x0000003cu) != 0) {
+  if ((cached_has_bits & 0x0000007cu) != 0) {
     ::memset(&_impl_.offset_, 0, static_cast<::size_t>(
-        reinterpret_cast<char*>(&_impl_.max_) -
-        reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.max_));
+        reinterpret_cast<char*>(&_impl_.aggregation_) -
+        reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.aggregation_));
   }
   _impl_._has_bits_.Clear();
   _internal_metadata_.Clear<::google::protobuf::UnknownFieldSet>();
@@ -2300,6 +2423,13 @@ PROTOBUF_NOINLINE void Int32Metric::Clear() {
             stream, this_._internal_max(), target);
   }
 
+  // optional .abacus.protobuf.Aggregation aggregation = 7;
+  if ((cached_has_bits & 0x00000040u) != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+        7, this_._internal_aggregation(), target);
+  }
+
   if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
     target =
         ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
@@ -2325,7 +2455,7 @@ PROTOBUF_NOINLINE void Int32Metric::Clear() {
 
   ::_pbi::Prefetch5LinesFrom7Lines(&this_);
   cached_has_bits = this_._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x0000003fu) != 0) {
+  if ((cached_has_bits & 0x0000007fu) != 0) {
     // string description = 2;
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!this_._internal_description().empty()) {
@@ -2362,6 +2492,11 @@ PROTOBUF_NOINLINE void Int32Metric::Clear() {
       total_size += ::_pbi::WireFormatLite::Int32SizePlusOne(
           this_._internal_max());
     }
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    if ((cached_has_bits & 0x00000040u) != 0) {
+      total_size += 1 +
+                    ::_pbi::WireFormatLite::EnumSize(this_._internal_aggregation());
+    }
   }
   return this_.MaybeComputeUnknownFieldsSize(total_size,
                                              &this_._impl_._cached_size_);
@@ -2376,7 +2511,7 @@ void Int32Metric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::goo
   (void) cached_has_bits;
 
   cached_has_bits = from._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x0000003fu) != 0) {
+  if ((cached_has_bits & 0x0000007fu) != 0) {
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!from._internal_description().empty()) {
         _this->_internal_set_description(from._internal_description());
@@ -2405,6 +2540,9 @@ void Int32Metric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::goo
     if ((cached_has_bits & 0x00000020u) != 0) {
       _this->_impl_.max_ = from._impl_.max_;
     }
+    if ((cached_has_bits & 0x00000040u) != 0) {
+      _this->_impl_.aggregation_ = from._impl_.aggregation_;
+    }
   }
   _this->_impl_._has_bits_[0] |= cached_has_bits;
   _this->_internal_metadata_.MergeFrom<::google::protobuf::UnknownFieldSet>(from._internal_metadata_);
@@ -2427,8 +2565,8 @@ void Int32Metric::InternalSwap(Int32Metric* PROTOBUF_RESTRICT PROTOBUF_NONNULL o
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.description_, &other->_impl_.description_, arena);
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.unit_, &other->_impl_.unit_, arena);
   ::google::protobuf::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(Int32Metric, _impl_.max_)
-      + sizeof(Int32Metric::_impl_.max_)
+      PROTOBUF_FIELD_OFFSET(Int32Metric, _impl_.aggregation_)
+      + sizeof(Int32Metric::_impl_.aggregation_)
       - PROTOBUF_FIELD_OFFSET(Int32Metric, _impl_.offset_)>(
           reinterpret_cast<char*>(&_impl_.offset_),
           reinterpret_cast<char*>(&other->_impl_.offset_));
@@ -2482,9 +2620,9 @@ Float64Metric::Float64Metric(
                offsetof(Impl_, offset_),
            reinterpret_cast<const char *>(&from._impl_) +
                offsetof(Impl_, offset_),
-           offsetof(Impl_, max_) -
+           offsetof(Impl_, aggregation_) -
                offsetof(Impl_, offset_) +
-               sizeof(Impl_::max_));
+               sizeof(Impl_::aggregation_));
 
   // @@protoc_insertion_point(copy_constructor:abacus.protobuf.Float64Metric)
 }
@@ -2500,9 +2638,9 @@ inline void Float64Metric::SharedCtor(::_pb::Arena* PROTOBUF_NULLABLE arena) {
   ::memset(reinterpret_cast<char *>(&_impl_) +
                offsetof(Impl_, offset_),
            0,
-           offsetof(Impl_, max_) -
+           offsetof(Impl_, aggregation_) -
                offsetof(Impl_, offset_) +
-               sizeof(Impl_::max_));
+               sizeof(Impl_::aggregation_));
 }
 Float64Metric::~Float64Metric() {
   // @@protoc_insertion_point(destructor:abacus.protobuf.Float64Metric)
@@ -2560,16 +2698,16 @@ Float64Metric::GetClassData() const {
   return Float64Metric_class_data_.base();
 }
 PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1
-const ::_pbi::TcParseTable<3, 6, 0, 53, 2>
+const ::_pbi::TcParseTable<3, 7, 0, 53, 2>
 Float64Metric::_table_ = {
   {
     PROTOBUF_FIELD_OFFSET(Float64Metric, _impl_._has_bits_),
     0, // no _extensions_
-    6, 56,  // max_field_number, fast_idx_mask
+    7, 56,  // max_field_number, fast_idx_mask
     offsetof(decltype(_table_), field_lookup_table),
-    4294967232,  // skipmap
+    4294967168,  // skipmap
     offsetof(decltype(_table_), field_entries),
-    6,  // num_field_entries
+    7,  // num_field_entries
     0,  // num_aux_entries
     offsetof(decltype(_table_), field_names),  // no aux_entries
     Float64Metric_class_data_.base(),
@@ -2598,7 +2736,9 @@ Float64Metric::_table_ = {
     // optional double max = 6;
     {::_pbi::TcParser::FastF64S1,
      {49, 5, 0, PROTOBUF_FIELD_OFFSET(Float64Metric, _impl_.max_)}},
-    {::_pbi::TcParser::MiniParse, {}},
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    {::_pbi::TcParser::SingularVarintNoZag1<::uint32_t, offsetof(Float64Metric, _impl_.aggregation_), 6>(),
+     {56, 6, 0, PROTOBUF_FIELD_OFFSET(Float64Metric, _impl_.aggregation_)}},
   }}, {{
     65535, 65535
   }}, {{
@@ -2620,6 +2760,9 @@ Float64Metric::_table_ = {
     // optional double max = 6;
     {PROTOBUF_FIELD_OFFSET(Float64Metric, _impl_.max_), _Internal::kHasBitsOffset + 5, 0,
     (0 | ::_fl::kFcOptional | ::_fl::kDouble)},
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    {PROTOBUF_FIELD_OFFSET(Float64Metric, _impl_.aggregation_), _Internal::kHasBitsOffset + 6, 0,
+    (0 | ::_fl::kFcOptional | ::_fl::kOpenEnum)},
   }},
   // no aux_entries
   {{
@@ -2645,10 +2788,10 @@ PROTOBUF_NOINLINE void Float64Metric::Clear() {
       _impl_.unit_.ClearNonDefaultToEmpty();
     }
   }
-  if ((cached_has_bits & 0x0000003cu) != 0) {
+  if ((cached_has_bits & 0x0000007cu) != 0) {
     ::memset(&_impl_.offset_, 0, static_cast<::size_t>(
-        reinterpret_cast<char*>(&_impl_.max_) -
-        reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.max_));
+        reinterpret_cast<char*>(&_impl_.aggregation_) -
+        reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.aggregation_));
   }
   _impl_._has_bits_.Clear();
   _internal_metadata_.Clear<::google::protobuf::UnknownFieldSet>();
@@ -2720,6 +2863,13 @@ PROTOBUF_NOINLINE void Float64Metric::Clear() {
         6, this_._internal_max(), target);
   }
 
+  // optional .abacus.protobuf.Aggregation aggregation = 7;
+  if ((cached_has_bits & 0x00000040u) != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+        7, this_._internal_aggregation(), target);
+  }
+
   if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
     target =
         ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
@@ -2746,7 +2896,7 @@ PROTOBUF_NOINLINE void Float64Metric::Clear() {
   ::_pbi::Prefetch5LinesFrom7Lines(&this_);
   cached_has_bits = this_._impl_._has_bits_[0];
   total_size += ::absl::popcount(0x00000030u & cached_has_bits) * 9;
-  if ((cached_has_bits & 0x0000000fu) != 0) {
+  if ((cached_has_bits & 0x0000004fu) != 0) {
     // string description = 2;
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!this_._internal_description().empty()) {
@@ -2773,6 +2923,11 @@ PROTOBUF_NOINLINE void Float64Metric::Clear() {
                       ::_pbi::WireFormatLite::EnumSize(this_._internal_kind());
       }
     }
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    if ((cached_has_bits & 0x00000040u) != 0) {
+      total_size += 1 +
+                    ::_pbi::WireFormatLite::EnumSize(this_._internal_aggregation());
+    }
   }
   return this_.MaybeComputeUnknownFieldsSize(total_size,
                                              &this_._impl_._cached_size_);
@@ -2787,7 +2942,7 @@ void Float64Metric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::g
   (void) cached_has_bits;
 
   cached_has_bits = from._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x0000003fu) != 0) {
+  if ((cached_has_bits & 0x0000007fu) != 0) {
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!from._internal_description().empty()) {
         _this->_internal_set_description(from._internal_description());
@@ -2816,6 +2971,9 @@ void Float64Metric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::g
     if ((cached_has_bits & 0x00000020u) != 0) {
       _this->_impl_.max_ = from._impl_.max_;
     }
+    if ((cached_has_bits & 0x00000040u) != 0) {
+      _this->_impl_.aggregation_ = from._impl_.aggregation_;
+    }
   }
   _this->_impl_._has_bits_[0] |= cached_has_bits;
   _this->_internal_metadata_.MergeFrom<::google::protobuf::UnknownFieldSet>(from._internal_metadata_);
@@ -2838,8 +2996,8 @@ void Float64Metric::InternalSwap(Float64Metric* PROTOBUF_RESTRICT PROTOBUF_NONNU
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.description_, &other->_impl_.description_, arena);
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.unit_, &other->_impl_.unit_, arena);
   ::google::protobuf::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(Float64Metric, _impl_.max_)
-      + sizeof(Float64Metric::_impl_.max_)
+      PROTOBUF_FIELD_OFFSET(Float64Metric, _impl_.aggregation_)
+      + sizeof(Float64Metric::_impl_.aggregation_)
       - PROTOBUF_FIELD_OFFSET(Float64Metric, _impl_.offset_)>(
           reinterpret_cast<char*>(&_impl_.offset_),
           reinterpret_cast<char*>(&other->_impl_.offset_));
@@ -2893,9 +3051,9 @@ Float32Metric::Float32Metric(
                offsetof(Impl_, offset_),
            reinterpret_cast<const char *>(&from._impl_) +
                offsetof(Impl_, offset_),
-           offsetof(Impl_, max_) -
+           offsetof(Impl_, aggregation_) -
                offsetof(Impl_, offset_) +
-               sizeof(Impl_::max_));
+               sizeof(Impl_::aggregation_));
 
   // @@protoc_insertion_point(copy_constructor:abacus.protobuf.Float32Metric)
 }
@@ -2911,9 +3069,9 @@ inline void Float32Metric::SharedCtor(::_pb::Arena* PROTOBUF_NULLABLE arena) {
   ::memset(reinterpret_cast<char *>(&_impl_) +
                offsetof(Impl_, offset_),
            0,
-           offsetof(Impl_, max_) -
+           offsetof(Impl_, aggregation_) -
                offsetof(Impl_, offset_) +
-               sizeof(Impl_::max_));
+               sizeof(Impl_::aggregation_));
 }
 Float32Metric::~Float32Metric() {
   // @@protoc_insertion_point(destructor:abacus.protobuf.Float32Metric)
@@ -2971,16 +3129,16 @@ Float32Metric::GetClassData() const {
   return Float32Metric_class_data_.base();
 }
 PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1
-const ::_pbi::TcParseTable<3, 6, 0, 53, 2>
+const ::_pbi::TcParseTable<3, 7, 0, 53, 2>
 Float32Metric::_table_ = {
   {
     PROTOBUF_FIELD_OFFSET(Float32Metric, _impl_._has_bits_),
     0, // no _extensions_
-    6, 56,  // max_field_number, fast_idx_mask
+    7, 56,  // max_field_number, fast_idx_mask
     offsetof(decltype(_table_), field_lookup_table),
-    4294967232,  // skipmap
+    4294967168,  // skipmap
     offsetof(decltype(_table_), field_entries),
-    6,  // num_field_entries
+    7,  // num_field_entries
     0,  // num_aux_entries
     offsetof(decltype(_table_), field_names),  // no aux_entries
     Float32Metric_class_data_.base(),
@@ -3009,7 +3167,9 @@ Float32Metric::_table_ = {
     // optional float max = 6;
     {::_pbi::TcParser::FastF32S1,
      {53, 5, 0, PROTOBUF_FIELD_OFFSET(Float32Metric, _impl_.max_)}},
-    {::_pbi::TcParser::MiniParse, {}},
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    {::_pbi::TcParser::SingularVarintNoZag1<::uint32_t, offsetof(Float32Metric, _impl_.aggregation_), 6>(),
+     {56, 6, 0, PROTOBUF_FIELD_OFFSET(Float32Metric, _impl_.aggregation_)}},
   }}, {{
     65535, 65535
   }}, {{
@@ -3031,6 +3191,9 @@ Float32Metric::_table_ = {
     // optional float max = 6;
     {PROTOBUF_FIELD_OFFSET(Float32Metric, _impl_.max_), _Internal::kHasBitsOffset + 5, 0,
     (0 | ::_fl::kFcOptional | ::_fl::kFloat)},
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    {PROTOBUF_FIELD_OFFSET(Float32Metric, _impl_.aggregation_), _Internal::kHasBitsOffset + 6, 0,
+    (0 | ::_fl::kFcOptional | ::_fl::kOpenEnum)},
   }},
   // no aux_entries
   {{
@@ -3056,10 +3219,10 @@ PROTOBUF_NOINLINE void Float32Metric::Clear() {
       _impl_.unit_.ClearNonDefaultToEmpty();
     }
   }
-  if ((cached_has_bits & 0x0000003cu) != 0) {
+  if ((cached_has_bits & 0x0000007cu) != 0) {
     ::memset(&_impl_.offset_, 0, static_cast<::size_t>(
-        reinterpret_cast<char*>(&_impl_.max_) -
-        reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.max_));
+        reinterpret_cast<char*>(&_impl_.aggregation_) -
+        reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.aggregation_));
   }
   _impl_._has_bits_.Clear();
   _internal_metadata_.Clear<::google::protobuf::UnknownFieldSet>();
@@ -3131,6 +3294,13 @@ PROTOBUF_NOINLINE void Float32Metric::Clear() {
         6, this_._internal_max(), target);
   }
 
+  // optional .abacus.protobuf.Aggregation aggregation = 7;
+  if ((cached_has_bits & 0x00000040u) != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+        7, this_._internal_aggregation(), target);
+  }
+
   if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
     target =
         ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
@@ -3157,7 +3327,7 @@ PROTOBUF_NOINLINE void Float32Metric::Clear() {
   ::_pbi::Prefetch5LinesFrom7Lines(&this_);
   cached_has_bits = this_._impl_._has_bits_[0];
   total_size += ::absl::popcount(0x00000030u & cached_has_bits) * 5;
-  if ((cached_has_bits & 0x0000000fu) != 0) {
+  if ((cached_has_bits & 0x0000004fu) != 0) {
     // string description = 2;
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!this_._internal_description().empty()) {
@@ -3184,6 +3354,11 @@ PROTOBUF_NOINLINE void Float32Metric::Clear() {
                       ::_pbi::WireFormatLite::EnumSize(this_._internal_kind());
       }
     }
+    // optional .abacus.protobuf.Aggregation aggregation = 7;
+    if ((cached_has_bits & 0x00000040u) != 0) {
+      total_size += 1 +
+                    ::_pbi::WireFormatLite::EnumSize(this_._internal_aggregation());
+    }
   }
   return this_.MaybeComputeUnknownFieldsSize(total_size,
                                              &this_._impl_._cached_size_);
@@ -3198,7 +3373,7 @@ void Float32Metric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::g
   (void) cached_has_bits;
 
   cached_has_bits = from._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x0000003fu) != 0) {
+  if ((cached_has_bits & 0x0000007fu) != 0) {
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!from._internal_description().empty()) {
         _this->_internal_set_description(from._internal_description());
@@ -3227,6 +3402,9 @@ void Float32Metric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::g
     if ((cached_has_bits & 0x00000020u) != 0) {
       _this->_impl_.max_ = from._impl_.max_;
     }
+    if ((cached_has_bits & 0x00000040u) != 0) {
+      _this->_impl_.aggregation_ = from._impl_.aggregation_;
+    }
   }
   _this->_impl_._has_bits_[0] |= cached_has_bits;
   _this->_internal_metadata_.MergeFrom<::google::protobuf::UnknownFieldSet>(from._internal_metadata_);
@@ -3249,8 +3427,8 @@ void Float32Metric::InternalSwap(Float32Metric* PROTOBUF_RESTRICT PROTOBUF_NONNU
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.description_, &other->_impl_.description_, arena);
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.unit_, &other->_impl_.unit_, arena);
   ::google::protobuf::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(Float32Metric, _impl_.max_)
-      + sizeof(Float32Metric::_impl_.max_)
+      PROTOBUF_FIELD_OFFSET(Float32Metric, _impl_.aggregation_)
+      + sizeof(Float32Metric::_impl_.aggregation_)
       - PROTOBUF_FIELD_OFFSET(Float32Metric, _impl_.offset_)>(
           reinterpret_cast<char*>(&_impl_.offset_),
           reinterpret_cast<char*>(&other->_impl_.offset_));
@@ -3300,7 +3478,13 @@ BoolMetric::BoolMetric(
   _internal_metadata_.MergeFrom<::google::protobuf::UnknownFieldSet>(
       from._internal_metadata_);
   new (&_impl_) Impl_(internal_visibility(), arena, from._impl_, from);
-  _impl_.offset_ = from._impl_.offset_;
+  ::memcpy(reinterpret_cast<char *>(&_impl_) +
+               offsetof(Impl_, offset_),
+           reinterpret_cast<const char *>(&from._impl_) +
+               offsetof(Impl_, offset_),
+           offsetof(Impl_, aggregation_) -
+               offsetof(Impl_, offset_) +
+               sizeof(Impl_::aggregation_));
 
   // @@protoc_insertion_point(copy_constructor:abacus.protobuf.BoolMetric)
 }
@@ -3313,7 +3497,12 @@ PROTOBUF_NDEBUG_INLINE BoolMetric::Impl_::Impl_(
 
 inline void BoolMetric::SharedCtor(::_pb::Arena* PROTOBUF_NULLABLE arena) {
   new (&_impl_) Impl_(internal_visibility(), arena);
-  _impl_.offset_ = {};
+  ::memset(reinterpret_cast<char *>(&_impl_) +
+               offsetof(Impl_, offset_),
+           0,
+           offsetof(Impl_, aggregation_) -
+               offsetof(Impl_, offset_) +
+               sizeof(Impl_::aggregation_));
 }
 BoolMetric::~BoolMetric() {
   // @@protoc_insertion_point(destructor:abacus.protobuf.BoolMetric)
@@ -3371,16 +3560,16 @@ BoolMetric::GetClassData() const {
   return BoolMetric_class_data_.base();
 }
 PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1
-const ::_pbi::TcParseTable<2, 3, 0, 50, 2>
+const ::_pbi::TcParseTable<2, 4, 0, 50, 2>
 BoolMetric::_table_ = {
   {
     PROTOBUF_FIELD_OFFSET(BoolMetric, _impl_._has_bits_),
     0, // no _extensions_
-    3, 24,  // max_field_number, fast_idx_mask
+    4, 24,  // max_field_number, fast_idx_mask
     offsetof(decltype(_table_), field_lookup_table),
-    4294967288,  // skipmap
+    4294967280,  // skipmap
     offsetof(decltype(_table_), field_entries),
-    3,  // num_field_entries
+    4,  // num_field_entries
     0,  // num_aux_entries
     offsetof(decltype(_table_), field_names),  // no aux_entries
     BoolMetric_class_data_.base(),
@@ -3390,7 +3579,9 @@ BoolMetric::_table_ = {
     ::_pbi::TcParser::GetTable<::abacus::protobuf::BoolMetric>(),  // to_prefetch
     #endif  // PROTOBUF_PREFETCH_PARSE_TABLE
   }, {{
-    {::_pbi::TcParser::MiniParse, {}},
+    // optional .abacus.protobuf.Aggregation aggregation = 4;
+    {::_pbi::TcParser::SingularVarintNoZag1<::uint32_t, offsetof(BoolMetric, _impl_.aggregation_), 3>(),
+     {32, 3, 0, PROTOBUF_FIELD_OFFSET(BoolMetric, _impl_.aggregation_)}},
     // uint32 offset = 1;
     {::_pbi::TcParser::SingularVarintNoZag1<::uint32_t, offsetof(BoolMetric, _impl_.offset_), 2>(),
      {8, 2, 0, PROTOBUF_FIELD_OFFSET(BoolMetric, _impl_.offset_)}},
@@ -3412,6 +3603,9 @@ BoolMetric::_table_ = {
     // optional string unit = 3;
     {PROTOBUF_FIELD_OFFSET(BoolMetric, _impl_.unit_), _Internal::kHasBitsOffset + 1, 0,
     (0 | ::_fl::kFcOptional | ::_fl::kUtf8String | ::_fl::kRepAString)},
+    // optional .abacus.protobuf.Aggregation aggregation = 4;
+    {PROTOBUF_FIELD_OFFSET(BoolMetric, _impl_.aggregation_), _Internal::kHasBitsOffset + 3, 0,
+    (0 | ::_fl::kFcOptional | ::_fl::kOpenEnum)},
   }},
   // no aux_entries
   {{
@@ -3437,7 +3631,11 @@ PROTOBUF_NOINLINE void BoolMetric::Clear() {
       _impl_.unit_.ClearNonDefaultToEmpty();
     }
   }
-  _impl_.offset_ = 0u;
+  if ((cached_has_bits & 0x0000000cu) != 0) {
+    ::memset(&_impl_.offset_, 0, static_cast<::size_t>(
+        reinterpret_cast<char*>(&_impl_.aggregation_) -
+        reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.aggregation_));
+  }
   _impl_._has_bits_.Clear();
   _internal_metadata_.Clear<::google::protobuf::UnknownFieldSet>();
 }
@@ -3485,6 +3683,13 @@ PROTOBUF_NOINLINE void BoolMetric::Clear() {
     target = stream->WriteStringMaybeAliased(3, _s, target);
   }
 
+  // optional .abacus.protobuf.Aggregation aggregation = 4;
+  if ((cached_has_bits & 0x00000008u) != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+        4, this_._internal_aggregation(), target);
+  }
+
   if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
     target =
         ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
@@ -3510,7 +3715,7 @@ PROTOBUF_NOINLINE void BoolMetric::Clear() {
 
   ::_pbi::Prefetch5LinesFrom7Lines(&this_);
   cached_has_bits = this_._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x00000007u) != 0) {
+  if ((cached_has_bits & 0x0000000fu) != 0) {
     // string description = 2;
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!this_._internal_description().empty()) {
@@ -3530,6 +3735,11 @@ PROTOBUF_NOINLINE void BoolMetric::Clear() {
             this_._internal_offset());
       }
     }
+    // optional .abacus.protobuf.Aggregation aggregation = 4;
+    if ((cached_has_bits & 0x00000008u) != 0) {
+      total_size += 1 +
+                    ::_pbi::WireFormatLite::EnumSize(this_._internal_aggregation());
+    }
   }
   return this_.MaybeComputeUnknownFieldsSize(total_size,
                                              &this_._impl_._cached_size_);
@@ -3544,7 +3754,7 @@ void BoolMetric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::goog
   (void) cached_has_bits;
 
   cached_has_bits = from._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x00000007u) != 0) {
+  if ((cached_has_bits & 0x0000000fu) != 0) {
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!from._internal_description().empty()) {
         _this->_internal_set_description(from._internal_description());
@@ -3562,6 +3772,9 @@ void BoolMetric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::goog
         _this->_impl_.offset_ = from._impl_.offset_;
       }
     }
+    if ((cached_has_bits & 0x00000008u) != 0) {
+      _this->_impl_.aggregation_ = from._impl_.aggregation_;
+    }
   }
   _this->_impl_._has_bits_[0] |= cached_has_bits;
   _this->_internal_metadata_.MergeFrom<::google::protobuf::UnknownFieldSet>(from._internal_metadata_);
@@ -3583,7 +3796,12 @@ void BoolMetric::InternalSwap(BoolMetric* PROTOBUF_RESTRICT PROTOBUF_NONNULL oth
   swap(_impl_._has_bits_[0], other->_impl_._has_bits_[0]);
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.description_, &other->_impl_.description_, arena);
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.unit_, &other->_impl_.unit_, arena);
-  swap(_impl_.offset_, other->_impl_.offset_);
+  ::google::protobuf::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(BoolMetric, _impl_.aggregation_)
+      + sizeof(BoolMetric::_impl_.aggregation_)
+      - PROTOBUF_FIELD_OFFSET(BoolMetric, _impl_.offset_)>(
+          reinterpret_cast<char*>(&_impl_.offset_),
+          reinterpret_cast<char*>(&other->_impl_.offset_));
 }
 
 ::google::protobuf::Metadata BoolMetric::GetMetadata() const {
@@ -4025,7 +4243,13 @@ Enum8Metric::Enum8Metric(
   _internal_metadata_.MergeFrom<::google::protobuf::UnknownFieldSet>(
       from._internal_metadata_);
   new (&_impl_) Impl_(internal_visibility(), arena, from._impl_, from);
-  _impl_.offset_ = from._impl_.offset_;
+  ::memcpy(reinterpret_cast<char *>(&_impl_) +
+               offsetof(Impl_, offset_),
+           reinterpret_cast<const char *>(&from._impl_) +
+               offsetof(Impl_, offset_),
+           offsetof(Impl_, aggregation_) -
+               offsetof(Impl_, offset_) +
+               sizeof(Impl_::aggregation_));
 
   // @@protoc_insertion_point(copy_constructor:abacus.protobuf.Enum8Metric)
 }
@@ -4039,7 +4263,12 @@ PROTOBUF_NDEBUG_INLINE Enum8Metric::Impl_::Impl_(
 
 inline void Enum8Metric::SharedCtor(::_pb::Arena* PROTOBUF_NULLABLE arena) {
   new (&_impl_) Impl_(internal_visibility(), arena);
-  _impl_.offset_ = {};
+  ::memset(reinterpret_cast<char *>(&_impl_) +
+               offsetof(Impl_, offset_),
+           0,
+           offsetof(Impl_, aggregation_) -
+               offsetof(Impl_, offset_) +
+               sizeof(Impl_::aggregation_));
 }
 Enum8Metric::~Enum8Metric() {
   // @@protoc_insertion_point(destructor:abacus.protobuf.Enum8Metric)
@@ -4113,16 +4342,16 @@ Enum8Metric::GetClassData() const {
   return Enum8Metric_class_data_.base();
 }
 PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1
-const ::_pbi::TcParseTable<2, 4, 2, 51, 2>
+const ::_pbi::TcParseTable<3, 5, 2, 51, 2>
 Enum8Metric::_table_ = {
   {
     PROTOBUF_FIELD_OFFSET(Enum8Metric, _impl_._has_bits_),
     0, // no _extensions_
-    4, 24,  // max_field_number, fast_idx_mask
+    5, 56,  // max_field_number, fast_idx_mask
     offsetof(decltype(_table_), field_lookup_table),
-    4294967280,  // skipmap
+    4294967264,  // skipmap
     offsetof(decltype(_table_), field_entries),
-    4,  // num_field_entries
+    5,  // num_field_entries
     2,  // num_aux_entries
     offsetof(decltype(_table_), aux_entries),
     Enum8Metric_class_data_.base(),
@@ -4132,9 +4361,7 @@ Enum8Metric::_table_ = {
     ::_pbi::TcParser::GetTable<::abacus::protobuf::Enum8Metric>(),  // to_prefetch
     #endif  // PROTOBUF_PREFETCH_PARSE_TABLE
   }, {{
-    // optional string unit = 4;
-    {::_pbi::TcParser::FastUS1,
-     {34, 1, 0, PROTOBUF_FIELD_OFFSET(Enum8Metric, _impl_.unit_)}},
+    {::_pbi::TcParser::MiniParse, {}},
     // uint32 offset = 1;
     {::_pbi::TcParser::SingularVarintNoZag1<::uint32_t, offsetof(Enum8Metric, _impl_.offset_), 2>(),
      {8, 2, 0, PROTOBUF_FIELD_OFFSET(Enum8Metric, _impl_.offset_)}},
@@ -4142,6 +4369,14 @@ Enum8Metric::_table_ = {
     {::_pbi::TcParser::FastUS1,
      {18, 0, 0, PROTOBUF_FIELD_OFFSET(Enum8Metric, _impl_.description_)}},
     {::_pbi::TcParser::MiniParse, {}},
+    // optional string unit = 4;
+    {::_pbi::TcParser::FastUS1,
+     {34, 1, 0, PROTOBUF_FIELD_OFFSET(Enum8Metric, _impl_.unit_)}},
+    // optional .abacus.protobuf.Aggregation aggregation = 5;
+    {::_pbi::TcParser::SingularVarintNoZag1<::uint32_t, offsetof(Enum8Metric, _impl_.aggregation_), 3>(),
+     {40, 3, 0, PROTOBUF_FIELD_OFFSET(Enum8Metric, _impl_.aggregation_)}},
+    {::_pbi::TcParser::MiniParse, {}},
+    {::_pbi::TcParser::MiniParse, {}},
   }}, {{
     65535, 65535
   }}, {{
@@ -4157,6 +4392,9 @@ Enum8Metric::_table_ = {
     // optional string unit = 4;
     {PROTOBUF_FIELD_OFFSET(Enum8Metric, _impl_.unit_), _Internal::kHasBitsOffset + 1, 0,
     (0 | ::_fl::kFcOptional | ::_fl::kUtf8String | ::_fl::kRepAString)},
+    // optional .abacus.protobuf.Aggregation aggregation = 5;
+    {PROTOBUF_FIELD_OFFSET(Enum8Metric, _impl_.aggregation_), _Internal::kHasBitsOffset + 3, 0,
+    (0 | ::_fl::kFcOptional | ::_fl::kOpenEnum)},
   }},
   {{
       {::_pbi::TcParser::GetMapAuxInfo(0, 0, 0,
@@ -4188,7 +4426,11 @@ PROTOBUF_NOINLINE void Enum8Metric::Clear() {
       _impl_.unit_.ClearNonDefaultToEmpty();
     }
   }
-  _impl_.offset_ = 0u;
+  if ((cached_has_bits & 0x0000000cu) != 0) {
+    ::memset(&_impl_.offset_, 0, static_cast<::size_t>(
+        reinterpret_cast<char*>(&_impl_.aggregation_) -
+        reinterpret_cast<char*>(&_impl_.offset_)) + sizeof(_impl_.aggregation_));
+  }
   _impl_._has_bits_.Clear();
   _internal_metadata_.Clear<::google::protobuf::UnknownFieldSet>();
 }
@@ -4257,6 +4499,13 @@ PROTOBUF_NOINLINE void Enum8Metric::Clear() {
     target = stream->WriteStringMaybeAliased(4, _s, target);
   }
 
+  // optional .abacus.protobuf.Aggregation aggregation = 5;
+  if ((cached_has_bits & 0x00000008u) != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteEnumToArray(
+        5, this_._internal_aggregation(), target);
+  }
+
   if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
     target =
         ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
@@ -4294,7 +4543,7 @@ PROTOBUF_NOINLINE void Enum8Metric::Clear() {
     }
   }
   cached_has_bits = this_._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x00000007u) != 0) {
+  if ((cached_has_bits & 0x0000000fu) != 0) {
     // string description = 2;
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!this_._internal_description().empty()) {
@@ -4314,6 +4563,11 @@ PROTOBUF_NOINLINE void Enum8Metric::Clear() {
             this_._internal_offset());
       }
     }
+    // optional .abacus.protobuf.Aggregation aggregation = 5;
+    if ((cached_has_bits & 0x00000008u) != 0) {
+      total_size += 1 +
+                    ::_pbi::WireFormatLite::EnumSize(this_._internal_aggregation());
+    }
   }
   return this_.MaybeComputeUnknownFieldsSize(total_size,
                                              &this_._impl_._cached_size_);
@@ -4329,7 +4583,7 @@ void Enum8Metric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::goo
 
   _this->_impl_.values_.MergeFrom(from._impl_.values_);
   cached_has_bits = from._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x00000007u) != 0) {
+  if ((cached_has_bits & 0x0000000fu) != 0) {
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (!from._internal_description().empty()) {
         _this->_internal_set_description(from._internal_description());
@@ -4347,6 +4601,9 @@ void Enum8Metric::MergeImpl(::google::protobuf::MessageLite& to_msg, const ::goo
         _this->_impl_.offset_ = from._impl_.offset_;
       }
     }
+    if ((cached_has_bits & 0x00000008u) != 0) {
+      _this->_impl_.aggregation_ = from._impl_.aggregation_;
+    }
   }
   _this->_impl_._has_bits_[0] |= cached_has_bits;
   _this->_internal_metadata_.MergeFrom<::google::protobuf::UnknownFieldSet>(from._internal_metadata_);
@@ -4369,7 +4626,12 @@ void Enum8Metric::InternalSwap(Enum8Metric* PROTOBUF_RESTRICT PROTOBUF_NONNULL o
   _impl_.values_.InternalSwap(&other->_impl_.values_);
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.description_, &other->_impl_.description_, arena);
   ::_pbi::ArenaStringPtr::InternalSwap(&_impl_.unit_, &other->_impl_.unit_, arena);
-  swap(_impl_.offset_, other->_impl_.offset_);
+  ::google::protobuf::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(Enum8Metric, _impl_.aggregation_)
+      + sizeof(Enum8Metric::_impl_.aggregation_)
+      - PROTOBUF_FIELD_OFFSET(Enum8Metric, _impl_.offset_)>(
+          reinterpret_cast<char*>(&_impl_.offset_),
+          reinterpret_cast<char*>(&other->_impl_.offset_));
 }
 
 ::google::protobuf::Metadata Enum8Metric::GetMetadata() const {
@@ -5675,7 +5937,10 @@ PROTOBUF_NDEBUG_INLINE MetricsMetadata::Impl_::Impl_(
     const ::abacus::protobuf::MetricsMetadata& from_msg)
       : _has_bits_{from._has_bits_},
         _cached_size_{0},
-        metrics_{visibility, arena, from.metrics_} {}
+        metrics_{visibility, arena, from.metrics_},
+        strings_{visibility, arena, from.strings_},
+        references_{visibility, arena, from.references_},
+        _references_cached_byte_size_{0} {}
 
 MetricsMetadata::MetricsMetadata(
     ::google::protobuf::Arena* PROTOBUF_NULLABLE arena,
@@ -5694,9 +5959,9 @@ MetricsMetadata::MetricsMetadata(
                offsetof(Impl_, protocol_version_),
            reinterpret_cast<const char *>(&from._impl_) +
                offsetof(Impl_, protocol_version_),
-           offsetof(Impl_, sync_value_) -
+           offsetof(Impl_, base_sync_value_) -
                offsetof(Impl_, protocol_version_) +
-               sizeof(Impl_::sync_value_));
+               sizeof(Impl_::base_sync_value_));
 
   // @@protoc_insertion_point(copy_constructor:abacus.protobuf.MetricsMetadata)
 }
@@ -5704,16 +5969,19 @@ PROTOBUF_NDEBUG_INLINE MetricsMetadata::Impl_::Impl_(
     ::google::protobuf::internal::InternalVisibility visibility,
     ::google::protobuf::Arena* PROTOBUF_NULLABLE arena)
       : _cached_size_{0},
-        metrics_{visibility, arena} {}
+        metrics_{visibility, arena},
+        strings_{visibility, arena},
+        references_{visibility, arena},
+        _references_cached_byte_size_{0} {}
 
 inline void MetricsMetadata::SharedCtor(::_pb::Arena* PROTOBUF_NULLABLE arena) {
   new (&_impl_) Impl_(internal_visibility(), arena);
   ::memset(reinterpret_cast<char *>(&_impl_) +
                offsetof(Impl_, protocol_version_),
            0,
-           offsetof(Impl_, sync_value_) -
+           offsetof(Impl_, base_sync_value_) -
                offsetof(Impl_, protocol_version_) +
-               sizeof(Impl_::sync_value_));
+               sizeof(Impl_::base_sync_value_));
 }
 MetricsMetadata::~MetricsMetadata() {
   // @@protoc_insertion_point(destructor:abacus.protobuf.MetricsMetadata)
@@ -5741,6 +6009,14 @@ constexpr auto MetricsMetadata::InternalNewImpl_() {
           decltype(MetricsMetadata::_impl_.metrics_)::
               InternalGetArenaOffsetAlt(
                   ::google::protobuf::Message::internal_visibility()),
+      PROTOBUF_FIELD_OFFSET(MetricsMetadata, _impl_.strings_) +
+          decltype(MetricsMetadata::_impl_.strings_)::
+              InternalGetArenaOffset(
+                  ::google::protobuf::Message::internal_visibility()),
+      PROTOBUF_FIELD_OFFSET(MetricsMetadata, _impl_.references_) +
+          decltype(MetricsMetadata::_impl_.references_)::
+              InternalGetArenaOffset(
+                  ::google::protobuf::Message::internal_visibility()),
   });
   if (arena_bits.has_value()) {
     return ::google::protobuf::internal::MessageCreator::CopyInit(
@@ -5785,16 +6061,16 @@ MetricsMetadata::GetClassData() const {
   return MetricsMetadata_class_data_.base();
 }
 PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1
-const ::_pbi::TcParseTable<2, 4, 2, 47, 2>
+const ::_pbi::TcParseTable<3, 7, 2, 54, 2>
 MetricsMetadata::_table_ = {
   {
     PROTOBUF_FIELD_OFFSET(MetricsMetadata, _impl_._has_bits_),
     0, // no _extensions_
-    4, 24,  // max_field_number, fast_idx_mask
+    7, 56,  // max_field_number, fast_idx_mask
     offsetof(decltype(_table_), field_lookup_table),
-    4294967280,  // skipmap
+    4294967168,  // skipmap
     offsetof(decltype(_table_), field_entries),
-    4,  // num_field_entries
+    7,  // num_field_entries
     2,  // num_aux_entries
     offsetof(decltype(_table_), aux_entries),
     MetricsMetadata_class_data_.base(),
@@ -5814,6 +6090,16 @@ MetricsMetadata::_table_ = {
     // fixed32 sync_value = 3;
     {::_pbi::TcParser::FastF32S1,
      {29, 2, 0, PROTOBUF_FIELD_OFFSET(MetricsMetadata, _impl_.sync_value_)}},
+    {::_pbi::TcParser::MiniParse, {}},
+    // fixed32 base_sync_value = 5;
+    {::_pbi::TcParser::FastF32S1,
+     {45, 3, 0, PROTOBUF_FIELD_OFFSET(MetricsMetadata, _impl_.base_sync_value_)}},
+    // repeated string strings = 6;
+    {::_pbi::TcParser::FastUR1,
+     {50, 63, 0, PROTOBUF_FIELD_OFFSET(MetricsMetadata, _impl_.strings_)}},
+    // repeated uint32 references = 7;
+    {::_pbi::TcParser::FastV32P1,
+     {58, 63, 0, PROTOBUF_FIELD_OFFSET(MetricsMetadata, _impl_.references_)}},
   }}, {{
     65535, 65535
   }}, {{
@@ -5829,6 +6115,15 @@ MetricsMetadata::_table_ = {
     // map<string, .abacus.protobuf.Metric> metrics = 4;
     {PROTOBUF_FIELD_OFFSET(MetricsMetadata, _impl_.metrics_), -1, 0,
     (0 | ::_fl::kFcRepeated | ::_fl::kMap)},
+    // fixed32 base_sync_value = 5;
+    {PROTOBUF_FIELD_OFFSET(MetricsMetadata, _impl_.base_sync_value_), _Internal::kHasBitsOffset + 3, 0,
+    (0 | ::_fl::kFcOptional | ::_fl::kFixed32)},
+    // repeated string strings = 6;
+    {PROTOBUF_FIELD_OFFSET(MetricsMetadata, _impl_.strings_), -1, 0,
+    (0 | ::_fl::kFcRepeated | ::_fl::kUtf8String | ::_fl::kRepSString)},
+    // repeated uint32 references = 7;
+    {PROTOBUF_FIELD_OFFSET(MetricsMetadata, _impl_.references_), -1, 0,
+    (0 | ::_fl::kFcRepeated | ::_fl::kPackedUInt32)},
   }},
   {{
       {::_pbi::TcParser::GetMapAuxInfo(1, 0, 0,
@@ -5837,9 +6132,10 @@ MetricsMetadata::_table_ = {
       {::_pbi::TcParser::GetTable<::abacus::protobuf::Metric>()},
   }},
   {{
-    "\37\0\0\0\7\0\0\0"
+    "\37\0\0\0\7\0\7\0"
     "abacus.protobuf.MetricsMetadata"
     "metrics"
+    "strings"
   }},
 };
 PROTOBUF_NOINLINE void MetricsMetadata::Clear() {
@@ -5850,11 +6146,13 @@ PROTOBUF_NOINLINE void MetricsMetadata::Clear() {
   (void) cached_has_bits;
 
   _impl_.metrics_.Clear();
+  _impl_.strings_.Clear();
+  _impl_.references_.Clear();
   cached_has_bits = _impl_._has_bits_[0];
-  if ((cached_has_bits & 0x00000007u) != 0) {
+  if ((cached_has_bits & 0x0000000fu) != 0) {
     ::memset(&_impl_.protocol_version_, 0, static_cast<::size_t>(
-        reinterpret_cast<char*>(&_impl_.sync_value_) -
-        reinterpret_cast<char*>(&_impl_.protocol_version_)) + sizeof(_impl_.sync_value_));
+        reinterpret_cast<char*>(&_impl_.base_sync_value_) -
+        reinterpret_cast<char*>(&_impl_.protocol_version_)) + sizeof(_impl_.base_sync_value_));
   }
   _impl_._has_bits_.Clear();
   _internal_metadata_.Clear<::google::protobuf::UnknownFieldSet>();
@@ -5929,6 +6227,32 @@ PROTOBUF_NOINLINE void MetricsMetadata::Clear() {
     }
   }
 
+  // fixed32 base_sync_value = 5;
+  if ((this_._impl_._has_bits_[0] & 0x00000008u) != 0) {
+    if (this_._internal_base_sync_value() != 0) {
+      target = stream->EnsureSpace(target);
+      target = ::_pbi::WireFormatLite::WriteFixed32ToArray(
+          5, this_._internal_base_sync_value(), target);
+    }
+  }
+
+  // repeated string strings = 6;
+  for (int i = 0, n = this_._internal_strings_size(); i < n; ++i) {
+    const auto& s = this_._internal_strings().Get(i);
+    ::google::protobuf::internal::WireFormatLite::VerifyUtf8String(
+        s.data(), static_cast<int>(s.length()), ::google::protobuf::internal::WireFormatLite::SERIALIZE, "abacus.protobuf.MetricsMetadata.strings");
+    target = stream->WriteString(6, s, target);
+  }
+
+  // repeated uint32 references = 7;
+  {
+    int byte_size = this_._impl_._references_cached_byte_size_.Get();
+    if (byte_size > 0) {
+      target = stream->WriteUInt32Packed(
+          7, this_._internal_references(), byte_size, target);
+    }
+  }
+
   if (ABSL_PREDICT_FALSE(this_._internal_metadata_.have_unknown_fields())) {
     target =
         ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
@@ -5964,9 +6288,25 @@ PROTOBUF_NOINLINE void MetricsMetadata::Clear() {
                                        _pbi::WireFormatLite::TYPE_MESSAGE>::ByteSizeLong(entry.first, entry.second);
       }
     }
+    // repeated string strings = 6;
+    {
+      total_size +=
+          1 * ::google::protobuf::internal::FromIntSize(this_._internal_strings().size());
+      for (int i = 0, n = this_._internal_strings().size(); i < n; ++i) {
+        total_size += ::google::protobuf::internal::WireFormatLite::StringSize(
+            this_._internal_strings().Get(i));
+      }
+    }
+    // repeated uint32 references = 7;
+    {
+      total_size +=
+          ::_pbi::WireFormatLite::UInt32SizeWithPackedTagSize(
+              this_._internal_references(), 1,
+              this_._impl_._references_cached_byte_size_);
+    }
   }
   cached_has_bits = this_._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x00000007u) != 0) {
+  if ((cached_has_bits & 0x0000000fu) != 0) {
     // uint32 protocol_version = 1;
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (this_._internal_protocol_version() != 0) {
@@ -5987,6 +6327,12 @@ PROTOBUF_NOINLINE void MetricsMetadata::Clear() {
         total_size += 5;
       }
     }
+    // fixed32 base_sync_value = 5;
+    if ((cached_has_bits & 0x00000008u) != 0) {
+      if (this_._internal_base_sync_value() != 0) {
+        total_size += 5;
+      }
+    }
   }
   return this_.MaybeComputeUnknownFieldsSize(total_size,
                                              &this_._impl_._cached_size_);
@@ -6001,8 +6347,10 @@ void MetricsMetadata::MergeImpl(::google::protobuf::MessageLite& to_msg, const :
   (void) cached_has_bits;
 
   _this->_impl_.metrics_.MergeFrom(from._impl_.metrics_);
+  _this->_internal_mutable_strings()->MergeFrom(from._internal_strings());
+  _this->_internal_mutable_references()->MergeFrom(from._internal_references());
   cached_has_bits = from._impl_._has_bits_[0];
-  if ((cached_has_bits & 0x00000007u) != 0) {
+  if ((cached_has_bits & 0x0000000fu) != 0) {
     if ((cached_has_bits & 0x00000001u) != 0) {
       if (from._internal_protocol_version() != 0) {
         _this->_impl_.protocol_version_ = from._impl_.protocol_version_;
@@ -6018,6 +6366,11 @@ void MetricsMetadata::MergeImpl(::google::protobuf::MessageLite& to_msg, const :
         _this->_impl_.sync_value_ = from._impl_.sync_value_;
       }
     }
+    if ((cached_has_bits & 0x00000008u) != 0) {
+      if (from._internal_base_sync_value() != 0) {
+        _this->_impl_.base_sync_value_ = from._impl_.base_sync_value_;
+      }
+    }
   }
   _this->_impl_._has_bits_[0] |= cached_has_bits;
   _this->_internal_metadata_.MergeFrom<::google::protobuf::UnknownFieldSet>(from._internal_metadata_);
@@ -6036,9 +6389,11 @@ void MetricsMetadata::InternalSwap(MetricsMetadata* PROTOBUF_RESTRICT PROTOBUF_N
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
   swap(_impl_._has_bits_[0], other->_impl_._has_bits_[0]);
   _impl_.metrics_.InternalSwap(&other->_impl_.metrics_);
+  _impl_.strings_.InternalSwap(&other->_impl_.strings_);
+  _impl_.references_.InternalSwap(&other->_impl_.references_);
   ::google::protobuf::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(MetricsMetadata, _impl_.sync_value_)
-      + sizeof(MetricsMetadata::_impl_.sync_value_)
+      PROTOBUF_FIELD_OFFSET(MetricsMetadata, _impl_.base_sync_value_)
+      + sizeof(MetricsMetadata::_impl_.base_sync_value_)
       - PROTOBUF_FIELD_OFFSET(MetricsMetadata, _impl_.protocol_version_)>(
           reinterpret_cast<char*>(&_impl_.protocol_version_),
           reinterpret_cast<char*>(&other->_impl_.protocol_version_));
@@ -59,6 +59,8 @@ extern const ::google::protobuf::internal::DescriptorTable descriptor_table_abac
 }  // extern "C"
 namespace abacus {
 namespace protobuf {
+enum Aggregation : int;
+extern const uint32_t Aggregation_internal_data_[];
 enum Endianness : int;
 extern const uint32_t Endianness_internal_data_[];
 enum Kind : int;
@@ -124,6 +126,9 @@ extern const ::google::protobuf::internal::ClassDataFull UInt64Metric_class_data
 namespace google {
 namespace protobuf {
 template <>
+internal::EnumTraitsT<::abacus::protobuf::Aggregation_internal_data_>
+    internal::EnumTraitsImpl::value<::abacus::protobuf::Aggregation>;
+template <>
 internal::EnumTraitsT<::abacus::protobuf::Endianness_internal_data_>
     internal::EnumTraitsImpl::value<::abacus::protobuf::Endianness>;
 template <>
@@ -206,6 +211,46 @@ inline bool Kind_Parse(
   return ::google::protobuf::internal::ParseNamedEnum<Kind>(Kind_descriptor(), name,
                                            value);
 }
+enum Aggregation : int {
+  SUM = 0,
+  MINIMUM = 1,
+  MAXIMUM = 2,
+  AVERAGE = 3,
+  ANY = 4,
+  ALL = 5,
+  Aggregation_INT_MIN_SENTINEL_DO_NOT_USE_ =
+      ::std::numeric_limits<::int32_t>::min(),
+  Aggregation_INT_MAX_SENTINEL_DO_NOT_USE_ =
+      ::std::numeric_limits<::int32_t>::max(),
+};
+
+extern const uint32_t Aggregation_internal_data_[];
+inline constexpr Aggregation Aggregation_MIN =
+    static_cast<Aggregation>(0);
+inline constexpr Aggregation Aggregation_MAX =
+    static_cast<Aggregation>(5);
+inline bool Aggregation_IsValid(int value) {
+  return 0 <= value && value <= 5;
+}
+inline constexpr int Aggregation_ARRAYSIZE = 5 + 1;
+const ::google::protobuf::EnumDescriptor* PROTOBUF_NONNULL Aggregation_descriptor();
+template <typename T>
+const ::std::string& Aggregation_Name(T value) {
+  static_assert(::std::is_same<T, Aggregation>::value ||
+                    ::std::is_integral<T>::value,
+                "Incorrect type passed to Aggregation_Name().");
+  return Aggregation_Name(static_cast<Aggregation>(value));
+}
+template <>
+inline const ::std::string& Aggregation_Name(Aggregation value) {
+  return ::google::protobuf::internal::NameOfDenseEnum<Aggregation_descriptor, 0, 5>(
+      static_cast<int>(value));
+}
+inline bool Aggregation_Parse(
+    ::absl::string_view name, Aggregation* PROTOBUF_NONNULL value) {
+  return ::google::protobuf::internal::ParseNamedEnum<Aggregation>(Aggregation_descriptor(), name,
+                                           value);
+}
 
 // ===================================================================
 
@@ -361,6 +406,7 @@ class UInt64Metric final : public ::google::protobuf::Message
     kKindFieldNumber = 3,
     kMinFieldNumber = 5,
     kMaxFieldNumber = 6,
+    kAggregationFieldNumber = 7,
   };
   // string description = 2;
   void clear_description() ;
@@ -434,12 +480,23 @@ class UInt64Metric final : public ::google::protobuf::Message
   ::uint64_t _internal_max() const;
   void _internal_set_max(::uint64_t value);
 
+  public:
+  // optional .abacus.protobuf.Aggregation aggregation = 7;
+  bool has_aggregation() const;
+  void clear_aggregation() ;
+  ::abacus::protobuf::Aggregation aggregation() const;
+  void set_aggregation(::abacus::protobuf::Aggregation value);
+
+  private:
+  ::abacus::protobuf::Aggregation _internal_aggregation() const;
+  void _internal_set_aggregation(::abacus::protobuf::Aggregation value);
+
   public:
   // @@protoc_insertion_point(class_scope:abacus.protobuf.UInt64Metric)
  private:
   class _Internal;
   friend class ::google::protobuf::internal::TcParser;
-  static const ::google::protobuf::internal::TcParseTable<3, 6,
+  static const ::google::protobuf::internal::TcParseTable<3, 7,
                                    0, 52,
                                    2>
       _table_;
@@ -467,6 +524,7 @@ class UInt64Metric final : public ::google::protobuf::Message
     int kind_;
     ::uint64_t min_;
     ::uint64_t max_;
+    int aggregation_;
     PROTOBUF_TSAN_DECLARE_MEMBER
   };
   union { Impl_ _impl_; };
@@ -625,6 +683,7 @@ class UInt32Metric final : public ::google::protobuf::Message
     kKindFieldNumber = 3,
     kMinFieldNumber = 5,
     kMaxFieldNumber = 6,
+    kAggregationFieldNumber = 7,
   };
   // string description = 2;
   void clear_description() ;
@@ -698,12 +757,23 @@ class UInt32Metric final : public ::google::protobuf::Message
   ::uint32_t _internal_max() const;
   void _internal_set_max(::uint32_t value);
 
+  public:
+  // optional .abacus.protobuf.Aggregation aggregation = 7;
+  bool has_aggregation() const;
+  void clear_aggregation() ;
+  ::abacus::protobuf::Aggregation aggregation() const;
+  void set_aggregation(::abacus::protobuf::Aggregation value);
+
+  private:
+  ::abacus::protobuf::Aggregation _internal_aggregation() const;
+  void _internal_set_aggregation(::abacus::protobuf::Aggregation value);
+
   public:
   // @@protoc_insertion_point(class_scope:abacus.protobuf.UInt32Metric)
  private:
   class _Internal;
   friend class ::google::protobuf::internal::TcParser;
-  static const ::google::protobuf::internal::TcParseTable<3, 6,
+  static const ::google::protobuf::internal::TcParseTable<3, 7,
                                    0, 52,
                                    2>
       _table_;
@@ -731,6 +801,7 @@ class UInt32Metric final : public ::google::protobuf::Message
     int kind_;
     ::uint32_t min_;
     ::uint32_t max_;
+    int aggregation_;
     PROTOBUF_TSAN_DECLARE_MEMBER
   };
   union { Impl_ _impl_; };
@@ -889,6 +960,7 @@ class Int64Metric final : public ::google::protobuf::Message
     kKindFieldNumber = 3,
     kMinFieldNumber = 5,
     kMaxFieldNumber = 6,
+    kAggregationFieldNumber = 7,
   };
   // string description = 2;
   void clear_description() ;
@@ -962,12 +1034,23 @@ class Int64Metric final : public ::google::protobuf::Message
   ::int64_t _internal_max() const;
   void _internal_set_max(::int64_t value);
 
+  public:
+  // optional .abacus.protobuf.Aggregation aggregation = 7;
+  bool has_aggregation() const;
+  void clear_aggregation() ;
+  ::abacus::protobuf::Aggregation aggregation() const;
+  void set_aggregation(::abacus::protobuf::Aggregation value);
+
+  private:
+  ::abacus::protobuf::Aggregation _internal_aggregation() const;
+  void _internal_set_aggregation(::abacus::protobuf::Aggregation value);
+
   public:
   // @@protoc_insertion_point(class_scope:abacus.protobuf.Int64Metric)
  private:
   class _Internal;
   friend class ::google::protobuf::internal::TcParser;
-  static const ::google::protobuf::internal::TcParseTable<3, 6,
+  static const ::google::protobuf::internal::TcParseTable<3, 7,
                                    0, 51,
                                    2>
       _table_;
@@ -995,6 +1078,7 @@ class Int64Metric final : public ::google::protobuf::Message
     int kind_;
     ::int64_t min_;
     ::int64_t max_;
+    int aggregation_;
     PROTOBUF_TSAN_DECLARE_MEMBER
   };
   union { Impl_ _impl_; };
@@ -1153,6 +1237,7 @@ class Int32Metric final : public ::google::protobuf::Message
     kKindFieldNumber = 3,
     kMinFieldNumber = 5,
     kMaxFieldNumber = 6,
+    kAggregationFieldNumber = 7,
   };
   // string description = 2;
   void clear_description() ;
@@ -1226,12 +1311,23 @@ class Int32Metric final : public ::google::protobuf::Message
   ::int32_t _internal_max() const;
   void _internal_set_max(::int32_t value);
 
+  public:
+  // optional .abacus.protobuf.Aggregation aggregation = 7;
+  bool has_aggregation() const;
+  void clear_aggregation() ;
+  ::abacus::protobuf::Aggregation aggregation() const;
+  void set_aggregation(::abacus::protobuf::Aggregation value);
+
+  private:
+  ::abacus::protobuf::Aggregation _internal_aggregation() const;
+  void _internal_set_aggregation(::abacus::protobuf::Aggregation value);
+
   public:
   // @@protoc_insertion_point(class_scope:abacus.protobuf.Int32Metric)
  private:
   class _Internal;
   friend class ::google::protobuf::internal::TcParser;
-  static const ::google::protobuf::internal::TcParseTable<3, 6,
+  static const ::google::protobuf::internal::TcParseTable<3, 7,
                                    0, 51,
                                    2>
       _table_;
@@ -1259,6 +1355,7 @@ class Int32Metric final : public ::google::protobuf::Message
     int kind_;
     ::int32_t min_;
     ::int32_t max_;
+    int aggregation_;
     PROTOBUF_TSAN_DECLARE_MEMBER
   };
   union { Impl_ _impl_; };
@@ -1417,6 +1514,7 @@ class Float64Metric final : public ::google::protobuf::Message
     kKindFieldNumber = 3,
     kMinFieldNumber = 5,
     kMaxFieldNumber = 6,
+    kAggregationFieldNumber = 7,
   };
   // string description = 2;
   void clear_description() ;
@@ -1490,12 +1588,23 @@ class Float64Metric final : public ::google::protobuf::Message
   double _internal_max() const;
   void _internal_set_max(double value);
 
+  public:
+  // optional .abacus.protobuf.Aggregation aggregation = 7;
+  bool has_aggregation() const;
+  void clear_aggregation() ;
+  ::abacus::protobuf::Aggregation aggregation() const;
+  void set_aggregation(::abacus::protobuf::Aggregation value);
+
+  private:
+  ::abacus::protobuf::Aggregation _internal_aggregation() const;
+  void _internal_set_aggregation(::abacus::protobuf::Aggregation value);
+
   public:
   // @@protoc_insertion_point(class_scope:abacus.protobuf.Float64Metric)
  private:
   class _Internal;
   friend class ::google::protobuf::internal::TcParser;
-  static const ::google::protobuf::internal::TcParseTable<3, 6,
+  static const ::google::protobuf::internal::TcParseTable<3, 7,
                                    0, 53,
                                    2>
       _table_;
@@ -1523,6 +1632,7 @@ class Float64Metric final : public ::google::protobuf::Message
     int kind_;
     double min_;
     double max_;
+    int aggregation_;
     PROTOBUF_TSAN_DECLARE_MEMBER
   };
   union { Impl_ _impl_; };
@@ -1681,6 +1791,7 @@ class Float32Metric final : public ::google::protobuf::Message
     kKindFieldNumber = 3,
     kMinFieldNumber = 5,
     kMaxFieldNumber = 6,
+    kAggregationFieldNumber = 7,
   };
   // string description = 2;
   void clear_description() ;
@@ -1754,12 +1865,23 @@ class Float32Metric final : public ::google::protobuf::Message
   float _internal_max() const;
   void _internal_set_max(float value);
 
+  public:
+  // optional .abacus.protobuf.Aggregation aggregation = 7;
+  bool has_aggregation() const;
+  void clear_aggregation() ;
+  ::abacus::protobuf::Aggregation aggregation() const;
+  void set_aggregation(::abacus::protobuf::Aggregation value);
+
+  private:
+  ::abacus::protobuf::Aggregation _internal_aggregation() const;
+  void _internal_set_aggregation(::abacus::protobuf::Aggregation value);
+
   public:
   // @@protoc_insertion_point(class_scope:abacus.protobuf.Float32Metric)
  private:
   class _Internal;
   friend class ::google::protobuf::internal::TcParser;
-  static const ::google::protobuf::internal::TcParseTable<3, 6,
+  static const ::google::protobuf::internal::TcParseTable<3, 7,
                                    0, 53,
                                    2>
       _table_;
@@ -1787,6 +1909,7 @@ class Float32Metric final : public ::google::protobuf::Message
     int kind_;
     float min_;
     float max_;
+    int aggregation_;
     PROTOBUF_TSAN_DECLARE_MEMBER
   };
   union { Impl_ _impl_; };
@@ -2462,6 +2585,7 @@ class BoolMetric final : public ::google::protobuf::Message
     kDescriptionFieldNumber = 2,
     kUnitFieldNumber = 3,
     kOffsetFieldNumber = 1,
+    kAggregationFieldNumber = 4,
   };
   // string description = 2;
   void clear_description() ;
@@ -2503,12 +2627,23 @@ class BoolMetric final : public ::google::protobuf::Message
   ::uint32_t _internal_offset() const;
   void _internal_set_offset(::uint32_t value);
 
+  public:
+  // optional .abacus.protobuf.Aggregation aggregation = 4;
+  bool has_aggregation() const;
+  void clear_aggregation() ;
+  ::abacus::protobuf::Aggregation aggregation() const;
+  void set_aggregation(::abacus::protobuf::Aggregation value);
+
+  private:
+  ::abacus::protobuf::Aggregation _internal_aggregation() const;
+  void _internal_set_aggregation(::abacus::protobuf::Aggregation value);
+
   public:
   // @@protoc_insertion_point(class_scope:abacus.protobuf.BoolMetric)
  private:
   class _Internal;
   friend class ::google::protobuf::internal::TcParser;
-  static const ::google::protobuf::internal::TcParseTable<2, 3,
+  static const ::google::protobuf::internal::TcParseTable<2, 4,
                                    0, 50,
                                    2>
       _table_;
@@ -2533,6 +2668,7 @@ class BoolMetric final : public ::google::protobuf::Message
     ::google::protobuf::internal::ArenaStringPtr description_;
     ::google::protobuf::internal::ArenaStringPtr unit_;
     ::uint32_t offset_;
+    int aggregation_;
     PROTOBUF_TSAN_DECLARE_MEMBER
   };
   union { Impl_ _impl_; };
@@ -2729,6 +2865,7 @@ class Enum8Metric final : public ::google::protobuf::Message
     kDescriptionFieldNumber = 2,
     kUnitFieldNumber = 4,
     kOffsetFieldNumber = 1,
+    kAggregationFieldNumber = 5,
   };
   // map<uint32, .abacus.protobuf.Enum8Metric.EnumValue> values = 3;
   int values_size() const;
@@ -2785,12 +2922,23 @@ class Enum8Metric final : public ::google::protobuf::Message
   ::uint32_t _internal_offset() const;
   void _internal_set_offset(::uint32_t value);
 
+  public:
+  // optional .abacus.protobuf.Aggregation aggregation = 5;
+  bool has_aggregation() const;
+  void clear_aggregation() ;
+  ::abacus::protobuf::Aggregation aggregation() const;
+  void set_aggregation(::abacus::protobuf::Aggregation value);
+
+  private:
+  ::abacus::protobuf::Aggregation _internal_aggregation() const;
+  void _internal_set_aggregation(::abacus::protobuf::Aggregation value);
+
   public:
   // @@protoc_insertion_point(class_scope:abacus.protobuf.Enum8Metric)
  private:
   class _Internal;
   friend class ::google::protobuf::internal::TcParser;
-  static const ::google::protobuf::internal::TcParseTable<2, 4,
+  static const ::google::protobuf::internal::TcParseTable<3, 5,
                                    2, 51,
                                    2>
       _table_;
@@ -2819,6 +2967,7 @@ class Enum8Metric final : public ::google::protobuf::Message
     ::google::protobuf::internal::ArenaStringPtr description_;
     ::google::protobuf::internal::ArenaStringPtr unit_;
     ::uint32_t offset_;
+    int aggregation_;
     PROTOBUF_TSAN_DECLARE_MEMBER
   };
   union { Impl_ _impl_; };
@@ -3408,9 +3557,12 @@ class MetricsMetadata final : public ::google::protobuf::Message
   // accessors -------------------------------------------------------
   enum : int {
     kMetricsFieldNumber = 4,
+    kStringsFieldNumber = 6,
+    kReferencesFieldNumber = 7,
     kProtocolVersionFieldNumber = 1,
     kEndiannessFieldNumber = 2,
     kSyncValueFieldNumber = 3,
+    kBaseSyncValueFieldNumber = 5,
   };
   // map<string, .abacus.protobuf.Metric> metrics = 4;
   int metrics_size() const;
@@ -3426,6 +3578,46 @@ class MetricsMetadata final : public ::google::protobuf::Message
   const ::google::protobuf::Map<std::string, ::abacus::protobuf::Metric>& _internal_metrics() const;
   ::google::protobuf::Map<std::string, ::abacus::protobuf::Metric>* PROTOBUF_NONNULL _internal_mutable_metrics();
 
+  public:
+  // repeated string strings = 6;
+  int strings_size() const;
+  private:
+  int _internal_strings_size() const;
+
+  public:
+  void clear_strings() ;
+  const ::std::string& strings(int index) const;
+  ::std::string* PROTOBUF_NONNULL mutable_strings(int index);
+  template <typename Arg_ = const ::std::string&, typename... Args_>
+  void set_strings(int index, Arg_&& value, Args_... args);
+  ::std::string* PROTOBUF_NONNULL add_strings();
+  template <typename Arg_ = const ::std::string&, typename... Args_>
+  void add_strings(Arg_&& value, Args_... args);
+  const ::google::protobuf::RepeatedPtrField<::std::string>& strings() const;
+  ::google::protobuf::RepeatedPtrField<::std::string>* PROTOBUF_NONNULL mutable_strings();
+
+  private:
+  const ::google::protobuf::RepeatedPtrField<::std::string>& _internal_strings() const;
+  ::google::protobuf::RepeatedPtrField<::std::string>* PROTOBUF_NONNULL _internal_mutable_strings();
+
+  public:
+  // repeated uint32 references = 7;
+  int references_size() const;
+  private:
+  int _internal_references_size() const;
+
+  public:
+  void clear_references() ;
+  ::uint32_t references(int index) const;
+  void set_references(int index, ::uint32_t value);
+  void add_references(::uint32_t value);
+  const ::google::protobuf::RepeatedField<::uint32_t>& references() const;
+  ::google::protobuf::RepeatedField<::uint32_t>* PROTOBUF_NONNULL mutable_references();
+
+  private:
+  const ::google::protobuf::RepeatedField<::uint32_t>& _internal_references() const;
+  ::google::protobuf::RepeatedField<::uint32_t>* PROTOBUF_NONNULL _internal_mutable_references();
+
   public:
   // uint32 protocol_version = 1;
   void clear_protocol_version() ;
@@ -3456,13 +3648,23 @@ class MetricsMetadata final : public ::google::protobuf::Message
   ::uint32_t _internal_sync_value() const;
   void _internal_set_sync_value(::uint32_t value);
 
+  public:
+  // fixed32 base_sync_value = 5;
+  void clear_base_sync_value() ;
+  ::uint32_t base_sync_value() const;
+  void set_base_sync_value(::uint32_t value);
+
+  private:
+  ::uint32_t _internal_base_sync_value() const;
+  void _internal_set_base_sync_value(::uint32_t value);
+
   public:
   // @@protoc_insertion_point(class_scope:abacus.protobuf.MetricsMetadata)
  private:
   class _Internal;
   friend class ::google::protobuf::internal::TcParser;
-  static const ::google::protobuf::internal::TcParseTable<2, 4,
-                                   2, 47,
+  static const ::google::protobuf::internal::TcParseTable<3, 7,
+                                   2, 54,
                                    2>
       _table_;
 
@@ -3487,9 +3689,13 @@ class MetricsMetadata final : public ::google::protobuf::Message
                       ::google::protobuf::internal::WireFormatLite::TYPE_STRING,
                       ::google::protobuf::internal::WireFormatLite::TYPE_MESSAGE>
         metrics_;
+    ::google::protobuf::RepeatedPtrField<::std::string> strings_;
+    ::google::protobuf::RepeatedField<::uint32_t> references_;
+    ::google::protobuf::internal::CachedSize _references_cached_byte_size_;
     ::uint32_t protocol_version_;
     int endianness_;
     ::uint32_t sync_value_;
+    ::uint32_t base_sync_value_;
     PROTOBUF_TSAN_DECLARE_MEMBER
   };
   union { Impl_ _impl_; };
@@ -3752,6 +3958,34 @@ inline void UInt64Metric::_internal_set_max(::uint64_t value) {
   _impl_.max_ = value;
 }
 
+// optional .abacus.protobuf.Aggregation aggregation = 7;
+inline bool UInt64Metric::has_aggregation() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000040u) != 0;
+  return value;
+}
+inline void UInt64Metric::clear_aggregation() {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = 0;
+  _impl_._has_bits_[0] &= ~0x00000040u;
+}
+inline ::abacus::protobuf::Aggregation UInt64Metric::aggregation() const {
+  // @@protoc_insertion_point(field_get:abacus.protobuf.UInt64Metric.aggregation)
+  return _internal_aggregation();
+}
+inline void UInt64Metric::set_aggregation(::abacus::protobuf::Aggregation value) {
+  _internal_set_aggregation(value);
+  _impl_._has_bits_[0] |= 0x00000040u;
+  // @@protoc_insertion_point(field_set:abacus.protobuf.UInt64Metric.aggregation)
+}
+inline ::abacus::protobuf::Aggregation UInt64Metric::_internal_aggregation() const {
+  ::google::protobuf::internal::TSanRead(&_impl_);
+  return static_cast<::abacus::protobuf::Aggregation>(_impl_.aggregation_);
+}
+inline void UInt64Metric::_internal_set_aggregation(::abacus::protobuf::Aggregation value) {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = value;
+}
+
 // -------------------------------------------------------------------
 
 // Int64Metric
@@ -3994,6 +4228,34 @@ inline void Int64Metric::_internal_set_max(::int64_t value) {
   _impl_.max_ = value;
 }
 
+// optional .abacus.protobuf.Aggregation aggregation = 7;
+inline bool Int64Metric::has_aggregation() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000040u) != 0;
+  return value;
+}
+inline void Int64Metric::clear_aggregation() {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = 0;
+  _impl_._has_bits_[0] &= ~0x00000040u;
+}
+inline ::abacus::protobuf::Aggregation Int64Metric::aggregation() const {
+  // @@protoc_insertion_point(field_get:abacus.protobuf.Int64Metric.aggregation)
+  return _internal_aggregation();
+}
+inline void Int64Metric::set_aggregation(::abacus::protobuf::Aggregation value) {
+  _internal_set_aggregation(value);
+  _impl_._has_bits_[0] |= 0x00000040u;
+  // @@protoc_insertion_point(field_set:abacus.protobuf.Int64Metric.aggregation)
+}
+inline ::abacus::protobuf::Aggregation Int64Metric::_internal_aggregation() const {
+  ::google::protobuf::internal::TSanRead(&_impl_);
+  return static_cast<::abacus::protobuf::Aggregation>(_impl_.aggregation_);
+}
+inline void Int64Metric::_internal_set_aggregation(::abacus::protobuf::Aggregation value) {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = value;
+}
+
 // -------------------------------------------------------------------
 
 // UInt32Metric
@@ -4236,6 +4498,34 @@ inline void UInt32Metric::_internal_set_max(::uint32_t value) {
   _impl_.max_ = value;
 }
 
+// optional .abacus.protobuf.Aggregation aggregation = 7;
+inline bool UInt32Metric::has_aggregation() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000040u) != 0;
+  return value;
+}
+inline void UInt32Metric::clear_aggregation() {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = 0;
+  _impl_._has_bits_[0] &= ~0x00000040u;
+}
+inline ::abacus::protobuf::Aggregation UInt32Metric::aggregation() const {
+  // @@protoc_insertion_point(field_get:abacus.protobuf.UInt32Metric.aggregation)
+  return _internal_aggregation();
+}
+inline void UInt32Metric::set_aggregation(::abacus::protobuf::Aggregation value) {
+  _internal_set_aggregation(value);
+  _impl_._has_bits_[0] |= 0x00000040u;
+  // @@protoc_insertion_point(field_set:abacus.protobuf.UInt32Metric.aggregation)
+}
+inline ::abacus::protobuf::Aggregation UInt32Metric::_internal_aggregation() const {
+  ::google::protobuf::internal::TSanRead(&_impl_);
+  return static_cast<::abacus::protobuf::Aggregation>(_impl_.aggregation_);
+}
+inline void UInt32Metric::_internal_set_aggregation(::abacus::protobuf::Aggregation value) {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = value;
+}
+
 // -------------------------------------------------------------------
 
 // Int32Metric
@@ -4478,6 +4768,34 @@ inline void Int32Metric::_internal_set_max(::int32_t value) {
   _impl_.max_ = value;
 }
 
+// optional .abacus.protobuf.Aggregation aggregation = 7;
+inline bool Int32Metric::has_aggregation() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000040u) != 0;
+  return value;
+}
+inline void Int32Metric::clear_aggregation() {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = 0;
+  _impl_._has_bits_[0] &= ~0x00000040u;
+}
+inline ::abacus::protobuf::Aggregation Int32Metric::aggregation() const {
+  // @@protoc_insertion_point(field_get:abacus.protobuf.Int32Metric.aggregation)
+  return _internal_aggregation();
+}
+inline void Int32Metric::set_aggregation(::abacus::protobuf::Aggregation value) {
+  _internal_set_aggregation(value);
+  _impl_._has_bits_[0] |= 0x00000040u;
+  // @@protoc_insertion_point(field_set:abacus.protobuf.Int32Metric.aggregation)
+}
+inline ::abacus::protobuf::Aggregation Int32Metric::_internal_aggregation() const {
+  ::google::protobuf::internal::TSanRead(&_impl_);
+  return static_cast<::abacus::protobuf::Aggregation>(_impl_.aggregation_);
+}
+inline void Int32Metric::_internal_set_aggregation(::abacus::protobuf::Aggregation value) {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = value;
+}
+
 // -------------------------------------------------------------------
 
 // Float64Metric
@@ -4720,6 +5038,34 @@ inline void Float64Metric::_internal_set_max(double value) {
   _impl_.max_ = value;
 }
 
+// optional .abacus.protobuf.Aggregation aggregation = 7;
+inline bool Float64Metric::has_aggregation() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000040u) != 0;
+  return value;
+}
+inline void Float64Metric::clear_aggregation() {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = 0;
+  _impl_._has_bits_[0] &= ~0x00000040u;
+}
+inline ::abacus::protobuf::Aggregation Float64Metric::aggregation() const {
+  // @@protoc_insertion_point(field_get:abacus.protobuf.Float64Metric.aggregation)
+  return _internal_aggregation();
+}
+inline void Float64Metric::set_aggregation(::abacus::protobuf::Aggregation value) {
+  _internal_set_aggregation(value);
+  _impl_._has_bits_[0] |= 0x00000040u;
+  // @@protoc_insertion_point(field_set:abacus.protobuf.Float64Metric.aggregation)
+}
+inline ::abacus::protobuf::Aggregation Float64Metric::_internal_aggregation() const {
+  ::google::protobuf::internal::TSanRead(&_impl_);
+  return static_cast<::abacus::protobuf::Aggregation>(_impl_.aggregation_);
+}
+inline void Float64Metric::_internal_set_aggregation(::abacus::protobuf::Aggregation value) {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = value;
+}
+
 // -------------------------------------------------------------------
 
 // Float32Metric
@@ -4962,6 +5308,34 @@ inline void Float32Metric::_internal_set_max(float value) {
   _impl_.max_ = value;
 }
 
+// optional .abacus.protobuf.Aggregation aggregation = 7;
+inline bool Float32Metric::has_aggregation() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000040u) != 0;
+  return value;
+}
+inline void Float32Metric::clear_aggregation() {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = 0;
+  _impl_._has_bits_[0] &= ~0x00000040u;
+}
+inline ::abacus::protobuf::Aggregation Float32Metric::aggregation() const {
+  // @@protoc_insertion_point(field_get:abacus.protobuf.Float32Metric.aggregation)
+  return _internal_aggregation();
+}
+inline void Float32Metric::set_aggregation(::abacus::protobuf::Aggregation value) {
+  _internal_set_aggregation(value);
+  _impl_._has_bits_[0] |= 0x00000040u;
+  // @@protoc_insertion_point(field_set:abacus.protobuf.Float32Metric.aggregation)
+}
+inline ::abacus::protobuf::Aggregation Float32Metric::_internal_aggregation() const {
+  ::google::protobuf::internal::TSanRead(&_impl_);
+  return static_cast<::abacus::protobuf::Aggregation>(_impl_.aggregation_);
+}
+inline void Float32Metric::_internal_set_aggregation(::abacus::protobuf::Aggregation value) {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = value;
+}
+
 // -------------------------------------------------------------------
 
 // BoolMetric
@@ -5124,6 +5498,34 @@ inline void BoolMetric::set_allocated_unit(::std::string* PROTOBUF_NULLABLE valu
   // @@protoc_insertion_point(field_set_allocated:abacus.protobuf.BoolMetric.unit)
 }
 
+// optional .abacus.protobuf.Aggregation aggregation = 4;
+inline bool BoolMetric::has_aggregation() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000008u) != 0;
+  return value;
+}
+inline void BoolMetric::clear_aggregation() {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = 0;
+  _impl_._has_bits_[0] &= ~0x00000008u;
+}
+inline ::abacus::protobuf::Aggregation BoolMetric::aggregation() const {
+  // @@protoc_insertion_point(field_get:abacus.protobuf.BoolMetric.aggregation)
+  return _internal_aggregation();
+}
+inline void BoolMetric::set_aggregation(::abacus::protobuf::Aggregation value) {
+  _internal_set_aggregation(value);
+  _impl_._has_bits_[0] |= 0x00000008u;
+  // @@protoc_insertion_point(field_set:abacus.protobuf.BoolMetric.aggregation)
+}
+inline ::abacus::protobuf::Aggregation BoolMetric::_internal_aggregation() const {
+  ::google::protobuf::internal::TSanRead(&_impl_);
+  return static_cast<::abacus::protobuf::Aggregation>(_impl_.aggregation_);
+}
+inline void BoolMetric::_internal_set_aggregation(::abacus::protobuf::Aggregation value) {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = value;
+}
+
 // -------------------------------------------------------------------
 
 // Enum8Metric_EnumValue
@@ -5455,6 +5857,34 @@ inline void Enum8Metric::set_allocated_unit(::std::string* PROTOBUF_NULLABLE val
   // @@protoc_insertion_point(field_set_allocated:abacus.protobuf.Enum8Metric.unit)
 }
 
+// optional .abacus.protobuf.Aggregation aggregation = 5;
+inline bool Enum8Metric::has_aggregation() const {
+  bool value = (_impl_._has_bits_[0] & 0x00000008u) != 0;
+  return value;
+}
+inline void Enum8Metric::clear_aggregation() {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = 0;
+  _impl_._has_bits_[0] &= ~0x00000008u;
+}
+inline ::abacus::protobuf::Aggregation Enum8Metric::aggregation() const {
+  // @@protoc_insertion_point(field_get:abacus.protobuf.Enum8Metric.aggregation)
+  return _internal_aggregation();
+}
+inline void Enum8Metric::set_aggregation(::abacus::protobuf::Aggregation value) {
+  _internal_set_aggregation(value);
+  _impl_._has_bits_[0] |= 0x00000008u;
+  // @@protoc_insertion_point(field_set:abacus.protobuf.Enum8Metric.aggregation)
+}
+inline ::abacus::protobuf::Aggregation Enum8Metric::_internal_aggregation() const {
+  ::google::protobuf::internal::TSanRead(&_impl_);
+  return static_cast<::abacus::protobuf::Aggregation>(_impl_.aggregation_);
+}
+inline void Enum8Metric::_internal_set_aggregation(::abacus::protobuf::Aggregation value) {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.aggregation_ = value;
+}
+
 // -------------------------------------------------------------------
 
 // Constant
@@ -6639,6 +7069,141 @@ inline void MetricsMetadata::_internal_set_sync_value(::uint32_t value) {
   _impl_.sync_value_ = value;
 }
 
+// fixed32 base_sync_value = 5;
+inline void MetricsMetadata::clear_base_sync_value() {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.base_sync_value_ = 0u;
+  _impl_._has_bits_[0] &= ~0x00000008u;
+}
+inline ::uint32_t MetricsMetadata::base_sync_value() const {
+  // @@protoc_insertion_point(field_get:abacus.protobuf.MetricsMetadata.base_sync_value)
+  return _internal_base_sync_value();
+}
+inline void MetricsMetadata::set_base_sync_value(::uint32_t value) {
+  _internal_set_base_sync_value(value);
+  _impl_._has_bits_[0] |= 0x00000008u;
+  // @@protoc_insertion_point(field_set:abacus.protobuf.MetricsMetadata.base_sync_value)
+}
+inline ::uint32_t MetricsMetadata::_internal_base_sync_value() const {
+  ::google::protobuf::internal::TSanRead(&_impl_);
+  return _impl_.base_sync_value_;
+}
+inline void MetricsMetadata::_internal_set_base_sync_value(::uint32_t value) {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.base_sync_value_ = value;
+}
+
+// repeated string strings = 6;
+inline int MetricsMetadata::_internal_strings_size() const {
+  return _internal_strings().size();
+}
+inline int MetricsMetadata::strings_size() const {
+  return _internal_strings_size();
+}
+inline void MetricsMetadata::clear_strings() {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.strings_.Clear();
+}
+inline ::std::string* PROTOBUF_NONNULL MetricsMetadata::add_strings()
+    ABSL_ATTRIBUTE_LIFETIME_BOUND {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  ::std::string* _s = _internal_mutable_strings()->Add();
+  // @@protoc_insertion_point(field_add_mutable:abacus.protobuf.MetricsMetadata.strings)
+  return _s;
+}
+inline const ::std::string& MetricsMetadata::strings(int index) const
+    ABSL_ATTRIBUTE_LIFETIME_BOUND {
+  // @@protoc_insertion_point(field_get:abacus.protobuf.MetricsMetadata.strings)
+  return _internal_strings().Get(index);
+}
+inline ::std::string* PROTOBUF_NONNULL MetricsMetadata::mutable_strings(int index)
+    ABSL_ATTRIBUTE_LIFETIME_BOUND {
+  // @@protoc_insertion_point(field_mutable:abacus.protobuf.MetricsMetadata.strings)
+  return _internal_mutable_strings()->Mutable(index);
+}
+template <typename Arg_, typename... Args_>
+inline void MetricsMetadata::set_strings(int index, Arg_&& value, Args_... args) {
+  ::google::protobuf::internal::AssignToString(
+      *_internal_mutable_strings()->Mutable(index),
+      std::forward<Arg_>(value), args... );
+  // @@protoc_insertion_point(field_set:abacus.protobuf.MetricsMetadata.strings)
+}
+template <typename Arg_, typename... Args_>
+inline void MetricsMetadata::add_strings(Arg_&& value, Args_... args) {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  ::google::protobuf::internal::AddToRepeatedPtrField(*_internal_mutable_strings(),
+                               std::forward<Arg_>(value),
+                               args... );
+  // @@protoc_insertion_point(field_add:abacus.protobuf.MetricsMetadata.strings)
+}
+inline const ::google::protobuf::RepeatedPtrField<::std::string>&
+MetricsMetadata::strings() const ABSL_ATTRIBUTE_LIFETIME_BOUND {
+  // @@protoc_insertion_point(field_list:abacus.protobuf.MetricsMetadata.strings)
+  return _internal_strings();
+}
+inline ::google::protobuf::RepeatedPtrField<::std::string>* PROTOBUF_NONNULL
+MetricsMetadata::mutable_strings() ABSL_ATTRIBUTE_LIFETIME_BOUND {
+  // @@protoc_insertion_point(field_mutable_list:abacus.protobuf.MetricsMetadata.strings)
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  return _internal_mutable_strings();
+}
+inline const ::google::protobuf::RepeatedPtrField<::std::string>&
+MetricsMetadata::_internal_strings() const {
+  ::google::protobuf::internal::TSanRead(&_impl_);
+  return _impl_.strings_;
+}
+inline ::google::protobuf::RepeatedPtrField<::std::string>* PROTOBUF_NONNULL
+MetricsMetadata::_internal_mutable_strings() {
+  ::google::protobuf::internal::TSanRead(&_impl_);
+  return &_impl_.strings_;
+}
+
+// repeated uint32 references = 7;
+inline int MetricsMetadata::_internal_references_size() const {
+  return _internal_references().size();
+}
+inline int MetricsMetadata::references_size() const {
+  return _internal_references_size();
+}
+inline void MetricsMetadata::clear_references() {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _impl_.references_.Clear();
+}
+inline ::uint32_t MetricsMetadata::references(int index) const {
+  // @@protoc_insertion_point(field_get:abacus.protobuf.MetricsMetadata.references)
+  return _internal_references().Get(index);
+}
+inline void MetricsMetadata::set_references(int index, ::uint32_t value) {
+  _internal_mutable_references()->Set(index, value);
+  // @@protoc_insertion_point(field_set:abacus.protobuf.MetricsMetadata.references)
+}
+inline void MetricsMetadata::add_references(::uint32_t value) {
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  _internal_mutable_references()->Add(value);
+  // @@protoc_insertion_point(field_add:abacus.protobuf.MetricsMetadata.references)
+}
+inline const ::google::protobuf::RepeatedField<::uint32_t>& MetricsMetadata::references() const
+    ABSL_ATTRIBUTE_LIFETIME_BOUND {
+  // @@protoc_insertion_point(field_list:abacus.protobuf.MetricsMetadata.references)
+  return _internal_references();
+}
+inline ::google::protobuf::RepeatedField<::uint32_t>* PROTOBUF_NONNULL MetricsMetadata::mutable_references()
+    ABSL_ATTRIBUTE_LIFETIME_BOUND {
+  // @@protoc_insertion_point(field_mutable_list:abacus.protobuf.MetricsMetadata.references)
+  ::google::protobuf::internal::TSanWrite(&_impl_);
+  return _internal_mutable_references();
+}
+inline const ::google::protobuf::RepeatedField<::uint32_t>&
+MetricsMetadata::_internal_references() const {
+  ::google::protobuf::internal::TSanRead(&_impl_);
+  return _impl_.references_;
+}
+inline ::google::protobuf::RepeatedField<::uint32_t>* PROTOBUF_NONNULL
+MetricsMetadata::_internal_mutable_references() {
+  ::google::protobuf::internal::TSanRead(&_impl_);
+  return &_impl_.references_;
+}
+
 // map<string, .abacus.protobuf.Metric> metrics = 4;
 inline int MetricsMetadata::_internal_metrics_size() const {
   return _internal_metrics().size();
@@ -6692,6 +7257,12 @@ template <>
 inline const EnumDescriptor* PROTOBUF_NONNULL GetEnumDescriptor<::abacus::protobuf::Kind>() {
   return ::abacus::protobuf::Kind_descriptor();
 }
+template <>
+struct is_proto_enum<::abacus::protobuf::Aggregation> : std::true_type {};
+template <>
+inline const EnumDescriptor* PROTOBUF_NONNULL GetEnumDescriptor<::abacus::protobuf::Aggregation>() {
+  return ::abacus::protobuf::Aggregation_descriptor();
+}
 
 }  // namespace protobuf
 }  // namespace google
@@ -14,5 +14,22 @@ uint8_t protocol_version()
 {
     return 2;
 }
+
+uint8_t newest_protocol_version()
+{
+    return 3;
+}
+
+uint8_t protocol_version(metadata_encoding encoding)
+{
+    return encoding == metadata_encoding::inline_strings
+               ? protocol_version()
+               : newest_protocol_version();
+}
+
+bool is_supported_protocol_version(uint32_t version)
+{
+    return version >= 2 && version <= newest_protocol_version();
+}
 }
 }
@@ -7,13 +7,30 @@
 
 #include <cstdint>
 
+#include "metadata_encoding.hpp"
 #include "version.hpp"
 
 namespace abacus
 {
 inline namespace STEINWURF_ABACUS_VERSION
 {
-/// @return The version of the protocol
+/// @return The version of the protocol written by default, i.e. for meta
+///         data with inline strings
 uint8_t protocol_version();
+
+/// @return The newest version of the protocol, which can be read and is
+///         written for the string table and lean encodings
+uint8_t newest_protocol_version();
+
+/// The meta data with inline strings is written with version 2, so readers
+/// of version 2 can still read it. The string table and lean encodings need
+/// version 3.
+/// @param encoding The encoding of the meta data
+/// @return The version of the protocol the meta data is written with
+uint8_t protocol_version(metadata_encoding encoding);
+
+/// @param version The protocol version of meta data
+/// @return true if meta data with the protocol version can be read
+bool is_supported_protocol_version(uint32_t version);
 }
 }
@@ -0,0 +1,38 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// The parts of a frame read with abacus::read_frame().
+///
+/// The parts point into the received bytes, so they are only valid as long
+/// as those bytes are. A view reads the parts directly, e.g. with
+/// abacus::view::set_metadata() and abacus::view::set_value_data(). Copy
+/// the parts to keep them longer.
+struct received_frame
+{
+    /// The meta data, or nullptr if the frame has none
+    const uint8_t* metadata_data = nullptr;
+
+    /// The size of the meta data
+    std::size_t metadata_bytes = 0;
+
+    /// The value data
+    const uint8_t* value_data = nullptr;
+
+    /// The size of the value data
+    std::size_t value_bytes = 0;
+};
+}
+}
@@ -0,0 +1,269 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "recorder.hpp"
+
+#include "detail/crc32c.hpp"
+#include "detail/record_format.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define ABACUS_POSIX_FILES 1
+#endif
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace
+{
+namespace format = detail::record_format;
+
+static inline auto nanoseconds(recorder::clock::time_point time) -> int64_t
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               time.time_since_epoch())
+        .count();
+}
+}
+
+recorder::recorder(const std::string& path, std::size_t sync_bytes,
+                   std::size_t index_interval) :
+    m_sync_bytes(sync_bytes), m_index_interval(index_interval)
+{
+    assert(m_index_interval > 0);
+#if defined(ABACUS_POSIX_FILES)
+    m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                  0644);
+#else
+    (void)path;
+#endif
+    if (m_fd < 0)
+    {
+        return;
+    }
+    m_buffer.reserve(m_sync_bytes + format::header_bytes);
+    m_buffer.resize(format::file_header_bytes);
+    std::copy(std::begin(format::magic), std::end(format::magic),
+              m_buffer.begin());
+    format::put32(format::version, m_buffer.data() + 8);
+    format::put32(0, m_buffer.data() + 12);
+}
+
+recorder::~recorder()
+{
+    if (is_open())
+    {
+        (void)close();
+    }
+}
+
+auto recorder::is_open() const -> bool
+{
+    return m_fd >= 0;
+}
+
+auto recorder::record(const metrics& metrics, clock::time_point time) -> bool
+{
+    return record(metrics.metadata_data(), metrics.metadata_bytes(),
+                  metrics.value_data(), metrics.value_bytes(), time);
+}
+
+auto recorder::record(const uint8_t* metadata_data, std::size_t metadata_bytes,
+                      const uint8_t* value_data, std::size_t value_bytes,
+                      clock::time_point time) -> bool
+{
+    assert(metadata_data != nullptr);
+    assert(value_data != nullptr);
+    assert(value_bytes >= sizeof(uint32_t));
+    if (!is_open())
+    {
+        return false;
+    }
+    m_time = std::max(m_time, nanoseconds(time));
+
+    // The meta data is written before the first value data of a sync value.
+    // The sync value is compared in the byte order of the value data.
+    uint32_t sync_value;
+    std::memcpy(&sync_value, value_data, sizeof(sync_value));
+    if (m_sync_values.empty() || m_sync_values.back() != sync_value)
+    {
+        auto it = std::find(m_sync_values.begin(), m_sync_values.end(),
+                            sync_value);
+        if (it == m_sync_values.end())
+        {
+            m_metadata_offsets.push_back(bytes());
+            append(format::metadata, m_time, metadata_data, metadata_bytes);
+            m_sync_values.push_back(sync_value);
+        }
+        else
+        {
+            // The last sync value is found without a search next time
+            std::iter_swap(it, m_sync_values.end() - 1);
+        }
+    }
+
+    if (m_until_entry == 0)
+    {
+        uint8_t entry[format::entry_bytes];
+        format::put64(static_cast<uint64_t>(m_time), entry);
+        format::put64(bytes(), entry + 8);
+        m_entries.insert(m_entries.end(), entry, entry + sizeof(entry));
+        m_until_entry = m_index_interval;
+    }
+    --m_until_entry;
+    append(format::values, m_time, value_data, value_bytes);
+
+    if (m_buffer.size() >= m_sync_bytes)
+    {
+        return sync();
+    }
+    return true;
+}
+
+auto recorder::sync() -> bool
+{
+    if (!is_open())
+    {
+        return false;
+    }
+    append_index();
+    return flush();
+}
+
+auto recorder::close() -> bool
+{
+    if (!is_open())
+    {
+        return false;
+    }
+    append_index();
+    uint8_t trailer[8];
+    format::put64(m_index_offset, trailer);
+    append(format::trailer, m_time, trailer, sizeof(trailer));
+    bool flushed = flush();
+#if defined(ABACUS_POSIX_FILES)
+    bool closed = ::close(m_fd) == 0;
+#else
+    bool closed = false;
+#endif
+    m_fd = -1;
+    return flushed && closed;
+}
+
+auto recorder::bytes() const -> uint64_t
+{
+    return m_written + m_buffer.size();
+}
+
+auto recorder::append(uint8_t type, int64_t time, const uint8_t* data,
+                      std::size_t bytes) -> void
+{
+    const std::size_t start = begin_record(type, time, bytes);
+    if (bytes > 0)
+    {
+        std::memcpy(m_buffer.data() + start + format::header_bytes, data,
+                    bytes);
+    }
+    end_record(start);
+}
+
+auto recorder::append_index() -> void
+{
+    if (m_entries.empty() && m_metadata_offsets.empty())
+    {
+        return;
+    }
+    const std::size_t entries = m_entries.size() / format::entry_bytes;
+    const std::size_t payload = format::index_bytes + m_entries.size() +
+                                m_metadata_offsets.size() * sizeof(uint64_t);
+
+    const uint64_t offset = bytes();
+    const std::size_t start = begin_record(format::index, m_time, payload);
+    uint8_t* out = m_buffer.data() + start + format::header_bytes;
+    format::put64(m_index_offset, out);
+    format::put32(static_cast<uint32_t>(entries), out + 8);
+    format::put32(static_cast<uint32_t>(m_metadata_offsets.size()), out + 12);
+    out += format::index_bytes;
+    std::copy(m_entries.begin(), m_entries.end(), out);
+    out += m_entries.size();
+    for (uint64_t metadata_offset : m_metadata_offsets)
+    {
+        format::put64(metadata_offset, out);
+        out += sizeof(uint64_t);
+    }
+    end_record(start);
+
+    m_index_offset = offset;
+    m_entries.clear();
+    m_metadata_offsets.clear();
+}
+
+auto recorder::begin_record(uint8_t type, int64_t time, std::size_t bytes)
+    -> std::size_t
+{
+    assert(bytes <= std::numeric_limits<uint32_t>::max());
+    const std::size_t start = m_buffer.size();
+    m_buffer.resize(start + format::header_bytes + bytes);
+    uint8_t* header = m_buffer.data() + start;
+    format::put32(static_cast<uint32_t>(bytes), header);
+    std::fill(header + format::type_offset, header + format::time_offset, 0);
+    header[format::type_offset] = type;
+    format::put64(static_cast<uint64_t>(time), header + format::time_offset);
+    return start;
+}
+
+auto recorder::end_record(std::size_t start) -> void
+{
+    // The checksum covers the header after the checksum and the payload
+    uint8_t* header = m_buffer.data() + start;
+    const std::size_t bytes = m_buffer.size() - start;
+    uint32_t crc = detail::crc32c(header + format::type_offset,
+                                  bytes - format::type_offset);
+    format::put32(crc, header + format::checksum_offset);
+}
+
+auto recorder::flush() -> bool
+{
+#if defined(ABACUS_POSIX_FILES)
+    std::size_t written = 0;
+    while (written < m_buffer.size())
+    {
+        auto result = ::write(m_fd, m_buffer.data() + written,
+                              m_buffer.size() - written);
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result <= 0)
+        {
+            ::close(m_fd);
+            m_fd = -1;
+            return false;
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    m_written += m_buffer.size();
+    m_buffer.clear();
+    if (::fsync(m_fd) != 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+}
+}
@@ -0,0 +1,122 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "metrics.hpp"
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// Records the value data of metrics to an append-only file, e.g. as a black
+/// box recorder on a device. The file is read with abacus::recording.
+///
+/// The meta data of a sync value is written once, the first time value data
+/// with the sync value is recorded, and the value data is written as
+/// timestamped records. Recording a snapshot only copies the value data into
+/// a buffer and computes its checksum. The buffer is written and synced to
+/// disk when it holds sync_bytes, or when sync() is called, so a crash loses
+/// at most the records since the last sync.
+///
+/// Every index_interval value records the time and offset of a record is
+/// added to a sparse index, which is written with every sync. The reader
+/// finds the records of a time range by a binary search of the index.
+///
+/// The times of the records must not decrease, an earlier time is recorded
+/// as the time of the previous record. The recorder is not thread-safe.
+class recorder
+{
+public:
+    /// The clock of the record times
+    using clock = std::chrono::system_clock;
+
+public:
+    /// Constructor, creates or truncates the file
+    /// @param path The path of the file
+    /// @param sync_bytes The number of buffered bytes which are written and
+    ///        synced to disk
+    /// @param index_interval The number of value records per index entry
+    recorder(const std::string& path, std::size_t sync_bytes = 1U << 20,
+             std::size_t index_interval = 64);
+
+    /// The recorder owns the file, so it is not copied
+    recorder(const recorder&) = delete;
+    recorder& operator=(const recorder&) = delete;
+
+    /// Destructor, closes the file
+    ~recorder();
+
+    /// @return true if the file is open, false if it could not be created
+    ///         or after an I/O error
+    auto is_open() const -> bool;
+
+    /// Records the value data of metrics
+    /// @param metrics The metrics
+    /// @param time The time of the value data
+    /// @return false on an I/O error
+    [[nodiscard]] auto record(const metrics& metrics,
+                              clock::time_point time = clock::now()) -> bool;
+
+    /// Records value data, e.g. received from another process
+    /// @param metadata_data The meta data of the value data
+    /// @param metadata_bytes The size of the meta data
+    /// @param value_data The value data
+    /// @param value_bytes The size of the value data
+    /// @param time The time of the value data
+    /// @return false on an I/O error
+    [[nodiscard]] auto record(const uint8_t* metadata_data,
+                              std::size_t metadata_bytes,
+                              const uint8_t* value_data,
+                              std::size_t value_bytes, clock::time_point time)
+        -> bool;
+
+    /// Writes the buffered records and the index and syncs them to disk
+    /// @return false on an I/O error
+    [[nodiscard]] auto sync() -> bool;
+
+    /// Syncs the records and closes the file. A closed file ends with a
+    /// trailer, which lets the reader find the index without scanning the
+    /// records.
+    /// @return false on an I/O error
+    [[nodiscard]] auto close() -> bool;
+
+    /// @return The size of the file including the buffered records
+    auto bytes() const -> uint64_t;
+
+private:
+    auto append(uint8_t type, int64_t time, const uint8_t* data,
+                std::size_t bytes) -> void;
+
+    auto append_index() -> void;
+
+    auto begin_record(uint8_t type, int64_t time, std::size_t bytes)
+        -> std::size_t;
+
+    auto end_record(std::size_t start) -> void;
+
+    auto flush() -> bool;
+
+private:
+    int m_fd = -1;
+    const std::size_t m_sync_bytes;
+    const std::size_t m_index_interval;
+    std::vector<uint8_t> m_buffer;
+    uint64_t m_written = 0;
+    int64_t m_time = 0;
+    std::vector<uint32_t> m_sync_values;
+    std::size_t m_until_entry = 0;
+    std::vector<uint8_t> m_entries;
+    std::vector<uint64_t> m_metadata_offsets;
+    uint64_t m_index_offset = 0;
+};
+}
+}
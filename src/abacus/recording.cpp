@@ -0,0 +1,359 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "recording.hpp"
+
+#include "detail/crc32c.hpp"
+#include "detail/record_format.hpp"
+#include "detail/value_bytes.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <endian/big_endian.hpp>
+#include <endian/little_endian.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ABACUS_POSIX_FILES 1
+#endif
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace
+{
+namespace format = detail::record_format;
+
+// The size of the trailer record at the end of a closed file
+static constexpr std::size_t trailer_bytes = format::header_bytes + 8;
+}
+
+recording::recording(const std::string& path)
+{
+#if defined(ABACUS_POSIX_FILES)
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return;
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0 ||
+        static_cast<std::size_t>(status.st_size) < format::file_header_bytes)
+    {
+        ::close(fd);
+        return;
+    }
+    const std::size_t bytes = static_cast<std::size_t>(status.st_size);
+    void* data = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping stays valid when the file is closed
+    ::close(fd);
+    if (data == MAP_FAILED)
+    {
+        return;
+    }
+    m_data = static_cast<const uint8_t*>(data);
+    m_bytes = bytes;
+#else
+    (void)path;
+    return;
+#endif
+
+    if (!std::equal(std::begin(format::magic), std::end(format::magic),
+                    m_data) ||
+        format::get32(m_data + 8) != format::version)
+    {
+        return;
+    }
+
+    // A closed file is read from its index, otherwise the records are
+    // scanned up to the first torn or corrupted record
+    if (!read_index())
+    {
+        m_schemas.clear();
+        m_entries.clear();
+        scan();
+    }
+}
+
+recording::~recording()
+{
+#if defined(ABACUS_POSIX_FILES)
+    if (m_data != nullptr)
+    {
+        ::munmap(const_cast<uint8_t*>(m_data), m_bytes);
+    }
+#endif
+}
+
+auto recording::is_open() const -> bool
+{
+    return m_end != 0;
+}
+
+auto recording::recovered() const -> bool
+{
+    return m_recovered;
+}
+
+auto recording::sync_values() const -> std::vector<uint32_t>
+{
+    std::vector<uint32_t> sync_values;
+    sync_values.reserve(m_schemas.size());
+    for (const auto& [key, schema] : m_schemas)
+    {
+        sync_values.push_back(schema.view.metadata().sync_value());
+    }
+    return sync_values;
+}
+
+auto recording::index_entries() const -> std::size_t
+{
+    return m_entries.size();
+}
+
+auto recording::read(clock::time_point from, clock::time_point to,
+                     const callback& function) -> bool
+{
+    assert(function);
+    if (!is_open() || m_entries.empty() || to < from)
+    {
+        return true;
+    }
+    const int64_t first = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              from.time_since_epoch())
+                              .count();
+    const int64_t last = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             to.time_since_epoch())
+                             .count();
+
+    // The records between two index entries have times between the times of
+    // the entries, so the range starts after the last entry before it
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), first,
+                               [](const entry& e, int64_t time)
+                               { return e.time < time; });
+    if (it != m_entries.begin())
+    {
+        --it;
+    }
+
+    uint64_t offset = it->offset;
+    schema* current = nullptr;
+    uint32_t current_key = 0;
+    while (offset + format::header_bytes <= m_end)
+    {
+        const uint8_t* header = m_data + offset;
+        const std::size_t payload = format::get32(header);
+        const uint64_t next = offset + format::header_bytes + payload;
+        if (next > m_end)
+        {
+            return false;
+        }
+        const auto time =
+            static_cast<int64_t>(format::get64(header + format::time_offset));
+        if (time > last)
+        {
+            break;
+        }
+        const uint64_t start = offset;
+        offset = next;
+        if (header[format::type_offset] != format::values || time < first)
+        {
+            continue;
+        }
+
+        // Only the records in the range are checked and parsed
+        if (record_bytes(start, format::values) == 0 ||
+            payload < sizeof(uint32_t))
+        {
+            return false;
+        }
+        const uint8_t* value_data = header + format::header_bytes;
+        uint32_t key;
+        std::memcpy(&key, value_data, sizeof(key));
+        if (current == nullptr || key != current_key)
+        {
+            auto schema = m_schemas.find(key);
+            if (schema == m_schemas.end())
+            {
+                return false;
+            }
+            current = &schema->second;
+            current_key = key;
+        }
+        // The view reads the value data only within the size of the schema
+        if (payload != current->value_bytes ||
+            !current->view.set_value_data(value_data, payload))
+        {
+            return false;
+        }
+        auto since_epoch = std::chrono::duration_cast<clock::duration>(
+            std::chrono::nanoseconds(time));
+        function(clock::time_point(since_epoch), current->view);
+    }
+    return true;
+}
+
+auto recording::record_bytes(uint64_t offset, uint8_t type) const
+    -> std::size_t
+{
+    if (offset < format::file_header_bytes ||
+        offset + format::header_bytes > m_bytes)
+    {
+        return 0;
+    }
+    const uint8_t* header = m_data + offset;
+    const uint64_t bytes = format::header_bytes + format::get32(header);
+    if (bytes > m_bytes - offset ||
+        (type != 0 && header[format::type_offset] != type))
+    {
+        return 0;
+    }
+    uint32_t crc = detail::crc32c(header + format::type_offset,
+                                  bytes - format::type_offset);
+    if (crc != format::get32(header + format::checksum_offset))
+    {
+        return 0;
+    }
+    return static_cast<std::size_t>(bytes);
+}
+
+auto recording::read_index() -> bool
+{
+    if (m_bytes < format::file_header_bytes + trailer_bytes)
+    {
+        return false;
+    }
+    const uint64_t trailer = m_bytes - trailer_bytes;
+    if (record_bytes(trailer, format::trailer) != trailer_bytes)
+    {
+        return false;
+    }
+    m_end = trailer;
+
+    // The index records are chained from the last to the first
+    std::vector<uint64_t> chain;
+    uint64_t offset = format::get64(m_data + trailer + format::header_bytes);
+    while (offset != 0)
+    {
+        const uint64_t previous = chain.empty() ? trailer : chain.back();
+        if (offset >= previous || record_bytes(offset, format::index) == 0)
+        {
+            return false;
+        }
+        chain.push_back(offset);
+        offset = format::get64(m_data + offset + format::header_bytes);
+    }
+
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+    {
+        const uint8_t* header = m_data + *it;
+        const std::size_t payload = format::get32(header);
+        const uint8_t* in = header + format::header_bytes;
+        const std::size_t entries = format::get32(in + 8);
+        const std::size_t metadata = format::get32(in + 12);
+        if (payload != format::index_bytes + entries * format::entry_bytes +
+                           metadata * sizeof(uint64_t))
+        {
+            return false;
+        }
+        in += format::index_bytes;
+        for (std::size_t i = 0; i < entries; ++i)
+        {
+            entry e{static_cast<int64_t>(format::get64(in)),
+                    format::get64(in + 8)};
+            if (e.offset >= trailer ||
+                (!m_entries.empty() && e.time < m_entries.back().time))
+            {
+                return false;
+            }
+            m_entries.push_back(e);
+            in += format::entry_bytes;
+        }
+        for (std::size_t i = 0; i < metadata; ++i)
+        {
+            if (!add_metadata(format::get64(in)))
+            {
+                return false;
+            }
+            in += sizeof(uint64_t);
+        }
+    }
+    return true;
+}
+
+auto recording::scan() -> void
+{
+    m_recovered = true;
+    uint64_t offset = format::file_header_bytes;
+    while (true)
+    {
+        const std::size_t bytes = record_bytes(offset, 0);
+        if (bytes == 0)
+        {
+            break;
+        }
+        const uint8_t* header = m_data + offset;
+        const auto time =
+            static_cast<int64_t>(format::get64(header + format::time_offset));
+        if (!m_entries.empty() && time < m_entries.back().time)
+        {
+            break;
+        }
+        const uint8_t type = header[format::type_offset];
+        if (type == format::metadata && !add_metadata(offset))
+        {
+            break;
+        }
+        if (type == format::values)
+        {
+            // Every value record is indexed, as the scan reads all of them
+            m_entries.push_back({time, offset});
+        }
+        offset += bytes;
+    }
+    m_end = offset;
+}
+
+auto recording::add_metadata(uint64_t offset) -> bool
+{
+    const std::size_t bytes = record_bytes(offset, format::metadata);
+    if (bytes == 0)
+    {
+        return false;
+    }
+    schema schema;
+    if (!schema.view.set_metadata(m_data + offset + format::header_bytes,
+                                  bytes - format::header_bytes))
+    {
+        return false;
+    }
+    const auto& metadata = schema.view.metadata();
+    schema.value_bytes = detail::value_bytes(metadata);
+
+    // The schemas are found by the sync value in the byte order of the value
+    // data
+    uint8_t sync_value[sizeof(uint32_t)];
+    if (metadata.endianness() == protobuf::Endianness::BIG)
+    {
+        endian::big_endian::put<uint32_t>(metadata.sync_value(), sync_value);
+    }
+    else
+    {
+        endian::little_endian::put<uint32_t>(metadata.sync_value(),
+                                             sync_value);
+    }
+    uint32_t key;
+    std::memcpy(&key, sync_value, sizeof(key));
+    m_schemas.emplace(key, std::move(schema));
+    return true;
+}
+}
+}
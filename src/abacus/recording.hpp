@@ -0,0 +1,109 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "version.hpp"
+#include "view.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// Reads a file written by abacus::recorder.
+///
+/// The file is mapped into memory and the meta data and index are read when
+/// it is opened. The value data of a time range is found by a binary search
+/// of the sparse index, from where the records are skipped by their headers
+/// until the range starts, so records outside the range are not parsed. The
+/// views passed to read() point into the mapped file, no value data is
+/// copied.
+///
+/// A file which was not closed, e.g. after a crash, has no trailer. Its
+/// records are then scanned once when it is opened, and the records before
+/// the first torn or corrupted record are read.
+class recording
+{
+public:
+    /// The clock of the record times
+    using clock = std::chrono::system_clock;
+
+    /// The function called with the value data of a record
+    using callback = std::function<void(clock::time_point, const view&)>;
+
+public:
+    /// Constructor, opens and maps the file
+    /// @param path The path of the file
+    recording(const std::string& path);
+
+    /// The recording owns the mapping, so it is not copied
+    recording(const recording&) = delete;
+    recording& operator=(const recording&) = delete;
+
+    /// Destructor, unmaps the file
+    ~recording();
+
+    /// @return true if the file is open, false if it could not be mapped or
+    ///         is not a recording
+    auto is_open() const -> bool;
+
+    /// @return true if the file had no trailer and its records were scanned
+    auto recovered() const -> bool;
+
+    /// @return The sync values of the meta data in the file
+    auto sync_values() const -> std::vector<uint32_t>;
+
+    /// @return The number of entries of the index
+    auto index_entries() const -> std::size_t;
+
+    /// Reads the value data recorded in a time range. The view is only
+    /// valid during the call.
+    /// @param from The start of the range
+    /// @param to The end of the range, included
+    /// @param function The function called with the time and a view of
+    ///        every value data in the range, in the recorded order
+    /// @return false if a record in the range is corrupted or has no meta
+    ///         data, the records before it have been read
+    [[nodiscard]] auto read(clock::time_point from, clock::time_point to,
+                            const callback& function) -> bool;
+
+private:
+    struct entry
+    {
+        int64_t time;
+        uint64_t offset;
+    };
+
+    struct schema
+    {
+        abacus::view view;
+        std::size_t value_bytes;
+    };
+
+    auto record_bytes(uint64_t offset, uint8_t type) const -> std::size_t;
+
+    auto read_index() -> bool;
+
+    auto scan() -> void;
+
+    auto add_metadata(uint64_t offset) -> bool;
+
+private:
+    const uint8_t* m_data = nullptr;
+    std::size_t m_bytes = 0;
+    std::size_t m_end = 0;
+    bool m_recovered = false;
+    std::vector<entry> m_entries;
+    std::map<uint32_t, schema> m_schemas;
+};
+}
+}
@@ -0,0 +1,252 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "registry.hpp"
+
+#include "detail/hash_function.hpp"
+#include "detail/make_metric.hpp"
+#include "detail/serialize.hpp"
+
+#include "protocol_version.hpp"
+
+#include <endian/is_big_endian.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace
+{
+// The largest value of a metric, including the byte telling whether it is
+// set. A value never crosses a segment boundary.
+constexpr std::size_t max_value_bytes = sizeof(uint64_t) + 1;
+
+template <class Metric>
+static inline auto type_case() -> protobuf::Metric::TypeCase
+{
+    if constexpr (std::is_same_v<Metric, uint64>)
+        return protobuf::Metric::kUint64;
+    if constexpr (std::is_same_v<Metric, int64>)
+        return protobuf::Metric::kInt64;
+    if constexpr (std::is_same_v<Metric, uint32>)
+        return protobuf::Metric::kUint32;
+    if constexpr (std::is_same_v<Metric, int32>)
+        return protobuf::Metric::kInt32;
+    if constexpr (std::is_same_v<Metric, float64>)
+        return protobuf::Metric::kFloat64;
+    if constexpr (std::is_same_v<Metric, float32>)
+        return protobuf::Metric::kFloat32;
+    if constexpr (std::is_same_v<Metric, boolean>)
+        return protobuf::Metric::kBoolean;
+    if constexpr (std::is_same_v<Metric, enum8>)
+        return protobuf::Metric::kEnum8;
+    return protobuf::Metric::TYPE_NOT_SET;
+}
+
+// Computes the sync value of a meta data message with the sync value unset
+static inline auto sync_value(const protobuf::MetricsMetadata& metadata)
+    -> uint32_t
+{
+    assert(metadata.sync_value() == 0);
+    std::size_t bytes = metadata.ByteSizeLong();
+    std::vector<uint8_t> data(bytes);
+    detail::serialize(metadata, data.data(), bytes);
+    return detail::hash_function(data.data(), bytes);
+}
+}
+
+registry::registry(std::size_t segment_bytes) :
+    m_segment_bytes(segment_bytes), m_value_bytes(sizeof(uint32_t))
+{
+    assert(m_segment_bytes >= sizeof(uint32_t) + max_value_bytes);
+    m_segments.emplace_back(new uint8_t[m_segment_bytes]());
+
+    m_metadata.set_protocol_version(
+        protocol_version(metadata_encoding::inline_strings));
+    m_metadata.set_endianness(endian::is_big_endian()
+                                  ? protobuf::Endianness::BIG
+                                  : protobuf::Endianness::LITTLE);
+    m_pending.set_protocol_version(m_metadata.protocol_version());
+    m_pending.set_endianness(m_metadata.endianness());
+
+    // The first sync value covers the empty meta data
+    uint32_t sync = sync_value(m_metadata);
+    m_metadata.set_sync_value(sync);
+    std::memcpy(m_segments[0].get(), &sync, sizeof(uint32_t));
+}
+
+auto registry::add(const name& name, const abacus::info& info) -> std::size_t
+{
+    // Nothing is changed when the name is in use, so the ids and offsets
+    // stay in step with the meta data
+    auto [it, inserted] = m_ids.try_emplace(name.value, m_names.size());
+    if (!inserted)
+    {
+        throw std::invalid_argument("Metric already added: " + name.value);
+    }
+
+    // Start a new segment if the value may not fit in the current one
+    const bool has_value = !std::holds_alternative<constant>(info);
+    std::size_t segment_end = m_segments.size() * m_segment_bytes;
+    if (has_value && m_value_bytes + max_value_bytes > segment_end)
+    {
+        m_value_bytes = segment_end;
+        m_segments.emplace_back(new uint8_t[m_segment_bytes]());
+    }
+
+    protobuf::Metric& metric = (*m_pending.mutable_metrics())[name.value];
+    std::size_t bytes = detail::make_metric(info, m_value_bytes, metric);
+
+    assert(has_value == (bytes > 0));
+
+    // Constants have no value and are always initialized
+    m_names.emplace_back(it->first);
+    m_offsets.push_back(has_value ? m_value_bytes : 0);
+    m_types.push_back(metric.type_case());
+    m_initialized.push_back(!has_value);
+    m_retired.push_back(false);
+
+    m_value_bytes += bytes;
+    return it->second;
+}
+
+auto registry::retire(std::size_t id) -> void
+{
+    assert(id < m_names.size());
+    assert(!m_retired[id]);
+    m_retired[id] = true;
+
+    if (m_types[id] != protobuf::Metric::kConstant)
+    {
+        // Clear the value, the metric reads as not set
+        *value(m_offsets[id]) = 0;
+    }
+}
+
+auto registry::is_retired(std::size_t id) const -> bool
+{
+    assert(id < m_retired.size());
+    return m_retired[id];
+}
+
+auto registry::count() const -> std::size_t
+{
+    return m_names.size();
+}
+
+auto registry::id(std::string_view name) const -> std::size_t
+{
+    auto it = m_ids.find(name);
+    if (it == m_ids.end())
+    {
+        throw std::out_of_range("Unknown metric: " + std::string(name));
+    }
+    return it->second;
+}
+
+auto registry::metric_name(std::size_t id) const -> std::string_view
+{
+    assert(id < m_names.size());
+    return m_names[id];
+}
+
+template <class Metric>
+[[nodiscard]] auto registry::initialize(std::size_t id) -> metric<Metric>
+{
+    assert(id < m_names.size());
+    assert(!m_initialized[id]);
+    assert(!m_retired[id]);
+    assert(m_types[id] == type_case<Metric>());
+
+    m_initialized[id] = true;
+    return metric<Metric>(value(m_offsets[id]));
+}
+
+// Explicit instantiations for the expected types
+template auto registry::initialize<uint64>(std::size_t id) -> metric<uint64>;
+
+template auto registry::initialize<int64>(std::size_t id) -> metric<int64>;
+
+template auto registry::initialize<uint32>(std::size_t id) -> metric<uint32>;
+
+template auto registry::initialize<int32>(std::size_t id) -> metric<int32>;
+
+template auto registry::initialize<float64>(std::size_t id) -> metric<float64>;
+
+template auto registry::initialize<float32>(std::size_t id) -> metric<float32>;
+
+template auto registry::initialize<boolean>(std::size_t id) -> metric<boolean>;
+
+template auto registry::initialize<enum8>(std::size_t id) -> metric<enum8>;
+
+auto registry::is_initialized(std::size_t id) const -> bool
+{
+    assert(id < m_initialized.size());
+    return m_initialized[id];
+}
+
+auto registry::has_update() const -> bool
+{
+    return !m_pending.metrics().empty();
+}
+
+auto registry::update() -> protobuf::MetricsMetadata
+{
+    protobuf::MetricsMetadata update;
+    update.Swap(&m_pending);
+    m_pending.set_protocol_version(update.protocol_version());
+    m_pending.set_endianness(update.endianness());
+
+    // The update is chained to the current meta data through the base sync
+    // value, so the new sync value covers all published metrics
+    update.set_base_sync_value(m_metadata.sync_value());
+    uint32_t sync = sync_value(update);
+    update.set_sync_value(sync);
+
+    auto* metrics = m_metadata.mutable_metrics();
+    for (const auto& [name, metric] : update.metrics())
+    {
+        (*metrics)[name] = metric;
+    }
+    m_metadata.set_sync_value(sync);
+    std::memcpy(m_segments[0].get(), &sync, sizeof(uint32_t));
+    return update;
+}
+
+auto registry::metadata() const -> const protobuf::MetricsMetadata&
+{
+    return m_metadata;
+}
+
+auto registry::value_bytes() const -> std::size_t
+{
+    return m_value_bytes;
+}
+
+auto registry::copy_value_data(uint8_t* data) const -> void
+{
+    assert(data != nullptr);
+    std::size_t offset = 0;
+    for (const auto& segment : m_segments)
+    {
+        std::size_t bytes = std::min(m_segment_bytes, m_value_bytes - offset);
+        std::memcpy(data + offset, segment.get(), bytes);
+        offset += bytes;
+    }
+}
+
+auto registry::value(std::size_t offset) const -> uint8_t*
+{
+    assert(offset < m_value_bytes);
+    return m_segments[offset / m_segment_bytes].get() +
+           offset % m_segment_bytes;
+}
+}
+}
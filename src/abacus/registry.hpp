@@ -0,0 +1,157 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "info.hpp"
+#include "metric.hpp"
+#include "name.hpp"
+#include "version.hpp"
+
+#include "protobuf/metrics.pb.h"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// A set of metrics which can grow at runtime, e.g. when a new peer or
+/// queue appears.
+///
+/// The values are stored in fixed-size segments which are never moved, so
+/// the metric objects returned by initialize() stay valid when metrics are
+/// added. The value data seen by a view is the concatenation of the
+/// segments, see copy_value_data().
+///
+/// Added metrics are published with update(), which returns an incremental
+/// meta data update holding only the new metrics and advances the sync
+/// value. Consumers apply the update with abacus::view::apply_update(), new
+/// consumers start from the full metadata().
+///
+/// Unlike abacus::metrics the ids are assigned in the order the metrics are
+/// added, so they are not the ids used by abacus::view.
+class registry
+{
+public:
+    /// Constructor
+    /// @param segment_bytes The size of a value segment in bytes
+    registry(std::size_t segment_bytes = 4096);
+
+    /// Adds a metric. The metric is included in the meta data from the next
+    /// update().
+    /// @param name The name of the metric, if it is in use
+    ///        std::invalid_argument is thrown and the registry is unchanged
+    /// @param info The info of the metric
+    /// @return The id of the metric
+    auto add(const name& name, const abacus::info& info) -> std::size_t;
+
+    /// Retires a metric. The value of the metric is cleared and it is never
+    /// set again, the metric object of the metric must no longer be used.
+    /// The metric stays in the meta data without a value, as an update can
+    /// only add metrics.
+    /// @param id The id of the metric
+    auto retire(std::size_t id) -> void;
+
+    /// @param id The id of the metric
+    /// @return true if the metric has been retired
+    auto is_retired(std::size_t id) const -> bool;
+
+    /// @return The number of metrics, including retired metrics
+    auto count() const -> std::size_t;
+
+    /// @param name The name of the metric
+    /// @return The id of the metric
+    auto id(std::string_view name) const -> std::size_t;
+
+    /// @param id The id of the metric
+    /// @return The name of the metric
+    auto metric_name(std::size_t id) const -> std::string_view;
+
+    /// Initialize a metric
+    /// @param id The id of the metric
+    /// @return The metric object
+    template <class Metric>
+    [[nodiscard]] auto initialize(std::size_t id) -> metric<Metric>;
+
+    /// Initialize a metric
+    /// @param name The name of the metric
+    /// @return The metric object
+    template <class Metric>
+    [[nodiscard]] auto initialize(std::string_view name) -> metric<Metric>
+    {
+        return initialize<Metric>(id(name));
+    }
+
+    /// @param id The id of the metric
+    /// @return true if the metric has been initialized
+    auto is_initialized(std::size_t id) const -> bool;
+
+    /// @return true if metrics have been added since the last update
+    auto has_update() const -> bool;
+
+    /// Publishes the metrics added since the last update. The sync value is
+    /// advanced and written to the value data.
+    /// @return The meta data update with the added metrics, the sync value
+    ///         of the meta data it applies to is the base sync value
+    auto update() -> protobuf::MetricsMetadata;
+
+    /// @return The meta data of the published metrics
+    auto metadata() const -> const protobuf::MetricsMetadata&;
+
+    /// @return The size of the value data in bytes
+    auto value_bytes() const -> std::size_t;
+
+    /// Copies the value data, i.e. the segments, into a buffer
+    /// @param data The buffer of at least value_bytes() bytes
+    auto copy_value_data(uint8_t* data) const -> void;
+
+private:
+    /// @param offset The offset of a value in the value data
+    /// @return The pointer to the value in its segment
+    auto value(std::size_t offset) const -> uint8_t*;
+
+private:
+    /// The size of a segment in bytes
+    std::size_t m_segment_bytes;
+
+    /// The value segments
+    std::vector<std::unique_ptr<uint8_t[]>> m_segments;
+
+    /// The size of the value data in bytes
+    std::size_t m_value_bytes;
+
+    /// The meta data of the published metrics
+    protobuf::MetricsMetadata m_metadata;
+
+    /// The meta data of the metrics added since the last update
+    protobuf::MetricsMetadata m_pending;
+
+    /// The ids of the metrics by name
+    std::map<std::string, std::size_t, std::less<>> m_ids;
+
+    /// The names of the metrics indexed by id, pointing into m_ids
+    std::vector<std::string_view> m_names;
+
+    /// The value offsets of the metrics indexed by id
+    std::vector<std::size_t> m_offsets;
+
+    /// The types of the metrics indexed by id
+    std::vector<protobuf::Metric::TypeCase> m_types;
+
+    /// The initialization status of the metrics indexed by id
+    std::vector<bool> m_initialized;
+
+    /// The retired status of the metrics indexed by id
+    std::vector<bool> m_retired;
+};
+}
+}
@@ -0,0 +1,394 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "rollup.hpp"
+
+#include "detail/saturate.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <string_view>
+#include <type_traits>
+
+#include <endian/is_big_endian.hpp>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace
+{
+// The position of a metric which is in no group
+static constexpr std::size_t no_group =
+    std::numeric_limits<std::size_t>::max();
+}
+
+rollup::rollup(const protobuf::MetricsMetadata& metadata,
+               clock::duration window, std::size_t capacity) :
+    m_sync_value(metadata.sync_value()), m_value_bytes(sizeof(uint32_t)),
+    m_window(window), m_capacity(capacity)
+{
+    assert(m_window > clock::duration::zero());
+    assert(m_capacity > 0);
+
+    auto host = endian::is_big_endian() ? protobuf::Endianness::BIG
+                                        : protobuf::Endianness::LITTLE;
+    m_native = metadata.endianness() == host;
+
+    // The ids are assigned in the order of the names
+    std::vector<std::string_view> names;
+    names.reserve(metadata.metrics_size());
+    for (const auto& [name, metric] : metadata.metrics())
+    {
+        names.emplace_back(name);
+    }
+    std::sort(names.begin(), names.end());
+
+    // Group the metrics by type, the map keeps the groups in a deterministic
+    // order
+    std::map<protobuf::Metric::TypeCase, std::size_t> groups;
+    for (auto name : names)
+    {
+        const auto& metric = metadata.metrics().at(std::string(name));
+        std::size_t offset = 0;
+        std::size_t size = 0;
+        switch (metric.type_case())
+        {
+        case protobuf::Metric::kUint64:
+            offset = metric.uint64().offset();
+            size = sizeof(uint64_t);
+            break;
+        case protobuf::Metric::kInt64:
+            offset = metric.int64().offset();
+            size = sizeof(int64_t);
+            break;
+        case protobuf::Metric::kUint32:
+            offset = metric.uint32().offset();
+            size = sizeof(uint32_t);
+            break;
+        case protobuf::Metric::kInt32:
+            offset = metric.int32().offset();
+            size = sizeof(int32_t);
+            break;
+        case protobuf::Metric::kFloat64:
+            offset = metric.float64().offset();
+            size = sizeof(double);
+            break;
+        case protobuf::Metric::kFloat32:
+            offset = metric.float32().offset();
+            size = sizeof(float);
+            break;
+        case protobuf::Metric::kBoolean:
+            offset = metric.boolean().offset();
+            size = 1;
+            break;
+        case protobuf::Metric::kEnum8:
+            offset = metric.enum8().offset();
+            size = 1;
+            break;
+        default:
+            // Constants have no value
+            m_positions.emplace_back(no_group, 0);
+            continue;
+        }
+        m_value_bytes = std::max(m_value_bytes, offset + 1 + size);
+
+        auto [it, inserted] =
+            groups.try_emplace(metric.type_case(), m_groups.size());
+        if (inserted)
+        {
+            m_groups.push_back({metric.type_case(), {}, {}, {}});
+        }
+        auto& group = m_groups[it->second];
+        m_positions.emplace_back(it->second, group.offsets.size());
+        group.offsets.push_back(offset);
+    }
+
+    // One slot more than the closed windows for the current window
+    const std::size_t slots = m_capacity + 1;
+    for (auto& group : m_groups)
+    {
+        switch (group.type)
+        {
+        case protobuf::Metric::kUint64:
+            group.statistics = columns<uint64_t, uint64_t>{};
+            break;
+        case protobuf::Metric::kInt64:
+            group.statistics = columns<int64_t, int64_t>{};
+            break;
+        case protobuf::Metric::kUint32:
+            group.statistics = columns<uint32_t, uint64_t>{};
+            break;
+        case protobuf::Metric::kInt32:
+            group.statistics = columns<int32_t, int64_t>{};
+            break;
+        case protobuf::Metric::kFloat64:
+            group.statistics = columns<double, double>{};
+            break;
+        case protobuf::Metric::kFloat32:
+            group.statistics = columns<float, double>{};
+            break;
+        default:
+            group.statistics = columns<uint8_t, uint64_t>{};
+            break;
+        }
+        const std::size_t size = slots * group.offsets.size();
+        std::visit(
+            [size](auto& columns)
+            {
+                columns.min.resize(size);
+                columns.max.resize(size);
+                columns.last.resize(size);
+                columns.sum.resize(size);
+            },
+            group.statistics);
+        group.counts.resize(size);
+    }
+    m_starts.resize(slots);
+    m_samples.resize(slots);
+    reset(slot(0));
+}
+
+auto rollup::value_bytes() const -> std::size_t
+{
+    return m_value_bytes;
+}
+
+auto rollup::window() const -> clock::duration
+{
+    return m_window;
+}
+
+auto rollup::capacity() const -> std::size_t
+{
+    return m_capacity;
+}
+
+auto rollup::size() const -> std::size_t
+{
+    return m_size;
+}
+
+auto rollup::update(const uint8_t* value_data, clock::time_point time)
+    -> bool
+{
+    assert(value_data != nullptr);
+
+    // The values are combined in the byte order of the host
+    uint32_t sync_value;
+    std::memcpy(&sync_value, value_data, sizeof(sync_value));
+    if (!m_native || sync_value != m_sync_value)
+    {
+        return false;
+    }
+
+    const clock::time_point start(m_window *
+                                  (time.time_since_epoch() / m_window));
+    std::size_t current = slot(m_size);
+    if (m_samples[current] != 0 && start > m_starts[current])
+    {
+        flush();
+        current = slot(m_size);
+    }
+    if (m_samples[current] == 0)
+    {
+        m_starts[current] = start;
+    }
+    ++m_samples[current];
+
+    for (auto& group : m_groups)
+    {
+        const std::size_t size = group.offsets.size();
+        const std::size_t* offsets = group.offsets.data();
+        uint32_t* counts = group.counts.data() + current * size;
+        std::visit(
+            [&](auto& columns)
+            {
+                using value_type =
+                    typename std::decay_t<decltype(columns.min)>::value_type;
+                using sum_type =
+                    typename std::decay_t<decltype(columns.sum)>::value_type;
+                value_type* min = columns.min.data() + current * size;
+                value_type* max = columns.max.data() + current * size;
+                value_type* last = columns.last.data() + current * size;
+                sum_type* sum = columns.sum.data() + current * size;
+
+                // Branchless, a value which is not set is replaced by the
+                // identity of the statistic. Integer sums saturate at the
+                // limits of the sum type instead of wrapping.
+                const value_type highest =
+                    std::numeric_limits<value_type>::max();
+                const value_type lowest =
+                    std::numeric_limits<value_type>::lowest();
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    const uint8_t* slot = value_data + offsets[i];
+                    const bool set = slot[0] != 0;
+                    value_type value;
+                    std::memcpy(&value, slot + 1, sizeof(value));
+                    min[i] = std::min(min[i], set ? value : highest);
+                    max[i] = std::max(max[i], set ? value : lowest);
+                    last[i] = set ? value : last[i];
+                    bool overflow;
+                    sum[i] = detail::saturating_add(
+                        sum[i], set ? static_cast<sum_type>(value) : sum_type{},
+                        overflow);
+                    counts[i] += set;
+                }
+            },
+            group.statistics);
+    }
+    return true;
+}
+
+auto rollup::flush() -> void
+{
+    if (m_samples[slot(m_size)] == 0)
+    {
+        return;
+    }
+    if (m_size < m_capacity)
+    {
+        ++m_size;
+    }
+    else
+    {
+        // Overwrite the oldest window
+        m_first = m_first == m_capacity ? 0 : m_first + 1;
+    }
+    reset(slot(m_size));
+}
+
+auto rollup::start(std::size_t index) const -> clock::time_point
+{
+    assert(index < m_size);
+    return m_starts[slot(index)];
+}
+
+auto rollup::samples(std::size_t index) const -> uint32_t
+{
+    assert(index < m_size);
+    return m_samples[slot(index)];
+}
+
+auto rollup::count(std::size_t index, std::size_t id) const -> uint32_t
+{
+    assert(index < m_size);
+    assert(id < m_positions.size());
+    auto [group, position] = m_positions[id];
+    if (group == no_group)
+    {
+        return 0;
+    }
+    const auto& counts = m_groups[group].counts;
+    return counts[slot(index) * m_groups[group].offsets.size() + position];
+}
+
+auto rollup::write(std::size_t index, abacus::statistic statistic,
+                   uint8_t* data) const -> void
+{
+    assert(index < m_size);
+    assert(data != nullptr);
+
+    const std::size_t window = slot(index);
+    std::memset(data, 0, m_value_bytes);
+    std::memcpy(data, &m_sync_value, sizeof(m_sync_value));
+    for (const auto& group : m_groups)
+    {
+        const bool number = group.type != protobuf::Metric::kBoolean &&
+                            group.type != protobuf::Metric::kEnum8;
+        if (!number &&
+            (statistic == statistic::sum || statistic == statistic::avg))
+        {
+            continue;
+        }
+        const std::size_t size = group.offsets.size();
+        const uint32_t* counts = group.counts.data() + window * size;
+        std::visit(
+            [&](const auto& columns)
+            {
+                using value_type =
+                    typename std::decay_t<decltype(columns.min)>::value_type;
+                using sum_type =
+                    typename std::decay_t<decltype(columns.sum)>::value_type;
+                const std::size_t first = window * size;
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    if (counts[i] == 0)
+                    {
+                        continue;
+                    }
+                    value_type value{};
+                    switch (statistic)
+                    {
+                    case statistic::min:
+                        value = columns.min[first + i];
+                        break;
+                    case statistic::max:
+                        value = columns.max[first + i];
+                        break;
+                    case statistic::last:
+                        value = columns.last[first + i];
+                        break;
+                    case statistic::sum:
+                        value = detail::narrow<value_type>(
+                            columns.sum[first + i]);
+                        break;
+                    case statistic::avg:
+                        value = detail::narrow<value_type>(
+                            columns.sum[first + i] /
+                            static_cast<sum_type>(counts[i]));
+                        break;
+                    }
+                    uint8_t* slot = data + group.offsets[i];
+                    slot[0] = 1;
+                    std::memcpy(slot + 1, &value, sizeof(value));
+                }
+            },
+            group.statistics);
+    }
+}
+
+auto rollup::slot(std::size_t index) const -> std::size_t
+{
+    // The ring has one slot more than the closed windows
+    std::size_t slot = m_first + index;
+    return slot <= m_capacity ? slot : slot - m_capacity - 1;
+}
+
+auto rollup::reset(std::size_t slot) -> void
+{
+    for (auto& group : m_groups)
+    {
+        const std::size_t size = group.offsets.size();
+        const auto first = static_cast<std::ptrdiff_t>(slot * size);
+        const auto last = static_cast<std::ptrdiff_t>((slot + 1) * size);
+        std::visit(
+            [&](auto& columns)
+            {
+                using value_type =
+                    typename std::decay_t<decltype(columns.min)>::value_type;
+                std::fill(columns.min.begin() + first,
+                          columns.min.begin() + last,
+                          std::numeric_limits<value_type>::max());
+                std::fill(columns.max.begin() + first,
+                          columns.max.begin() + last,
+                          std::numeric_limits<value_type>::lowest());
+                std::fill(columns.last.begin() + first,
+                          columns.last.begin() + last, value_type{});
+                std::fill(columns.sum.begin() + first,
+                          columns.sum.begin() + last, 0);
+            },
+            group.statistics);
+        std::fill(group.counts.begin() + first, group.counts.begin() + last,
+                  0);
+    }
+    m_samples[slot] = 0;
+}
+}
+}
@@ -0,0 +1,186 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+#include "protobuf/metrics.pb.h"
+#include "statistic.hpp"
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// Downsamples successive value buffers of one schema into fixed windows,
+/// e.g. of 10 seconds, keeping the min, max, sum, count and last value of
+/// every metric per window.
+///
+/// The windows start at multiples of the window length since the epoch of
+/// the clock. A value buffer with a time in a later window closes the
+/// current window, windows without value buffers are not stored. The
+/// closed windows are kept in a ring allocated when the rollup is
+/// constructed, so updating never allocates and the memory use is fixed.
+/// The closed windows are indexed from 0, the oldest, to size() - 1, the
+/// newest. Several resolutions, e.g. 10 seconds, 1 minute and 1 hour, are
+/// kept by updating one rollup per resolution.
+///
+/// The statistics are stored in columns per value type, so an update is a
+/// branchless loop over homogeneous arrays which the compiler can
+/// vectorize. A statistic of a closed window is written as a value buffer
+/// with the layout and sync value of the input with write(), so it can be
+/// read with an abacus::view using the same meta data.
+///
+/// Like abacus::metrics the rollup is not thread-safe.
+class rollup
+{
+public:
+    /// The clock of the value buffer times
+    using clock = std::chrono::steady_clock;
+
+public:
+    /// Constructor
+    /// @param metadata The meta data of the value buffers
+    /// @param window The length of a window
+    /// @param capacity The maximum number of closed windows, at least one
+    rollup(const protobuf::MetricsMetadata& metadata, clock::duration window,
+           std::size_t capacity);
+
+    /// @return The size of the value buffers in bytes
+    auto value_bytes() const -> std::size_t;
+
+    /// @return The length of a window
+    auto window() const -> clock::duration;
+
+    /// @return The maximum number of closed windows
+    auto capacity() const -> std::size_t;
+
+    /// @return The number of closed windows
+    auto size() const -> std::size_t;
+
+    /// Adds a value buffer to the window of its time. A buffer with a time
+    /// before the current window is added to the current window.
+    /// @param value_data The value data, value_bytes() large
+    /// @param time The time of the value data
+    /// @return true if the value data has the sync value of the meta data and
+    ///         the endianness of the host, otherwise false and the value data
+    ///         is ignored
+    [[nodiscard]] auto update(const uint8_t* value_data,
+                              clock::time_point time = clock::now()) -> bool;
+
+    /// Closes the current window, if any value buffers were added to it
+    auto flush() -> void;
+
+    /// @return The start of a closed window
+    /// @param index The index of the window, 0 is the oldest
+    auto start(std::size_t index) const -> clock::time_point;
+
+    /// @return The number of value buffers added to a closed window
+    /// @param index The index of the window, 0 is the oldest
+    auto samples(std::size_t index) const -> uint32_t;
+
+    /// @return The number of value buffers of a closed window where a
+    ///         metric has a value
+    /// @param index The index of the window, 0 is the oldest
+    /// @param id The id of the metric, see abacus::view::id()
+    auto count(std::size_t index, std::size_t id) const -> uint32_t;
+
+    /// Writes a statistic of a closed window as a value buffer. Metrics
+    /// without a value in the window, constants and metrics the statistic
+    /// does not apply to are not set. Sums which do not fit the value type
+    /// of a metric saturate, and so does the average of a saturated sum.
+    /// @param index The index of the window, 0 is the oldest
+    /// @param statistic The statistic to write
+    /// @param data The output buffer, must be value_bytes() large
+    auto write(std::size_t index, abacus::statistic statistic,
+               uint8_t* data) const -> void;
+
+private:
+    /// The statistics of the metrics of one value type. The statistics of a
+    /// window are stored after each other, one slot of the ring at a time.
+    template <class T, class Sum>
+    struct columns
+    {
+        /// The smallest values
+        std::vector<T> min;
+
+        /// The largest values
+        std::vector<T> max;
+
+        /// The last values
+        std::vector<T> last;
+
+        /// The sums of the values
+        std::vector<Sum> sum;
+    };
+
+    /// The metrics of one value type
+    struct group
+    {
+        /// The value type of the metrics
+        protobuf::Metric::TypeCase type;
+
+        /// The value offsets of the metrics
+        std::vector<std::size_t> offsets;
+
+        /// The statistics of the metrics
+        std::variant<columns<uint64_t, uint64_t>, columns<int64_t, int64_t>,
+                     columns<uint32_t, uint64_t>, columns<int32_t, int64_t>,
+                     columns<double, double>, columns<float, double>,
+                     columns<uint8_t, uint64_t>>
+            statistics;
+
+        /// The number of value buffers with a value for each metric
+        std::vector<uint32_t> counts;
+    };
+
+    /// @return The slot of the ring of a window, the current window is at
+    ///         index size()
+    auto slot(std::size_t index) const -> std::size_t;
+
+    /// Resets the statistics of a slot
+    auto reset(std::size_t slot) -> void;
+
+private:
+    /// The sync value of the value buffers
+    uint32_t m_sync_value;
+
+    /// True if the value buffers have the endianness of the host
+    bool m_native;
+
+    /// The size of the value buffers in bytes
+    std::size_t m_value_bytes;
+
+    /// The length of a window
+    clock::duration m_window;
+
+    /// The maximum number of closed windows
+    std::size_t m_capacity;
+
+    /// The groups of metrics
+    std::vector<group> m_groups;
+
+    /// The group and position in the group of the metrics by id, constants
+    /// are in no group
+    std::vector<std::pair<std::size_t, std::size_t>> m_positions;
+
+    /// The start of the windows of the slots
+    std::vector<clock::time_point> m_starts;
+
+    /// The number of value buffers of the windows of the slots
+    std::vector<uint32_t> m_samples;
+
+    /// The slot of the oldest closed window
+    std::size_t m_first = 0;
+
+    /// The number of closed windows
+    std::size_t m_size = 0;
+};
+}
+}
@@ -0,0 +1,215 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "schema.hpp"
+
+#include "detail/hash_function.hpp"
+#include "detail/make_metric.hpp"
+#include "detail/serialize.hpp"
+#include "detail/string_table.hpp"
+
+#include "protocol_version.hpp"
+
+#include <endian/is_big_endian.hpp>
+#include <endian/little_endian.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+schema::schema(const std::map<name, abacus::info>& info,
+               metadata_encoding encoding)
+{
+    m_metadata = protobuf::MetricsMetadata();
+    m_metadata.set_protocol_version(protocol_version(encoding));
+    m_metadata.set_endianness(endian::is_big_endian()
+                                  ? protobuf::Endianness::BIG
+                                  : protobuf::Endianness::LITTLE);
+
+    // Set the sync value to 1 so that the field is reserved in the serialized
+    // metadata. The header fields are serialized before the metrics, so the
+    // sync value is always the last four bytes of the header.
+    m_metadata.set_sync_value(1);
+    const std::size_t sync_value_offset =
+        m_metadata.ByteSizeLong() - sizeof(uint32_t);
+
+    // The first byte is reserved for the sync value
+    m_value_bytes = sizeof(uint32_t);
+
+    m_names.reserve(info.size());
+    m_offsets.reserve(info.size());
+    std::vector<bool> constants;
+    constants.reserve(info.size());
+    auto* metrics_map = m_metadata.mutable_metrics();
+
+    // The info map is sorted by name, so the ids are assigned in
+    // lexicographical order
+    for (const auto& [name, metric_info] : info)
+    {
+        // Construct the metric in-place to avoid copying it into the map
+        auto [it, inserted] = metrics_map->try_emplace(name.value);
+        assert(inserted);
+        (void)inserted;
+        protobuf::Metric& metric = it->second;
+        m_names.emplace_back(it->first);
+
+        // Save the offset of the metric, constants will not use it
+        m_offsets.push_back(m_value_bytes);
+        constants.push_back(false);
+
+        std::size_t bytes =
+            detail::make_metric(metric_info, m_value_bytes, metric);
+
+        // Constants have no value and are always initialized
+        if (bytes == 0)
+        {
+            m_offsets.back() = 0;
+            constants.back() = true;
+        }
+        m_value_bytes += bytes;
+    }
+
+    // The string table only changes the serialized meta data, the header
+    // and so the position of the sync value stay the same
+    const protobuf::MetricsMetadata* serialized = &m_metadata;
+    protobuf::MetricsMetadata string_table;
+    if (encoding != metadata_encoding::inline_strings)
+    {
+        string_table = detail::make_string_table(m_metadata);
+        serialized = &string_table;
+    }
+
+    const std::size_t metadata_bytes = serialized->ByteSizeLong();
+    m_metadata_data.resize(metadata_bytes);
+
+    // Serialize the metadata, the sizes were cached by ByteSizeLong(). The
+    // serialization is deterministic, so schemas with the same info get the
+    // same sync value.
+    detail::serialize(*serialized, m_metadata_data.data(), metadata_bytes);
+
+    // Calculate the hash of the metadata
+    uint32_t hash =
+        detail::hash_function(m_metadata_data.data(), metadata_bytes);
+
+    // Update the sync value
+    m_metadata.set_sync_value(hash);
+
+    // Patch the reserved sync value in the serialized metadata instead of
+    // serializing it again. The fixed32 wire format is always little endian.
+    assert(m_metadata_data[sync_value_offset - 1] == 0x1d &&
+           "Unexpected sync tag");
+    assert(m_metadata_data[sync_value_offset] == 1 && "Unexpected sync value");
+    endian::little_endian::put(hash,
+                               m_metadata_data.data() + sync_value_offset);
+
+    // The lean meta data is the string table form without the string table,
+    // which becomes the dictionary. Both use the sync value of the string
+    // table form, so it also changes with the descriptive strings.
+    if (encoding == metadata_encoding::lean)
+    {
+        protobuf::MetricsMetadata dictionary;
+        dictionary.set_protocol_version(m_metadata.protocol_version());
+        dictionary.set_endianness(m_metadata.endianness());
+        dictionary.set_sync_value(hash);
+        dictionary.mutable_strings()->Swap(string_table.mutable_strings());
+        dictionary.mutable_references()->Swap(
+            string_table.mutable_references());
+        string_table.set_sync_value(hash);
+
+        m_metadata_data.resize(string_table.ByteSizeLong());
+        detail::serialize(string_table, m_metadata_data.data(),
+                          m_metadata_data.size());
+        m_dictionary_data.resize(dictionary.ByteSizeLong());
+        detail::serialize(dictionary, m_dictionary_data.data(),
+                          m_dictionary_data.size());
+    }
+
+    // Write the sync value to the first bytes of the value data (this
+    // will be written as the endianess of the system) Consuming code
+    // can use the endianness field in the metadata to read the sync
+    // value
+    m_initial_data.resize(m_value_bytes + m_names.size());
+    std::memcpy(m_initial_data.data(), &hash, sizeof(uint32_t));
+
+    // Constants have no value and are always initialized
+    for (std::size_t id = 0; id < constants.size(); ++id)
+    {
+        m_initial_data[m_value_bytes + id] = constants[id];
+    }
+}
+
+auto schema::count() const -> std::size_t
+{
+    return m_names.size();
+}
+
+auto schema::id(std::string_view name) const -> std::size_t
+{
+    auto it = std::lower_bound(m_names.begin(), m_names.end(), name);
+    if (it == m_names.end() || *it != name)
+    {
+        throw std::out_of_range("Unknown metric: " + std::string(name));
+    }
+    return static_cast<std::size_t>(it - m_names.begin());
+}
+
+auto schema::metric_name(std::size_t id) const -> std::string_view
+{
+    assert(id < m_names.size());
+    return m_names[id];
+}
+
+auto schema::offset(std::size_t id) const -> std::size_t
+{
+    assert(id < m_offsets.size());
+    return m_offsets[id];
+}
+
+auto schema::is_constant(std::size_t id) const -> bool
+{
+    assert(id < m_names.size());
+    return m_initial_data[m_value_bytes + id] != 0;
+}
+
+auto schema::sync_value() const -> uint32_t
+{
+    return m_metadata.sync_value();
+}
+
+auto schema::metadata() const -> const protobuf::MetricsMetadata&
+{
+    return m_metadata;
+}
+
+auto schema::metadata_data() const -> const uint8_t*
+{
+    return m_metadata_data.data();
+}
+
+auto schema::metadata_bytes() const -> std::size_t
+{
+    return m_metadata_data.size();
+}
+
+auto schema::dictionary_data() const -> const uint8_t*
+{
+    return m_dictionary_data.data();
+}
+
+auto schema::dictionary_bytes() const -> std::size_t
+{
+    return m_dictionary_data.size();
+}
+
+auto schema::value_bytes() const -> std::size_t
+{
+    return m_value_bytes;
+}
+}
+}
@@ -0,0 +1,135 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <map>
+#include <string_view>
+#include <vector>
+
+#include "info.hpp"
+#include "metadata_encoding.hpp"
+#include "name.hpp"
+#include "version.hpp"
+
+#include "protobuf/metrics.pb.h"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+class metrics;
+
+/// The immutable description of a set of metrics.
+///
+/// Building the meta data of the metrics, i.e. the protobuf message, its
+/// serialized form, the sync value and the value offsets, is done once
+/// when the schema is constructed. A schema is meant to be shared between
+/// many abacus::metrics through a std::shared_ptr<const schema>. Creating
+/// metrics from a shared schema only allocates their value data, and all
+/// the metrics share the serialized meta data of the schema.
+///
+/// The ids of the metrics are assigned in the lexicographical order of the
+/// metric names, like in abacus::metrics and abacus::view.
+///
+/// With metadata_encoding::string_table the serialized meta data stores the
+/// descriptions, units and enum values once in a shared string table.
+/// metadata() always holds the strings in the metrics, abacus::view and
+/// abacus::parse_metadata() resolve the string table when reading.
+///
+/// With metadata_encoding::lean the string table is left out of the
+/// serialized meta data and serialized as a separate dictionary instead.
+/// The sync value covers both, so a dictionary can be cached by sync value
+/// and added to an abacus::view with abacus::view::set_dictionary().
+class schema
+{
+public:
+    /// Constructor
+    /// @param info The info of the metrics
+    /// @param encoding How the strings are stored in the serialized meta data
+    schema(const std::map<name, abacus::info>& info,
+           metadata_encoding encoding = metadata_encoding::inline_strings);
+
+    /// @return The number of metrics
+    auto count() const -> std::size_t;
+
+    /// Look up the id of a metric. The lookup is a binary search.
+    /// @param name The name of the metric
+    /// @return The id of the metric
+    auto id(std::string_view name) const -> std::size_t;
+
+    /// @param id The id of the metric
+    /// @return The name of the metric
+    auto metric_name(std::size_t id) const -> std::string_view;
+
+    /// @param id The id of the metric
+    /// @return The offset of the value of the metric in the value data,
+    ///         constants have no value and return 0
+    auto offset(std::size_t id) const -> std::size_t;
+
+    /// @param id The id of the metric
+    /// @return true if the metric is a constant
+    auto is_constant(std::size_t id) const -> bool;
+
+    /// @return The sync value of the schema
+    auto sync_value() const -> uint32_t;
+
+    /// @return The meta data of the schema
+    auto metadata() const -> const protobuf::MetricsMetadata&;
+
+    /// @return The pointer to the serialized meta data
+    auto metadata_data() const -> const uint8_t*;
+
+    /// @return The size of the serialized meta data in bytes
+    auto metadata_bytes() const -> std::size_t;
+
+    /// @return The pointer to the serialized dictionary of lean meta data
+    auto dictionary_data() const -> const uint8_t*;
+
+    /// @return The size of the serialized dictionary in bytes, 0 unless the
+    ///         meta data is lean
+    auto dictionary_bytes() const -> std::size_t;
+
+    /// @return The size of the value data of metrics using this schema
+    auto value_bytes() const -> std::size_t;
+
+private:
+    /// No copy
+    schema(const schema&) = delete;
+
+    /// No copy assignment
+    schema& operator=(const schema&) = delete;
+
+    /// The metrics copy their initial state from the schema
+    friend class metrics;
+
+private:
+    /// The meta data of the metrics
+    protobuf::MetricsMetadata m_metadata;
+
+    /// The serialized meta data
+    std::vector<uint8_t> m_metadata_data;
+
+    /// The serialized dictionary, only used for lean meta data
+    std::vector<uint8_t> m_dictionary_data;
+
+    /// The size of the value data in bytes
+    std::size_t m_value_bytes;
+
+    /// The metric names sorted, the position of a name is the id of the
+    /// metric. The names point into the keys of m_metadata.
+    std::vector<std::string_view> m_names;
+
+    /// The value offsets of the metrics indexed by id, constants have no
+    /// value and use the offset 0
+    std::vector<std::size_t> m_offsets;
+
+    /// The initial state of metrics using this schema. The value data with
+    /// the sync value and no values set, followed by an initialized flag per
+    /// metric. Constants are always initialized.
+    std::vector<uint8_t> m_initial_data;
+};
+}
+}
@@ -0,0 +1,201 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "selection.hpp"
+
+#include "detail/hash_function.hpp"
+#include "detail/serialize.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <endian/big_endian.hpp>
+#include <endian/little_endian.hpp>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace
+{
+// Moves the metric to a new offset and returns the size of its value slot
+// including the byte marking whether the value is set
+static inline std::size_t rebase(protobuf::Metric& m, uint32_t offset)
+{
+    switch (m.type_case())
+    {
+    case protobuf::Metric::kUint64:
+        m.mutable_uint64()->set_offset(offset);
+        return 1 + sizeof(uint64_t);
+    case protobuf::Metric::kInt64:
+        m.mutable_int64()->set_offset(offset);
+        return 1 + sizeof(int64_t);
+    case protobuf::Metric::kUint32:
+        m.mutable_uint32()->set_offset(offset);
+        return 1 + sizeof(uint32_t);
+    case protobuf::Metric::kInt32:
+        m.mutable_int32()->set_offset(offset);
+        return 1 + sizeof(int32_t);
+    case protobuf::Metric::kFloat64:
+        m.mutable_float64()->set_offset(offset);
+        return 1 + sizeof(double);
+    case protobuf::Metric::kFloat32:
+        m.mutable_float32()->set_offset(offset);
+        return 1 + sizeof(float);
+    case protobuf::Metric::kBoolean:
+        m.mutable_boolean()->set_offset(offset);
+        return 1 + sizeof(bool);
+    case protobuf::Metric::kEnum8:
+        m.mutable_enum8()->set_offset(offset);
+        return 1 + sizeof(uint8_t);
+    default:
+        // Constants have no value
+        return 0;
+    }
+}
+
+static inline std::size_t get_offset(const protobuf::Metric& m)
+{
+    switch (m.type_case())
+    {
+    case protobuf::Metric::kUint64:
+        return m.uint64().offset();
+    case protobuf::Metric::kInt64:
+        return m.int64().offset();
+    case protobuf::Metric::kUint32:
+        return m.uint32().offset();
+    case protobuf::Metric::kInt32:
+        return m.int32().offset();
+    case protobuf::Metric::kFloat64:
+        return m.float64().offset();
+    case protobuf::Metric::kFloat32:
+        return m.float32().offset();
+    case protobuf::Metric::kBoolean:
+        return m.boolean().offset();
+    case protobuf::Metric::kEnum8:
+        return m.enum8().offset();
+    default:
+        return 0;
+    }
+}
+}
+
+selection::selection(const view& view, std::vector<std::size_t> ids) :
+    m_ids(std::move(ids)), m_source_sync_value(view.metadata().sync_value())
+{
+    assert(std::is_sorted(m_ids.begin(), m_ids.end()));
+
+    m_metadata.set_protocol_version(view.metadata().protocol_version());
+    m_metadata.set_endianness(view.metadata().endianness());
+
+    // The first bytes are reserved for the sync value
+    m_value_bytes = sizeof(uint32_t);
+
+    auto* metrics_map = m_metadata.mutable_metrics();
+    for (auto id : m_ids)
+    {
+        assert(id < view.count());
+        const auto& source = view.metric(id);
+        auto& metric = (*metrics_map)[std::string(view.metric_name(id))];
+        metric = source;
+
+        auto bytes = rebase(metric, m_value_bytes);
+        if (bytes == 0)
+        {
+            continue;
+        }
+
+        auto offset = get_offset(source);
+        if (!m_ranges.empty() &&
+            m_ranges.back().source + m_ranges.back().bytes == offset)
+        {
+            // The slot follows the previous one in the full buffer as well,
+            // so both are copied at once
+            m_ranges.back().bytes += bytes;
+        }
+        else
+        {
+            m_ranges.push_back({offset, m_value_bytes, bytes});
+        }
+        m_value_bytes += bytes;
+    }
+
+    // The sync value identifies the packed schema, so it is derived from
+    // the serialized meta data like for abacus::metrics
+    auto bytes = m_metadata.ByteSizeLong();
+    std::vector<uint8_t> data(bytes);
+    detail::serialize(m_metadata, data.data(), bytes);
+    m_metadata.set_sync_value(detail::hash_function(data.data(), bytes));
+}
+
+auto selection::count() const -> std::size_t
+{
+    return m_ids.size();
+}
+
+auto selection::ids() const -> const std::vector<std::size_t>&
+{
+    return m_ids;
+}
+
+auto selection::source_sync_value() const -> uint32_t
+{
+    return m_source_sync_value;
+}
+
+auto selection::metadata() const -> const protobuf::MetricsMetadata&
+{
+    return m_metadata;
+}
+
+auto selection::value_bytes() const -> std::size_t
+{
+    return m_value_bytes;
+}
+
+auto selection::pack(const uint8_t* value_data, std::size_t value_bytes,
+                     uint8_t* data) const -> bool
+{
+    assert(value_data != nullptr);
+    assert(data != nullptr);
+    assert(value_bytes >= sizeof(uint32_t));
+    (void)value_bytes;
+
+    // The sync values are written in the endianness of the meta data
+    bool big_endian = m_metadata.endianness() == protobuf::Endianness::BIG;
+    uint32_t sync_value = 0;
+    if (big_endian)
+    {
+        endian::big_endian::get(sync_value, value_data);
+    }
+    else
+    {
+        endian::little_endian::get(sync_value, value_data);
+    }
+    if (sync_value != m_source_sync_value)
+    {
+        return false;
+    }
+
+    if (big_endian)
+    {
+        endian::big_endian::put(m_metadata.sync_value(), data);
+    }
+    else
+    {
+        endian::little_endian::put(m_metadata.sync_value(), data);
+    }
+
+    for (const auto& range : m_ranges)
+    {
+        assert(range.source + range.bytes <= value_bytes);
+        std::memcpy(data + range.target, value_data + range.source,
+                    range.bytes);
+    }
+    return true;
+}
+}
+}
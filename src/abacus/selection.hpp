@@ -0,0 +1,96 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "protobuf/metrics.pb.h"
+#include "version.hpp"
+#include "view.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// A subset of the metrics of a schema, compiled once against the meta data
+/// of a view. See abacus::selector for selecting metrics by name, kind or
+/// unit.
+///
+/// The selection describes a packed value buffer which only contains the
+/// selected metrics. The meta data of the packed buffer is available from
+/// metadata() and has its own sync value, so the packed buffer can be read
+/// with a regular abacus::view. Use pack() to copy the selected values from
+/// a full value buffer into a packed buffer.
+class selection
+{
+public:
+    /// Default constructor
+    /// No metrics will be contained within this object.
+    selection() = default;
+
+    /// Constructor
+    /// @param view The view with the meta data of the full schema
+    /// @param ids The ids of the selected metrics in ascending order
+    selection(const view& view, std::vector<std::size_t> ids);
+
+    /// @return The number of selected metrics
+    auto count() const -> std::size_t;
+
+    /// @return The ids of the selected metrics in the full schema
+    auto ids() const -> const std::vector<std::size_t>&;
+
+    /// @return The sync value of the full schema the selection was compiled
+    ///         against
+    auto source_sync_value() const -> uint32_t;
+
+    /// @return The meta data of the packed value buffer
+    auto metadata() const -> const protobuf::MetricsMetadata&;
+
+    /// @return The size of the packed value buffer in bytes
+    auto value_bytes() const -> std::size_t;
+
+    /// Copies the selected values from a full value buffer to a packed
+    /// buffer. Only the selected slots of the full buffer are read.
+    /// @param value_data The value data of the full schema
+    /// @param value_bytes The size of the value data in bytes
+    /// @param data The packed buffer, must be value_bytes() large
+    /// @return true if the sync value of the value data matches the schema
+    ///         of the selection otherwise false
+    [[nodiscard]] auto pack(const uint8_t* value_data,
+                            std::size_t value_bytes, uint8_t* data) const
+        -> bool;
+
+private:
+    /// A contiguous range of bytes copied by pack()
+    struct copy_range
+    {
+        /// The offset in the full value buffer
+        std::size_t source;
+        /// The offset in the packed value buffer
+        std::size_t target;
+        /// The number of bytes to copy
+        std::size_t bytes;
+    };
+
+private:
+    /// The ids of the selected metrics
+    std::vector<std::size_t> m_ids;
+
+    /// The sync value of the full schema
+    uint32_t m_source_sync_value = 0;
+
+    /// The meta data of the packed buffer
+    protobuf::MetricsMetadata m_metadata;
+
+    /// The size of the packed value buffer in bytes
+    std::size_t m_value_bytes = 0;
+
+    /// The ranges copied by pack(), neighbouring slots are merged
+    std::vector<copy_range> m_ranges;
+};
+}
+}
@@ -0,0 +1,186 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "selector.hpp"
+
+#include <algorithm>
+#include <optional>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+namespace
+{
+static inline std::optional<abacus::kind> get_kind(const protobuf::Metric& m)
+{
+    switch (m.type_case())
+    {
+    case protobuf::Metric::kUint64:
+        return static_cast<abacus::kind>(m.uint64().kind());
+    case protobuf::Metric::kInt64:
+        return static_cast<abacus::kind>(m.int64().kind());
+    case protobuf::Metric::kUint32:
+        return static_cast<abacus::kind>(m.uint32().kind());
+    case protobuf::Metric::kInt32:
+        return static_cast<abacus::kind>(m.int32().kind());
+    case protobuf::Metric::kFloat64:
+        return static_cast<abacus::kind>(m.float64().kind());
+    case protobuf::Metric::kFloat32:
+        return static_cast<abacus::kind>(m.float32().kind());
+    default:
+        return std::nullopt;
+    }
+}
+
+static inline std::optional<std::string_view>
+get_unit(const protobuf::Metric& m)
+{
+    switch (m.type_case())
+    {
+    case protobuf::Metric::kUint64:
+        if (m.uint64().has_unit())
+            return m.uint64().unit();
+        break;
+    case protobuf::Metric::kInt64:
+        if (m.int64().has_unit())
+            return m.int64().unit();
+        break;
+    case protobuf::Metric::kUint32:
+        if (m.uint32().has_unit())
+            return m.uint32().unit();
+        break;
+    case protobuf::Metric::kInt32:
+        if (m.int32().has_unit())
+            return m.int32().unit();
+        break;
+    case protobuf::Metric::kFloat64:
+        if (m.float64().has_unit())
+            return m.float64().unit();
+        break;
+    case protobuf::Metric::kFloat32:
+        if (m.float32().has_unit())
+            return m.float32().unit();
+        break;
+    case protobuf::Metric::kBoolean:
+        if (m.boolean().has_unit())
+            return m.boolean().unit();
+        break;
+    case protobuf::Metric::kEnum8:
+        if (m.enum8().has_unit())
+            return m.enum8().unit();
+        break;
+    case protobuf::Metric::kConstant:
+        if (m.constant().has_unit())
+            return m.constant().unit();
+        break;
+    default:
+        break;
+    }
+    return std::nullopt;
+}
+}
+
+auto selector::add_name(std::string_view name) -> selector&
+{
+    m_names.emplace_back(name);
+    return *this;
+}
+
+auto selector::add_prefix(std::string_view prefix) -> selector&
+{
+    m_prefixes.emplace_back(prefix);
+    return *this;
+}
+
+auto selector::add_glob(std::string_view pattern) -> selector&
+{
+    m_globs.emplace_back(pattern);
+    return *this;
+}
+
+auto selector::add_kind(abacus::kind kind) -> selector&
+{
+    m_kinds.push_back(kind);
+    return *this;
+}
+
+auto selector::add_unit(std::string_view unit) -> selector&
+{
+    m_units.emplace_back(unit);
+    return *this;
+}
+
+auto selector::compile(const view& view) const -> selection
+{
+    std::vector<std::size_t> ids;
+    if (m_names.empty() && m_prefixes.empty() && m_globs.empty())
+    {
+        ids.resize(view.count());
+        for (std::size_t id = 0; id < ids.size(); ++id)
+        {
+            ids[id] = id;
+        }
+    }
+    else
+    {
+        // Use the name index of the view, so only the matching metrics are
+        // visited
+        for (const auto& name : m_names)
+        {
+            auto [first, last] = view.prefix_range(name);
+            if (first != last && view.metric_name(first) == name)
+            {
+                ids.push_back(first);
+            }
+        }
+        for (const auto& prefix : m_prefixes)
+        {
+            auto [first, last] = view.prefix_range(prefix);
+            for (std::size_t id = first; id < last; ++id)
+            {
+                ids.push_back(id);
+            }
+        }
+        for (const auto& pattern : m_globs)
+        {
+            auto matches = view.match(pattern);
+            ids.insert(ids.end(), matches.begin(), matches.end());
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+
+    auto excluded = [&](std::size_t id)
+    {
+        const auto& metric = view.metric(id);
+        if (!m_kinds.empty())
+        {
+            auto kind = get_kind(metric);
+            if (!kind.has_value() ||
+                std::find(m_kinds.begin(), m_kinds.end(), *kind) ==
+                    m_kinds.end())
+            {
+                return true;
+            }
+        }
+        if (!m_units.empty())
+        {
+            auto unit = get_unit(metric);
+            if (!unit.has_value() ||
+                std::find(m_units.begin(), m_units.end(), *unit) ==
+                    m_units.end())
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+    ids.erase(std::remove_if(ids.begin(), ids.end(), excluded), ids.end());
+
+    return selection(view, std::move(ids));
+}
+}
+}
@@ -0,0 +1,83 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "kind.hpp"
+#include "selection.hpp"
+#include "version.hpp"
+#include "view.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// Describes which metrics to select from a schema, e.g. for exporting a
+/// subset of the metrics.
+///
+/// A metric is selected if its name matches any of the added names,
+/// prefixes or glob patterns, and its kind and unit are among the added
+/// kinds and units. Criteria which have not been added match all metrics,
+/// so an empty selector selects everything. Metrics without a kind, i.e.
+/// booleans, enums and constants, never match a kind criteria.
+///
+/// The selector is compiled once against the meta data of a view into an
+/// abacus::selection, which can then be reused for every export.
+class selector
+{
+public:
+    /// Selects a metric by its full name
+    /// @param name The name of the metric
+    /// @return The selector
+    auto add_name(std::string_view name) -> selector&;
+
+    /// Selects all metrics with names starting with a prefix
+    /// @param prefix The name prefix
+    /// @return The selector
+    auto add_prefix(std::string_view prefix) -> selector&;
+
+    /// Selects all metrics with names matching a glob pattern, see
+    /// abacus::view::match()
+    /// @param pattern The glob pattern
+    /// @return The selector
+    auto add_glob(std::string_view pattern) -> selector&;
+
+    /// Restricts the selection to metrics of a kind
+    /// @param kind The kind
+    /// @return The selector
+    auto add_kind(abacus::kind kind) -> selector&;
+
+    /// Restricts the selection to metrics with a unit
+    /// @param unit The unit
+    /// @return The selector
+    auto add_unit(std::string_view unit) -> selector&;
+
+    /// Compiles the selector against the meta data of a view
+    /// @param view The view with the meta data
+    /// @return The selection of the matching metrics
+    auto compile(const view& view) const -> selection;
+
+private:
+    /// The selected names
+    std::vector<std::string> m_names;
+
+    /// The selected name prefixes
+    std::vector<std::string> m_prefixes;
+
+    /// The selected glob patterns
+    std::vector<std::string> m_globs;
+
+    /// The selected kinds
+    std::vector<abacus::kind> m_kinds;
+
+    /// The selected units
+    std::vector<std::string> m_units;
+};
+}
+}
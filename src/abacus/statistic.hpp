@@ -0,0 +1,31 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// The statistics of a metric over a window of abacus::rollup. Only the
+/// value buffers where the metric has a value are included.
+enum class statistic
+{
+    /// The smallest value, for booleans whether all values were true
+    min,
+    /// The largest value, for booleans whether any value was true
+    max,
+    /// The sum of the values, only for numbers
+    sum,
+    /// The average value, only for numbers. Integer metrics use integer
+    /// division.
+    avg,
+    /// The value of the last value buffer
+    last
+};
+}
+}
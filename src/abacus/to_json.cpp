@@ -6,7 +6,6 @@
 #include <bourne/json.hpp>
 
 #include "detail/to_json.hpp"
-#include "parse_metadata.hpp"
 #include "protobuf/metrics.pb.h"
 #include "to_json.hpp"
 
@@ -20,13 +19,7 @@ auto to_json(const uint8_t* metadata_data, std::size_t metadata_bytes,
              bool minimal) -> std::string
 {
     view v;
-    auto parsed = parse_metadata(metadata_data, metadata_bytes);
-    if (!parsed.has_value())
-    {
-        return "";
-    }
-
-    if (v.set_metadata(parsed.value()))
+    if (v.set_metadata(metadata_data, metadata_bytes))
     {
         if (v.set_value_data(value_data, value_bytes))
         {
@@ -57,5 +50,16 @@ auto to_json(const view& view, bool minimal) -> std::string
     return json.dump();
 }
 
+auto to_json(const view& view, const selection& selection, bool minimal)
+    -> std::string
+{
+    if (view.metadata().sync_value() != selection.source_sync_value())
+    {
+        return "";
+    }
+    bourne::json json = detail::to_json(view, selection, minimal);
+    return json.dump();
+}
+
 }
 }
@@ -7,6 +7,7 @@
 
 #include <vector>
 
+#include "selection.hpp"
 #include "version.hpp"
 #include "view.hpp"
 
@@ -40,5 +41,17 @@ auto to_json(const protobuf::MetricsMetadata& metadata,
 /// @param minimal If true, the JSON will be slimmed down to only contain the
 ///        the value data.
 auto to_json(const view& view, bool minimal = false) -> std::string;
+
+/// @return a JSON-formatted string of the selected metrics of a views data.
+///         Only the selected values are read. The meta data is that of the
+///         packed selection, see abacus::selection::metadata(). If the
+///         selection was compiled against another schema an empty string is
+///         returned.
+/// @param view A view with access to metrics-data.
+/// @param selection The selected metrics
+/// @param minimal If true, the JSON will be slimmed down to only contain the
+///        the value data.
+auto to_json(const view& view, const selection& selection,
+             bool minimal = false) -> std::string;
 }
 }
@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include <optional>
+
+#include "aggregation.hpp"
 #include "description.hpp"
 #include "kind.hpp"
 #include "max.hpp"
@@ -35,6 +38,10 @@ struct uint32
 
     /// The maximum value of the metric
     abacus::max<type> max{};
+
+    /// The aggregation of the metric, one of sum, min, max or avg. If not
+    /// set counters are summed and gauges use the aggregator default.
+    std::optional<abacus::aggregation> aggregation{};
 };
 }
 }
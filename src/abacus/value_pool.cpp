@@ -0,0 +1,81 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "value_pool.hpp"
+
+#include <cassert>
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+value_pool::value_pool(std::shared_ptr<const abacus::schema> schema,
+                       std::size_t chunk_blocks) :
+    m_schema(std::move(schema)), m_chunk_blocks(chunk_blocks)
+{
+    assert(m_schema);
+    assert(m_chunk_blocks > 0);
+    m_block_bytes = m_schema->value_bytes() + m_schema->count();
+}
+
+value_pool::~value_pool()
+{
+    assert(size() == 0 && "The pool must outlive its metrics");
+}
+
+auto value_pool::schema() const -> const std::shared_ptr<const abacus::schema>&
+{
+    return m_schema;
+}
+
+auto value_pool::block_bytes() const -> std::size_t
+{
+    return m_block_bytes;
+}
+
+auto value_pool::size() const -> std::size_t
+{
+    return capacity() - m_free.size();
+}
+
+auto value_pool::capacity() const -> std::size_t
+{
+    return m_chunks.size() * m_chunk_blocks;
+}
+
+auto value_pool::allocate() -> uint8_t*
+{
+    if (m_free.empty())
+    {
+        m_chunks.emplace_back(new uint8_t[m_block_bytes * m_chunk_blocks]);
+        uint8_t* chunk = m_chunks.back().get();
+
+        // Push the blocks in reverse, so they are handed out in order
+        m_free.reserve(capacity());
+        for (std::size_t i = m_chunk_blocks; i > 0; --i)
+        {
+            m_free.push_back(chunk + (i - 1) * m_block_bytes);
+        }
+    }
+    uint8_t* block = m_free.back();
+    m_free.pop_back();
+    return block;
+}
+
+auto value_pool::deallocate(uint8_t* block) -> void
+{
+    assert(block != nullptr);
+    assert(size() > 0);
+    m_free.push_back(block);
+}
+
+auto value_pool::clear() -> void
+{
+    assert(size() == 0 && "Blocks are still in use");
+    m_free = std::vector<uint8_t*>();
+    m_chunks = std::vector<std::unique_ptr<uint8_t[]>>();
+}
+}
+}
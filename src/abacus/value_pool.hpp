@@ -0,0 +1,89 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "schema.hpp"
+#include "version.hpp"
+
+namespace abacus
+{
+inline namespace STEINWURF_ABACUS_VERSION
+{
+/// A pool of fixed-size value blocks for the metrics of one schema.
+///
+/// The blocks are allocated in chunks and recycled when the metrics using
+/// them are destroyed, so creating and destroying many short-lived
+/// abacus::metrics, e.g. one per connection, does not go through the global
+/// allocator. The memory is only returned when the pool is cleared or
+/// destroyed.
+///
+/// The pool must outlive all metrics created from it. Like abacus::metrics
+/// the pool is not thread-safe.
+class value_pool
+{
+public:
+    /// Constructor
+    /// @param schema The schema of the metrics using the pool
+    /// @param chunk_blocks The number of blocks allocated at a time
+    value_pool(std::shared_ptr<const abacus::schema> schema,
+               std::size_t chunk_blocks = 64);
+
+    /// Destructor
+    ~value_pool();
+
+    /// @return The schema of the metrics using the pool
+    auto schema() const -> const std::shared_ptr<const abacus::schema>&;
+
+    /// @return The size of a block in bytes. A block holds the value data of
+    ///         a metrics followed by an initialized flag per metric.
+    auto block_bytes() const -> std::size_t;
+
+    /// @return The number of blocks in use
+    auto size() const -> std::size_t;
+
+    /// @return The number of blocks allocated by the pool
+    auto capacity() const -> std::size_t;
+
+    /// Allocates a block, the content of the block is unspecified
+    /// @return The block
+    auto allocate() -> uint8_t*;
+
+    /// Returns a block to the pool
+    /// @param block A block allocated from this pool
+    auto deallocate(uint8_t* block) -> void;
+
+    /// Releases all memory of the pool. No blocks may be in use.
+    auto clear() -> void;
+
+private:
+    /// No copy
+    value_pool(const value_pool&) = delete;
+
+    /// No copy assignment
+    value_pool& operator=(const value_pool&) = delete;
+
+private:
+    /// The schema of the metrics using the pool
+    std::shared_ptr<const abacus::schema> m_schema;
+
+    /// The size of a block in bytes
+    std::size_t m_block_bytes;
+
+    /// The number of blocks allocated at a time
+    std::size_t m_chunk_blocks;
+
+    /// The allocated chunks
+    std::vector<std::unique_ptr<uint8_t[]>> m_chunks;
+
+    /// The blocks not in use
+    std::vector<uint8_t*> m_free;
+};
+}
+}
@@ -7,7 +7,9 @@
 
 #include "boolean.hpp"
 #include "constant.hpp"
+#include "detail/glob_match.hpp"
 #include "detail/is_constant.hpp"
+#include "detail/string_table.hpp"
 #include "enum8.hpp"
 #include "float32.hpp"
 #include "float64.hpp"
@@ -17,8 +19,12 @@
 #include "uint32.hpp"
 #include "uint64.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <map>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include <endian/big_endian.hpp>
@@ -67,28 +73,221 @@ static inline std::size_t get_offset(const protobuf::Metric& m)
 }
 }
 
+view::view(const view& other) :
+    m_value_data(other.m_value_data), m_value_bytes(other.m_value_bytes)
+{
+    if (other.m_metadata != nullptr)
+    {
+        reset_metadata(other.m_metadata->metrics_size())
+            ->CopyFrom(*other.m_metadata);
+    }
+    // The index points into the meta data, so it must be rebuilt for the copy
+    build_index();
+}
+
+view::view(view&& other) noexcept :
+    m_arena(std::move(other.m_arena)),
+    m_metadata(std::exchange(other.m_metadata, nullptr)),
+    m_names(std::move(other.m_names)), m_metrics(std::move(other.m_metrics)),
+    m_offsets(std::move(other.m_offsets)), m_native(other.m_native),
+    m_value_data(std::exchange(other.m_value_data, nullptr)),
+    m_value_bytes(std::exchange(other.m_value_bytes, 0))
+{
+}
+
+view::~view() = default;
+
+auto view::operator=(const view& other) -> view&
+{
+    if (this != &other)
+    {
+        view copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+auto view::operator=(view&& other) noexcept -> view&
+{
+    if (this != &other)
+    {
+        m_arena = std::move(other.m_arena);
+        m_metadata = std::exchange(other.m_metadata, nullptr);
+        m_names = std::move(other.m_names);
+        m_metrics = std::move(other.m_metrics);
+        m_offsets = std::move(other.m_offsets);
+        m_native = other.m_native;
+        m_value_data = std::exchange(other.m_value_data, nullptr);
+        m_value_bytes = std::exchange(other.m_value_bytes, 0);
+    }
+    return *this;
+}
+
 [[nodiscard]] auto
 view::set_metadata(const protobuf::MetricsMetadata& metadata) -> bool
 {
     assert(metadata.IsInitialized());
-    m_metadata = metadata;
-    if (m_metadata.protocol_version() != protocol_version())
+    if (!is_supported_protocol_version(metadata.protocol_version()))
     {
-        m_metadata.Clear();
+        clear_metadata();
         return false;
     }
+    auto* copy = reset_metadata(metadata.metrics_size());
+    copy->CopyFrom(metadata);
+    if (!detail::resolve_string_table(*copy))
+    {
+        clear_metadata();
+        return false;
+    }
+    build_index();
     return true;
 }
 
+[[nodiscard]] auto view::set_metadata(const uint8_t* metadata_data,
+                                      std::size_t metadata_bytes) -> bool
+{
+    assert(metadata_data != nullptr);
+    assert(metadata_bytes > 0);
+
+    // Roughly one metric per 64 bytes of serialized meta data
+    auto* metadata = reset_metadata(metadata_bytes / 64);
+    if (!metadata->ParseFromArray(metadata_data,
+                                  static_cast<int>(metadata_bytes)) ||
+        !is_supported_protocol_version(metadata->protocol_version()) ||
+        !detail::resolve_string_table(*metadata))
+    {
+        clear_metadata();
+        return false;
+    }
+    build_index();
+    return true;
+}
+
+[[nodiscard]] auto view::set_dictionary(const uint8_t* dictionary_data,
+                                        std::size_t dictionary_bytes) -> bool
+{
+    assert(dictionary_data != nullptr);
+    protobuf::MetricsMetadata dictionary;
+    if (m_metadata == nullptr ||
+        !dictionary.ParseFromArray(dictionary_data,
+                                   static_cast<int>(dictionary_bytes)) ||
+        dictionary.metrics_size() != 0 ||
+        dictionary.protocol_version() != m_metadata->protocol_version() ||
+        dictionary.sync_value() != m_metadata->sync_value())
+    {
+        return false;
+    }
+
+    // The references of the dictionary follow the metrics of the meta data,
+    // the metrics are only changed if all references are valid
+    m_metadata->mutable_strings()->Swap(dictionary.mutable_strings());
+    m_metadata->mutable_references()->Swap(dictionary.mutable_references());
+    if (!detail::resolve_string_table(*m_metadata))
+    {
+        m_metadata->clear_strings();
+        m_metadata->clear_references();
+        return false;
+    }
+    return true;
+}
+
+auto view::apply_update(const protobuf::MetricsMetadata& update) -> bool
+{
+    if (update.base_sync_value() == 0 ||
+        update.base_sync_value() != metadata().sync_value() ||
+        update.protocol_version() != metadata().protocol_version() ||
+        update.endianness() != metadata().endianness())
+    {
+        return false;
+    }
+
+    auto* metrics = m_metadata->mutable_metrics();
+    for (const auto& [name, metric] : update.metrics())
+    {
+        (*metrics)[name] = metric;
+    }
+    m_metadata->set_sync_value(update.sync_value());
+
+    // The old value data does not match the new sync value
+    m_value_data = nullptr;
+    m_value_bytes = 0;
+    build_index();
+    return true;
+}
+
+auto view::reset_metadata(std::size_t metrics) -> protobuf::MetricsMetadata*
+{
+    // The meta data is allocated in one arena, so the strings and map nodes
+    // of the metrics do not need separate allocations and are freed
+    // together. The first block is sized for the expected number of
+    // metrics, so even a large schema only needs a few blocks.
+    google::protobuf::ArenaOptions options;
+    options.start_block_size =
+        std::clamp<std::size_t>(metrics * 256, 1024, 64 << 20);
+    options.max_block_size =
+        std::max<std::size_t>(options.start_block_size, 1 << 20);
+
+    m_names.clear();
+    m_metrics.clear();
+    m_offsets.clear();
+    m_metadata = nullptr;
+    m_arena = std::make_unique<google::protobuf::Arena>(options);
+    m_metadata =
+        google::protobuf::Arena::Create<protobuf::MetricsMetadata>(
+            m_arena.get());
+    return m_metadata;
+}
+
+auto view::clear_metadata() -> void
+{
+    m_metadata = nullptr;
+    m_arena.reset();
+    build_index();
+}
+
+auto view::build_index() -> void
+{
+    const auto& metrics = metadata().metrics();
+
+    auto host = endian::is_big_endian() ? protobuf::Endianness::BIG
+                                        : protobuf::Endianness::LITTLE;
+    m_native = metadata().endianness() == host;
+
+    // The protobuf map is unordered, so sort the entries by name to assign
+    // the ids
+    std::vector<std::pair<std::string_view, const protobuf::Metric*>> entries;
+    entries.reserve(metrics.size());
+    for (const auto& [name, metric] : metrics)
+    {
+        entries.emplace_back(name, &metric);
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const auto& lhs, const auto& rhs)
+              { return lhs.first < rhs.first; });
+
+    m_names.clear();
+    m_names.reserve(entries.size());
+    m_metrics.clear();
+    m_metrics.reserve(entries.size());
+    m_offsets.clear();
+    m_offsets.reserve(entries.size());
+    for (const auto& [name, metric] : entries)
+    {
+        m_names.push_back(name);
+        m_metrics.push_back(metric);
+        m_offsets.push_back(metric->has_constant() ? 0 : get_offset(*metric));
+    }
+}
+
 [[nodiscard]] auto view::set_value_data(const uint8_t* value_data,
                                         std::size_t value_bytes) -> bool
 {
-    assert(m_metadata.IsInitialized());
+    assert(metadata().IsInitialized());
     assert(value_data != nullptr);
 
     // Check that the hash is correct
     uint32_t value_data_hash = 0;
-    switch (m_metadata.endianness())
+    switch (metadata().endianness())
     {
     case protobuf::Endianness::BIG:
         endian::big_endian::get(value_data_hash, value_data);
@@ -100,7 +299,7 @@ view::set_metadata(const protobuf::MetricsMetadata& metadata) -> bool
         assert(false);
     }
 
-    if (m_metadata.sync_value() != value_data_hash)
+    if (metadata().sync_value() != value_data_hash)
     {
         return false;
     }
@@ -121,28 +320,83 @@ std::size_t view::value_bytes() const
 
 auto view::metadata() const -> const protobuf::MetricsMetadata&
 {
-    return m_metadata;
+    return m_metadata != nullptr
+               ? *m_metadata
+               : protobuf::MetricsMetadata::default_instance();
+}
+
+auto view::count() const -> std::size_t
+{
+    return m_names.size();
+}
+
+auto view::id(std::string_view name) const -> std::size_t
+{
+    auto it = std::lower_bound(m_names.begin(), m_names.end(), name);
+    if (it == m_names.end() || *it != name)
+    {
+        throw std::out_of_range("Unknown metric: " + std::string(name));
+    }
+    return static_cast<std::size_t>(it - m_names.begin());
+}
+
+auto view::metric_name(std::size_t id) const -> std::string_view
+{
+    assert(id < m_names.size());
+    return m_names[id];
+}
+
+auto view::prefix_range(std::string_view prefix) const
+    -> std::pair<std::size_t, std::size_t>
+{
+    // All names starting with the prefix sort at or after the prefix itself
+    // and before any name not starting with it
+    auto first = std::lower_bound(m_names.begin(), m_names.end(), prefix);
+    auto last = std::partition_point(
+        first, m_names.end(), [prefix](std::string_view name)
+        { return name.substr(0, prefix.size()) == prefix; });
+    return {static_cast<std::size_t>(first - m_names.begin()),
+            static_cast<std::size_t>(last - m_names.begin())};
 }
 
-const protobuf::Metric& view::metric(const std::string& name) const
+auto view::match(std::string_view pattern) const -> std::vector<std::size_t>
 {
-    assert(m_metadata.metrics().count(name) != 0);
-    return m_metadata.metrics().at(name);
+    auto [first, last] = prefix_range(detail::glob_prefix(pattern));
+    std::vector<std::size_t> ids;
+    for (std::size_t id = first; id < last; ++id)
+    {
+        if (detail::glob_match(pattern, m_names[id]))
+        {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
+const protobuf::Metric& view::metric(std::size_t id) const
+{
+    assert(id < m_metrics.size());
+    return *m_metrics[id];
+}
+
+const protobuf::Metric& view::metric(std::string_view name) const
+{
+    return metric(id(name));
 }
 
 template <class Metric>
-auto view::value(const std::string& name) const
+auto view::value(std::size_t id) const
     -> std::conditional_t<detail::is_constant_v<Metric>, typename Metric::type,
                           std::optional<typename Metric::type>>
 {
-    assert(m_metadata.IsInitialized());
+    assert(metadata().IsInitialized());
     assert(m_value_data != nullptr);
-    auto m = metric(name);
+    const auto& m = metric(id);
     if constexpr (detail::is_constant_v<Metric>)
     {
         // Check that Metric is constant
         assert(m.has_constant());
-        auto constant = m.constant();
+        const auto& constant = m.constant();
         if constexpr (std::is_same_v<Metric, constant::str>)
         {
             if (constant.value_case() != protobuf::Constant::ValueCase::kString)
@@ -153,7 +407,6 @@ auto view::value(const std::string& name) const
         }
         if constexpr (!std::is_same_v<Metric, constant::str>)
         {
-            auto constant = m.constant();
             switch (constant.value_case())
             {
             case protobuf::Constant::ValueCase::kUint64:
@@ -171,7 +424,7 @@ auto view::value(const std::string& name) const
     }
     if constexpr (!detail::is_constant_v<Metric>)
     {
-        auto offset = get_offset(m);
+        auto offset = m_offsets[id];
         assert(offset < m_value_bytes);
         auto data = m_value_data + offset;
         assert(data != nullptr);
@@ -181,7 +434,13 @@ auto view::value(const std::string& name) const
             return std::nullopt;
         }
 
-        if (m_metadata.endianness() == protobuf::Endianness::BIG)
+        if (m_native)
+        {
+            typename Metric::type value;
+            std::memcpy(&value, data + 1, sizeof(value));
+            return value;
+        }
+        else if (metadata().endianness() == protobuf::Endianness::BIG)
         {
             return endian::big_endian::get<typename Metric::type>(data + 1);
         }
@@ -193,33 +452,33 @@ auto view::value(const std::string& name) const
 }
 
 // Explicit instantiations for the expected types
-template auto view::value<abacus::uint64>(const std::string& name) const
+template auto view::value<abacus::uint64>(std::size_t id) const
     -> std::optional<abacus::uint64::type>;
-template auto view::value<abacus::int64>(const std::string& name) const
+template auto view::value<abacus::int64>(std::size_t id) const
     -> std::optional<abacus::int64::type>;
-template auto view::value<abacus::uint32>(const std::string& name) const
+template auto view::value<abacus::uint32>(std::size_t id) const
     -> std::optional<abacus::uint32::type>;
-template auto view::value<abacus::int32>(const std::string& name) const
+template auto view::value<abacus::int32>(std::size_t id) const
     -> std::optional<abacus::int32::type>;
-template auto view::value<abacus::float64>(const std::string& name) const
+template auto view::value<abacus::float64>(std::size_t id) const
     -> std::optional<abacus::float64::type>;
-template auto view::value<abacus::float32>(const std::string& name) const
+template auto view::value<abacus::float32>(std::size_t id) const
     -> std::optional<abacus::float32::type>;
-template auto view::value<abacus::boolean>(const std::string& name) const
+template auto view::value<abacus::boolean>(std::size_t id) const
     -> std::optional<abacus::boolean::type>;
-template auto view::value<abacus::enum8>(const std::string& name) const
+template auto view::value<abacus::enum8>(std::size_t id) const
     -> std::optional<abacus::enum8::type>;
 
 // Constants (no optional)
 template auto view::value<abacus::constant::uint64>(
-    const std::string& name) const -> abacus::constant::uint64::type;
+    std::size_t id) const -> abacus::constant::uint64::type;
 template auto view::value<abacus::constant::int64>(
-    const std::string& name) const -> abacus::constant::int64::type;
+    std::size_t id) const -> abacus::constant::int64::type;
 template auto view::value<abacus::constant::float64>(
-    const std::string& name) const -> abacus::constant::float64::type;
+    std::size_t id) const -> abacus::constant::float64::type;
 template auto view::value<abacus::constant::boolean>(
-    const std::string& name) const -> abacus::constant::boolean::type;
-template auto view::value<abacus::constant::str>(const std::string& name) const
+    std::size_t id) const -> abacus::constant::boolean::type;
+template auto view::value<abacus::constant::str>(std::size_t id) const
     -> abacus::constant::str::type;
 }
 }
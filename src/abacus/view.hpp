@@ -6,8 +6,12 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "detail/is_constant.hpp"
 #include "protobuf/metrics.pb.h"
@@ -31,15 +35,78 @@ inline namespace STEINWURF_ABACUS_VERSION
 /// meta data, subsequently view.set_value_data() can be called to populate
 /// the view with the value data. To update the view with new value data
 /// view.set_value_data() can be called again.
+///
+/// When the meta data is set the metrics are indexed by a dense integer id
+/// in the range [0, count()). The ids are assigned in the lexicographical
+/// order of the metric names, matching the ids used by abacus::metrics.
+/// Metrics sharing a name prefix, e.g. all metrics under "conn.tx.", therefore
+/// have consecutive ids and can be found with a binary search.
 class view
 {
 public:
-    /// Sets the meta data
+    /// Default constructor
+    view() = default;
+
+    /// Copy constructor
+    /// @param other The view to copy
+    view(const view& other);
+
+    /// Copy assignment
+    /// @param other The view to copy
+    /// @return The view
+    auto operator=(const view& other) -> view&;
+
+    /// Move constructor
+    /// @param other The view to move from
+    view(view&& other) noexcept;
+
+    /// Move assignment
+    /// @param other The view to move from
+    /// @return The view
+    auto operator=(view&& other) noexcept -> view&;
+
+    /// Destructor
+    ~view();
+
+    /// Sets the meta data. A string table is resolved, so the strings of
+    /// metric() are always stored in the metrics.
     /// @param metadata The meta data
     /// @return true if the meta data was unpacked correctly otherwise false
     [[nodiscard]]
     auto set_metadata(const protobuf::MetricsMetadata& metadata) -> bool;
 
+    /// Parses and sets the meta data. The meta data is parsed directly into
+    /// the arena of the view, so parsing a large schema only needs a few
+    /// allocations and no copy.
+    /// @param metadata_data The meta data pointer
+    /// @param metadata_bytes The meta data size in bytes
+    /// @return true if the meta data was parsed and unpacked correctly
+    ///         otherwise false
+    [[nodiscard]] auto set_metadata(const uint8_t* metadata_data,
+                                    std::size_t metadata_bytes) -> bool;
+
+    /// Adds the descriptions, units and enum values of lean meta data from
+    /// its dictionary, see abacus::metadata_encoding::lean. The values can
+    /// be read without the dictionary.
+    /// @param dictionary_data The dictionary pointer
+    /// @param dictionary_bytes The dictionary size in bytes
+    /// @return true if the dictionary belongs to the meta data and was
+    ///         added, otherwise false and the view is unchanged
+    [[nodiscard]] auto set_dictionary(const uint8_t* dictionary_data,
+                                      std::size_t dictionary_bytes) -> bool;
+
+    /// Applies an incremental meta data update, e.g. from an
+    /// abacus::registry. The metrics of the update are added to the meta
+    /// data and the sync value is advanced, without receiving and parsing
+    /// the full meta data again. The value data must be set again after
+    /// the update.
+    /// @param update The update, its base sync value must be the sync value
+    ///        of the current meta data
+    /// @return true if the update was applied, otherwise false and the view
+    ///         is unchanged
+    [[nodiscard]]
+    auto apply_update(const protobuf::MetricsMetadata& update) -> bool;
+
     /// Sets the value data pointer
     /// @param value_data The value data pointer
     /// @param value_bytes The value data size in bytes
@@ -55,34 +122,113 @@ public:
     /// @return The value data size in bytes
     std::size_t value_bytes() const;
 
+    /// @return The number of metrics
+    auto count() const -> std::size_t;
+
+    /// Look up the id of a metric. The lookup is a binary search, so the
+    /// id should be looked up once and reused for repeated access.
+    /// @param name The name of the metric
+    /// @return The id of the metric
+    auto id(std::string_view name) const -> std::size_t;
+
+    /// @param id The id of the metric
+    /// @return The name of the metric
+    auto metric_name(std::size_t id) const -> std::string_view;
+
+    /// Finds the metrics with names starting with a prefix. The matching
+    /// metrics have consecutive ids, so the lookup is a binary search and
+    /// no memory is allocated. To select a level in a hierarchical name
+    /// include the separator in the prefix, e.g. "conn.tx.".
+    /// @param prefix The name prefix
+    /// @return The ids of the matching metrics as the half-open range
+    ///         [first, second), which is empty if no metrics match
+    auto prefix_range(std::string_view prefix) const
+        -> std::pair<std::size_t, std::size_t>;
+
+    /// Finds the metrics with names matching a glob pattern, where '*'
+    /// matches any sequence of characters and '?' matches any single
+    /// character. Only the metrics in the prefix range of the literal part
+    /// of the pattern before the first wildcard are tested.
+    /// @param pattern The glob pattern
+    /// @return The ids of the matching metrics in ascending order
+    auto match(std::string_view pattern) const -> std::vector<std::size_t>;
+
+    /// Gets the metric
+    /// @param id The id of the metric
+    /// @return The metric
+    const protobuf::Metric& metric(std::size_t id) const;
+
     /// Gets the metric
     /// @param name The name of the metric
     /// @return The metric
-    const protobuf::Metric& metric(const std::string& name) const;
+    const protobuf::Metric& metric(std::string_view name) const;
 
     /// Gets the meta data
     /// @return The meta data
     auto metadata() const -> const protobuf::MetricsMetadata&;
 
     /// Gets the value of a metric
-    /// @param name The name of the metric
+    /// @param id The id of the metric
     /// @return The value of the metric, if the metric is a constant the value
     ///         is returned directly, otherwise an optional is returned
     template <class Metric>
-    auto value(const std::string& name) const
+    auto value(std::size_t id) const
         -> std::conditional_t<detail::is_constant_v<Metric>,
                               typename Metric::type,
                               std::optional<typename Metric::type>>;
 
+    /// Gets the value of a metric
+    /// @param name The name of the metric
+    /// @return The value of the metric, if the metric is a constant the value
+    ///         is returned directly, otherwise an optional is returned
+    template <class Metric>
+    auto value(std::string_view name) const
+        -> std::conditional_t<detail::is_constant_v<Metric>,
+                              typename Metric::type,
+                              std::optional<typename Metric::type>>
+    {
+        return value<Metric>(id(name));
+    }
+
 private:
-    /// The meta data
-    protobuf::MetricsMetadata m_metadata;
+    /// Replaces the arena and allocates empty meta data in it
+    /// @param metrics The expected number of metrics, used to size the arena
+    /// @return The meta data
+    auto reset_metadata(std::size_t metrics) -> protobuf::MetricsMetadata*;
+
+    /// Removes the meta data
+    auto clear_metadata() -> void;
+
+    /// Builds the id index of the meta data
+    auto build_index() -> void;
+
+private:
+    /// The arena holding the meta data
+    std::unique_ptr<google::protobuf::Arena> m_arena;
+
+    /// The meta data, allocated in the arena, or nullptr if not set
+    protobuf::MetricsMetadata* m_metadata = nullptr;
+
+    /// The metric names sorted, the position of a name is the id of the
+    /// metric. The names point into the keys of the meta data.
+    std::vector<std::string_view> m_names;
+
+    /// The metrics indexed by id, pointing into the meta data
+    std::vector<const protobuf::Metric*> m_metrics;
+
+    /// The value offsets of the metrics indexed by id, constants have no
+    /// value and use the offset 0
+    std::vector<std::size_t> m_offsets;
+
+    /// True if the value data is in the byte order of the host, e.g. after
+    /// abacus::normalizer, so the values are read with plain loads
+    bool m_native = false;
 
     /// The value data pointer
-    const uint8_t* m_value_data;
+    const uint8_t* m_value_data = nullptr;
 
     /// The value data size in bytes
-    std::size_t m_value_bytes;
+    std::size_t m_value_bytes = 0;
 };
 }
 }
@@ -0,0 +1,364 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <abacus/aggregator.hpp>
+#include <abacus/metrics.hpp>
+#include <abacus/view.hpp>
+
+namespace
+{
+enum class test_state
+{
+    idle = 0
+};
+
+struct connection
+{
+    connection(const std::map<abacus::name, abacus::info>& infos,
+               uint64_t bytes, std::optional<int32_t> delta, double rate,
+               bool up) :
+        metrics(infos)
+    {
+        metrics.initialize<abacus::uint64>("bytes").set_value(bytes);
+        metrics.initialize<abacus::int32>("delta").set_value(delta);
+        metrics.initialize<abacus::float64>("rate").set_value(rate);
+        metrics.initialize<abacus::boolean>("up").set_value(up);
+        metrics.initialize<abacus::enum8>("state").set_value(test_state::idle);
+    }
+
+    abacus::metrics metrics;
+};
+}
+
+TEST(test_aggregator, aggregate)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"delta"},
+         abacus::int32{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"rate"},
+         abacus::float64{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}},
+        {abacus::name{"state"},
+         abacus::enum8{abacus::description{""}, {{0, {"idle", ""}}}}},
+        {abacus::name{"version"},
+         abacus::constant{abacus::constant::uint64{1},
+                          abacus::description{""}}}};
+
+    std::vector<connection> connections;
+    connections.emplace_back(infos, 10U, -4, 1.0, true);
+    connections.emplace_back(infos, 20U, std::nullopt, 2.0, false);
+    connections.emplace_back(infos, 30U, 1, 6.0, false);
+
+    std::vector<const uint8_t*> value_data;
+    for (const auto& c : connections)
+    {
+        value_data.push_back(c.metrics.value_data());
+    }
+    const auto& metadata = connections[0].metrics.metadata();
+
+    std::vector<uint8_t> data;
+    auto check = [&](abacus::aggregation gauge, abacus::aggregation boolean,
+                     std::size_t threads)
+    {
+        abacus::aggregator aggregator(metadata, gauge, boolean);
+        EXPECT_EQ(connections[0].metrics.value_bytes(),
+                  aggregator.value_bytes());
+
+        data.assign(aggregator.value_bytes(), 0xff);
+        EXPECT_TRUE(aggregator.aggregate(value_data, data.data(), threads));
+
+        // The result can be read with a view using the same meta data
+        abacus::view view;
+        EXPECT_TRUE(view.set_metadata(metadata));
+        EXPECT_TRUE(view.set_value_data(data.data(), data.size()));
+
+        // Counters are always summed
+        EXPECT_EQ(60U, view.value<abacus::uint64>("bytes").value());
+
+        // Enums are not aggregated and constants are unchanged
+        EXPECT_FALSE(view.value<abacus::enum8>("state").has_value());
+        EXPECT_EQ(1U, view.value<abacus::constant::uint64>("version"));
+        return view;
+    };
+
+    for (std::size_t threads : {1U, 2U, 3U, 8U})
+    {
+        SCOPED_TRACE(threads);
+        auto view = check(abacus::aggregation::sum, abacus::aggregation::any,
+                          threads);
+        EXPECT_EQ(-3, view.value<abacus::int32>("delta").value());
+        EXPECT_EQ(9.0, view.value<abacus::float64>("rate").value());
+        EXPECT_TRUE(view.value<abacus::boolean>("up").value());
+
+        view = check(abacus::aggregation::min, abacus::aggregation::all,
+                     threads);
+        EXPECT_EQ(-4, view.value<abacus::int32>("delta").value());
+        EXPECT_EQ(1.0, view.value<abacus::float64>("rate").value());
+        EXPECT_FALSE(view.value<abacus::boolean>("up").value());
+
+        view = check(abacus::aggregation::max, abacus::aggregation::any,
+                     threads);
+        EXPECT_EQ(1, view.value<abacus::int32>("delta").value());
+        EXPECT_EQ(6.0, view.value<abacus::float64>("rate").value());
+
+        // Only the buffers with a value count towards the average
+        view = check(abacus::aggregation::avg, abacus::aggregation::any,
+                     threads);
+        EXPECT_EQ(-1, view.value<abacus::int32>("delta").value());
+        EXPECT_EQ(3.0, view.value<abacus::float64>("rate").value());
+    }
+}
+
+TEST(test_aggregator, unset)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"delta"},
+         abacus::int32{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"rate"},
+         abacus::float64{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}},
+        {abacus::name{"state"},
+         abacus::enum8{abacus::description{""}, {{0, {"idle", ""}}}}},
+        {abacus::name{"version"},
+         abacus::constant{abacus::constant::uint64{1},
+                          abacus::description{""}}}};
+
+    abacus::metrics metrics(infos);
+    abacus::aggregator aggregator(metrics.metadata());
+    std::vector<uint8_t> data(aggregator.value_bytes());
+
+    // No buffers gives a result with all values unset
+    ASSERT_TRUE(aggregator.aggregate({}, data.data()));
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metrics.metadata()));
+    ASSERT_TRUE(view.set_value_data(data.data(), data.size()));
+    EXPECT_FALSE(view.value<abacus::uint64>("bytes").has_value());
+    EXPECT_FALSE(view.value<abacus::boolean>("up").has_value());
+
+    ASSERT_TRUE(aggregator.aggregate({metrics.value_data()}, data.data()));
+    EXPECT_FALSE(view.value<abacus::uint64>("bytes").has_value());
+
+    // Buffers of another schema are rejected
+    abacus::metrics other(
+        {{abacus::name{"other"},
+          abacus::uint64{abacus::kind::counter, abacus::description{""}}}});
+    EXPECT_FALSE(aggregator.aggregate(
+        {metrics.value_data(), other.value_data()}, data.data()));
+}
+
+TEST(test_aggregator, declared)
+{
+    enum class severity
+    {
+        info = 0,
+        warning = 1,
+        error = 2
+    };
+
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"peak"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""},
+                        abacus::unit{}, abacus::min<uint64_t>{},
+                        abacus::max<uint64_t>{}, abacus::aggregation::max}},
+        {abacus::name{"temperature"},
+         abacus::float64{abacus::kind::gauge, abacus::description{""},
+                         abacus::unit{"C"}, abacus::min<double>{},
+                         abacus::max<double>{}, abacus::aggregation::avg}},
+        {abacus::name{"queue"},
+         abacus::int32{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"ready"},
+         abacus::boolean{abacus::description{""}, abacus::aggregation::all}},
+        {abacus::name{"severity"},
+         abacus::enum8{abacus::description{""},
+                       {{severity::info, {"info", ""}},
+                        {severity::warning, {"warning", ""}},
+                        {severity::error, {"error", ""}}},
+                       abacus::unit{},
+                       abacus::aggregation::max}}};
+
+    std::vector<abacus::metrics> devices;
+    auto add = [&](uint64_t peak, double temperature, int32_t queue,
+                   bool ready, severity s)
+    {
+        abacus::metrics& m = devices.emplace_back(infos);
+        m.initialize<abacus::uint64>("peak").set_value(peak);
+        m.initialize<abacus::float64>("temperature").set_value(temperature);
+        m.initialize<abacus::int32>("queue").set_value(queue);
+        m.initialize<abacus::boolean>("ready").set_value(ready);
+        m.initialize<abacus::enum8>("severity").set_value(s);
+    };
+    add(5U, 20.0, 3, true, severity::info);
+    add(9U, 30.0, 4, false, severity::error);
+    add(7U, 40.0, 5, true, severity::warning);
+
+    // The aggregation is part of the meta data
+    const auto& metadata = devices[0].metadata();
+    EXPECT_EQ(abacus::protobuf::MAXIMUM,
+              metadata.metrics().at("peak").uint64().aggregation());
+    EXPECT_TRUE(metadata.metrics().at("ready").boolean().has_aggregation());
+    EXPECT_FALSE(metadata.metrics().at("queue").int32().has_aggregation());
+
+    std::vector<const uint8_t*> value_data;
+    for (const auto& m : devices)
+    {
+        value_data.push_back(m.value_data());
+    }
+
+    // The declared aggregations take precedence over the defaults
+    abacus::aggregator aggregator(metadata, abacus::aggregation::min,
+                                  abacus::aggregation::any);
+    std::vector<uint8_t> data(aggregator.value_bytes());
+    ASSERT_TRUE(aggregator.aggregate(value_data, data.data()));
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metadata));
+    ASSERT_TRUE(view.set_value_data(data.data(), data.size()));
+    EXPECT_EQ(9U, view.value<abacus::uint64>("peak").value());
+    EXPECT_EQ(30.0, view.value<abacus::float64>("temperature").value());
+    EXPECT_EQ(3, view.value<abacus::int32>("queue").value());
+    EXPECT_FALSE(view.value<abacus::boolean>("ready").value());
+    EXPECT_EQ(severity::error,
+              severity(view.value<abacus::enum8>("severity").value()));
+}
+
+TEST(test_aggregator, hierarchy)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"delta"},
+         abacus::int32{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"rate"},
+         abacus::float64{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}},
+        {abacus::name{"state"},
+         abacus::enum8{abacus::description{""}, {{0, {"idle", ""}}}}},
+        {abacus::name{"version"},
+         abacus::constant{abacus::constant::uint64{1},
+                          abacus::description{""}}}};
+
+    // Two racks with three devices each are merged into a site, one pass
+    // per level
+    std::vector<connection> devices;
+    for (uint64_t i = 0; i < 6; ++i)
+    {
+        devices.emplace_back(infos, i + 1, int32_t(i), double(i), i == 4);
+    }
+    const auto& metadata = devices[0].metrics.metadata();
+    abacus::aggregator aggregator(metadata, abacus::aggregation::max);
+
+    std::vector<std::vector<uint8_t>> racks(
+        2, std::vector<uint8_t>(aggregator.value_bytes()));
+    std::vector<abacus::view> rack_views(2);
+    for (std::size_t rack = 0; rack < racks.size(); ++rack)
+    {
+        std::vector<abacus::view> views(3);
+        std::vector<const abacus::view*> level;
+        for (std::size_t i = 0; i < views.size(); ++i)
+        {
+            const auto& m = devices[rack * 3 + i].metrics;
+            ASSERT_TRUE(views[i].set_metadata(metadata));
+            ASSERT_TRUE(
+                views[i].set_value_data(m.value_data(), m.value_bytes()));
+            level.push_back(&views[i]);
+        }
+        ASSERT_TRUE(aggregator.aggregate_views(level, racks[rack].data()));
+        ASSERT_TRUE(rack_views[rack].set_metadata(metadata));
+        ASSERT_TRUE(rack_views[rack].set_value_data(racks[rack].data(),
+                                                    racks[rack].size()));
+    }
+    EXPECT_EQ(6U, rack_views[0].value<abacus::uint64>("bytes").value());
+    EXPECT_EQ(15U, rack_views[1].value<abacus::uint64>("bytes").value());
+    EXPECT_FALSE(rack_views[0].value<abacus::boolean>("up").value());
+
+    std::vector<uint8_t> site(aggregator.value_bytes());
+    ASSERT_TRUE(aggregator.aggregate_views({&rack_views[0], &rack_views[1]},
+                                           site.data()));
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metadata));
+    ASSERT_TRUE(view.set_value_data(site.data(), site.size()));
+    EXPECT_EQ(21U, view.value<abacus::uint64>("bytes").value());
+    EXPECT_EQ(5, view.value<abacus::int32>("delta").value());
+    EXPECT_EQ(5.0, view.value<abacus::float64>("rate").value());
+    EXPECT_TRUE(view.value<abacus::boolean>("up").value());
+
+    // A view without value data cannot be aggregated
+    abacus::view empty;
+    ASSERT_TRUE(empty.set_metadata(metadata));
+    EXPECT_FALSE(aggregator.aggregate_views({&view, &empty}, site.data()));
+}
+
+TEST(test_aggregator, saturate)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"packets"},
+         abacus::uint32{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"delta"},
+         abacus::int32{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"debt"},
+         abacus::int64{abacus::kind::gauge, abacus::description{""}}}};
+
+    std::vector<abacus::metrics> connections;
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        abacus::metrics& m = connections.emplace_back(infos);
+        m.initialize<abacus::uint64>("bytes").set_value(
+            std::numeric_limits<uint64_t>::max() - 1);
+        m.initialize<abacus::uint32>("packets").set_value(
+            std::numeric_limits<uint32_t>::max() - 1);
+        m.initialize<abacus::int32>("delta").set_value(
+            std::numeric_limits<int32_t>::max() - 1);
+        m.initialize<abacus::int64>("debt").set_value(
+            std::numeric_limits<int64_t>::min() + 1);
+    }
+    std::vector<const uint8_t*> value_data;
+    for (const auto& m : connections)
+    {
+        value_data.push_back(m.value_data());
+    }
+    const auto& metadata = connections[0].metadata();
+
+    for (std::size_t threads : {1U, 3U})
+    {
+        SCOPED_TRACE(threads);
+        std::vector<uint8_t> data;
+        abacus::view view;
+        ASSERT_TRUE(view.set_metadata(metadata));
+
+        // The sums saturate at the limits of the value types
+        abacus::aggregator sum(metadata, abacus::aggregation::sum);
+        data.resize(sum.value_bytes());
+        ASSERT_TRUE(sum.aggregate(value_data, data.data(), threads));
+        ASSERT_TRUE(view.set_value_data(data.data(), data.size()));
+        EXPECT_EQ(std::numeric_limits<uint64_t>::max(),
+                  view.value<abacus::uint64>("bytes").value());
+        EXPECT_EQ(std::numeric_limits<uint32_t>::max(),
+                  view.value<abacus::uint32>("packets").value());
+        EXPECT_EQ(std::numeric_limits<int32_t>::max(),
+                  view.value<abacus::int32>("delta").value());
+        EXPECT_EQ(std::numeric_limits<int64_t>::min(),
+                  view.value<abacus::int64>("debt").value());
+
+        // The sum of 32-bit values does not overflow before the average
+        abacus::aggregator avg(metadata, abacus::aggregation::avg);
+        ASSERT_TRUE(avg.aggregate(value_data, data.data(), threads));
+        ASSERT_TRUE(view.set_value_data(data.data(), data.size()));
+        EXPECT_EQ(std::numeric_limits<int32_t>::max() - 1,
+                  view.value<abacus::int32>("delta").value());
+    }
+}
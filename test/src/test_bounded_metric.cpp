@@ -0,0 +1,101 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <cstdint>
+#include <limits>
+#include <gtest/gtest.h>
+
+#include <abacus/bounded_metric.hpp>
+#include <abacus/metrics.hpp>
+
+TEST(test_bounded_metric, clamp)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"queue"},
+         abacus::uint32{abacus::kind::gauge, abacus::description{""},
+                        abacus::unit{"packets"}, abacus::min<uint32_t>{2U},
+                        abacus::max<uint32_t>{10U}}},
+        {abacus::name{"loss"},
+         abacus::float64{abacus::kind::gauge, abacus::description{""},
+                         abacus::unit{""}, abacus::min<double>{0.0},
+                         abacus::max<double>{1.0}}}};
+    abacus::metrics metrics(infos);
+
+    auto queue = metrics.initialize_bounded<abacus::uint32>("queue");
+    EXPECT_EQ(2U, queue.min());
+    EXPECT_EQ(10U, queue.max());
+
+    queue = 5U;
+    EXPECT_EQ(5U, queue.value());
+    EXPECT_EQ(0U, queue.violations());
+
+    queue = 20U;
+    EXPECT_EQ(10U, queue.value());
+    queue += 1;
+    EXPECT_EQ(10U, queue.value());
+    EXPECT_EQ(2U, queue.violations());
+
+    // Decrementing below zero saturates before it is clamped
+    queue -= 100;
+    EXPECT_EQ(2U, queue.value());
+    --queue;
+    EXPECT_EQ(2U, queue.value());
+    ++queue;
+    EXPECT_EQ(3U, queue.value());
+    EXPECT_EQ(4U, queue.violations());
+    queue.reset_violations();
+    EXPECT_EQ(0U, queue.violations());
+
+    auto loss = metrics.initialize_bounded<abacus::float64>("loss");
+    loss = 1.5;
+    EXPECT_EQ(1.0, loss.value());
+    loss = -0.5;
+    EXPECT_EQ(0.0, loss.value());
+    loss = 0.25;
+    EXPECT_EQ(0.25, loss.value());
+    EXPECT_EQ(2U, loss.violations());
+
+    loss = std::nullopt;
+    EXPECT_FALSE(loss.has_value());
+}
+
+TEST(test_bounded_metric, saturate)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"packets"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"delta"},
+         abacus::int64{abacus::kind::gauge, abacus::description{""}}}};
+    abacus::metrics metrics(infos);
+
+    // Without bounds the limits of the type are used
+    auto packets = metrics.initialize_bounded<abacus::uint64>("packets");
+    packets = std::numeric_limits<uint64_t>::max() - 1;
+    ++packets;
+    EXPECT_EQ(0U, packets.violations());
+    ++packets;
+    EXPECT_EQ(std::numeric_limits<uint64_t>::max(), packets.value());
+    EXPECT_EQ(1U, packets.violations());
+
+    auto delta = metrics.initialize_bounded<abacus::int64>("delta");
+    delta = std::numeric_limits<int64_t>::min() + 1;
+    delta -= 5;
+    EXPECT_EQ(std::numeric_limits<int64_t>::min(), delta.value());
+    delta += -5;
+    EXPECT_EQ(std::numeric_limits<int64_t>::min(), delta.value());
+    delta -= -10;
+    EXPECT_EQ(std::numeric_limits<int64_t>::min() + 10, delta.value());
+    EXPECT_EQ(2U, delta.violations());
+
+    // A handle can also be bounded explicitly
+    abacus::metrics other(infos);
+    abacus::bounded_metric<abacus::int64> bounded(
+        other.initialize<abacus::int64>("delta"), abacus::min<int64_t>{-1},
+        abacus::max<int64_t>{1});
+    bounded = 7;
+    EXPECT_EQ(1, bounded.value());
+    EXPECT_EQ(1U, bounded.violations());
+}
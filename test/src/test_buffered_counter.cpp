@@ -0,0 +1,88 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <abacus/buffered_counter.hpp>
+#include <abacus/metrics.hpp>
+
+TEST(test_buffered_counter, threshold_and_flush)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"packets"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"seconds"},
+         abacus::float64{abacus::kind::counter, abacus::description{""}}}};
+    abacus::metrics metrics(infos);
+
+    auto packets = metrics.initialize<abacus::uint64>("packets");
+    packets = 100U;
+    abacus::buffered_counter<abacus::uint64> counter(packets, 4);
+
+    {
+        auto local = counter.make_local();
+        ++local;
+        local += 2;
+        ++local;
+        EXPECT_EQ(100U, packets.value());
+
+        // The fourth increment reaches the threshold
+        ++local;
+        EXPECT_EQ(105U, packets.value());
+
+        local += 10;
+        EXPECT_EQ(105U, packets.value());
+        counter.flush();
+        EXPECT_EQ(115U, packets.value());
+        local += 1;
+    }
+    // Destroying the local flushes it
+    EXPECT_EQ(116U, packets.value());
+
+    auto seconds = metrics.initialize<abacus::float64>("seconds");
+    abacus::buffered_counter<abacus::float64> timer(seconds);
+    EXPECT_EQ(0.0, seconds.value());
+    auto local = timer.make_local();
+    local += 0.5;
+    local.flush();
+    EXPECT_EQ(0.5, seconds.value());
+}
+
+TEST(test_buffered_counter, threads)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"packets"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}}};
+    abacus::metrics metrics(infos);
+    auto packets = metrics.initialize<abacus::uint64>("packets");
+    abacus::buffered_counter<abacus::uint64> counter(packets, 100);
+
+    const std::size_t increments = 10000;
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        threads.emplace_back(
+            [&counter, increments]()
+            {
+                thread_local auto local = counter.make_local();
+                for (std::size_t j = 0; j < increments; ++j)
+                {
+                    ++local;
+                }
+            });
+    }
+
+    // Flushing while the threads increment is safe
+    counter.flush();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(4 * increments, packets.value());
+}
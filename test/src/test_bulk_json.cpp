@@ -0,0 +1,202 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <abacus/bulk_json.hpp>
+#include <abacus/detail/append_json.hpp>
+#include <abacus/metrics.hpp>
+#include <abacus/to_json.hpp>
+#include <abacus/view.hpp>
+
+namespace
+{
+enum class state
+{
+    idle = 0,
+    busy = 1,
+    down = 2
+};
+
+// Returns JSON without the whitespace outside of strings
+std::string compact(const std::string& json)
+{
+    std::string out;
+    abacus::detail::append_compact_json(json, out);
+    return out;
+}
+
+struct device
+{
+    device(const std::map<abacus::name, abacus::info>& infos, uint64_t i) :
+        metrics(infos)
+    {
+        metrics.initialize<abacus::uint64>("bytes").set_value(i * 1500);
+        metrics.initialize<abacus::int64>("delta").set_value(-int64_t(i));
+        metrics.initialize<abacus::float32>("load").set_value(i / 7.0F);
+        metrics.initialize<abacus::float64>("ratio").set_value(i / 3.0);
+        metrics.initialize<abacus::enum8>("state").set_value(state(i % 3));
+        metrics.initialize<abacus::boolean>("up").set_value(i % 2 == 0);
+        bool valid = view.set_metadata(metrics.metadata());
+        EXPECT_TRUE(valid);
+        valid =
+            view.set_value_data(metrics.value_data(), metrics.value_bytes());
+        EXPECT_TRUE(valid);
+    }
+
+    abacus::metrics metrics;
+    abacus::view view;
+};
+}
+
+TEST(test_bulk_json, to_json)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{"Bytes"},
+                        abacus::unit{"bytes"}}},
+        {abacus::name{"delta"},
+         abacus::int64{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"host"},
+         abacus::constant{abacus::constant::str{"a \"b\"\\c"},
+                          abacus::description{""}}},
+        {abacus::name{"load"},
+         abacus::float32{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"ratio"},
+         abacus::float64{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"state"},
+         abacus::enum8{abacus::description{""},
+                       {{0, {"idle", ""}},
+                        {1, {"busy", ""}},
+                        {2, {"down", ""}}}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}},
+        {abacus::name{"unset"},
+         abacus::uint32{abacus::kind::gauge, abacus::description{""}}}};
+
+    device device(infos, 7);
+    const abacus::view* views[] = {&device.view, nullptr};
+
+    // The JSON of a view is the JSON of abacus::to_json() on one line
+    abacus::bulk_json bulk_json(1);
+    std::string json;
+    for (bool minimal : {true, false})
+    {
+        auto expected = compact(abacus::to_json(device.view, minimal));
+        bulk_json.render(views, 2, abacus::bulk_json::format::array, minimal,
+                         json);
+        EXPECT_EQ("[" + expected + ",null]", json);
+        bulk_json.render(views, 2, abacus::bulk_json::format::ndjson, minimal,
+                         json);
+        EXPECT_EQ(expected + "\nnull\n", json);
+    }
+    auto json_object = compact(abacus::to_json(device.view, true));
+    EXPECT_EQ(0U, json_object.find(
+                      R"({"bytes":10500,"delta":-7,"host":"a \"b\"\\c",)"));
+    EXPECT_NE(std::string::npos,
+              json_object.find(R"("state":1,"unset":null,"up":false})"));
+
+    // Floats are written like abacus::to_json(), also when they are not
+    // finite
+    std::vector<uint8_t> value_data(device.metrics.value_data(),
+                                    device.metrics.value_data() +
+                                        device.metrics.value_bytes());
+    for (double value : {std::numeric_limits<double>::infinity(),
+                         -std::numeric_limits<double>::infinity(),
+                         std::numeric_limits<double>::quiet_NaN(), 0.1, 1e30})
+    {
+        auto load = static_cast<float>(value);
+        std::memcpy(value_data.data() +
+                        device.view.metric("load").float32().offset() + 1,
+                    &load, sizeof(load));
+        std::memcpy(value_data.data() +
+                        device.view.metric("ratio").float64().offset() + 1,
+                    &value, sizeof(value));
+        bool valid =
+            device.view.set_value_data(value_data.data(), value_data.size());
+        EXPECT_TRUE(valid);
+        for (bool minimal : {true, false})
+        {
+            bulk_json.render(views, 1, abacus::bulk_json::format::ndjson,
+                             minimal, json);
+            EXPECT_EQ(compact(abacus::to_json(device.view, minimal)) + "\n",
+                      json)
+                << value;
+        }
+    }
+
+    bulk_json.render(views, 0, abacus::bulk_json::format::array, true, json);
+    EXPECT_EQ("[]", json);
+    bulk_json.render(views, 0, abacus::bulk_json::format::ndjson, true, json);
+    EXPECT_EQ("", json);
+}
+
+TEST(test_bulk_json, threads)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{"Bytes"},
+                        abacus::unit{"bytes"}}},
+        {abacus::name{"delta"},
+         abacus::int64{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"host"},
+         abacus::constant{abacus::constant::str{"a \"b\"\\c"},
+                          abacus::description{""}}},
+        {abacus::name{"load"},
+         abacus::float32{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"ratio"},
+         abacus::float64{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"state"},
+         abacus::enum8{abacus::description{""},
+                       {{0, {"idle", ""}},
+                        {1, {"busy", ""}},
+                        {2, {"down", ""}}}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}},
+        {abacus::name{"unset"},
+         abacus::uint32{abacus::kind::gauge, abacus::description{""}}}};
+
+    std::vector<std::unique_ptr<device>> devices;
+    std::vector<const abacus::view*> views;
+    std::string expected_array = "[";
+    std::string expected_ndjson;
+    for (uint64_t i = 0; i < 1000; ++i)
+    {
+        devices.push_back(std::make_unique<device>(infos, i));
+        views.push_back(&devices.back()->view);
+        auto json = compact(abacus::to_json(devices.back()->view, true));
+        expected_array += (i == 0 ? "" : ",") + json;
+        expected_ndjson += json + "\n";
+    }
+    expected_array += "]";
+
+    // The views are rendered in order whatever the number of threads and
+    // views
+    for (std::size_t threads : {1, 2, 4, 7})
+    {
+        abacus::bulk_json bulk_json(threads);
+        EXPECT_EQ(threads, bulk_json.threads());
+        std::string json;
+        for (int repeat = 0; repeat < 3; ++repeat)
+        {
+            bulk_json.render(views.data(), views.size(),
+                             abacus::bulk_json::format::array, true, json);
+            EXPECT_EQ(expected_array, json) << threads;
+            bulk_json.render(views.data(), views.size(),
+                             abacus::bulk_json::format::ndjson, true, json);
+            EXPECT_EQ(expected_ndjson, json) << threads;
+        }
+        bulk_json.render(views.data(), 3, abacus::bulk_json::format::ndjson,
+                         true, json);
+        EXPECT_EQ(expected_ndjson.substr(0, json.size()), json);
+        EXPECT_EQ(3, std::count(json.begin(), json.end(), '\n'));
+    }
+}
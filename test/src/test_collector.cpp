@@ -0,0 +1,195 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <abacus/collector.hpp>
+#include <abacus/framer.hpp>
+#include <abacus/metrics.hpp>
+#include <abacus/view.hpp>
+
+namespace
+{
+// Returns the bytes of a frame of metrics
+std::vector<uint8_t> make_frame(const abacus::metrics& metrics,
+                                bool with_metadata)
+{
+    abacus::framer framer;
+    framer.frame(metrics, with_metadata);
+    std::vector<uint8_t> bytes;
+    for (std::size_t i = 0; i < framer.span_count(); ++i)
+    {
+        const auto& span = framer.spans()[i];
+        bytes.insert(bytes.end(), span.data, span.data + span.size);
+    }
+    return bytes;
+}
+}
+
+TEST(test_collector, dispatch)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}}};
+    std::map<abacus::name, abacus::info> other_infos = {
+        {abacus::name{"other.bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"other.up"}, abacus::boolean{abacus::description{""}}}};
+
+    abacus::metrics metrics0(infos);
+    abacus::metrics metrics1(infos);
+    abacus::metrics other(other_infos);
+    metrics0.initialize<abacus::uint64>("bytes").set_value(10);
+    metrics1.initialize<abacus::uint64>("bytes").set_value(32);
+    other.initialize<abacus::uint64>("other.bytes").set_value(5);
+
+    abacus::collector collector;
+    auto p0 = collector.add_producer();
+    auto p1 = collector.add_producer();
+    auto p2 = collector.add_producer();
+    EXPECT_EQ(3U, collector.producers());
+
+    // Values of an unknown sync value are dropped until the meta data
+    // arrives
+    auto frame = make_frame(metrics1, false);
+    ASSERT_TRUE(collector.receive(p1, frame.data(), frame.size()));
+    EXPECT_EQ(1U, collector.unknown_frames());
+    EXPECT_EQ(nullptr, collector.view(p1));
+
+    // The meta data of one producer serves all producers of the sync value
+    frame = make_frame(metrics0, true);
+    ASSERT_TRUE(collector.receive(p0, frame.data(), frame.size()));
+    frame = make_frame(metrics1, false);
+    ASSERT_TRUE(collector.receive(p1, frame.data(), frame.size()));
+    frame = make_frame(other, true);
+    ASSERT_TRUE(collector.receive(p2, frame.data(), frame.size()));
+    EXPECT_EQ(4U, collector.frames());
+    EXPECT_EQ(2U, collector.sync_values().size());
+
+    ASSERT_NE(nullptr, collector.view(p0));
+    ASSERT_NE(nullptr, collector.view(p1));
+    EXPECT_EQ(10U, collector.view(p0)->value<abacus::uint64>("bytes").value());
+    EXPECT_EQ(32U, collector.view(p1)->value<abacus::uint64>("bytes").value());
+    EXPECT_EQ(5U, collector.view(p2)
+                      ->value<abacus::uint64>("other.bytes")
+                      .value());
+
+    // The counters of the producers of a sync value are summed
+    const uint32_t sync_value = metrics0.schema()->sync_value();
+    EXPECT_EQ(sync_value, collector.metadata(sync_value).sync_value());
+    std::vector<uint8_t> aggregate;
+    EXPECT_EQ(2U, collector.aggregate(sync_value, aggregate));
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(collector.metadata(sync_value)));
+    ASSERT_TRUE(view.set_value_data(aggregate.data(), aggregate.size()));
+    EXPECT_EQ(42U, view.value<abacus::uint64>("bytes").value());
+
+    // A removed producer is no longer aggregated and its id is reused
+    collector.remove_producer(p1);
+    EXPECT_EQ(2U, collector.producers());
+    EXPECT_EQ(1U, collector.aggregate(sync_value, aggregate));
+    EXPECT_EQ(p1, collector.add_producer());
+    EXPECT_EQ(nullptr, collector.view(p1));
+}
+
+TEST(test_collector, stream)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}}};
+
+    abacus::metrics metrics(infos);
+    auto bytes = metrics.initialize<abacus::uint64>("bytes");
+
+    // Frames split at every position are reassembled
+    std::vector<uint8_t> stream = make_frame(metrics, true);
+    for (uint64_t i = 1; i <= 3; ++i)
+    {
+        bytes = i;
+        auto frame = make_frame(metrics, false);
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    for (std::size_t chunk : {1, 2, 3, 5, 16, 17, 100, 1000})
+    {
+        abacus::collector collector;
+        auto producer = collector.add_producer();
+        for (std::size_t offset = 0; offset < stream.size(); offset += chunk)
+        {
+            std::size_t size = std::min(chunk, stream.size() - offset);
+            ASSERT_TRUE(
+                collector.receive(producer, stream.data() + offset, size));
+        }
+        EXPECT_EQ(4U, collector.frames()) << chunk;
+        ASSERT_NE(nullptr, collector.view(producer));
+        EXPECT_EQ(
+            3U,
+            collector.view(producer)->value<abacus::uint64>("bytes").value());
+    }
+}
+
+TEST(test_collector, invalid)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}}};
+    std::map<abacus::name, abacus::info> other_infos = {
+        {abacus::name{"other.bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"other.up"}, abacus::boolean{abacus::description{""}}}};
+
+    abacus::metrics metrics(infos);
+    auto frame = make_frame(metrics, true);
+
+    // Corrupted frames are invalid
+    {
+        abacus::collector collector;
+        auto producer = collector.add_producer();
+        auto corrupted = frame;
+        corrupted.back() ^= 1;
+        EXPECT_FALSE(
+            collector.receive(producer, corrupted.data(), corrupted.size()));
+    }
+
+    // Frames larger than the maximum are invalid before they are buffered
+    {
+        abacus::collector collector(frame.size() - 1);
+        auto producer = collector.add_producer();
+        EXPECT_FALSE(collector.receive(producer, frame.data(), 4));
+    }
+
+    // Meta data beyond the maximum is invalid
+    {
+        abacus::metrics other(other_infos);
+        auto other_frame = make_frame(other, true);
+        abacus::collector collector(1U << 20, 1);
+        auto producer = collector.add_producer();
+        EXPECT_TRUE(collector.receive(producer, frame.data(), frame.size()));
+        EXPECT_FALSE(collector.receive(producer, other_frame.data(),
+                                       other_frame.size()));
+    }
+
+    // Value data of the wrong size is invalid
+    {
+        abacus::collector collector;
+        auto producer = collector.add_producer();
+        EXPECT_TRUE(collector.receive(producer, frame.data(), frame.size()));
+        std::vector<uint8_t> values(metrics.value_data(),
+                                    metrics.value_data() +
+                                        metrics.value_bytes() - 1);
+        abacus::framer framer;
+        framer.frame(nullptr, 0, values.data(), values.size());
+        std::vector<uint8_t> truncated(framer.spans()[0].data,
+                                       framer.spans()[0].data +
+                                           abacus::framer::header_bytes);
+        truncated.insert(truncated.end(), values.begin(), values.end());
+        EXPECT_FALSE(
+            collector.receive(producer, truncated.data(), truncated.size()));
+    }
+}
@@ -0,0 +1,261 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <cstring>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <abacus/compressor.hpp>
+#include <abacus/metrics.hpp>
+#include <abacus/view.hpp>
+
+namespace
+{
+// Compresses and decompresses data and checks that it is unchanged
+std::vector<uint8_t> round_trip(const abacus::compressor& compressor,
+                                const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> frame;
+    compressor.compress(data.data(), data.size(), frame);
+    EXPECT_LE(frame.size(), compressor.max_frame_bytes(data.size()));
+
+    auto bytes = abacus::decompressed_bytes(frame.data(), frame.size());
+    EXPECT_TRUE(bytes.has_value());
+    EXPECT_EQ(data.size(), bytes.value_or(0));
+
+    std::vector<uint8_t> result(data.size());
+    EXPECT_TRUE(abacus::decompress(frame.data(), frame.size(), result.data(),
+                                   result.size()));
+    EXPECT_EQ(data, result);
+    return frame;
+}
+}
+
+TEST(test_compressor, metrics)
+{
+    std::map<abacus::name, abacus::info> infos;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+        infos.emplace(abacus::name{"conn." + std::to_string(i) + ".bytes"},
+                      abacus::uint64{abacus::kind::counter,
+                                     abacus::description{"Bytes"},
+                                     abacus::unit{"bytes"}});
+        infos.emplace(abacus::name{"conn." + std::to_string(i) + ".up"},
+                      abacus::boolean{abacus::description{"Up"}});
+    }
+    abacus::metrics metrics(infos);
+    for (std::size_t i = 0; i < 100; i += 3)
+    {
+        auto bytes = metrics.initialize<abacus::uint64>(
+            "conn." + std::to_string(i) + ".bytes");
+        bytes.set_value(1000 + i);
+    }
+
+    std::vector<uint8_t> values(metrics.value_data(),
+                                metrics.value_data() + metrics.value_bytes());
+    std::vector<uint8_t> metadata(metrics.metadata_data(),
+                                  metrics.metadata_data() +
+                                      metrics.metadata_bytes());
+
+    // The sparse values shrink with both codecs
+    auto frame =
+        round_trip(abacus::compressor{abacus::codec::zero_run}, values);
+    EXPECT_EQ(static_cast<uint8_t>(abacus::codec::zero_run), frame[0]);
+    EXPECT_LT(frame.size() * 3, values.size());
+    frame = round_trip(abacus::compressor{abacus::codec::lz}, values);
+    EXPECT_EQ(static_cast<uint8_t>(abacus::codec::lz), frame[0]);
+    EXPECT_LT(frame.size() * 3, values.size());
+
+    // The repeated names and strings of the meta data need the lz codec
+    frame = round_trip(abacus::compressor{abacus::codec::lz}, metadata);
+    EXPECT_LT(frame.size() * 2, metadata.size());
+
+    // The decompressed values are read by a view
+    frame = round_trip(abacus::compressor{}, values);
+    std::vector<uint8_t> data(
+        abacus::decompressed_bytes(frame.data(), frame.size()).value());
+    ASSERT_TRUE(abacus::decompress(frame.data(), frame.size(), data.data(),
+                                   data.size()));
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metrics.metadata()));
+    ASSERT_TRUE(view.set_value_data(data.data(), data.size()));
+    EXPECT_EQ(1003U, view.value<abacus::uint64>("conn.3.bytes").value());
+    EXPECT_FALSE(view.value<abacus::uint64>("conn.4.bytes").has_value());
+}
+
+TEST(test_compressor, round_trip)
+{
+    std::mt19937 random(42);
+    std::vector<abacus::compressor> compressors = {
+        abacus::compressor{abacus::codec::none},
+        abacus::compressor{abacus::codec::zero_run},
+        abacus::compressor{abacus::codec::lz}};
+
+    for (std::size_t size : {0, 1, 7, 8, 9, 100, 2048, 5000})
+    {
+        // Mixed runs of zeros, random bytes and repeated patterns
+        std::vector<uint8_t> data(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            switch ((i / 64) % 3)
+            {
+            case 0:
+                data[i] = 0;
+                break;
+            case 1:
+                data[i] = static_cast<uint8_t>(random());
+                break;
+            default:
+                data[i] = static_cast<uint8_t>(i % 5);
+                break;
+            }
+        }
+        for (const auto& compressor : compressors)
+        {
+            SCOPED_TRACE(size);
+            round_trip(compressor, data);
+        }
+    }
+
+    // Runs longer than a run count and matches longer than a length byte
+    std::vector<uint8_t> zeros(100000, 0);
+    for (const auto& compressor : compressors)
+    {
+        round_trip(compressor, zeros);
+    }
+    std::vector<uint8_t> ones(100000, 1);
+    for (const auto& compressor : compressors)
+    {
+        round_trip(compressor, ones);
+    }
+
+    // Random data is stored as is
+    std::vector<uint8_t> noise(1000);
+    for (auto& byte : noise)
+    {
+        byte = static_cast<uint8_t>(random());
+    }
+    for (const auto& compressor : compressors)
+    {
+        auto frame = round_trip(compressor, noise);
+        EXPECT_EQ(static_cast<uint8_t>(abacus::codec::none), frame[0]);
+    }
+}
+
+TEST(test_compressor, invalid)
+{
+    std::vector<uint8_t> data(1000, 0);
+    for (std::size_t i = 0; i < data.size(); i += 10)
+    {
+        data[i] = static_cast<uint8_t>(i);
+    }
+
+    for (auto codec : {abacus::codec::zero_run, abacus::codec::lz})
+    {
+        abacus::compressor compressor(codec);
+        std::vector<uint8_t> frame;
+        compressor.compress(data.data(), data.size(), frame);
+        ASSERT_EQ(static_cast<uint8_t>(codec), frame[0]);
+
+        // Truncated frames are rejected
+        std::vector<uint8_t> result(data.size());
+        for (std::size_t size = 0; size < frame.size(); ++size)
+        {
+            EXPECT_FALSE(abacus::decompress(frame.data(), size, result.data(),
+                                            result.size()))
+                << size;
+        }
+
+        // A wrong size is rejected
+        EXPECT_FALSE(abacus::decompress(frame.data(), frame.size(),
+                                        result.data(), result.size() - 1));
+
+        // Corrupted frames are rejected or decompressed within bounds
+        for (std::size_t i = 1; i < frame.size(); ++i)
+        {
+            auto corrupted = frame;
+            corrupted[i] ^= 0xFF;
+            auto bytes =
+                abacus::decompressed_bytes(corrupted.data(), corrupted.size());
+            if (bytes.has_value() && bytes.value() <= 2 * data.size())
+            {
+                std::vector<uint8_t> output(bytes.value());
+                (void)abacus::decompress(corrupted.data(), corrupted.size(),
+                                         output.data(), output.size());
+            }
+        }
+    }
+
+    // Unknown codecs are rejected
+    std::vector<uint8_t> frame = {200, 1, 0};
+    uint8_t byte;
+    EXPECT_FALSE(abacus::decompress(frame.data(), frame.size(), &byte, 1));
+    EXPECT_FALSE(abacus::decompressed_bytes(frame.data(), 1).has_value());
+}
+
+TEST(test_compressor, custom_codec)
+{
+    // A codec storing every other byte of data where the odd bytes are zero
+    abacus::custom_codec codec;
+    codec.id = abacus::custom_codec::first_id + 1;
+    codec.bound = [](std::size_t bytes) { return (bytes + 1) / 2; };
+    codec.compress = [](const uint8_t* data, std::size_t bytes,
+                        uint8_t* compressed) -> std::size_t
+    {
+        for (std::size_t i = 1; i < bytes; i += 2)
+        {
+            if (data[i] != 0)
+            {
+                return 0;
+            }
+        }
+        for (std::size_t i = 0; i < bytes; i += 2)
+        {
+            compressed[i / 2] = data[i];
+        }
+        return (bytes + 1) / 2;
+    };
+    codec.decompress = [](const uint8_t* compressed,
+                          std::size_t compressed_bytes, uint8_t* data,
+                          std::size_t bytes)
+    {
+        if (compressed_bytes != (bytes + 1) / 2)
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < bytes; ++i)
+        {
+            data[i] = i % 2 == 0 ? compressed[i / 2] : 0;
+        }
+        return true;
+    };
+
+    abacus::compressor compressor(codec);
+    EXPECT_EQ(codec.id, compressor.id());
+
+    std::vector<uint8_t> data = {1, 0, 2, 0, 3, 0, 4, 0, 5, 0};
+    std::vector<uint8_t> frame;
+    compressor.compress(data.data(), data.size(), frame);
+    EXPECT_EQ(codec.id, frame[0]);
+    EXPECT_EQ(2U + 5U, frame.size());
+
+    // The frame can only be decompressed with the codec
+    std::vector<uint8_t> result(data.size());
+    EXPECT_FALSE(abacus::decompress(frame.data(), frame.size(), result.data(),
+                                    result.size()));
+    ASSERT_TRUE(abacus::decompress(frame.data(), frame.size(), result.data(),
+                                   result.size(), codec));
+    EXPECT_EQ(data, result);
+
+    // Data the codec cannot compress is stored as is
+    data[1] = 1;
+    compressor.compress(data.data(), data.size(), frame);
+    EXPECT_EQ(static_cast<uint8_t>(abacus::codec::none), frame[0]);
+    ASSERT_TRUE(abacus::decompress(frame.data(), frame.size(), result.data(),
+                                   result.size(), codec));
+    EXPECT_EQ(data, result);
+}
@@ -0,0 +1,439 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <abacus/buffered_counter.hpp>
+#include <abacus/exporter.hpp>
+#include <abacus/metrics.hpp>
+#include <abacus/view.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+// Reads a little endian number of a record
+uint64_t read_little_endian(const std::vector<uint8_t>& data,
+                            std::size_t offset, std::size_t bytes)
+{
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < bytes; ++i)
+    {
+        value |= static_cast<uint64_t>(data[offset + i]) << (8 * i);
+    }
+    return value;
+}
+
+// A record written by the built-in sinks
+struct record
+{
+    uint8_t type;
+    uint32_t source;
+    std::vector<uint8_t> payload;
+};
+
+std::vector<record> parse_records(const std::vector<uint8_t>& data)
+{
+    std::vector<record> records;
+    std::size_t offset = 0;
+    while (offset + 17 <= data.size())
+    {
+        record r;
+        r.type = data[offset];
+        r.source =
+            static_cast<uint32_t>(read_little_endian(data, offset + 1, 4));
+        auto size = read_little_endian(data, offset + 13, 4);
+        offset += 17;
+        EXPECT_LE(offset + size, data.size());
+        r.payload.assign(data.begin() + offset,
+                         data.begin() + offset + size);
+        offset += size;
+        records.push_back(std::move(r));
+    }
+    EXPECT_EQ(data.size(), offset);
+    return records;
+}
+}
+
+TEST(test_exporter, value_data)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}}};
+
+    abacus::metrics metrics(infos);
+    auto bytes = metrics.initialize<abacus::uint64>("bytes");
+    bytes = 10;
+
+    std::vector<abacus::exporter::snapshot> snapshots;
+    abacus::exporter exporter(std::chrono::seconds(1), 4);
+    exporter.add_sink([&](const abacus::exporter::snapshot& s)
+                      { snapshots.push_back(s); });
+    auto source = exporter.add(metrics);
+
+    // A stopped exporter delivers on the calling thread
+    exporter.flush();
+    bytes = 20;
+    exporter.flush();
+    ASSERT_EQ(2U, snapshots.size());
+    EXPECT_EQ(2U, exporter.delivered());
+    EXPECT_EQ(0U, exporter.dropped());
+    EXPECT_LE(snapshots[0].time, snapshots[1].time);
+    EXPECT_EQ(0U, snapshots[0].sequence);
+    EXPECT_EQ(1U, snapshots[1].sequence);
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metrics.metadata()));
+    for (std::size_t i = 0; i < snapshots.size(); ++i)
+    {
+        const auto& s = snapshots[i];
+        EXPECT_EQ(source, s.source);
+        EXPECT_EQ(abacus::exporter::encoding::value_data, s.encoding);
+        EXPECT_EQ(metrics.schema()->sync_value(), s.sync_value);
+        ASSERT_NE(nullptr, s.metadata);
+        EXPECT_EQ(std::vector<uint8_t>(metrics.metadata_data(),
+                                       metrics.metadata_data() +
+                                           metrics.metadata_bytes()),
+                  *s.metadata);
+        ASSERT_TRUE(view.set_value_data(s.data.data(), s.data.size()));
+        EXPECT_EQ(10U * (i + 1), view.value<abacus::uint64>("bytes").value());
+    }
+
+    // Removed metrics are no longer exported
+    exporter.remove(source);
+    exporter.flush();
+    EXPECT_EQ(2U, snapshots.size());
+}
+
+TEST(test_exporter, json)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}}};
+
+    abacus::metrics metrics(infos);
+    metrics.initialize<abacus::uint64>("bytes").set_value(42);
+
+    std::vector<std::string> documents;
+    abacus::exporter exporter(std::chrono::seconds(1), 4,
+                              abacus::exporter::encoding::minimal_json);
+    exporter.add_sink(
+        [&](const abacus::exporter::snapshot& s)
+        {
+            EXPECT_EQ(abacus::exporter::encoding::minimal_json, s.encoding);
+            documents.emplace_back(s.data.begin(), s.data.end());
+        });
+    exporter.add(metrics);
+    exporter.flush();
+
+    ASSERT_EQ(1U, documents.size());
+    EXPECT_EQ(R"({"bytes":42,"up":null})", documents[0]);
+}
+
+TEST(test_exporter, add_flush)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}}};
+
+    abacus::metrics metrics(infos);
+    auto bytes = metrics.initialize<abacus::uint64>("bytes");
+    bytes = 0U;
+    abacus::buffered_counter<abacus::uint64> counter(bytes, 1000);
+    auto local = counter.make_local();
+
+    std::vector<uint64_t> values;
+    abacus::exporter exporter(std::chrono::seconds(1), 4);
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metrics.metadata()));
+    exporter.add_sink(
+        [&](const abacus::exporter::snapshot& s)
+        {
+            ASSERT_TRUE(view.set_value_data(s.data.data(), s.data.size()));
+            values.push_back(view.value<abacus::uint64>("bytes").value());
+        });
+    exporter.add(metrics);
+
+    // The increments below the threshold are not in the value data
+    local += 10;
+    exporter.flush();
+
+    // The buffered increments are written before the value data is copied
+    exporter.add_flush([&counter] { counter.flush(); });
+    exporter.flush();
+    local += 5;
+    exporter.flush();
+    EXPECT_EQ((std::vector<uint64_t>{0, 10, 15}), values);
+}
+
+TEST(test_exporter, overflow)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}}};
+
+    abacus::metrics metrics0(infos);
+    abacus::metrics metrics1(infos);
+    abacus::metrics metrics2(infos);
+
+    // A stopped exporter takes the snapshots of all metrics before they are
+    // delivered, so a queue of two overflows with three metrics
+    auto export_sources = [&](abacus::exporter::overflow overflow)
+    {
+        std::vector<std::size_t> sources;
+        abacus::exporter exporter(std::chrono::seconds(1), 2,
+                                  abacus::exporter::encoding::value_data,
+                                  overflow);
+        exporter.add_sink([&](const abacus::exporter::snapshot& s)
+                          { sources.push_back(s.source); });
+        exporter.add(metrics0);
+        exporter.add(metrics1);
+        exporter.add(metrics2);
+        exporter.flush();
+        EXPECT_EQ(1U, exporter.dropped());
+        EXPECT_EQ(2U, exporter.delivered());
+        return sources;
+    };
+
+    using sources = std::vector<std::size_t>;
+    EXPECT_EQ((sources{0, 1}),
+              export_sources(abacus::exporter::overflow::drop_newest));
+    EXPECT_EQ((sources{1, 2}),
+              export_sources(abacus::exporter::overflow::drop_oldest));
+
+    // Without a queued snapshot of the same metrics the oldest is dropped
+    EXPECT_EQ((sources{1, 2}),
+              export_sources(abacus::exporter::overflow::coalesce));
+}
+
+TEST(test_exporter, thread)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}}};
+
+    abacus::metrics metrics0(infos);
+    abacus::metrics metrics1(infos);
+    metrics0.initialize<abacus::uint64>("bytes").set_value(1);
+
+    for (auto overflow : {abacus::exporter::overflow::drop_newest,
+                          abacus::exporter::overflow::drop_oldest,
+                          abacus::exporter::overflow::coalesce})
+    {
+        std::mutex mutex;
+        std::vector<abacus::exporter::snapshot> snapshots;
+        abacus::exporter exporter(std::chrono::milliseconds(1), 2,
+                                  abacus::exporter::encoding::value_data,
+                                  overflow);
+
+        // A slow sink makes the queue overflow
+        exporter.add_sink(
+            [&](const abacus::exporter::snapshot& s)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                std::lock_guard<std::mutex> lock(mutex);
+                snapshots.push_back(s);
+            });
+        exporter.add(metrics0);
+        exporter.add(metrics1);
+        exporter.start();
+        EXPECT_TRUE(exporter.is_running());
+
+        auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (exporter.dropped() == 0 || exporter.delivered() < 4)
+        {
+            ASSERT_LT(std::chrono::steady_clock::now(), deadline);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        exporter.flush();
+        exporter.stop();
+        EXPECT_FALSE(exporter.is_running());
+
+        // The snapshots of each metrics are delivered in the order of time
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(exporter.delivered(), snapshots.size());
+        for (std::size_t source = 0; source < 2; ++source)
+        {
+            abacus::exporter::wall_clock::time_point last;
+            uint64_t sequence = 0;
+            for (const auto& s : snapshots)
+            {
+                if (s.source == source)
+                {
+                    EXPECT_LE(last, s.time);
+                    EXPECT_LE(sequence, s.sequence);
+                    last = s.time;
+                    sequence = s.sequence;
+                }
+            }
+        }
+    }
+}
+
+TEST(test_exporter, file_sink)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}}};
+
+    abacus::metrics metrics(infos);
+    metrics.initialize<abacus::uint64>("bytes").set_value(7);
+
+    const std::string path =
+        ::testing::TempDir() + "abacus_test_exporter_file_sink";
+    std::remove(path.c_str());
+    {
+        auto sink = abacus::exporter::file_sink(path);
+        ASSERT_TRUE(sink);
+        abacus::exporter exporter(std::chrono::seconds(1), 4);
+        exporter.add_sink(sink);
+        exporter.add(metrics);
+        exporter.flush();
+        exporter.flush();
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)),
+                              std::istreambuf_iterator<char>());
+    file.close();
+    std::remove(path.c_str());
+
+    // The meta data is only written before the first value data
+    auto records = parse_records(data);
+    ASSERT_EQ(3U, records.size());
+    EXPECT_EQ(0U, records[0].type);
+    EXPECT_EQ(std::vector<uint8_t>(metrics.metadata_data(),
+                                   metrics.metadata_data() +
+                                       metrics.metadata_bytes()),
+              records[0].payload);
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(records[0].payload.data(),
+                                  records[0].payload.size()));
+    for (std::size_t i = 1; i < records.size(); ++i)
+    {
+        EXPECT_EQ(1U, records[i].type);
+        EXPECT_EQ(0U, records[i].source);
+        ASSERT_TRUE(view.set_value_data(records[i].payload.data(),
+                                        records[i].payload.size()));
+        EXPECT_EQ(7U, view.value<abacus::uint64>("bytes").value());
+    }
+
+    // JSON is written one snapshot per line
+    {
+        auto sink = abacus::exporter::file_sink(path);
+        ASSERT_TRUE(sink);
+        abacus::exporter exporter(std::chrono::seconds(1), 4,
+                                  abacus::exporter::encoding::minimal_json);
+        exporter.add_sink(sink);
+        exporter.add(metrics);
+        exporter.flush();
+        exporter.flush();
+    }
+    std::ifstream lines(path);
+    std::string line;
+    std::size_t count = 0;
+    while (std::getline(lines, line))
+    {
+        EXPECT_EQ('{', line.front());
+        EXPECT_EQ('}', line.back());
+        ++count;
+    }
+    EXPECT_EQ(2U, count);
+    lines.close();
+    std::remove(path.c_str());
+
+    // A file which cannot be opened gives no sink
+    EXPECT_FALSE(abacus::exporter::file_sink(path + "/missing/file"));
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST(test_exporter, unix_socket_sink)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}}};
+
+    abacus::metrics metrics(infos);
+    metrics.initialize<abacus::uint64>("bytes").set_value(3);
+
+    const std::string path =
+        ::testing::TempDir() + "abacus_test_exporter.sock";
+    ::unlink(path.c_str());
+
+    auto sink = abacus::exporter::unix_socket_sink(path);
+    ASSERT_TRUE(sink);
+    abacus::exporter exporter(std::chrono::seconds(1), 4);
+    exporter.add_sink(sink);
+    exporter.add(metrics);
+
+    // Snapshots are dropped while nobody listens
+    exporter.flush();
+    EXPECT_EQ(1U, exporter.delivered());
+
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::snprintf(address.sun_path, sizeof(address.sun_path), "%s",
+                  path.c_str());
+    ASSERT_EQ(0, ::bind(listener, reinterpret_cast<sockaddr*>(&address),
+                        sizeof(address)));
+    ASSERT_EQ(0, ::listen(listener, 1));
+
+    // The sink connects and the records fit in the socket buffer
+    exporter.flush();
+    exporter.flush();
+    int connection = ::accept(listener, nullptr, nullptr);
+    ASSERT_GE(connection, 0);
+    ::shutdown(connection, SHUT_WR);
+
+    const std::size_t record_bytes = 17 + metrics.value_bytes();
+    const std::size_t expected =
+        17 + metrics.metadata_bytes() + 2 * record_bytes;
+    std::vector<uint8_t> data(expected);
+    std::size_t received = 0;
+    while (received < expected)
+    {
+        auto result = ::recv(connection, data.data() + received,
+                             expected - received, 0);
+        ASSERT_GT(result, 0);
+        received += static_cast<std::size_t>(result);
+    }
+    ::close(connection);
+    ::close(listener);
+    ::unlink(path.c_str());
+
+    auto records = parse_records(data);
+    ASSERT_EQ(3U, records.size());
+    EXPECT_EQ(0U, records[0].type);
+    EXPECT_EQ(1U, records[1].type);
+    EXPECT_EQ(1U, records[2].type);
+
+    // The sink survives the closed connection
+    exporter.flush();
+    EXPECT_EQ(4U, exporter.delivered());
+}
+#endif
@@ -0,0 +1,149 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <cstring>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <abacus/framer.hpp>
+#include <abacus/metrics.hpp>
+#include <abacus/view.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+// Gathers the spans of a frame into one buffer
+std::vector<uint8_t> gather(const abacus::framer& framer)
+{
+    std::vector<uint8_t> bytes;
+    for (std::size_t i = 0; i < framer.span_count(); ++i)
+    {
+        const auto& span = framer.spans()[i];
+        bytes.insert(bytes.end(), span.data, span.data + span.size);
+    }
+    EXPECT_EQ(framer.bytes(), bytes.size());
+    return bytes;
+}
+}
+
+TEST(test_framer, metrics)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}}};
+    abacus::metrics metrics(infos);
+    metrics.initialize<abacus::uint64>("bytes").set_value(99);
+
+    // The spans point at the memory of the metrics
+    abacus::framer framer;
+    framer.frame(metrics, true);
+    ASSERT_EQ(3U, framer.span_count());
+    EXPECT_EQ(abacus::framer::header_bytes, framer.spans()[0].size);
+    EXPECT_EQ(metrics.metadata_data(), framer.spans()[1].data);
+    EXPECT_EQ(metrics.metadata_bytes(), framer.spans()[1].size);
+    EXPECT_EQ(metrics.value_data(), framer.spans()[2].data);
+    EXPECT_EQ(metrics.value_bytes(), framer.spans()[2].size);
+
+    auto bytes = gather(framer);
+    EXPECT_EQ(bytes.size(), abacus::frame_bytes(bytes.data(), 4).value());
+    abacus::received_frame frame;
+    ASSERT_TRUE(abacus::read_frame(bytes.data(), bytes.size(), frame));
+    ASSERT_NE(nullptr, frame.metadata_data);
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(frame.metadata_data, frame.metadata_bytes));
+    ASSERT_TRUE(view.set_value_data(frame.value_data, frame.value_bytes));
+    EXPECT_EQ(99U, view.value<abacus::uint64>("bytes").value());
+
+    // The following frames only need the value data
+    metrics.initialize<abacus::boolean>("up").set_value(true);
+    framer.frame(metrics, false);
+    ASSERT_EQ(2U, framer.span_count());
+    bytes = gather(framer);
+    ASSERT_TRUE(abacus::read_frame(bytes.data(), bytes.size(), frame));
+    EXPECT_EQ(nullptr, frame.metadata_data);
+    EXPECT_EQ(0U, frame.metadata_bytes);
+    ASSERT_TRUE(view.set_value_data(frame.value_data, frame.value_bytes));
+    EXPECT_TRUE(view.value<abacus::boolean>("up").value());
+}
+
+TEST(test_framer, checksum)
+{
+    // The checksum is the CRC-32C of the header after the checksum and the
+    // data
+    const uint8_t data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    abacus::framer framer;
+    framer.frame(nullptr, 0, data, sizeof(data));
+    auto bytes = gather(framer);
+    ASSERT_EQ(16U + 9U, bytes.size());
+    const std::vector<uint8_t> header = {25 - 4, 0, 0, 0, 0x96, 0x85, 0xea,
+                                         0xdd,   1, 0, 0, 0, 0,    0,    0,
+                                         0};
+    EXPECT_EQ(header, std::vector<uint8_t>(bytes.begin(), bytes.begin() + 16));
+
+    // Every corrupted or missing byte is detected
+    abacus::received_frame frame;
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        for (uint8_t bit = 1; bit != 0; bit <<= 1)
+        {
+            auto corrupted = bytes;
+            corrupted[i] ^= bit;
+            EXPECT_FALSE(abacus::read_frame(corrupted.data(), corrupted.size(),
+                                            frame));
+        }
+        EXPECT_FALSE(abacus::read_frame(bytes.data(), i, frame));
+    }
+    EXPECT_FALSE(abacus::frame_bytes(bytes.data(), 3).has_value());
+    ASSERT_TRUE(abacus::read_frame(bytes.data(), bytes.size(), frame));
+    EXPECT_EQ(0, std::memcmp(data, frame.value_data, sizeof(data)));
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST(test_framer, writev)
+{
+    std::vector<uint8_t> metadata(1000, 7);
+    std::vector<uint8_t> values(3000, 3);
+    abacus::framer framer;
+    framer.frame(metadata.data(), metadata.size(), values.data(),
+                 values.size());
+
+    int sockets[2];
+    ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets));
+    iovec iovecs[abacus::framer::max_spans];
+    auto count = framer.to_iovecs(iovecs);
+    ASSERT_EQ(3U, count);
+    auto sent = ::writev(sockets[0], iovecs, static_cast<int>(count));
+    ASSERT_EQ(static_cast<ssize_t>(framer.bytes()), sent);
+
+    std::vector<uint8_t> received(framer.bytes());
+    std::size_t offset = 0;
+    while (offset < received.size())
+    {
+        auto result = ::read(sockets[1], received.data() + offset,
+                             received.size() - offset);
+        ASSERT_GT(result, 0);
+        offset += static_cast<std::size_t>(result);
+    }
+    ::close(sockets[0]);
+    ::close(sockets[1]);
+
+    abacus::received_frame frame;
+    ASSERT_TRUE(abacus::read_frame(received.data(), received.size(), frame));
+    EXPECT_EQ(metadata, std::vector<uint8_t>(frame.metadata_data,
+                                             frame.metadata_data +
+                                                 frame.metadata_bytes));
+    EXPECT_EQ(values, std::vector<uint8_t>(frame.value_data,
+                                           frame.value_data +
+                                               frame.value_bytes));
+}
+#endif
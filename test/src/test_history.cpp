@@ -0,0 +1,79 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <chrono>
+#include <gtest/gtest.h>
+
+#include <abacus/history.hpp>
+#include <abacus/metrics.hpp>
+#include <abacus/view.hpp>
+
+TEST(test_history, ring)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}}};
+    abacus::metrics metrics(infos);
+    auto bytes = metrics.initialize<abacus::uint64>("bytes");
+
+    abacus::history history(metrics.schema(), 3);
+    EXPECT_EQ(3U, history.capacity());
+    EXPECT_EQ(0U, history.size());
+    EXPECT_EQ(metrics.value_bytes(), history.value_bytes());
+
+    using namespace std::chrono_literals;
+    const abacus::history::clock::time_point start;
+    for (uint64_t i = 0; i < 5; ++i)
+    {
+        bytes = i;
+        history.record(metrics, start + i * 10ms);
+    }
+
+    // The oldest snapshots have been overwritten
+    ASSERT_EQ(3U, history.size());
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metrics.metadata()));
+    for (std::size_t index = 0; index < history.size(); ++index)
+    {
+        EXPECT_EQ(start + (index + 2) * 10ms, history.time(index));
+        ASSERT_TRUE(history.read(index, view));
+        EXPECT_EQ(index + 2, view.value<abacus::uint64>("bytes").value());
+        EXPECT_FALSE(view.value<abacus::boolean>("up").has_value());
+    }
+
+    // A view with other meta data cannot read the snapshots
+    abacus::view other;
+    EXPECT_FALSE(history.read(0, other));
+
+    // The snapshots within a time window
+    EXPECT_EQ(std::make_pair(std::size_t{0}, std::size_t{3}),
+              history.window(start, start + 1h));
+    EXPECT_EQ(std::make_pair(std::size_t{1}, std::size_t{3}),
+              history.window(start + 25ms, start + 40ms));
+    EXPECT_EQ(std::make_pair(std::size_t{1}, std::size_t{2}),
+              history.window(start + 30ms, start + 30ms));
+    EXPECT_EQ(std::make_pair(std::size_t{3}, std::size_t{3}),
+              history.window(start + 41ms, start + 1h));
+    EXPECT_EQ(std::make_pair(std::size_t{0}, std::size_t{0}),
+              history.window(start, start + 19ms));
+    EXPECT_EQ(std::make_pair(std::size_t{2}, std::size_t{2}),
+              history.window(start + 35ms, start + 31ms));
+
+    // Raw value data can be recorded as well
+    std::vector<uint8_t> data(history.value_data(0),
+                              history.value_data(0) + history.value_bytes());
+    history.record(data.data(), start + 50ms);
+    ASSERT_TRUE(history.read(2, view));
+    EXPECT_EQ(2U, view.value<abacus::uint64>("bytes").value());
+    EXPECT_EQ(3U, history.size());
+
+    history.clear();
+    EXPECT_EQ(0U, history.size());
+    history.record(metrics);
+    ASSERT_TRUE(history.read(0, view));
+    EXPECT_EQ(4U, view.value<abacus::uint64>("bytes").value());
+}
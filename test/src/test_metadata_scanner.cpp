@@ -0,0 +1,167 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <abacus/metadata_scanner.hpp>
+#include <abacus/metrics.hpp>
+#include <abacus/view.hpp>
+
+#include <google/protobuf/util/message_differencer.h>
+
+namespace
+{
+enum class test_enum
+{
+    value0 = 0,
+    value1 = 1
+};
+}
+
+TEST(test_metadata_scanner, scan)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{"Bytes"},
+                        abacus::unit{"bytes"}}},
+        {abacus::name{"delta"},
+         abacus::int32{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"state"},
+         abacus::enum8{abacus::description{"The state"},
+                       {{test_enum::value0, {"idle", ""}},
+                        {test_enum::value1, {"busy", "Working"}}}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{"Up"}}},
+        {abacus::name{"version"},
+         abacus::constant{abacus::constant::str{"1.0"},
+                          abacus::description{"Version"}}}};
+    abacus::metrics metrics(infos);
+
+    abacus::metadata_scanner scanner;
+    ASSERT_TRUE(
+        scanner.scan(metrics.metadata_data(), metrics.metadata_bytes()));
+    EXPECT_EQ(metrics.metadata().protocol_version(),
+              scanner.protocol_version());
+    EXPECT_EQ(metrics.metadata().endianness(), scanner.endianness());
+    EXPECT_EQ(metrics.metadata().sync_value(), scanner.sync_value());
+
+    // The ids, types and offsets match the view
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metrics.metadata()));
+    ASSERT_EQ(view.count(), scanner.count());
+    for (std::size_t id = 0; id < view.count(); ++id)
+    {
+        EXPECT_EQ(view.metric_name(id), scanner.metric_name(id));
+        EXPECT_EQ(view.metric(id).type_case(), scanner.type(id));
+        EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
+            view.metric(id), scanner.metric(id)));
+    }
+    EXPECT_EQ(view.metric("bytes").uint64().offset(),
+              scanner.offset(scanner.id("bytes")));
+    EXPECT_EQ(view.metric("up").boolean().offset(),
+              scanner.offset(scanner.id("up")));
+    EXPECT_EQ(0U, scanner.offset(scanner.id("version")));
+
+    // The names point into the serialized meta data
+    auto name = scanner.metric_name(0);
+    auto* begin = reinterpret_cast<const char*>(metrics.metadata_data());
+    EXPECT_GE(name.data(), begin);
+    EXPECT_LT(name.data(), begin + metrics.metadata_bytes());
+
+    // The descriptive fields are read on demand
+    EXPECT_EQ("Bytes", scanner.description(scanner.id("bytes")));
+    EXPECT_EQ("bytes", scanner.unit(scanner.id("bytes")).value());
+    EXPECT_EQ("", scanner.description(scanner.id("delta")));
+    EXPECT_FALSE(scanner.unit(scanner.id("delta")).has_value());
+    EXPECT_EQ("Up", scanner.description(scanner.id("up")));
+    EXPECT_EQ("The state", scanner.description(scanner.id("state")));
+    EXPECT_EQ("Version", scanner.description(scanner.id("version")));
+    EXPECT_EQ(abacus::protobuf::Metric::kConstant,
+              scanner.type(scanner.id("version")));
+
+    EXPECT_THROW(scanner.id("unknown"), std::out_of_range);
+}
+
+TEST(test_metadata_scanner, string_table)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{"Bytes"},
+                        abacus::unit{"bytes"}}},
+        {abacus::name{"state0"},
+         abacus::enum8{abacus::description{"The state"},
+                       {{test_enum::value0, {"idle", ""}},
+                        {test_enum::value1, {"busy", "Working"}}}}},
+        {abacus::name{"state1"},
+         abacus::enum8{abacus::description{"The state"},
+                       {{test_enum::value0, {"idle", ""}},
+                        {test_enum::value1, {"busy", "Working"}}}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{"Up"}}},
+        {abacus::name{"version"},
+         abacus::constant{abacus::constant::str{"1.0"},
+                          abacus::description{"Bytes"}}}};
+    abacus::metrics metrics(infos, abacus::metadata_encoding::string_table);
+
+    abacus::metadata_scanner scanner;
+    ASSERT_TRUE(
+        scanner.scan(metrics.metadata_data(), metrics.metadata_bytes()));
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metrics.metadata()));
+    ASSERT_EQ(view.count(), scanner.count());
+    for (std::size_t id = 0; id < view.count(); ++id)
+    {
+        EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
+            view.metric(id), scanner.metric(id)));
+    }
+
+    // The descriptive fields point into the string table
+    EXPECT_EQ("Bytes", scanner.description(scanner.id("bytes")));
+    EXPECT_EQ("bytes", scanner.unit(scanner.id("bytes")).value());
+    EXPECT_EQ("Bytes", scanner.description(scanner.id("version")));
+    EXPECT_EQ(scanner.description(scanner.id("bytes")).data(),
+              scanner.description(scanner.id("version")).data());
+    EXPECT_EQ("The state", scanner.description(scanner.id("state1")));
+    EXPECT_FALSE(scanner.unit(scanner.id("up")).has_value());
+
+    // References past the end are rejected
+    std::vector<uint8_t> data(metrics.metadata_data(),
+                              metrics.metadata_data() +
+                                  metrics.metadata_bytes());
+    data.push_back(0x38);
+    data.push_back(0x00);
+    EXPECT_FALSE(scanner.scan(data.data(), data.size()));
+    EXPECT_EQ(0U, scanner.count());
+}
+
+TEST(test_metadata_scanner, invalid)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{"Bytes"}}}};
+    abacus::metrics metrics(infos);
+    std::vector<uint8_t> data(metrics.metadata_data(),
+                              metrics.metadata_data() +
+                                  metrics.metadata_bytes());
+
+    abacus::metadata_scanner scanner;
+    ASSERT_TRUE(scanner.scan(data.data(), data.size()));
+    EXPECT_EQ(1U, scanner.count());
+
+    // Truncated buffers are rejected like by the protobuf parser
+    for (std::size_t size = 1; size < data.size(); ++size)
+    {
+        abacus::protobuf::MetricsMetadata metadata;
+        if (!metadata.ParseFromArray(data.data(), static_cast<int>(size)))
+        {
+            EXPECT_FALSE(scanner.scan(data.data(), size)) << size;
+            EXPECT_EQ(0U, scanner.count());
+        }
+    }
+
+    std::vector<uint8_t> invalid(8, 0xFF);
+    EXPECT_FALSE(scanner.scan(invalid.data(), invalid.size()));
+}
@@ -223,6 +223,85 @@ TEST(test_metrics, value_and_metadata_bytes)
     );
 }
 
+TEST(test_metrics, ids)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"conn.tx.bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"conn.rx.bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"conn.id"},
+         abacus::constant{abacus::constant::uint64{42},
+                          abacus::description{""}}}};
+
+    abacus::metrics metrics(infos);
+
+    // Ids are assigned in lexicographical order of the names
+    ASSERT_EQ(3U, metrics.count());
+    EXPECT_EQ("conn.id", metrics.metric_name(0));
+    EXPECT_EQ("conn.rx.bytes", metrics.metric_name(1));
+    EXPECT_EQ("conn.tx.bytes", metrics.metric_name(2));
+    EXPECT_EQ(2U, metrics.id("conn.tx.bytes"));
+    EXPECT_THROW((void)metrics.id("conn.unknown"), std::out_of_range);
+    EXPECT_FALSE(metrics.is_initialized("conn.unknown"));
+
+    // Constants are always initialized
+    EXPECT_TRUE(metrics.is_initialized(0));
+    EXPECT_FALSE(metrics.is_initialized(1));
+
+    auto rx = metrics.initialize<abacus::uint64>(1).set_value(10U);
+    auto tx = metrics.initialize<abacus::uint64>("conn.tx.bytes");
+    tx = 20U;
+    EXPECT_TRUE(metrics.is_initialized(1));
+    EXPECT_TRUE(metrics.is_initialized());
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metrics.metadata()));
+    ASSERT_TRUE(
+        view.set_value_data(metrics.value_data(), metrics.value_bytes()));
+
+    // The view assigns the same ids
+    ASSERT_EQ(metrics.count(), view.count());
+    for (std::size_t id = 0; id < metrics.count(); ++id)
+    {
+        EXPECT_EQ(metrics.metric_name(id), view.metric_name(id));
+    }
+    EXPECT_EQ(42U, view.value<abacus::constant::uint64>(0));
+    EXPECT_EQ(rx.value(), view.value<abacus::uint64>(1).value());
+    EXPECT_EQ(tx.value(), view.value<abacus::uint64>(2).value());
+}
+
+TEST(test_metrics, metadata_data)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"metric0"},
+         abacus::uint64{abacus::kind::counter,
+                        abacus::description{"An unsigned integer metric"},
+                        abacus::unit{"bytes"}}},
+        {abacus::name{"metric1"},
+         abacus::enum8{abacus::description{"An enum metric"},
+                       {{test_enum::value0, {"value0", "The value for 0"}},
+                        {test_enum::value1, {"value1", ""}}}}},
+        {abacus::name{"metric2"},
+         abacus::constant{abacus::constant::str{"hello"},
+                          abacus::description{"A string metric"}}}};
+
+    abacus::metrics metrics{infos};
+
+    // The serialized metadata must contain the final sync value
+    auto parsed = abacus::parse_metadata(metrics.metadata_data(),
+                                         metrics.metadata_bytes());
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(metrics.metadata().ByteSizeLong(), metrics.metadata_bytes());
+    EXPECT_NE(parsed.value().sync_value(), 1U);
+    EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
+        metrics.metadata(), parsed.value()));
+
+    uint32_t sync_value = 0;
+    std::memcpy(&sync_value, metrics.value_data(), sizeof(sync_value));
+    EXPECT_EQ(parsed.value().sync_value(), sync_value);
+}
+
 TEST(test_metrics, reset_counters)
 {
     std::string name0 = "metric0";
@@ -547,3 +626,182 @@ TEST(test_metrics, reset)
 
     EXPECT_FALSE(view.value<abacus::uint64>("not_initialized").has_value());
 }
+
+TEST(test_metrics, sync_value)
+{
+    std::map<abacus::name, abacus::info> infos;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+        infos.emplace(abacus::name{"metric" + std::to_string(i)},
+                      abacus::uint64{abacus::kind::counter,
+                                     abacus::description{""}});
+    }
+
+    // The same info always gives the same meta data and sync value
+    abacus::metrics metrics1(infos);
+    abacus::metrics metrics2(infos);
+    EXPECT_EQ(metrics1.metadata().sync_value(),
+              metrics2.metadata().sync_value());
+    ASSERT_EQ(metrics1.metadata_bytes(), metrics2.metadata_bytes());
+    EXPECT_EQ(0, std::memcmp(metrics1.metadata_data(), metrics2.metadata_data(),
+                             metrics1.metadata_bytes()));
+}
+
+TEST(test_metrics, string_table)
+{
+    std::map<abacus::name, abacus::info> infos;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+        auto suffix = std::to_string(i);
+        infos.emplace(abacus::name{"bytes" + suffix},
+                      abacus::uint64{abacus::kind::counter,
+                                     abacus::description{"Bytes received"},
+                                     abacus::unit{"bytes"}});
+        infos.emplace(abacus::name{"state" + suffix},
+                      abacus::enum8{abacus::description{"The state"},
+                                    {{test_enum::value0, {"idle", ""}},
+                                     {test_enum::value1, {"busy", "Busy"}}}});
+    }
+    infos.emplace(abacus::name{"up"},
+                  abacus::boolean{abacus::description{"Up"}});
+    infos.emplace(abacus::name{"version"},
+                  abacus::constant{abacus::constant::str{"1.0"},
+                                   abacus::description{"Version"},
+                                   abacus::unit{"semver"}});
+
+    abacus::metrics inline_strings(infos);
+    abacus::metrics string_table(infos,
+                                 abacus::metadata_encoding::string_table);
+    EXPECT_LT(string_table.metadata_bytes() * 2,
+              inline_strings.metadata_bytes());
+
+    // Only the string table needs the new protocol version, readers of the
+    // previous version can still read the inline strings
+    EXPECT_EQ(2U, inline_strings.metadata().protocol_version());
+    EXPECT_EQ(3U, string_table.metadata().protocol_version());
+    EXPECT_EQ(2U, abacus::protocol_version());
+    EXPECT_EQ(3U, abacus::newest_protocol_version());
+    EXPECT_TRUE(abacus::is_supported_protocol_version(2));
+    EXPECT_TRUE(abacus::is_supported_protocol_version(3));
+    EXPECT_FALSE(abacus::is_supported_protocol_version(1));
+    EXPECT_FALSE(abacus::is_supported_protocol_version(4));
+
+    // The meta data of the metrics holds the strings in the metrics, also
+    // when serialized with a string table
+    auto expected = inline_strings.metadata();
+    expected.set_protocol_version(string_table.metadata().protocol_version());
+    expected.set_sync_value(string_table.metadata().sync_value());
+    EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
+        expected, string_table.metadata()));
+
+    // Parsing resolves the string table
+    auto parsed = abacus::parse_metadata(string_table.metadata_data(),
+                                         string_table.metadata_bytes());
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(0, parsed.value().strings_size());
+    EXPECT_EQ(0, parsed.value().references_size());
+    EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
+        string_table.metadata(), parsed.value()));
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(string_table.metadata_data(),
+                                  string_table.metadata_bytes()));
+    EXPECT_EQ("Bytes received", view.metric("bytes7").uint64().description());
+    EXPECT_EQ("bytes", view.metric("bytes7").uint64().unit());
+    const auto& state = view.metric("state42").enum8();
+    EXPECT_EQ("busy", state.values().at(1).name());
+    EXPECT_EQ("Busy", state.values().at(1).description());
+    EXPECT_FALSE(state.values().at(0).has_description());
+    EXPECT_FALSE(view.metric("up").boolean().has_unit());
+    EXPECT_EQ("semver", view.metric("version").constant().unit());
+
+    // References outside the string table are rejected
+    abacus::protobuf::MetricsMetadata invalid;
+    ASSERT_TRUE(invalid.ParseFromArray(
+        string_table.metadata_data(),
+        static_cast<int>(string_table.metadata_bytes())));
+    invalid.set_references(0, invalid.strings_size());
+    std::vector<uint8_t> data(invalid.ByteSizeLong());
+    ASSERT_TRUE(invalid.SerializeToArray(data.data(),
+                                         static_cast<int>(data.size())));
+    EXPECT_FALSE(abacus::parse_metadata(data.data(), data.size()));
+    EXPECT_FALSE(view.set_metadata(data.data(), data.size()));
+    EXPECT_FALSE(view.set_metadata(invalid));
+
+    // Missing references are rejected
+    invalid.set_references(0, 0);
+    invalid.mutable_references()->RemoveLast();
+    EXPECT_FALSE(view.set_metadata(invalid));
+}
+
+TEST(test_metrics, lean)
+{
+    std::map<abacus::name, abacus::info> infos;
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+        auto suffix = std::to_string(i);
+        infos.emplace(abacus::name{"bytes" + suffix},
+                      abacus::uint64{abacus::kind::counter,
+                                     abacus::description{"Bytes received"},
+                                     abacus::unit{"bytes"}});
+        infos.emplace(abacus::name{"state" + suffix},
+                      abacus::enum8{abacus::description{"The state"},
+                                    {{test_enum::value0, {"idle", ""}},
+                                     {test_enum::value1, {"busy", "Busy"}}}});
+    }
+
+    abacus::metrics string_table(infos,
+                                 abacus::metadata_encoding::string_table);
+    abacus::metrics lean(infos, abacus::metadata_encoding::lean);
+    EXPECT_LT(lean.metadata_bytes(), string_table.metadata_bytes());
+    EXPECT_GT(lean.dictionary_bytes(), 0U);
+    EXPECT_EQ(0U, string_table.dictionary_bytes());
+    EXPECT_EQ(string_table.metadata().sync_value(),
+              lean.metadata().sync_value());
+
+    auto bytes7 = lean.initialize<abacus::uint64>("bytes7").set_value(7U);
+    (void)bytes7;
+
+    // The values can be read with the lean meta data alone
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(lean.metadata_data(), lean.metadata_bytes()));
+    ASSERT_TRUE(view.set_value_data(lean.value_data(), lean.value_bytes()));
+    EXPECT_EQ(7U, view.value<abacus::uint64>("bytes7").value());
+    EXPECT_EQ("", view.metric("bytes7").uint64().description());
+    EXPECT_FALSE(view.metric("bytes7").uint64().has_unit());
+    EXPECT_EQ(0U, view.metric("state3").enum8().values().size());
+
+    // A dictionary of other meta data is rejected
+    EXPECT_FALSE(view.set_dictionary(lean.metadata_data(),
+                                     lean.metadata_bytes()));
+    abacus::protobuf::MetricsMetadata other;
+    ASSERT_TRUE(other.ParseFromArray(
+        lean.dictionary_data(), static_cast<int>(lean.dictionary_bytes())));
+    other.set_sync_value(other.sync_value() + 1);
+    std::vector<uint8_t> data(other.ByteSizeLong());
+    ASSERT_TRUE(
+        other.SerializeToArray(data.data(), static_cast<int>(data.size())));
+    EXPECT_FALSE(view.set_dictionary(data.data(), data.size()));
+
+    // Invalid references leave the view unchanged
+    other.set_sync_value(lean.metadata().sync_value());
+    other.mutable_references()->RemoveLast();
+    data.resize(other.ByteSizeLong());
+    ASSERT_TRUE(
+        other.SerializeToArray(data.data(), static_cast<int>(data.size())));
+    EXPECT_FALSE(view.set_dictionary(data.data(), data.size()));
+    EXPECT_EQ("", view.metric("bytes7").uint64().description());
+    EXPECT_EQ(0, view.metadata().strings_size());
+
+    // The dictionary adds the descriptive strings
+    ASSERT_TRUE(
+        view.set_dictionary(lean.dictionary_data(), lean.dictionary_bytes()));
+    EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
+        lean.metadata(), view.metadata()));
+    EXPECT_EQ(7U, view.value<abacus::uint64>("bytes7").value());
+
+    // A view without meta data cannot use a dictionary
+    abacus::view empty;
+    EXPECT_FALSE(
+        empty.set_dictionary(lean.dictionary_data(), lean.dictionary_bytes()));
+}
@@ -0,0 +1,115 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <abacus/aggregator.hpp>
+#include <abacus/metrics.hpp>
+#include <abacus/normalizer.hpp>
+#include <abacus/view.hpp>
+
+namespace
+{
+// Reverses the bytes of a value in the value data
+void reverse(std::vector<uint8_t>& data, std::size_t position,
+             std::size_t bytes)
+{
+    std::reverse(data.begin() + position, data.begin() + position + bytes);
+}
+}
+
+TEST(test_normalizer, foreign)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"delta"},
+         abacus::int32{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"loss"},
+         abacus::float64{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}},
+        {abacus::name{"version"},
+         abacus::constant{abacus::constant::uint64{2},
+                          abacus::description{""}}}};
+    abacus::metrics metrics(infos);
+    metrics.initialize<abacus::uint64>("bytes") = 0x0102030405060708U;
+    metrics.initialize<abacus::int32>("delta") = -42;
+    metrics.initialize<abacus::float64>("loss") = 0.125;
+    metrics.initialize<abacus::boolean>("up") = true;
+
+    // Make the buffer of a producer with the opposite byte order
+    abacus::view native;
+    ASSERT_TRUE(native.set_metadata(metrics.metadata()));
+    std::vector<uint8_t> data(metrics.value_data(),
+                              metrics.value_data() + metrics.value_bytes());
+    reverse(data, 0, 4);
+    reverse(data, native.metric("bytes").uint64().offset() + 1, 8);
+    reverse(data, native.metric("delta").int32().offset() + 1, 4);
+    reverse(data, native.metric("loss").float64().offset() + 1, 8);
+
+    auto foreign_metadata = metrics.metadata();
+    foreign_metadata.set_endianness(
+        metrics.metadata().endianness() == abacus::protobuf::Endianness::BIG
+            ? abacus::protobuf::Endianness::LITTLE
+            : abacus::protobuf::Endianness::BIG);
+
+    abacus::normalizer normalizer(foreign_metadata);
+    EXPECT_FALSE(normalizer.is_native());
+    EXPECT_EQ(metrics.metadata().endianness(),
+              normalizer.metadata().endianness());
+    EXPECT_EQ(metrics.value_bytes(), normalizer.value_bytes());
+
+    std::vector<uint8_t> normalized(data.size());
+    ASSERT_TRUE(
+        normalizer.normalize(data.data(), data.size(), normalized.data()));
+    EXPECT_EQ(0, std::memcmp(normalized.data(), metrics.value_data(),
+                             metrics.value_bytes()));
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(normalizer.metadata()));
+    ASSERT_TRUE(view.set_value_data(normalized.data(), normalized.size()));
+    EXPECT_EQ(0x0102030405060708U, view.value<abacus::uint64>("bytes"));
+    EXPECT_EQ(-42, view.value<abacus::int32>("delta"));
+    EXPECT_EQ(0.125, view.value<abacus::float64>("loss"));
+    EXPECT_EQ(true, view.value<abacus::boolean>("up"));
+    EXPECT_EQ(2U, view.value<abacus::constant::uint64>("version"));
+
+    // The aggregator only combines buffers in host byte order
+    std::vector<uint8_t> sum(normalized.size());
+    abacus::aggregator foreign(foreign_metadata);
+    EXPECT_FALSE(foreign.aggregate({data.data()}, sum.data()));
+    abacus::aggregator aggregator(normalizer.metadata());
+    EXPECT_TRUE(aggregator.aggregate({normalized.data()}, sum.data()));
+
+    // In place
+    ASSERT_TRUE(normalizer.normalize(data.data(), data.size()));
+    EXPECT_EQ(normalized, data);
+
+    // The normalized buffer no longer has the foreign sync value
+    EXPECT_FALSE(normalizer.normalize(data.data(), data.size()));
+    EXPECT_EQ(normalized, data);
+    EXPECT_FALSE(normalizer.normalize(data.data(), 3));
+}
+
+TEST(test_normalizer, native)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}}};
+    abacus::metrics metrics(infos);
+    metrics.initialize<abacus::uint64>("bytes") = 7U;
+
+    abacus::normalizer normalizer(metrics.metadata());
+    EXPECT_TRUE(normalizer.is_native());
+
+    std::vector<uint8_t> data(metrics.value_data(),
+                              metrics.value_data() + metrics.value_bytes());
+    ASSERT_TRUE(normalizer.normalize(data.data(), data.size()));
+    EXPECT_EQ(0, std::memcmp(data.data(), metrics.value_data(), data.size()));
+}
@@ -0,0 +1,76 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <abacus/metrics.hpp>
+#include <abacus/percpu_counter.hpp>
+
+TEST(test_percpu_counter, increment_and_flush)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"packets"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"balance"},
+         abacus::int64{abacus::kind::gauge, abacus::description{""}}}};
+    abacus::metrics metrics(infos);
+
+    auto packets = metrics.initialize<abacus::uint64>("packets");
+    packets = 100U;
+    abacus::percpu_counter<abacus::uint64> counter(packets);
+    EXPECT_GE(counter.slots(), 1U);
+
+    ++counter;
+    counter += 4;
+    EXPECT_EQ(105U, counter.value());
+    EXPECT_EQ(100U, packets.value());
+    counter.flush();
+    EXPECT_EQ(105U, packets.value());
+
+    // Negative increments are added in two's complement
+    auto balance = metrics.initialize<abacus::int64>("balance");
+    abacus::percpu_counter<abacus::int64> signed_counter(balance);
+    signed_counter += 3;
+    signed_counter += -10;
+    signed_counter.flush();
+    EXPECT_EQ(-7, balance.value());
+}
+
+TEST(test_percpu_counter, threads)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"packets"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}}};
+    abacus::metrics metrics(infos);
+    auto packets = metrics.initialize<abacus::uint64>("packets");
+    abacus::percpu_counter<abacus::uint64> counter(packets);
+
+    const std::size_t increments = 100000;
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        threads.emplace_back(
+            [&counter, increments]()
+            {
+                for (std::size_t j = 0; j < increments; ++j)
+                {
+                    ++counter;
+                }
+            });
+    }
+
+    // Flushing while the threads increment is safe
+    counter.flush();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    counter.flush();
+    EXPECT_EQ(4 * increments, packets.value());
+}
@@ -0,0 +1,270 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <abacus/metrics.hpp>
+#include <abacus/recorder.hpp>
+#include <abacus/recording.hpp>
+#include <abacus/view.hpp>
+
+namespace
+{
+std::vector<uint8_t> read_file(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>()};
+}
+
+void write_file(const std::string& path, const std::vector<uint8_t>& bytes)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()),
+               static_cast<std::streamsize>(bytes.size()));
+}
+
+// Records the packets 0 to count - 1 a millisecond apart, alternating
+// between two schemas. If synced is given it is set to the file after the
+// last sync, as it is left by a crash before the file is closed.
+void record(const std::string& path, abacus::recorder::clock::time_point start,
+            uint64_t count, std::vector<uint8_t>* synced = nullptr)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"packets"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}}};
+    std::map<abacus::name, abacus::info> other_infos = {
+        {abacus::name{"other.packets"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"other.up"}, abacus::boolean{abacus::description{""}}}};
+
+    abacus::metrics metrics0(infos);
+    abacus::metrics metrics1(other_infos);
+    auto packets0 = metrics0.initialize<abacus::uint64>("packets");
+    auto packets1 = metrics1.initialize<abacus::uint64>("other.packets");
+
+    abacus::recorder recorder(path, 1000, 8);
+    ASSERT_TRUE(recorder.is_open());
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        auto time = start + std::chrono::milliseconds(i);
+        if (i % 2 == 0)
+        {
+            packets0 = i;
+            ASSERT_TRUE(recorder.record(metrics0, time));
+        }
+        else
+        {
+            packets1 = i;
+            ASSERT_TRUE(recorder.record(metrics1, time));
+        }
+    }
+    if (synced != nullptr)
+    {
+        ASSERT_TRUE(recorder.sync());
+        *synced = read_file(path);
+    }
+    ASSERT_TRUE(recorder.close());
+}
+
+// Reads the packets of a time range
+std::vector<uint64_t> read_packets(abacus::recording& recording,
+                                   abacus::recording::clock::time_point from,
+                                   abacus::recording::clock::time_point to,
+                                   bool* valid = nullptr)
+{
+    std::vector<uint64_t> packets;
+    bool result = recording.read(
+        from, to,
+        [&](auto time, const abacus::view& view)
+        {
+            auto name = view.metadata().metrics().count("packets") != 0
+                            ? "packets"
+                            : "other.packets";
+            packets.push_back(view.value<abacus::uint64>(name).value());
+            EXPECT_LE(from, time);
+            EXPECT_GE(to, time);
+        });
+    if (valid != nullptr)
+    {
+        *valid = result;
+    }
+    else
+    {
+        EXPECT_TRUE(result);
+    }
+    return packets;
+}
+
+// Returns the offsets of the value records of a file
+std::vector<std::size_t> value_records(const std::vector<uint8_t>& bytes)
+{
+    std::vector<std::size_t> offsets;
+    std::size_t offset = 16;
+    while (offset + 24 <= bytes.size())
+    {
+        std::size_t size = bytes[offset] | bytes[offset + 1] << 8 |
+                           bytes[offset + 2] << 16 | bytes[offset + 3] << 24;
+        if (bytes[offset + 8] == 2)
+        {
+            offsets.push_back(offset);
+        }
+        offset += 24 + size;
+    }
+    return offsets;
+}
+
+std::vector<uint64_t> sequence(uint64_t first, uint64_t last)
+{
+    std::vector<uint64_t> values;
+    for (uint64_t i = first; i <= last; ++i)
+    {
+        values.push_back(i);
+    }
+    return values;
+}
+}
+
+TEST(test_recorder, time_range)
+{
+    const std::string path = ::testing::TempDir() + "abacus_test_recorder";
+    const auto start = abacus::recorder::clock::now();
+    record(path, start, 1000);
+
+    abacus::recording recording(path);
+    ASSERT_TRUE(recording.is_open());
+    EXPECT_FALSE(recording.recovered());
+    EXPECT_EQ(2U, recording.sync_values().size());
+    EXPECT_EQ(1000U / 8U, recording.index_entries());
+
+    using std::chrono::milliseconds;
+    EXPECT_EQ(sequence(0, 999),
+              read_packets(recording, start, start + milliseconds(999)));
+    EXPECT_EQ(sequence(100, 199),
+              read_packets(recording, start + milliseconds(100),
+                           start + milliseconds(199)));
+    EXPECT_EQ(sequence(995, 999),
+              read_packets(recording, start + milliseconds(995),
+                           start + std::chrono::hours(1)));
+    EXPECT_TRUE(read_packets(recording, start - milliseconds(10),
+                             start - milliseconds(1))
+                    .empty());
+    EXPECT_TRUE(read_packets(recording, start + milliseconds(1000),
+                             start + milliseconds(2000))
+                    .empty());
+    std::remove(path.c_str());
+}
+
+TEST(test_recorder, decreasing_time)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"packets"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}}};
+
+    const std::string path = ::testing::TempDir() + "abacus_test_recorder";
+    abacus::metrics metrics(infos);
+    auto packets = metrics.initialize<abacus::uint64>("packets");
+    const auto start = abacus::recorder::clock::now();
+    {
+        abacus::recorder recorder(path);
+        packets = 1;
+        ASSERT_TRUE(recorder.record(metrics, start));
+        packets = 2;
+        ASSERT_TRUE(
+            recorder.record(metrics, start - std::chrono::seconds(1)));
+    }
+
+    // The earlier time is recorded as the time of the previous record
+    abacus::recording recording(path);
+    std::vector<abacus::recording::clock::time_point> times;
+    ASSERT_TRUE(recording.read(start, start,
+                               [&](auto time, const abacus::view&)
+                               { times.push_back(time); }));
+    EXPECT_EQ(2U, times.size());
+    std::remove(path.c_str());
+}
+
+TEST(test_recorder, recovery)
+{
+    const std::string path = ::testing::TempDir() + "abacus_test_recorder";
+    const auto start = abacus::recorder::clock::now();
+    const auto end = start + std::chrono::hours(1);
+
+    // A file which was not closed is scanned
+    std::vector<uint8_t> synced;
+    record(path, start, 100, &synced);
+    write_file(path, synced);
+    {
+        abacus::recording recording(path);
+        ASSERT_TRUE(recording.is_open());
+        EXPECT_TRUE(recording.recovered());
+        EXPECT_EQ(sequence(0, 99), read_packets(recording, start, end));
+    }
+
+    // A torn record ends the scan
+    record(path, start, 100);
+    auto bytes = read_file(path);
+    bytes.resize(bytes.size() - 24 - 8 - 1);
+    write_file(path, bytes);
+    {
+        abacus::recording recording(path);
+        ASSERT_TRUE(recording.is_open());
+        EXPECT_TRUE(recording.recovered());
+        EXPECT_EQ(sequence(0, 99), read_packets(recording, start, end));
+    }
+    bytes.resize(bytes.size() - 100);
+    write_file(path, bytes);
+    {
+        abacus::recording recording(path);
+        ASSERT_TRUE(recording.is_open());
+        auto packets = read_packets(recording, start, end);
+        ASSERT_FALSE(packets.empty());
+        EXPECT_EQ(sequence(0, packets.back()), packets);
+        EXPECT_GT(99U, packets.back());
+    }
+
+    // A file which is not a recording is not opened
+    bytes[0] ^= 1;
+    write_file(path, bytes);
+    EXPECT_FALSE(abacus::recording(path).is_open());
+    EXPECT_FALSE(abacus::recording(path + ".missing").is_open());
+    std::remove(path.c_str());
+}
+
+TEST(test_recorder, corruption)
+{
+    const std::string path = ::testing::TempDir() + "abacus_test_recorder";
+    const auto start = abacus::recorder::clock::now();
+    const auto end = start + std::chrono::hours(1);
+    record(path, start, 100);
+
+    // A corrupted record is detected when it is read, the records before it
+    // have been read
+    auto bytes = read_file(path);
+    auto records = value_records(bytes);
+    ASSERT_EQ(100U, records.size());
+    bytes[records[51] - 1] ^= 1;
+    write_file(path, bytes);
+    abacus::recording recording(path);
+    ASSERT_TRUE(recording.is_open());
+    EXPECT_FALSE(recording.recovered());
+    bool valid = true;
+    auto packets = read_packets(recording, start, end, &valid);
+    EXPECT_FALSE(valid);
+    EXPECT_EQ(sequence(0, 49), packets);
+
+    // The records after it are read
+    auto after = start + std::chrono::milliseconds(51);
+    EXPECT_EQ(sequence(51, 99), read_packets(recording, after, end));
+    std::remove(path.c_str());
+}
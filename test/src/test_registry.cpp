@@ -0,0 +1,138 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <abacus/registry.hpp>
+#include <abacus/view.hpp>
+
+namespace
+{
+// Copies the value data of the registry, the view points into the copy
+auto read(const abacus::registry& registry, abacus::view& view)
+    -> std::vector<uint8_t>
+{
+    std::vector<uint8_t> data(registry.value_bytes());
+    registry.copy_value_data(data.data());
+    EXPECT_TRUE(view.set_value_data(data.data(), data.size()));
+    return data;
+}
+}
+
+TEST(test_registry, grow)
+{
+    // Small segments, so the values are spread over several segments
+    abacus::registry registry(32);
+    EXPECT_FALSE(registry.has_update());
+
+    auto uptime = registry.initialize<abacus::uint64>(registry.add(
+        abacus::name{"uptime"},
+        abacus::uint64{abacus::kind::counter, abacus::description{""}}));
+    registry.add(abacus::name{"version"},
+                 abacus::constant{abacus::constant::uint64{3},
+                                  abacus::description{""}});
+    uptime = 10U;
+    ASSERT_TRUE(registry.has_update());
+
+    // A consumer starting from the full meta data
+    registry.update();
+    EXPECT_FALSE(registry.has_update());
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(registry.metadata()));
+    auto data = read(registry, view);
+    EXPECT_EQ(10U, view.value<abacus::uint64>("uptime").value());
+    EXPECT_EQ(3U, view.value<abacus::constant::uint64>("version"));
+
+    // New peers appear, the existing metric stays valid
+    std::vector<abacus::metric<abacus::uint64>> peers;
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        std::size_t id = registry.add(
+            abacus::name{"peer" + std::to_string(i) + ".bytes"},
+            abacus::uint64{abacus::kind::counter, abacus::description{""}});
+        peers.push_back(registry.initialize<abacus::uint64>(id));
+        peers.back() = i;
+    }
+    EXPECT_GT(registry.value_bytes(), 64U);
+    uptime = 20U;
+
+    // The value data no longer matches the view once the update is published
+    auto update = registry.update();
+    EXPECT_EQ(8, update.metrics_size());
+    EXPECT_EQ(view.metadata().sync_value(), update.base_sync_value());
+    EXPECT_NE(update.base_sync_value(), update.sync_value());
+    data.resize(registry.value_bytes());
+    registry.copy_value_data(data.data());
+    EXPECT_FALSE(view.set_value_data(data.data(), data.size()));
+
+    ASSERT_TRUE(view.apply_update(update));
+    EXPECT_EQ(10U, view.count());
+    data = read(registry, view);
+    EXPECT_EQ(20U, view.value<abacus::uint64>("uptime").value());
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        auto name = "peer" + std::to_string(i) + ".bytes";
+        EXPECT_EQ(i, view.value<abacus::uint64>(name).value());
+    }
+
+    // An update only applies once, to the meta data it is based on
+    EXPECT_FALSE(view.apply_update(update));
+    abacus::view stale;
+    EXPECT_FALSE(stale.apply_update(update));
+
+    // A new consumer gets the same state from the full meta data
+    abacus::view fresh;
+    ASSERT_TRUE(fresh.set_metadata(registry.metadata()));
+    auto fresh_data = read(registry, fresh);
+    EXPECT_EQ(10U, fresh.count());
+    EXPECT_EQ(5U, fresh.value<abacus::uint64>("peer5.bytes").value());
+
+    // Retired metrics stay in the meta data without a value
+    std::size_t id = registry.id("peer3.bytes");
+    registry.retire(id);
+    EXPECT_TRUE(registry.is_retired(id));
+    EXPECT_FALSE(registry.has_update());
+    data = read(registry, view);
+    EXPECT_FALSE(view.value<abacus::uint64>("peer3.bytes").has_value());
+    EXPECT_EQ(4U, view.value<abacus::uint64>("peer4.bytes").value());
+    EXPECT_THROW(registry.id("peer8.bytes"), std::out_of_range);
+}
+
+TEST(test_registry, duplicate)
+{
+    abacus::registry registry;
+    std::size_t bytes = registry.add(
+        abacus::name{"bytes"},
+        abacus::uint64{abacus::kind::counter, abacus::description{""}});
+    const std::size_t value_bytes = registry.value_bytes();
+
+    // A name in use is rejected without changing the registry
+    EXPECT_THROW(registry.add(abacus::name{"bytes"},
+                              abacus::uint32{abacus::kind::gauge,
+                                             abacus::description{""}}),
+                 std::invalid_argument);
+    EXPECT_EQ(1U, registry.count());
+    EXPECT_EQ(value_bytes, registry.value_bytes());
+    EXPECT_EQ(bytes, registry.id("bytes"));
+
+    // The following metrics keep ids and offsets matching the meta data
+    auto packets = registry.initialize<abacus::uint64>(registry.add(
+        abacus::name{"packets"},
+        abacus::uint64{abacus::kind::counter, abacus::description{""}}));
+    EXPECT_EQ(2U, registry.count());
+    packets = 7U;
+    registry.update();
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(registry.metadata()));
+    auto data = read(registry, view);
+    EXPECT_EQ(abacus::protobuf::Metric::kUint64,
+              view.metric("bytes").type_case());
+    EXPECT_EQ(7U, view.value<abacus::uint64>("packets").value());
+}
@@ -0,0 +1,181 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <chrono>
+#include <limits>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <abacus/metrics.hpp>
+#include <abacus/rollup.hpp>
+#include <abacus/view.hpp>
+
+TEST(test_rollup, windows)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"delta"},
+         abacus::int32{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"rate"},
+         abacus::float64{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"up"}, abacus::boolean{abacus::description{""}}},
+        {abacus::name{"version"},
+         abacus::constant{abacus::constant::uint64{2},
+                          abacus::description{""}}}};
+    abacus::metrics metrics(infos);
+    auto bytes = metrics.initialize<abacus::uint64>("bytes");
+    auto delta = metrics.initialize<abacus::int32>("delta");
+    auto rate = metrics.initialize<abacus::float64>("rate");
+    auto up = metrics.initialize<abacus::boolean>("up");
+
+    using namespace std::chrono_literals;
+    abacus::rollup rollup(metrics.metadata(), 10s, 2);
+    EXPECT_EQ(metrics.value_bytes(), rollup.value_bytes());
+    EXPECT_EQ(10s, rollup.window());
+    EXPECT_EQ(2U, rollup.capacity());
+    EXPECT_EQ(0U, rollup.size());
+
+    // Three buffers in the first window, the rate is only set twice
+    const abacus::rollup::clock::time_point start(100s);
+    bytes = 10U;
+    delta = -5;
+    rate = 1.5;
+    up = true;
+    ASSERT_TRUE(rollup.update(metrics.value_data(), start + 1s));
+    bytes = 20U;
+    delta = 7;
+    rate = 0.5;
+    up = false;
+    ASSERT_TRUE(rollup.update(metrics.value_data(), start + 2s));
+    bytes = 30U;
+    delta = 1;
+    rate = std::nullopt;
+    ASSERT_TRUE(rollup.update(metrics.value_data(), start + 9s));
+    EXPECT_EQ(0U, rollup.size());
+
+    // A buffer in a later window closes the window
+    bytes = 40U;
+    ASSERT_TRUE(rollup.update(metrics.value_data(), start + 35s));
+    ASSERT_EQ(1U, rollup.size());
+    EXPECT_EQ(start, rollup.start(0));
+    EXPECT_EQ(3U, rollup.samples(0));
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metrics.metadata()));
+    EXPECT_EQ(3U, rollup.count(0, view.id("bytes")));
+    EXPECT_EQ(2U, rollup.count(0, view.id("rate")));
+    EXPECT_EQ(0U, rollup.count(0, view.id("version")));
+
+    std::vector<uint8_t> data(rollup.value_bytes());
+    auto read = [&](abacus::statistic statistic)
+    {
+        rollup.write(0, statistic, data.data());
+        EXPECT_TRUE(view.set_value_data(data.data(), data.size()));
+    };
+
+    read(abacus::statistic::min);
+    EXPECT_EQ(10U, view.value<abacus::uint64>("bytes").value());
+    EXPECT_EQ(-5, view.value<abacus::int32>("delta").value());
+    EXPECT_EQ(0.5, view.value<abacus::float64>("rate").value());
+    EXPECT_FALSE(view.value<abacus::boolean>("up").value());
+
+    read(abacus::statistic::max);
+    EXPECT_EQ(30U, view.value<abacus::uint64>("bytes").value());
+    EXPECT_EQ(7, view.value<abacus::int32>("delta").value());
+    EXPECT_EQ(1.5, view.value<abacus::float64>("rate").value());
+    EXPECT_TRUE(view.value<abacus::boolean>("up").value());
+
+    read(abacus::statistic::sum);
+    EXPECT_EQ(60U, view.value<abacus::uint64>("bytes").value());
+    EXPECT_EQ(3, view.value<abacus::int32>("delta").value());
+    EXPECT_EQ(2.0, view.value<abacus::float64>("rate").value());
+    EXPECT_FALSE(view.value<abacus::boolean>("up").has_value());
+
+    read(abacus::statistic::avg);
+    EXPECT_EQ(20U, view.value<abacus::uint64>("bytes").value());
+    EXPECT_EQ(1, view.value<abacus::int32>("delta").value());
+    EXPECT_EQ(1.0, view.value<abacus::float64>("rate").value());
+
+    read(abacus::statistic::last);
+    EXPECT_EQ(30U, view.value<abacus::uint64>("bytes").value());
+    EXPECT_EQ(1, view.value<abacus::int32>("delta").value());
+    EXPECT_EQ(0.5, view.value<abacus::float64>("rate").value());
+    EXPECT_FALSE(view.value<abacus::boolean>("up").value());
+
+    // Late buffers are added to the current window
+    bytes = 1U;
+    ASSERT_TRUE(rollup.update(metrics.value_data(), start));
+    rollup.flush();
+    ASSERT_EQ(2U, rollup.size());
+    EXPECT_EQ(start + 30s, rollup.start(1));
+    EXPECT_EQ(2U, rollup.samples(1));
+    rollup.write(1, abacus::statistic::min, data.data());
+    ASSERT_TRUE(view.set_value_data(data.data(), data.size()));
+    EXPECT_EQ(1U, view.value<abacus::uint64>("bytes").value());
+    EXPECT_FALSE(view.value<abacus::float64>("rate").has_value());
+
+    // Flushing an empty window does nothing, and the oldest window is
+    // overwritten when the ring is full
+    rollup.flush();
+    EXPECT_EQ(2U, rollup.size());
+    ASSERT_TRUE(rollup.update(metrics.value_data(), start + 50s));
+    rollup.flush();
+    ASSERT_EQ(2U, rollup.size());
+    EXPECT_EQ(start + 30s, rollup.start(0));
+    EXPECT_EQ(start + 50s, rollup.start(1));
+    EXPECT_EQ(1U, rollup.samples(1));
+
+    // Value data of another schema is rejected
+    std::vector<uint8_t> other(metrics.value_data(),
+                               metrics.value_data() + metrics.value_bytes());
+    other[0] ^= 0xFF;
+    EXPECT_FALSE(rollup.update(other.data(), start + 50s));
+}
+
+TEST(test_rollup, saturate)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"large"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"negative"},
+         abacus::int64{abacus::kind::gauge, abacus::description{""}}},
+        {abacus::name{"small"},
+         abacus::uint32{abacus::kind::counter, abacus::description{""}}}};
+    abacus::metrics metrics(infos);
+    auto large = metrics.initialize<abacus::uint64>("large");
+    large = std::numeric_limits<uint64_t>::max() - 1;
+    auto negative = metrics.initialize<abacus::int64>("negative");
+    negative = std::numeric_limits<int64_t>::min() + 1;
+    auto small = metrics.initialize<abacus::uint32>("small");
+    small = std::numeric_limits<uint32_t>::max();
+
+    abacus::rollup rollup(metrics.metadata(), std::chrono::seconds(1), 1);
+    const abacus::rollup::clock::time_point start;
+    ASSERT_TRUE(rollup.update(metrics.value_data(), start));
+    ASSERT_TRUE(rollup.update(metrics.value_data(), start));
+    rollup.flush();
+
+    std::vector<uint8_t> data(rollup.value_bytes());
+    rollup.write(0, abacus::statistic::sum, data.data());
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metrics.metadata()));
+    ASSERT_TRUE(view.set_value_data(data.data(), data.size()));
+    EXPECT_EQ(std::numeric_limits<uint32_t>::max(),
+              view.value<abacus::uint32>("small").value());
+
+    // The sums of 64-bit integers saturate instead of wrapping
+    EXPECT_EQ(std::numeric_limits<uint64_t>::max(),
+              view.value<abacus::uint64>("large").value());
+    EXPECT_EQ(std::numeric_limits<int64_t>::min(),
+              view.value<abacus::int64>("negative").value());
+
+    // The average is computed from the full sum
+    rollup.write(0, abacus::statistic::avg, data.data());
+    ASSERT_TRUE(view.set_value_data(data.data(), data.size()));
+    EXPECT_EQ(std::numeric_limits<uint32_t>::max(),
+              view.value<abacus::uint32>("small").value());
+}
@@ -0,0 +1,122 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <cstring>
+#include <memory>
+#include <gtest/gtest.h>
+
+#include <abacus/metrics.hpp>
+#include <abacus/schema.hpp>
+#include <abacus/view.hpp>
+
+TEST(test_schema, api)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter,
+                        abacus::description{"Received bytes"},
+                        abacus::unit{"bytes"}}},
+        {abacus::name{"connected"},
+         abacus::boolean{abacus::description{"Connected"}}},
+        {abacus::name{"pi"},
+         abacus::constant{abacus::constant::float64{3.14},
+                          abacus::description{"Pi"}}},
+        {abacus::name{"rtt"},
+         abacus::float64{abacus::kind::gauge,
+                         abacus::description{"Round trip time"},
+                         abacus::unit{"ms"}}}};
+
+    abacus::schema schema(infos);
+
+    ASSERT_EQ(4U, schema.count());
+    EXPECT_EQ(0U, schema.id("bytes"));
+    EXPECT_EQ(3U, schema.id("rtt"));
+    EXPECT_THROW(schema.id("unknown"), std::out_of_range);
+    EXPECT_EQ("pi", schema.metric_name(2));
+
+    EXPECT_TRUE(schema.is_constant(schema.id("pi")));
+    EXPECT_FALSE(schema.is_constant(schema.id("bytes")));
+    EXPECT_EQ(0U, schema.offset(schema.id("pi")));
+    EXPECT_EQ(sizeof(uint32_t), schema.offset(schema.id("bytes")));
+
+    // The schema produces the same meta data as the metrics
+    abacus::metrics metrics(infos);
+    EXPECT_EQ(metrics.metadata().sync_value(), schema.sync_value());
+    EXPECT_EQ(metrics.value_bytes(), schema.value_bytes());
+    ASSERT_EQ(metrics.metadata_bytes(), schema.metadata_bytes());
+    EXPECT_EQ(0, std::memcmp(metrics.metadata_data(), schema.metadata_data(),
+                             schema.metadata_bytes()));
+}
+
+TEST(test_schema, shared)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter,
+                        abacus::description{"Received bytes"},
+                        abacus::unit{"bytes"}}},
+        {abacus::name{"connected"},
+         abacus::boolean{abacus::description{"Connected"}}},
+        {abacus::name{"pi"},
+         abacus::constant{abacus::constant::float64{3.14},
+                          abacus::description{"Pi"}}},
+        {abacus::name{"rtt"},
+         abacus::float64{abacus::kind::gauge,
+                         abacus::description{"Round trip time"},
+                         abacus::unit{"ms"}}}};
+
+    auto schema = std::make_shared<const abacus::schema>(infos);
+
+    abacus::metrics metrics1(schema);
+    abacus::metrics metrics2(schema);
+
+    // The meta data is shared, the values are not
+    EXPECT_EQ(schema, metrics1.schema());
+    EXPECT_EQ(schema->metadata_data(), metrics1.metadata_data());
+    EXPECT_EQ(metrics1.metadata_data(), metrics2.metadata_data());
+    EXPECT_NE(metrics1.value_data(), metrics2.value_data());
+
+    EXPECT_TRUE(metrics1.is_initialized("pi"));
+    EXPECT_FALSE(metrics1.is_initialized("bytes"));
+
+    auto bytes1 = metrics1.initialize<abacus::uint64>("bytes");
+    auto bytes2 = metrics2.initialize<abacus::uint64>("bytes");
+    bytes1 = 10U;
+    bytes2 = 20U;
+    EXPECT_FALSE(metrics2.is_initialized("rtt"));
+
+    // The metrics keep the schema alive
+    schema.reset();
+    abacus::metrics moved(std::move(metrics2));
+    EXPECT_EQ(nullptr, metrics2.schema());
+    EXPECT_EQ(0U, metrics2.count());
+
+    for (const auto* m : {&metrics1, &moved})
+    {
+        abacus::view view;
+        ASSERT_TRUE(view.set_metadata(m->metadata()));
+        ASSERT_TRUE(view.set_value_data(m->value_data(), m->value_bytes()));
+        EXPECT_EQ(3.14, view.value<abacus::constant::float64>("pi"));
+        EXPECT_FALSE(view.value<abacus::float64>("rtt").has_value());
+    }
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(moved.metadata()));
+    ASSERT_TRUE(view.set_value_data(metrics1.value_data(),
+                                    metrics1.value_bytes()));
+    EXPECT_EQ(10U, view.value<abacus::uint64>("bytes").value());
+    ASSERT_TRUE(
+        view.set_value_data(moved.value_data(), moved.value_bytes()));
+    EXPECT_EQ(20U, view.value<abacus::uint64>("bytes").value());
+
+    // Resetting one metrics leaves the constants initialized
+    moved.reset();
+    EXPECT_TRUE(moved.is_initialized("pi"));
+    EXPECT_TRUE(moved.is_initialized("bytes"));
+    ASSERT_TRUE(
+        view.set_value_data(moved.value_data(), moved.value_bytes()));
+    EXPECT_FALSE(view.value<abacus::uint64>("bytes").has_value());
+}
@@ -0,0 +1,159 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <gtest/gtest.h>
+
+#include <abacus/metrics.hpp>
+#include <abacus/selection.hpp>
+#include <abacus/selector.hpp>
+#include <abacus/view.hpp>
+
+TEST(test_selector, compile)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"conn.rx.bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""},
+                        abacus::unit{"bytes"}}},
+        {abacus::name{"conn.rx.rate"},
+         abacus::float64{abacus::kind::gauge, abacus::description{""},
+                         abacus::unit{"bytes/s"}}},
+        {abacus::name{"conn.tx.bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""},
+                        abacus::unit{"bytes"}}},
+        {abacus::name{"conn.tx.rate"},
+         abacus::float64{abacus::kind::gauge, abacus::description{""},
+                         abacus::unit{"bytes/s"}}},
+        {abacus::name{"connected"},
+         abacus::boolean{abacus::description{""}}},
+        {abacus::name{"version"},
+         abacus::constant{abacus::constant::uint64{3},
+                          abacus::description{""}}}};
+
+    abacus::metrics metrics(infos);
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metrics.metadata()));
+
+    auto names = [&](const abacus::selection& selection)
+    {
+        std::vector<std::string> result;
+        for (auto id : selection.ids())
+        {
+            result.emplace_back(view.metric_name(id));
+        }
+        return result;
+    };
+
+    // An empty selector selects everything
+    EXPECT_EQ(view.count(), abacus::selector().compile(view).count());
+
+    EXPECT_EQ(std::vector<std::string>({"conn.tx.bytes", "conn.tx.rate"}),
+              names(abacus::selector().add_prefix("conn.tx.").compile(view)));
+
+    EXPECT_EQ(std::vector<std::string>({"conn.rx.bytes", "version"}),
+              names(abacus::selector()
+                        .add_name("version")
+                        .add_name("conn.rx.bytes")
+                        .add_name("conn.rx")
+                        .compile(view)));
+
+    // Overlapping criteria only select a metric once
+    EXPECT_EQ(std::vector<std::string>({"conn.rx.rate", "conn.tx.rate"}),
+              names(abacus::selector()
+                        .add_glob("conn.*.rate")
+                        .add_name("conn.tx.rate")
+                        .compile(view)));
+
+    EXPECT_EQ(std::vector<std::string>({"conn.rx.bytes", "conn.tx.bytes"}),
+              names(abacus::selector()
+                        .add_kind(abacus::kind::counter)
+                        .compile(view)));
+
+    EXPECT_EQ(std::vector<std::string>({"conn.rx.rate"}),
+              names(abacus::selector()
+                        .add_prefix("conn.rx.")
+                        .add_unit("bytes/s")
+                        .compile(view)));
+
+    EXPECT_EQ(0U, abacus::selector().add_prefix("disk.").compile(view).count());
+}
+
+TEST(test_selector, pack)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"conn.rx.bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""},
+                        abacus::unit{"bytes"}}},
+        {abacus::name{"conn.rx.rate"},
+         abacus::float64{abacus::kind::gauge, abacus::description{""},
+                         abacus::unit{"bytes/s"}}},
+        {abacus::name{"conn.tx.bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""},
+                        abacus::unit{"bytes"}}},
+        {abacus::name{"conn.tx.rate"},
+         abacus::float64{abacus::kind::gauge, abacus::description{""},
+                         abacus::unit{"bytes/s"}}},
+        {abacus::name{"connected"},
+         abacus::boolean{abacus::description{""}}},
+        {abacus::name{"version"},
+         abacus::constant{abacus::constant::uint64{3},
+                          abacus::description{""}}}};
+
+    abacus::metrics metrics(infos);
+    auto rx_bytes = metrics.initialize<abacus::uint64>("conn.rx.bytes");
+    auto tx_bytes = metrics.initialize<abacus::uint64>("conn.tx.bytes");
+    auto tx_rate = metrics.initialize<abacus::float64>("conn.tx.rate");
+    auto connected = metrics.initialize<abacus::boolean>("connected");
+    rx_bytes = 10U;
+    tx_bytes = 20U;
+    tx_rate = 1.5;
+    connected = true;
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metrics.metadata()));
+
+    auto selection = abacus::selector()
+                         .add_prefix("conn.tx.")
+                         .add_name("connected")
+                         .add_name("version")
+                         .compile(view);
+    ASSERT_EQ(4U, selection.count());
+    EXPECT_EQ(metrics.metadata().sync_value(), selection.source_sync_value());
+    EXPECT_NE(metrics.metadata().sync_value(),
+              selection.metadata().sync_value());
+    EXPECT_EQ(4, selection.metadata().metrics().size());
+
+    // The packed buffer holds the sync value and three values
+    EXPECT_EQ(4U + 9U + 9U + 2U, selection.value_bytes());
+    EXPECT_LT(selection.value_bytes(), metrics.value_bytes());
+
+    std::vector<uint8_t> packed(selection.value_bytes());
+    ASSERT_TRUE(selection.pack(metrics.value_data(), metrics.value_bytes(),
+                               packed.data()));
+
+    // The packed buffer can be read with a regular view
+    abacus::view packed_view;
+    ASSERT_TRUE(packed_view.set_metadata(selection.metadata()));
+    ASSERT_TRUE(packed_view.set_value_data(packed.data(), packed.size()));
+    EXPECT_EQ(20U, packed_view.value<abacus::uint64>("conn.tx.bytes").value());
+    EXPECT_EQ(1.5, packed_view.value<abacus::float64>("conn.tx.rate").value());
+    EXPECT_TRUE(packed_view.value<abacus::boolean>("connected").value());
+    EXPECT_EQ(3U, packed_view.value<abacus::constant::uint64>("version"));
+
+    // Repacking picks up new values
+    tx_bytes = 30U;
+    connected = false;
+    ASSERT_TRUE(selection.pack(metrics.value_data(), metrics.value_bytes(),
+                               packed.data()));
+    EXPECT_EQ(30U, packed_view.value<abacus::uint64>("conn.tx.bytes").value());
+    EXPECT_FALSE(packed_view.value<abacus::boolean>("connected").value());
+
+    // Value data of another schema is rejected
+    abacus::metrics other(
+        {{abacus::name{"other"},
+          abacus::uint64{abacus::kind::counter, abacus::description{""}}}});
+    EXPECT_FALSE(selection.pack(other.value_data(), other.value_bytes(),
+                                packed.data()));
+}
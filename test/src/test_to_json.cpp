@@ -8,6 +8,7 @@
 #include <gtest/gtest.h>
 
 #include <abacus/metrics.hpp>
+#include <abacus/selector.hpp>
 #include <abacus/to_json.hpp>
 #include <abacus/view.hpp>
 
@@ -209,3 +210,69 @@ TEST(test_to_json, to_json)
     EXPECT_EQ(json_from_view, json_from_data);
     EXPECT_EQ(expected_json, json_from_view) << json_from_view;
 }
+
+static const char* expected_json_selection = R"({
+  "metric1" : {
+    "int64" : {
+      "description" : "A signed integer metric",
+      "kind" : "GAUGE",
+      "offset" : 4,
+      "unit" : "USD"
+    },
+    "value" : -42
+  },
+  "metric2" : {
+    "constant" : {
+      "boolean" : true,
+      "description" : "A boolean constant"
+    },
+    "value" : true
+  }
+})";
+
+TEST(test_to_json, to_json_selection)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"metric0"},
+         abacus::uint64{abacus::kind::counter,
+                        abacus::description{"An unsigned integer metric"},
+                        abacus::unit{"bytes"}}},
+        {abacus::name{"metric1"},
+         abacus::int64{abacus::kind::gauge,
+                       abacus::description{"A signed integer metric"},
+                       abacus::unit{"USD"}}},
+        {abacus::name{"metric2"},
+         abacus::constant{abacus::constant::boolean{true},
+                          abacus::description{"A boolean constant"}}}};
+
+    abacus::metrics metrics(infos);
+    auto m0 = metrics.initialize<abacus::uint64>("metric0").set_value(42);
+    auto m1 = metrics.initialize<abacus::int64>("metric1").set_value(-42);
+    (void)m0;
+    (void)m1;
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metrics.metadata()));
+    ASSERT_TRUE(
+        view.set_value_data(metrics.value_data(), metrics.value_bytes()));
+
+    auto selection = abacus::selector()
+                         .add_name("metric1")
+                         .add_name("metric2")
+                         .compile(view);
+
+    EXPECT_EQ(R"({
+  "metric1" : -42,
+  "metric2" : true
+})",
+              abacus::to_json(view, selection, true));
+
+    // The meta data describes the packed selection
+    auto json = abacus::to_json(view, selection);
+    EXPECT_EQ(expected_json_selection, json) << json;
+
+    // A selection compiled against another schema is rejected
+    abacus::view other;
+    ASSERT_TRUE(other.set_metadata(selection.metadata()));
+    EXPECT_EQ("", abacus::to_json(other, selection, true));
+}
@@ -0,0 +1,80 @@
+// Copyright (c) Steinwurf ApS 2020.
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst
+// file.
+
+#include <memory>
+#include <optional>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include <abacus/metrics.hpp>
+#include <abacus/value_pool.hpp>
+#include <abacus/view.hpp>
+
+TEST(test_value_pool, recycle)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"bytes"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"up"},
+         abacus::constant{abacus::constant::boolean{true},
+                          abacus::description{""}}}};
+
+    auto schema = std::make_shared<const abacus::schema>(infos);
+    abacus::value_pool pool(schema, 2);
+    EXPECT_EQ(schema->value_bytes() + 2U, pool.block_bytes());
+    EXPECT_EQ(0U, pool.capacity());
+
+    const uint8_t* first_data = nullptr;
+    {
+        abacus::metrics first(pool);
+        EXPECT_EQ(2U, pool.capacity());
+        EXPECT_EQ(1U, pool.size());
+        first_data = first.value_data();
+
+        auto bytes = first.initialize<abacus::uint64>("bytes");
+        bytes = 42U;
+        EXPECT_TRUE(first.is_initialized());
+    }
+    EXPECT_EQ(0U, pool.size());
+
+    // The recycled block is reset to the initial state of the schema
+    std::optional<abacus::metrics> second(pool);
+    EXPECT_EQ(first_data, second->value_data());
+    EXPECT_FALSE(second->is_initialized("bytes"));
+    EXPECT_TRUE(second->is_initialized("up"));
+    EXPECT_EQ(schema->metadata_data(), second->metadata_data());
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(second->metadata()));
+    ASSERT_TRUE(
+        view.set_value_data(second->value_data(), second->value_bytes()));
+    EXPECT_FALSE(view.value<abacus::uint64>("bytes").has_value());
+    EXPECT_TRUE(view.value<abacus::constant::boolean>("up"));
+
+    // The pool grows a chunk at a time
+    std::vector<abacus::metrics> many;
+    many.reserve(3);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        many.emplace_back(pool);
+    }
+    EXPECT_EQ(4U, pool.size());
+    EXPECT_EQ(4U, pool.capacity());
+
+    // Moved metrics return their block once
+    abacus::metrics moved(std::move(many.back()));
+    many.clear();
+    EXPECT_EQ(2U, pool.size());
+
+    second.reset();
+    {
+        abacus::metrics gone(std::move(moved));
+    }
+    EXPECT_EQ(0U, pool.size());
+
+    pool.clear();
+    EXPECT_EQ(0U, pool.capacity());
+}
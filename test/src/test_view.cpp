@@ -8,6 +8,7 @@
 #include <gtest/gtest.h>
 
 #include <abacus/metrics.hpp>
+#include <abacus/parse_metadata.hpp>
 #include <abacus/protocol_version.hpp>
 #include <abacus/view.hpp>
 
@@ -120,3 +121,129 @@ TEST(test_view, api)
     EXPECT_TRUE(view_value3.has_value());
     EXPECT_EQ(test_enum::value2, (test_enum)view_value3.value());
 }
+
+TEST(test_view, copy)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"metric0"},
+         abacus::uint64{abacus::kind::counter, abacus::description{""}}},
+        {abacus::name{"metric1"},
+         abacus::int64{abacus::kind::gauge, abacus::description{""}}}};
+
+    abacus::metrics metrics(infos);
+    auto metric0 = metrics.initialize<abacus::uint64>("metric0").set_value(1U);
+    auto metric1 = metrics.initialize<abacus::int64>("metric1").set_value(-1);
+    (void)metric0;
+    (void)metric1;
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metrics.metadata()));
+    ASSERT_TRUE(
+        view.set_value_data(metrics.value_data(), metrics.value_bytes()));
+
+    // The copy must have its own index into its own copy of the meta data
+    abacus::view copy = view;
+    view = abacus::view();
+    EXPECT_EQ(0U, view.count());
+
+    ASSERT_EQ(2U, copy.count());
+    EXPECT_EQ("metric1", copy.metric_name(1));
+    EXPECT_EQ(1U, copy.value<abacus::uint64>("metric0").value());
+    EXPECT_EQ(-1, copy.value<abacus::int64>(1).value());
+    EXPECT_TRUE(copy.metric(1).has_int64());
+
+    abacus::view moved = std::move(copy);
+    EXPECT_EQ(-1, moved.value<abacus::int64>("metric1").value());
+}
+
+TEST(test_view, parse)
+{
+    std::map<abacus::name, abacus::info> infos = {
+        {abacus::name{"metric0"},
+         abacus::uint64{abacus::kind::counter, abacus::description{"Bytes"}}},
+        {abacus::name{"metric1"},
+         abacus::constant{abacus::constant::str{"hello"},
+                          abacus::description{""}}}};
+    abacus::metrics metrics(infos);
+    auto metric0 = metrics.initialize<abacus::uint64>("metric0").set_value(7U);
+    (void)metric0;
+
+    // The view parses the meta data directly
+    abacus::view view;
+    ASSERT_TRUE(
+        view.set_metadata(metrics.metadata_data(), metrics.metadata_bytes()));
+    EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
+        metrics.metadata(), view.metadata()));
+    ASSERT_TRUE(
+        view.set_value_data(metrics.value_data(), metrics.value_bytes()));
+    EXPECT_EQ(7U, view.value<abacus::uint64>("metric0").value());
+    EXPECT_EQ("hello", view.value<abacus::constant::str>("metric1"));
+
+    // Invalid meta data leaves the view empty
+    std::vector<uint8_t> invalid(16, 0xFF);
+    EXPECT_FALSE(view.set_metadata(invalid.data(), invalid.size()));
+    EXPECT_EQ(0U, view.count());
+
+    // The meta data can also be parsed into an arena owned by the caller
+    google::protobuf::Arena arena;
+    auto* parsed = abacus::parse_metadata(metrics.metadata_data(),
+                                          metrics.metadata_bytes(), arena);
+    ASSERT_NE(nullptr, parsed);
+    EXPECT_GT(arena.SpaceUsed(), 0U);
+    EXPECT_EQ(metrics.metadata().sync_value(), parsed->sync_value());
+    EXPECT_EQ(nullptr,
+              abacus::parse_metadata(invalid.data(), invalid.size(), arena));
+}
+
+TEST(test_view, prefix_and_match)
+{
+    std::map<abacus::name, abacus::info> infos;
+    for (auto name : {"conn.rx.bytes", "conn.rx.packets", "conn.tx.bytes",
+                      "conn.tx.packets", "conn.txq.length", "uptime"})
+    {
+        infos.emplace(abacus::name{name},
+                      abacus::uint64{abacus::kind::counter,
+                                     abacus::description{""}});
+    }
+
+    abacus::metrics metrics(infos);
+    auto bytes = metrics.initialize<abacus::uint64>("conn.tx.bytes");
+    bytes = 42U;
+
+    abacus::view view;
+    ASSERT_TRUE(view.set_metadata(metrics.metadata()));
+    ASSERT_TRUE(
+        view.set_value_data(metrics.value_data(), metrics.value_bytes()));
+
+    auto [first, last] = view.prefix_range("conn.tx.");
+    ASSERT_EQ(2U, last - first);
+    EXPECT_EQ("conn.tx.bytes", view.metric_name(first));
+    EXPECT_EQ("conn.tx.packets", view.metric_name(first + 1));
+    EXPECT_EQ(42U, view.value<abacus::uint64>(first).value());
+
+    // Without the separator the prefix also covers sibling names
+    auto tx = view.prefix_range("conn.tx");
+    EXPECT_EQ(3U, tx.second - tx.first);
+
+    auto all = view.prefix_range("");
+    EXPECT_EQ(0U, all.first);
+    EXPECT_EQ(view.count(), all.second);
+
+    auto none = view.prefix_range("disk.");
+    EXPECT_EQ(none.first, none.second);
+    none = view.prefix_range("zzz");
+    EXPECT_EQ(none.first, none.second);
+
+    EXPECT_EQ(std::vector<std::size_t>({view.id("conn.rx.bytes"),
+                                        view.id("conn.tx.bytes")}),
+              view.match("conn.*.bytes"));
+    EXPECT_EQ(std::vector<std::size_t>({view.id("conn.rx.packets"),
+                                        view.id("conn.tx.packets")}),
+              view.match("conn.?x.packets"));
+    EXPECT_EQ(std::vector<std::size_t>({view.id("conn.txq.length")}),
+              view.match("*q*h"));
+    EXPECT_EQ(std::vector<std::size_t>({view.id("uptime")}),
+              view.match("uptime"));
+    EXPECT_EQ(view.count(), view.match("*").size());
+    EXPECT_TRUE(view.match("conn.*.drops").empty());
+}